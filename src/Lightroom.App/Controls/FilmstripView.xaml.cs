@@ -15,6 +15,15 @@ namespace Lightroom.App.Controls
         public List<string>? ThumbnailPaths { get; private set; }
         private List<ThumbnailItem>? _thumbnailItems;
 
+        // 缩略图尺寸（与 ThumbnailItem 的单个加载路径一致）
+        private const uint ThumbnailSize = 200;
+
+        // 当前批量生成的批次及其缩略图项；委托必须保持引用，避免被 GC 回收后原生代码回调
+        private readonly Core.NativeMethods.ThumbnailBatchDelegate _thumbnailBatchCallback;
+        private readonly object _batchLock = new object();
+        private uint _currentBatchId;
+        private List<ThumbnailItem>? _batchItems;
+
         // 支持的图片格式
         private static readonly string[] SupportedImageExtensions = { 
             ".jpg", ".jpeg", ".png", ".bmp", ".tiff", ".tif", ".gif",  // 标准格式
@@ -40,6 +49,67 @@ namespace Lightroom.App.Controls
         public FilmstripView()
         {
             InitializeComponent();
+            _thumbnailBatchCallback = OnThumbnailGenerated;
+        }
+
+        /// <summary>
+        /// 创建缩略图项并在 SDK 的线程池中批量生成缩略图（先完成的先显示）
+        /// </summary>
+        private List<ThumbnailItem> CreateThumbnailItems(List<string> paths)
+        {
+            var items = paths.Select(path => new ThumbnailItem(path, loadImmediately: false)).ToList();
+
+            lock (_batchLock)
+            {
+                if (_currentBatchId != 0)
+                {
+                    Core.NativeMethods.CancelThumbnailBatch(_currentBatchId);
+                    _currentBatchId = 0;
+                }
+                _batchItems = items;
+
+                if (items.Count > 0)
+                {
+                    _currentBatchId = Core.NativeMethods.GenerateThumbnailsBatch(
+                        paths.ToArray(), (uint)paths.Count, ThumbnailSize, ThumbnailSize, _thumbnailBatchCallback, IntPtr.Zero);
+                }
+            }
+
+            if (items.Count > 0 && _currentBatchId == 0)
+            {
+                // 批量接口不可用时逐个加载
+                foreach (var item in items)
+                {
+                    item.LoadThumbnailFallback();
+                }
+            }
+            return items;
+        }
+
+        private void OnThumbnailGenerated(uint batchId, uint index, IntPtr filePath, bool success, uint width, uint height, IntPtr data, IntPtr userData)
+        {
+            ThumbnailItem? item = null;
+            lock (_batchLock)
+            {
+                // 已被新的文件夹替换的批次直接忽略
+                if (batchId != _currentBatchId || _batchItems == null || index >= _batchItems.Count)
+                {
+                    return;
+                }
+                item = _batchItems[(int)index];
+            }
+
+            if (success && data != IntPtr.Zero && width > 0 && height > 0)
+            {
+                // data 只在回调期间有效，先复制
+                byte[] pixelData = new byte[width * height * 4];
+                System.Runtime.InteropServices.Marshal.Copy(data, pixelData, 0, pixelData.Length);
+                item.SetThumbnailPixels(pixelData, width, height);
+            }
+            else
+            {
+                item.LoadThumbnailFallback();
+            }
         }
 
         /// <summary>
@@ -66,7 +136,7 @@ namespace Lightroom.App.Controls
                 ThumbnailPaths = imageFiles;
                 
                 // 创建缩略图项
-                _thumbnailItems = imageFiles.Select(path => new ThumbnailItem(path)).ToList();
+                _thumbnailItems = CreateThumbnailItems(imageFiles);
                 ThumbnailsContainer.ItemsSource = _thumbnailItems;
             }
             catch (Exception ex)
@@ -86,7 +156,7 @@ namespace Lightroom.App.Controls
             ThumbnailPaths = imagePaths;
             
             // 创建缩略图项
-            _thumbnailItems = imagePaths.Select(path => new ThumbnailItem(path)).ToList();
+            _thumbnailItems = CreateThumbnailItems(imagePaths);
             ThumbnailsContainer.ItemsSource = _thumbnailItems;
         }
 
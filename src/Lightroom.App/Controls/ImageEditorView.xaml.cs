@@ -21,11 +21,13 @@ namespace Lightroom.App.Controls
         private bool _isVideo = false;
         private bool _isPlaying = false;
         private uint[] _histogramData = new uint[256 * 4]; // R, G, B, Luminance (每个 256 bins)
+        private const uint HistogramSampleStep = 4; // 实时更新的直方图每 4 行、4 列取一个像素
         private bool _isInitializing = false;
         private bool _isResizing = false;
         private NativeMethods.VideoMetadata _videoMetadata;
         private bool _isSeeking = false; // 是否正在拖拽进度条
         private DispatcherTimer? _videoUpdateTimer = null; // 用于更新视频进度和时间
+        private NativeMethods.ProgressiveLoadDelegate? _progressiveLoadCallback = null; // 保持委托存活，防止被 GC 回收
 
         public event EventHandler<double>? ZoomChanged;
         
@@ -176,7 +178,9 @@ namespace Lightroom.App.Controls
                         }
                     }
                     
-                    success = NativeMethods.LoadImageToTarget(_renderTargetHandle, absolutePath);
+                    // RAW 先显示内嵌预览，完整质量图像由渲染定时器在下一帧自动替换
+                    _progressiveLoadCallback ??= OnProgressiveLoadCompleted;
+                    success = NativeMethods.LoadImageProgressive(_renderTargetHandle, absolutePath, _progressiveLoadCallback, IntPtr.Zero);
                     if (success)
                     {
                         _currentImagePath = absolutePath;
@@ -202,6 +206,20 @@ namespace Lightroom.App.Controls
             }
         }
 
+        // 渐进式加载完成（可能在 SDK 后台线程上调用）：完整质量图像替换预览后重新计算直方图
+        private void OnProgressiveLoadCompleted(IntPtr renderTargetHandle, bool success, IntPtr userData)
+        {
+            if (!success)
+            {
+                System.Diagnostics.Debug.WriteLine("[ImageEditorView] Full quality decode failed, keeping preview");
+                return;
+            }
+
+            Dispatcher.BeginInvoke(new Action(() => {
+                UpdateHistogram();
+            }), DispatcherPriority.Background);
+        }
+
         public ImageEditorView()
         {
             InitializeComponent();
@@ -335,10 +353,10 @@ namespace Lightroom.App.Controls
                     }
                 }
 
-                // 每 10 帧更新一次直方图（降低性能开销）
-                if (_renderCount % 10 == 0)
+                // 每 4 帧用降采样直方图更新一次（画面没有变化时 SDK 直接返回缓存结果）
+                if (_renderCount % 4 == 0)
                 {
-                    UpdateHistogram();
+                    UpdateHistogram(true);
                 }
             }
             catch (Exception ex)
@@ -563,7 +581,8 @@ namespace Lightroom.App.Controls
             }
         }
 
-        private void UpdateHistogram()
+        // sampled: 拖动滑块等实时更新时只统计 1/16 像素
+        private void UpdateHistogram(bool sampled = false)
         {
             if (HistogramCanvas == null || _renderTargetHandle == IntPtr.Zero)
                 return;
@@ -578,7 +597,9 @@ namespace Lightroom.App.Controls
             }
 
             // 从 SDK 获取直方图数据
-            bool success = NativeMethods.GetHistogramData(_renderTargetHandle, _histogramData);
+            bool success = sampled
+                ? NativeMethods.GetHistogramDataSampled(_renderTargetHandle, HistogramSampleStep, _histogramData)
+                : NativeMethods.GetHistogramData(_renderTargetHandle, _histogramData);
             if (!success)
             {
                 // 如果获取失败，清空直方图
@@ -9,14 +9,14 @@ namespace Lightroom.App.Controls
 {
     public class ThumbnailItem : INotifyPropertyChanged
     {
-        private BitmapImage? _thumbnail;
+        private BitmapSource? _thumbnail;
         private bool _isLoading = true;
         private bool _hasError = false;
         private bool _isVideo = false;
 
         public string ImagePath { get; set; }
         
-        public BitmapImage? Thumbnail
+        public BitmapSource? Thumbnail
         {
             get => _thumbnail;
             set
@@ -65,9 +65,45 @@ namespace Lightroom.App.Controls
             PropertyChanged?.Invoke(this, new PropertyChangedEventArgs(propertyName));
         }
 
-        public ThumbnailItem(string imagePath)
+        public ThumbnailItem(string imagePath, bool loadImmediately = true)
         {
             ImagePath = imagePath;
+            if (loadImmediately)
+            {
+                LoadThumbnail();
+            }
+            else
+            {
+                // 缩略图由 FilmstripView 批量生成后通过 SetThumbnailPixels 设置
+                IsVideo = NativeMethods.IsVideoFormat(ImagePath);
+            }
+        }
+
+        /// <summary>
+        /// 使用批量生成的缩略图像素（BGRA32），可在任意线程调用
+        /// </summary>
+        public void SetThumbnailPixels(byte[] pixelData, uint width, uint height)
+        {
+            try
+            {
+                var bitmap = CreateBitmapFromPixels(pixelData, width, height);
+                System.Windows.Application.Current?.Dispatcher.BeginInvoke(new Action(() =>
+                {
+                    Thumbnail = bitmap;
+                    IsLoading = false;
+                }));
+            }
+            catch
+            {
+                LoadThumbnailFallback();
+            }
+        }
+
+        /// <summary>
+        /// 批量生成失败时逐个加载（视频回退为占位图）
+        /// </summary>
+        public void LoadThumbnailFallback()
+        {
             LoadThumbnail();
         }
 
@@ -109,43 +145,15 @@ namespace Lightroom.App.Controls
                                     byte[] pixelData = new byte[dataSize];
                                     System.Runtime.InteropServices.Marshal.Copy(pixelDataPtr, pixelData, 0, dataSize);
                                     
-                                    // 创建BitmapImage
-                                    var bitmap = new BitmapImage();
-                                    bitmap.BeginInit();
+                                    // 直接由 BGRA 像素创建位图
+                                    var bitmap = CreateBitmapFromPixels(pixelData, width, height);
                                     
-                                    // 从像素数据创建BitmapSource
-                                    var stride = width * 4; // BGRA32，每像素4字节
-                                    var bitmapSource = System.Windows.Media.Imaging.BitmapSource.Create(
-                                        (int)width,
-                                        (int)height,
-                                        96, 96, // DPI
-                                        System.Windows.Media.PixelFormats.Bgra32,
-                                        null,
-                                        pixelData,
-                                        (int)stride
-                                    );
-                                    
-                                    // 将BitmapSource编码为PNG格式的MemoryStream
-                                    var encoder = new System.Windows.Media.Imaging.PngBitmapEncoder();
-                                    encoder.Frames.Add(System.Windows.Media.Imaging.BitmapFrame.Create(bitmapSource));
-                                    
-                                    using (var stream = new System.IO.MemoryStream())
+                                    // 回到UI线程更新
+                                    System.Windows.Application.Current.Dispatcher.Invoke(() =>
                                     {
-                                        encoder.Save(stream);
-                                        stream.Position = 0;
-                                        
-                                        bitmap.StreamSource = stream;
-                                        bitmap.CacheOption = BitmapCacheOption.OnLoad;
-                                        bitmap.EndInit();
-                                        bitmap.Freeze();
-                                        
-                                        // 回到UI线程更新
-                                        System.Windows.Application.Current.Dispatcher.Invoke(() =>
-                                        {
-                                            Thumbnail = bitmap;
-                                            IsLoading = false;
-                                        });
-                                    }
+                                        Thumbnail = bitmap;
+                                        IsLoading = false;
+                                    });
                                 }
                                 else
                                 {
@@ -183,13 +191,19 @@ namespace Lightroom.App.Controls
                     {
                         try
                         {
-                            var bitmap = new BitmapImage();
-                            bitmap.BeginInit();
-                            bitmap.UriSource = new Uri(ImagePath, UriKind.Absolute);
-                            bitmap.DecodePixelWidth = 200; // 限制缩略图大小以提高性能
-                            bitmap.CacheOption = BitmapCacheOption.OnLoad;
-                            bitmap.EndInit();
-                            bitmap.Freeze(); // 使图片可以在不同线程使用
+                            // 优先使用 SDK 的持久化缩略图缓存（同时支持 RAW），失败时回退到 WPF 解码
+                            BitmapSource? bitmap = LoadNativeThumbnail(200);
+                            if (bitmap == null)
+                            {
+                                var decoded = new BitmapImage();
+                                decoded.BeginInit();
+                                decoded.UriSource = new Uri(ImagePath, UriKind.Absolute);
+                                decoded.DecodePixelWidth = 200; // 限制缩略图大小以提高性能
+                                decoded.CacheOption = BitmapCacheOption.OnLoad;
+                                decoded.EndInit();
+                                decoded.Freeze(); // 使图片可以在不同线程使用
+                                bitmap = decoded;
+                            }
 
                             // 回到UI线程更新
                             System.Windows.Application.Current.Dispatcher.Invoke(() =>
@@ -216,7 +230,49 @@ namespace Lightroom.App.Controls
             }
         }
 
-        private BitmapImage CreateVideoPlaceholder()
+        private BitmapSource? LoadNativeThumbnail(uint maxDimension)
+        {
+            uint dataSize = maxDimension * maxDimension * 4; // BGRA32
+            IntPtr pixelDataPtr = System.Runtime.InteropServices.Marshal.AllocHGlobal((int)dataSize);
+            try
+            {
+                if (!NativeMethods.GetThumbnail(ImagePath, maxDimension, out uint width, out uint height, pixelDataPtr, dataSize) ||
+                    width == 0 || height == 0)
+                {
+                    return null;
+                }
+
+                byte[] pixelData = new byte[width * height * 4];
+                System.Runtime.InteropServices.Marshal.Copy(pixelDataPtr, pixelData, 0, pixelData.Length);
+                return CreateBitmapFromPixels(pixelData, width, height);
+            }
+            catch
+            {
+                return null;
+            }
+            finally
+            {
+                System.Runtime.InteropServices.Marshal.FreeHGlobal(pixelDataPtr);
+            }
+        }
+
+        // 直接使用 BGRA 像素（不经过 PNG 编码/解码），冻结后可跨线程使用
+        private static BitmapSource CreateBitmapFromPixels(byte[] pixelData, uint width, uint height)
+        {
+            var bitmap = BitmapSource.Create(
+                (int)width,
+                (int)height,
+                96, 96, // DPI
+                System.Windows.Media.PixelFormats.Bgra32,
+                null,
+                pixelData,
+                (int)(width * 4)
+            );
+            bitmap.Freeze();
+            return bitmap;
+        }
+
+        private BitmapSource CreateVideoPlaceholder()
         {
             // 创建一个简单的视频图标占位符
             // 使用 RenderTargetBitmap 创建一个带播放图标的占位符
@@ -247,22 +303,7 @@ namespace Lightroom.App.Controls
             var rtb = new System.Windows.Media.Imaging.RenderTargetBitmap(200, 200, 96, 96, System.Windows.Media.PixelFormats.Pbgra32);
             rtb.Render(drawingVisual);
             rtb.Freeze();
-
-            // 将 RenderTargetBitmap 转换为 BitmapImage
-            var encoder = new System.Windows.Media.Imaging.PngBitmapEncoder();
-            encoder.Frames.Add(System.Windows.Media.Imaging.BitmapFrame.Create(rtb));
-            using (var stream = new System.IO.MemoryStream())
-            {
-                encoder.Save(stream);
-                stream.Position = 0;
-                var bitmap = new BitmapImage();
-                bitmap.BeginInit();
-                bitmap.StreamSource = stream;
-                bitmap.CacheOption = BitmapCacheOption.OnLoad;
-                bitmap.EndInit();
-                bitmap.Freeze();
-                return bitmap;
-            }
+            return rtb;
         }
     }
 }
@@ -19,6 +19,24 @@ namespace Lightroom.App.Core
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern int GetSDKVersion();
 
+        // 纹理内存预算（字节，所有渲染目标合计，0 = 不限制）
+        [StructLayout(LayoutKind.Sequential)]
+        public struct MemoryStats
+        {
+            public ulong gpuBytes;          // GPU 纹理与渲染目标
+            public ulong systemBytes;       // 软件渲染后端的纹理（系统内存）
+            public uint textureCount;
+            public uint cacheCount;         // 参与回收的渲染目标缓存数量
+            public ulong budgetBytes;       // 预算（0 = 不限制）
+            public ulong evictions;         // 累计回收次数
+        }
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetMemoryBudget(ulong budgetBytes);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern bool GetMemoryStats(out MemoryStats outStats);
+
         // D3D11 渲染接口 - 图片编辑区渲染目标
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern IntPtr CreateRenderTarget(uint width, uint height);
@@ -32,6 +50,20 @@ namespace Lightroom.App.Core
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         public static extern bool LoadImageToTarget(IntPtr renderTargetHandle, string imagePath);
 
+        // 渐进式加载完成回调（RAW 在 SDK 后台线程上调用，其他格式在 LoadImageProgressive 返回前调用）
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        public delegate void ProgressiveLoadDelegate(IntPtr renderTargetHandle, [MarshalAs(UnmanagedType.I1)] bool success, IntPtr userData);
+
+        // 渐进式加载：RAW 先显示内嵌预览，完整质量解码完成后下一次 RenderToTarget 自动替换
+        // 调用者必须在加载完成前保持 callback 委托存活
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern bool LoadImageProgressive(IntPtr renderTargetHandle, string imagePath, ProgressiveLoadDelegate? callback, IntPtr userData);
+
+        // 高精度模式：RAW 使用 FP16 纹理与中间结果，PNG/TIFF 导出为 16-bit（对之后加载的图片生效，软件渲染不支持）
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool SetHighPrecisionMode(IntPtr renderTargetHandle, [MarshalAs(UnmanagedType.I1)] bool enable);
+
         // 渲染到目标（双缓冲+拷贝策略，内部处理，WPF端无需关心缓冲区切换）
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern bool RenderToTarget(IntPtr renderTargetHandle);
@@ -120,9 +152,15 @@ namespace Lightroom.App.Core
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern void ResetImageAdjustParams(IntPtr renderTargetHandle);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetProxyEditing(IntPtr renderTargetHandle, [MarshalAs(UnmanagedType.I1)] bool enable);
+
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern bool GetHistogramData(IntPtr renderTargetHandle, [Out] uint[] outHistogram);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern bool GetHistogramDataSampled(IntPtr renderTargetHandle, uint sampleStep, [Out] uint[] outHistogram);
+
         // 滤镜相关 API
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         public static extern bool LoadFilterLUTFromFile(IntPtr renderTargetHandle, string filePath);
@@ -133,6 +171,10 @@ namespace Lightroom.App.Core
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern void RemoveFilter(IntPtr renderTargetHandle);
 
+        // outBuffers: 每个元素指向 tileWidth * tileHeight * 4 字节的 BGRA8 缓冲区
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint RenderFilterPreviews(IntPtr renderTargetHandle, [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPStr)] string[] lutPaths, uint count, uint tileWidth, uint tileHeight, IntPtr[] outBuffers);
+
         // 视频相关 API
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         public static extern bool OpenVideo(IntPtr renderTargetHandle, string videoPath);
@@ -183,6 +225,23 @@ namespace Lightroom.App.Core
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern long GetCurrentVideoTimestamp(IntPtr renderTargetHandle);
 
+        // 视频预解码队列统计
+        [StructLayout(LayoutKind.Sequential)]
+        public struct VideoDecodeQueueStats
+        {
+            public uint queueDepth;         // 已解码、等待显示的帧数
+            public uint queueCapacity;      // 队列容量
+            public ulong framesDecoded;     // 解码线程累计输出的帧数
+            public ulong underruns;         // 取帧时队列为空、需要等待解码的次数
+        }
+
+        // 设置视频预解码队列容量（帧数，0 = 默认 6 帧）
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetVideoDecodeQueueCapacity(IntPtr renderTargetHandle, uint capacity);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern bool GetVideoDecodeQueueStats(IntPtr renderTargetHandle, out VideoDecodeQueueStats outStats);
+
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         public static extern bool IsVideoFormat(string filePath);
 
@@ -197,6 +256,34 @@ namespace Lightroom.App.Core
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         public static extern bool ExtractVideoThumbnail([MarshalAs(UnmanagedType.LPStr)] string videoPath, out uint outWidth, out uint outHeight, IntPtr outData, uint maxWidth, uint maxHeight);
 
+        // 缩略图缓存相关 API
+        // 设置缩略图缓存目录（默认 %LOCALAPPDATA%\Lightroom\ThumbnailCache）
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern bool SetThumbnailCacheDirectory([MarshalAs(UnmanagedType.LPStr)] string directory);
+
+        // 只查询磁盘缓存（不解码文件），outData 为 IntPtr.Zero 时只返回尺寸
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern bool GetCachedThumbnail([MarshalAs(UnmanagedType.LPStr)] string filePath, uint maxDimension, out uint outWidth, out uint outHeight, IntPtr outData, uint outDataSize);
+
+        // 获取缩略图（BGRA32）：先查询缓存，未命中时解码文件并写入缓存，图片和视频通用
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern bool GetThumbnail([MarshalAs(UnmanagedType.LPStr)] string filePath, uint maxDimension, out uint outWidth, out uint outHeight, IntPtr outData, uint outDataSize);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern bool ClearThumbnailCache();
+
+        // 批量生成缩略图（异步，回调在 SDK 的工作线程上调用，顺序与输入无关）
+        // data 只在回调期间有效（BGRA32，width*height*4 字节）
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        public delegate void ThumbnailBatchDelegate(uint batchId, uint index, IntPtr filePath, [MarshalAs(UnmanagedType.I1)] bool success, uint width, uint height, IntPtr data, IntPtr userData);
+
+        // 返回批次 ID（0 表示失败），调用者必须在批次完成前保持 callback 委托存活
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint GenerateThumbnailsBatch([MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPStr)] string[] filePaths, uint count, uint maxWidth, uint maxHeight, ThumbnailBatchDelegate callback, IntPtr userData);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void CancelThumbnailBatch(uint batchId);
+
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         public static extern bool ExportImage(IntPtr renderTargetHandle, [MarshalAs(UnmanagedType.LPStr)] string filePath, [MarshalAs(UnmanagedType.LPStr)] string format, uint quality);
 
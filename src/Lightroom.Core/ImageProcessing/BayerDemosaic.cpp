@@ -0,0 +1,409 @@
+﻿#include "BayerDemosaic.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace LightroomCore {
+
+namespace {
+
+// 每个行带至少处理的行数
+constexpr int32_t kMinRowsPerBand = 16;
+
+// 自动亮度直方图：与 LibRaw 相同，16-bit 值右移 3 位
+constexpr uint32_t kHistogramBins = 0x2000;
+constexpr uint32_t kHistogramShift = 3;
+
+// 自动亮度的白点：亮于白点的像素不超过 1%（LibRaw auto_bright_thr）
+constexpr double kAutoBrightThreshold = 0.01;
+
+inline uint16_t ClampToU16(float value) {
+    return static_cast<uint16_t>(std::min(std::max(value, 0.0f), 65535.0f) + 0.5f);
+}
+
+inline float Clamp65535(float value) {
+    return std::min(std::max(value, 0.0f), 65535.0f);
+}
+
+// 反射边界：-1 -> 1，n -> n - 2，保持 CFA 的奇偶性（调用者保证 n >= 3）
+inline int32_t Reflect(int32_t index, int32_t count) {
+    if (index < 0) {
+        return -index;
+    }
+    if (index >= count) {
+        return 2 * (count - 1) - index;
+    }
+    return index;
+}
+
+// 每个 CFA 位置的黑电平与增益（黑电平扣除、白电平归一化和白平衡合成一次乘法）
+struct CFAScale {
+    float Black[2][2];
+    float Gain[2][2];
+};
+
+// 可见区域扣除黑电平后的最大值
+float FindDataMaximum(const BayerDevelopParams& params) {
+    std::mutex mergeMutex;
+    float result = 0.0f;
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(params.Height), kMinRowsPerBand,
+        [&](int32_t beginRow, int32_t endRow) {
+            float localMax = 0.0f;
+            for (int32_t y = beginRow; y < endRow; ++y) {
+                const uint16_t* row = params.RawData + static_cast<size_t>(y) * params.RawPitch;
+                uint16_t max0 = 0;
+                uint16_t max1 = 0;
+                uint32_t x = 0;
+                for (; x + 1 < params.Width; x += 2) {
+                    max0 = std::max(max0, row[x]);
+                    max1 = std::max(max1, row[x + 1]);
+                }
+                if (x < params.Width) {
+                    max0 = std::max(max0, row[x]);
+                }
+                localMax = std::max(localMax, std::max(max0 - params.Black[y & 1][0], max1 - params.Black[y & 1][1]));
+            }
+
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            result = std::max(result, localMax);
+        });
+    return result;
+}
+
+CFAScale ComputeScale(const BayerDevelopParams& params) {
+    CFAScale scale;
+    float blackSum = 0.0f;
+    for (int r = 0; r < 2; ++r) {
+        for (int c = 0; c < 2; ++c) {
+            scale.Black[r][c] = params.Black[r][c];
+            blackSum += params.Black[r][c];
+        }
+    }
+
+    // 部分机型的标称白电平偏高：实际最大值接近但低于标称值时以实际值为准，避免高光发灰
+    float range = params.WhiteLevel - blackSum * 0.25f;
+    const float dataMaximum = FindDataMaximum(params);
+    if (dataMaximum > 0.0f && dataMaximum < range && dataMaximum > range * params.AdjustMaximumThreshold) {
+        range = dataMaximum;
+    }
+    range = std::max(range, 1.0f);
+
+    // 以最小的增益为 1（高光直接裁剪，与 LibRaw highlight = 0 相同）
+    float minMultiplier = std::min(params.Multipliers[0], std::min(params.Multipliers[1], params.Multipliers[2]));
+    if (minMultiplier <= 0.0f) {
+        minMultiplier = 1.0f;
+    }
+    for (int r = 0; r < 2; ++r) {
+        for (int c = 0; c < 2; ++c) {
+            const float multiplier = std::max(params.Multipliers[params.Pattern[r][c]], 0.0f);
+            scale.Gain[r][c] = multiplier / minMultiplier * 65535.0f / range;
+        }
+    }
+    return scale;
+}
+
+// 黑电平扣除 + 白平衡，结果为 0..65535 的 CFA 数据
+void ScaleCFA(const BayerDevelopParams& params, const CFAScale& scale, uint16_t* outCFA) {
+    const uint32_t width = params.Width;
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(params.Height), kMinRowsPerBand,
+        [&](int32_t beginRow, int32_t endRow) {
+            for (int32_t y = beginRow; y < endRow; ++y) {
+                const uint16_t* src = params.RawData + static_cast<size_t>(y) * params.RawPitch;
+                uint16_t* dst = outCFA + static_cast<size_t>(y) * width;
+                const float black0 = scale.Black[y & 1][0];
+                const float black1 = scale.Black[y & 1][1];
+                const float gain0 = scale.Gain[y & 1][0];
+                const float gain1 = scale.Gain[y & 1][1];
+                uint32_t x = 0;
+                for (; x + 1 < width; x += 2) {
+                    dst[x] = ClampToU16((src[x] - black0) * gain0);
+                    dst[x + 1] = ClampToU16((src[x + 1] - black1) * gain1);
+                }
+                if (x < width) {
+                    dst[x] = ClampToU16((src[x] - black0) * gain0);
+                }
+            }
+        });
+}
+
+// 一个像素的缺失颜色插值；at(dy, dx) 返回相对当前像素的 CFA 值
+// HighQuality 为 Malvar-He-Cutler 的 5x5 梯度校正核：在线性插值上加入本像素颜色的拉普拉斯项
+template <typename Fetch>
+inline void InterpolatePixel(const Fetch& at, int color, int rowColor, int columnColor,
+                             DemosaicAlgorithm algorithm, float rgb[3]) {
+    const float center = at(0, 0);
+    if (color == 1) {
+        // 绿色像素：水平邻居是 rowColor，垂直邻居是 columnColor
+        rgb[1] = center;
+        const float horizontal = at(0, -1) + at(0, 1);
+        const float vertical = at(-1, 0) + at(1, 0);
+        if (algorithm == DemosaicAlgorithm::Bilinear) {
+            rgb[rowColor] = horizontal * 0.5f;
+            rgb[columnColor] = vertical * 0.5f;
+        } else {
+            const float diagonal = at(-1, -1) + at(-1, 1) + at(1, -1) + at(1, 1);
+            const float horizontal2 = at(0, -2) + at(0, 2);
+            const float vertical2 = at(-2, 0) + at(2, 0);
+            rgb[rowColor] = (5.0f * center + 4.0f * horizontal - horizontal2 - diagonal + 0.5f * vertical2) * 0.125f;
+            rgb[columnColor] = (5.0f * center + 4.0f * vertical - vertical2 - diagonal + 0.5f * horizontal2) * 0.125f;
+        }
+    } else {
+        // 红/蓝像素：四邻域是绿色，对角是另一种颜色
+        rgb[color] = center;
+        const float cross = at(-1, 0) + at(1, 0) + at(0, -1) + at(0, 1);
+        const float diagonal = at(-1, -1) + at(-1, 1) + at(1, -1) + at(1, 1);
+        if (algorithm == DemosaicAlgorithm::Bilinear) {
+            rgb[1] = cross * 0.25f;
+            rgb[2 - color] = diagonal * 0.25f;
+        } else {
+            const float far = at(-2, 0) + at(2, 0) + at(0, -2) + at(0, 2);
+            rgb[1] = (4.0f * center + 2.0f * cross - far) * 0.125f;
+            rgb[2 - color] = (6.0f * center + 2.0f * diagonal - 1.5f * far) * 0.125f;
+        }
+    }
+}
+
+// 相机色彩 -> 线性 sRGB，写入 16-bit 线性结果并统计自动亮度直方图
+inline void StoreLinear(const float rgb[3], const float matrix[3][3], uint16_t* out, uint32_t* histogram) {
+    const float r = Clamp65535(rgb[0]);
+    const float g = Clamp65535(rgb[1]);
+    const float b = Clamp65535(rgb[2]);
+    for (int c = 0; c < 3; ++c) {
+        const uint16_t value = ClampToU16(matrix[c][0] * r + matrix[c][1] * g + matrix[c][2] * b);
+        out[c] = value;
+        ++histogram[c * kHistogramBins + (value >> kHistogramShift)];
+    }
+}
+
+// 完整分辨率去马赛克：每个行带直接读取上下两行的 CFA 数据，行带之间没有依赖
+void DemosaicRows(const BayerDevelopParams& params, const uint16_t* cfa, int32_t beginRow, int32_t endRow,
+                  uint16_t* outLinear, uint32_t* histogram) {
+    const int32_t width = static_cast<int32_t>(params.Width);
+    const int32_t height = static_cast<int32_t>(params.Height);
+    const DemosaicAlgorithm algorithm = params.Algorithm;
+    float rgb[3];
+
+    for (int32_t y = beginRow; y < endRow; ++y) {
+        const int colors[2] = { params.Pattern[y & 1][0], params.Pattern[y & 1][1] };
+        const int columnColors[2] = { params.Pattern[(y + 1) & 1][0], params.Pattern[(y + 1) & 1][1] };
+        uint16_t* out = outLinear + static_cast<size_t>(y) * width * 3;
+
+        // 边缘像素：坐标反射
+        auto edgePixel = [&](int32_t x) {
+            auto at = [&](int32_t dy, int32_t dx) {
+                return static_cast<float>(cfa[static_cast<size_t>(Reflect(y + dy, height)) * width + Reflect(x + dx, width)]);
+            };
+            InterpolatePixel(at, colors[x & 1], colors[(x + 1) & 1], columnColors[x & 1], algorithm, rgb);
+            StoreLinear(rgb, params.CameraToRGB, out + static_cast<size_t>(x) * 3, histogram);
+        };
+
+        if (y < 2 || y >= height - 2) {
+            for (int32_t x = 0; x < width; ++x) {
+                edgePixel(x);
+            }
+            continue;
+        }
+
+        const uint16_t* rows[5];
+        for (int32_t i = 0; i < 5; ++i) {
+            rows[i] = cfa + static_cast<size_t>(y - 2 + i) * width;
+        }
+
+        edgePixel(0);
+        edgePixel(1);
+        for (int32_t x = 2; x < width - 2; ++x) {
+            auto at = [&](int32_t dy, int32_t dx) {
+                return static_cast<float>(rows[dy + 2][x + dx]);
+            };
+            InterpolatePixel(at, colors[x & 1], colors[(x + 1) & 1], columnColors[x & 1], algorithm, rgb);
+            StoreLinear(rgb, params.CameraToRGB, out + static_cast<size_t>(x) * 3, histogram);
+        }
+        edgePixel(width - 2);
+        edgePixel(width - 1);
+    }
+}
+
+// 半尺寸：每个 2x2 单元合成一个像素（两个绿色取平均），不需要插值
+void BinRows(const BayerDevelopParams& params, const CFAScale& scale, int32_t beginRow, int32_t endRow,
+             uint32_t outWidth, uint16_t* outLinear, uint32_t* histogram) {
+    for (int32_t y = beginRow; y < endRow; ++y) {
+        const uint16_t* rows[2] = {
+            params.RawData + static_cast<size_t>(y) * 2 * params.RawPitch,
+            params.RawData + (static_cast<size_t>(y) * 2 + 1) * params.RawPitch
+        };
+        uint16_t* out = outLinear + static_cast<size_t>(y) * outWidth * 3;
+        for (uint32_t x = 0; x < outWidth; ++x) {
+            float sums[3] = { 0.0f, 0.0f, 0.0f };
+            float counts[3] = { 0.0f, 0.0f, 0.0f };
+            for (int r = 0; r < 2; ++r) {
+                for (int c = 0; c < 2; ++c) {
+                    const int color = params.Pattern[r][c];
+                    sums[color] += Clamp65535((rows[r][x * 2 + c] - scale.Black[r][c]) * scale.Gain[r][c]);
+                    counts[color] += 1.0f;
+                }
+            }
+            float rgb[3];
+            for (int c = 0; c < 3; ++c) {
+                rgb[c] = counts[c] > 0.0f ? sums[c] / counts[c] : 0.0f;
+            }
+            StoreLinear(rgb, params.CameraToRGB, out + static_cast<size_t>(x) * 3, histogram);
+        }
+    }
+}
+
+// LibRaw gamma_curve(pwr, ts, mode = 2, imax) 的移植：线性值 [0, imax) 映射到 gamma 校正后的 [0, 65535]
+void BuildGammaCurve(double power, double toeSlope, int whitePoint, std::vector<uint16_t>& outCurve) {
+    double g[5] = { power, toeSlope, 0.0, 0.0, 0.0 };
+    double bounds[2] = { 0.0, 0.0 };
+    bounds[g[1] >= 1] = 1.0;
+    if (g[1] != 0.0 && (g[1] - 1) * (g[0] - 1) <= 0) {
+        // 二分求解线性段与幂函数段相切的位置
+        for (int i = 0; i < 48; ++i) {
+            g[2] = (bounds[0] + bounds[1]) / 2;
+            if (g[0] != 0.0) {
+                bounds[(std::pow(g[2] / g[1], -g[0]) - 1) / g[0] - 1 / g[2] > -1] = g[2];
+            } else {
+                bounds[g[2] / std::exp(1 - 1 / g[2]) < g[1]] = g[2];
+            }
+        }
+        g[3] = g[2] / g[1];
+        if (g[0] != 0.0) {
+            g[4] = g[2] * (1 / g[0] - 1);
+        }
+    }
+
+    whitePoint = std::max(whitePoint, 1);
+    outCurve.resize(0x10000);
+    for (int i = 0; i < 0x10000; ++i) {
+        const double r = static_cast<double>(i) / whitePoint;
+        double value = 1.0;
+        if (r < 1) {
+            value = r < g[3] ? r * g[1]
+                             : (g[0] != 0.0 ? std::pow(r, g[0]) * (1 + g[4]) - g[4] : std::log(r) * g[2] + 1);
+        }
+        outCurve[i] = static_cast<uint16_t>(std::min(std::max(value * 0x10000, 0.0), 65535.0));
+    }
+}
+
+// 按直方图求自动亮度的白点（线性 16-bit 值）
+int FindWhitePoint(const std::vector<uint32_t>& histogram, size_t pixelCount, bool autoBright) {
+    uint32_t white = kHistogramBins;
+    if (autoBright) {
+        const uint64_t threshold = static_cast<uint64_t>(pixelCount * kAutoBrightThreshold);
+        white = 0;
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t* channel = histogram.data() + c * kHistogramBins;
+            uint64_t total = 0;
+            uint32_t value = kHistogramBins;
+            while (--value > 32) {
+                total += channel[value];
+                if (total > threshold) {
+                    break;
+                }
+            }
+            white = std::max(white, value);
+        }
+    }
+    return static_cast<int>(white << kHistogramShift);
+}
+
+template <typename T, int Shift>
+void ApplyCurveAndFlip(const uint16_t* linear, uint32_t width, uint32_t height, int flip,
+                       const std::vector<uint16_t>& curve, T* out, uint32_t outWidth, uint32_t outHeight) {
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(outHeight), kMinRowsPerBand,
+        [&](int32_t beginRow, int32_t endRow) {
+            for (int32_t row = beginRow; row < endRow; ++row) {
+                T* dst = out + static_cast<size_t>(row) * outWidth * 3;
+                for (uint32_t col = 0; col < outWidth; ++col) {
+                    // 与 LibRaw flip_index 相同：输出坐标 -> 源坐标
+                    uint32_t srcRow = static_cast<uint32_t>(row);
+                    uint32_t srcCol = col;
+                    if (flip & 4) {
+                        std::swap(srcRow, srcCol);
+                    }
+                    if (flip & 2) {
+                        srcRow = height - 1 - srcRow;
+                    }
+                    if (flip & 1) {
+                        srcCol = width - 1 - srcCol;
+                    }
+                    const uint16_t* src = linear + (static_cast<size_t>(srcRow) * width + srcCol) * 3;
+                    dst[col * 3 + 0] = static_cast<T>(curve[src[0]] >> Shift);
+                    dst[col * 3 + 1] = static_cast<T>(curve[src[1]] >> Shift);
+                    dst[col * 3 + 2] = static_cast<T>(curve[src[2]] >> Shift);
+                }
+            }
+        });
+}
+
+} // namespace
+
+bool BayerDemosaic::Develop(const BayerDevelopParams& params, uint32_t outputBits,
+                            std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    if (!params.RawData || params.Width < 4 || params.Height < 4 || params.RawPitch < params.Width ||
+        (outputBits != 8 && outputBits != 16)) {
+        return false;
+    }
+    for (int r = 0; r < 2; ++r) {
+        for (int c = 0; c < 2; ++c) {
+            if (params.Pattern[r][c] > 2) {
+                return false;
+            }
+        }
+    }
+
+    const CFAScale scale = ComputeScale(params);
+    const uint32_t width = params.HalfSize ? params.Width / 2 : params.Width;
+    const uint32_t height = params.HalfSize ? params.Height / 2 : params.Height;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+
+    // 1. 去马赛克 + 色彩矩阵 -> 16-bit 线性 RGB，同时统计直方图（每个行带私有，最后合并）
+    std::vector<uint16_t> linear(pixelCount * 3);
+    std::vector<uint32_t> histogram(kHistogramBins * 3, 0);
+    std::mutex mergeMutex;
+    {
+        std::vector<uint16_t> cfa;
+        if (!params.HalfSize) {
+            cfa.resize(static_cast<size_t>(params.Width) * params.Height);
+            ScaleCFA(params, scale, cfa.data());
+        }
+
+        RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(height), kMinRowsPerBand,
+            [&](int32_t beginRow, int32_t endRow) {
+                std::vector<uint32_t> local(kHistogramBins * 3, 0);
+                if (params.HalfSize) {
+                    BinRows(params, scale, beginRow, endRow, width, linear.data(), local.data());
+                } else {
+                    DemosaicRows(params, cfa.data(), beginRow, endRow, linear.data(), local.data());
+                }
+
+                std::lock_guard<std::mutex> lock(mergeMutex);
+                for (size_t i = 0; i < local.size(); ++i) {
+                    histogram[i] += local[i];
+                }
+            });
+    }
+
+    // 2. 自动亮度 + gamma 曲线（查找表），按 flip 旋转写入输出
+    std::vector<uint16_t> curve;
+    BuildGammaCurve(params.Gamma[0], params.Gamma[1],
+                    static_cast<int>(FindWhitePoint(histogram, pixelCount, params.AutoBright) / std::max(params.Bright, 0.01f)),
+                    curve);
+
+    const bool swapAxes = (params.Flip & 4) != 0;
+    outWidth = swapAxes ? height : width;
+    outHeight = swapAxes ? width : height;
+    outData.resize(pixelCount * 3 * (outputBits / 8));
+    if (outputBits == 16) {
+        ApplyCurveAndFlip<uint16_t, 0>(linear.data(), width, height, params.Flip, curve,
+                                       reinterpret_cast<uint16_t*>(outData.data()), outWidth, outHeight);
+    } else {
+        ApplyCurveAndFlip<uint8_t, 8>(linear.data(), width, height, params.Flip, curve,
+                                      outData.data(), outWidth, outHeight);
+    }
+    return true;
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace LightroomCore {
+
+// 去马赛克算法
+enum class DemosaicAlgorithm {
+    Bilinear,       // 双线性插值：最快，用于缩略图等会再缩小的场合
+    HighQuality     // 梯度校正线性插值（Malvar-He-Cutler）：边缘处的色彩伪影明显少于双线性，用于完整质量解码
+};
+
+// Bayer 传感器数据的显影参数（LibRawWrapper 从 LibRaw 解包后的元数据填充）
+struct BayerDevelopParams {
+    const uint16_t* RawData = nullptr;      // 可见区域左上角
+    size_t RawPitch = 0;                    // 行跨度（像素）
+    uint32_t Width = 0;                     // 可见区域尺寸
+    uint32_t Height = 0;
+    uint8_t Pattern[2][2] = {};             // [row & 1][col & 1] 位置的颜色：0=R，1=G，2=B
+    float Black[2][2] = {};                 // 每个 CFA 位置的黑电平
+    float WhiteLevel = 65535.0f;            // 饱和值（含黑电平）
+    float AdjustMaximumThreshold = 0.75f;   // 实际最大值高于 WhiteLevel 的这一比例时用作白电平（LibRaw adjust_maximum_thr）
+    float Multipliers[3] = { 1.0f, 1.0f, 1.0f };  // 白平衡增益（R, G, B）
+    float CameraToRGB[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };  // 相机色彩 -> 线性 sRGB
+    double Gamma[2] = { 1.0 / 2.222, 4.5 }; // gamma 幂次与线性段斜率（LibRaw gamm[0] / gamm[1]）
+    float Bright = 1.0f;
+    bool AutoBright = true;                 // 以 99% 分位的亮度作为白点（LibRaw no_auto_bright = 0）
+    int Flip = 0;                           // LibRaw sizes.flip
+    bool HalfSize = false;                  // 每个 2x2 单元直接合成一个像素，不插值
+    DemosaicAlgorithm Algorithm = DemosaicAlgorithm::HighQuality;
+};
+
+// Bayer RAW 显影：黑电平/白平衡 -> 去马赛克 -> 相机色彩矩阵 -> 自动亮度 + gamma 曲线 -> 旋转
+// 处理顺序与 LibRaw 的 dcraw_process + dcraw_make_mem_image 相同，但每个阶段都按行带分配到
+// SoftwareTaskPool 的所有线程（LibRaw 的 dcraw_process 是单线程的），耗时随核心数缩放。
+// 多个文件同时显影时共享同一个线程池，不会超额订阅。
+class BayerDemosaic {
+public:
+    // outputBits 为 8 或 16；输出为紧密排列的 RGB（16-bit 时按 uint16_t 排列）
+    static bool Develop(const BayerDevelopParams& params, uint32_t outputBits,
+                        std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight);
+};
+
+} // namespace LightroomCore
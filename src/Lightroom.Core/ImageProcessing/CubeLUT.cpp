@@ -0,0 +1,413 @@
+﻿// 防止 Winsock 冲突 - 必须在包含任何 Windows 头文件之前
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+
+#include "CubeLUT.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace LightroomCore {
+
+namespace {
+
+// ============================================
+// .cube 文本解析
+// ============================================
+
+constexpr uint32_t kMinLUTSize = 2;
+constexpr uint32_t kMaxLUTSize = 256;
+
+inline const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+// 关键字后必须是空白或行尾，避免 LUT_3D_SIZE 与 LUT_3D_SIZEX 之类的前缀误匹配
+inline bool MatchKeyword(const char*& p, const char* end, const char* keyword) {
+    const size_t length = strlen(keyword);
+    if (static_cast<size_t>(end - p) < length || memcmp(p, keyword, length) != 0) {
+        return false;
+    }
+    const char* after = p + length;
+    if (after < end && *after != ' ' && *after != '\t' && *after != '\r') {
+        return false;
+    }
+    p = after;
+    return true;
+}
+
+inline bool ParseFloat(const char*& p, const char* end, float& outValue) {
+    p = SkipSpaces(p, end);
+    if (p < end && *p == '+') {
+        ++p;  // from_chars 不接受前导 '+'
+    }
+    const auto result = std::from_chars(p, end, outValue);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+inline bool ParseUInt(const char*& p, const char* end, uint32_t& outValue) {
+    p = SkipSpaces(p, end);
+    const auto result = std::from_chars(p, end, outValue);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+// ============================================
+// 二进制缓存文件
+// ============================================
+
+constexpr uint32_t kCacheMagic = 0x4C425543;    // 'CUBL'
+constexpr uint32_t kCacheVersion = 1;
+constexpr wchar_t kCacheExtension[] = L".lut3d";
+
+// 缓存文件：文件头 + 源文件路径（UTF-16，无结尾 0，用于排除哈希冲突）+ Size^3 * 3 个 float
+struct CacheFileHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t Size;
+    uint32_t PathLength;        // 字符数
+    uint64_t FileSize;
+    uint64_t LastWriteTime;     // FILETIME
+};
+
+static_assert(sizeof(CacheFileHeader) == 32, "CacheFileHeader layout changed");
+
+// 只读内存映射的文件
+class MappedFile {
+public:
+    ~MappedFile() {
+        if (m_View) {
+            UnmapViewOfFile(m_View);
+        }
+        if (m_Mapping) {
+            CloseHandle(m_Mapping);
+        }
+        if (m_File != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_File);
+        }
+    }
+
+    bool Open(const std::wstring& path) {
+        m_File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_File == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_File, &size) || size.QuadPart <= 0) {
+            return false;
+        }
+        m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_Mapping) {
+            return false;
+        }
+        m_View = MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!m_View) {
+            return false;
+        }
+        m_Size = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    const char* GetData() const { return static_cast<const char*>(m_View); }
+    size_t GetSize() const { return m_Size; }
+
+private:
+    HANDLE m_File = INVALID_HANDLE_VALUE;
+    HANDLE m_Mapping = nullptr;
+    void* m_View = nullptr;
+    size_t m_Size = 0;
+};
+
+uint64_t HashCacheKey(const std::wstring& filePath, uint64_t fileSize, uint64_t lastWriteTime) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(filePath.data(), filePath.size() * sizeof(wchar_t));
+    mix(&fileSize, sizeof(fileSize));
+    mix(&lastWriteTime, sizeof(lastWriteTime));
+    return hash;
+}
+
+bool ReadCacheFile(const std::wstring& cachePath, const std::wstring& filePath,
+                   uint64_t fileSize, uint64_t lastWriteTime, CubeLUT& outLUT) {
+    MappedFile cacheFile;
+    if (!cacheFile.Open(cachePath) || cacheFile.GetSize() < sizeof(CacheFileHeader)) {
+        return false;
+    }
+
+    CacheFileHeader header;
+    memcpy(&header, cacheFile.GetData(), sizeof(header));
+    if (header.Magic != kCacheMagic || header.Version != kCacheVersion ||
+        header.Size < kMinLUTSize || header.Size > kMaxLUTSize ||
+        header.FileSize != fileSize || header.LastWriteTime != lastWriteTime ||
+        header.PathLength != filePath.size()) {
+        return false;
+    }
+
+    const size_t pathBytes = filePath.size() * sizeof(wchar_t);
+    const size_t valueCount = static_cast<size_t>(header.Size) * header.Size * header.Size * 3;
+    if (cacheFile.GetSize() != sizeof(header) + pathBytes + valueCount * sizeof(float)) {
+        return false;
+    }
+    const char* path = cacheFile.GetData() + sizeof(header);
+    if (memcmp(path, filePath.data(), pathBytes) != 0) {
+        return false;
+    }
+
+    outLUT.Size = header.Size;
+    outLUT.Data.resize(valueCount);
+    memcpy(outLUT.Data.data(), path + pathBytes, valueCount * sizeof(float));
+    return true;
+}
+
+bool WriteAll(HANDLE file, const void* data, size_t size) {
+    DWORD written = 0;
+    return WriteFile(file, data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+}
+
+// 先写临时文件再替换，其他线程/进程不会读到写了一半的缓存
+bool WriteCacheFile(const std::wstring& cachePath, const std::wstring& filePath,
+                    uint64_t fileSize, uint64_t lastWriteTime, const CubeLUT& lut) {
+    const std::wstring tempPath = cachePath + L"." + std::to_wstring(GetCurrentProcessId()) +
+                                  L"_" + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+    HANDLE file = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    CacheFileHeader header = {};
+    header.Magic = kCacheMagic;
+    header.Version = kCacheVersion;
+    header.Size = lut.Size;
+    header.PathLength = static_cast<uint32_t>(filePath.size());
+    header.FileSize = fileSize;
+    header.LastWriteTime = lastWriteTime;
+
+    const bool written = WriteAll(file, &header, sizeof(header)) &&
+                         WriteAll(file, filePath.data(), filePath.size() * sizeof(wchar_t)) &&
+                         WriteAll(file, lut.Data.data(), lut.Data.size() * sizeof(float));
+    CloseHandle(file);
+
+    if (!written || !MoveFileExW(tempPath.c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileW(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::wstring GetDefaultCacheDirectory() {
+    wchar_t buffer[MAX_PATH];
+    DWORD length = GetEnvironmentVariableW(L"LOCALAPPDATA", buffer, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH) {
+        length = GetTempPathW(MAX_PATH, buffer);
+        if (length == 0 || length >= MAX_PATH) {
+            return std::wstring();
+        }
+    }
+    std::wstring directory(buffer, length);
+    if (directory.back() != L'\\') {
+        directory += L'\\';
+    }
+    return directory + L"Lightroom\\LUTCache";
+}
+
+// 逐级创建目录
+bool EnsureDirectory(const std::wstring& directory) {
+    for (size_t separator = directory.find(L'\\', 3); ; separator = directory.find(L'\\', separator + 1)) {
+        const std::wstring partial = directory.substr(0, separator);
+        if (!CreateDirectoryW(partial.c_str(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS) {
+            return false;
+        }
+        if (separator == std::wstring::npos) {
+            return true;
+        }
+    }
+}
+
+} // namespace
+
+bool ParseCubeLUT(const char* text, size_t length, CubeLUT& outLUT) {
+    outLUT.Size = 0;
+    outLUT.Data.clear();
+    if (!text) {
+        return false;
+    }
+
+    const char* p = text;
+    const char* end = text + length;
+    if (length >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+        p += 3;
+    }
+
+    float domainMin[3] = { 0.0f, 0.0f, 0.0f };
+    float domainMax[3] = { 1.0f, 1.0f, 1.0f };
+    bool foundDomain = false;
+    size_t expectedValues = 0;
+    size_t parsedValues = 0;
+
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        const char* next = (lineEnd < end) ? lineEnd + 1 : end;
+        const char* q = SkipSpaces(p, lineEnd);
+        p = next;
+        if (q == lineEnd || *q == '#') {
+            continue;
+        }
+
+        // 数据行（最常见，放在最前面）
+        const char first = *q;
+        if ((first >= '0' && first <= '9') || first == '-' || first == '+' || first == '.') {
+            if (expectedValues == 0 || parsedValues + 3 > expectedValues) {
+                std::cerr << "[CubeLUT] Unexpected data line" << std::endl;
+                return false;
+            }
+            float* values = outLUT.Data.data() + parsedValues;
+            if (!ParseFloat(q, lineEnd, values[0]) || !ParseFloat(q, lineEnd, values[1]) ||
+                !ParseFloat(q, lineEnd, values[2])) {
+                std::cerr << "[CubeLUT] Malformed data line" << std::endl;
+                return false;
+            }
+            parsedValues += 3;
+            continue;
+        }
+
+        if (MatchKeyword(q, lineEnd, "LUT_3D_SIZE")) {
+            uint32_t size = 0;
+            if (expectedValues != 0 || !ParseUInt(q, lineEnd, size) || size < kMinLUTSize || size > kMaxLUTSize) {
+                std::cerr << "[CubeLUT] Invalid LUT_3D_SIZE" << std::endl;
+                return false;
+            }
+            outLUT.Size = size;
+            expectedValues = static_cast<size_t>(size) * size * size * 3;
+            outLUT.Data.resize(expectedValues);
+        } else if (MatchKeyword(q, lineEnd, "DOMAIN_MIN")) {
+            if (!ParseFloat(q, lineEnd, domainMin[0]) || !ParseFloat(q, lineEnd, domainMin[1]) ||
+                !ParseFloat(q, lineEnd, domainMin[2])) {
+                return false;
+            }
+            foundDomain = true;
+        } else if (MatchKeyword(q, lineEnd, "DOMAIN_MAX")) {
+            if (!ParseFloat(q, lineEnd, domainMax[0]) || !ParseFloat(q, lineEnd, domainMax[1]) ||
+                !ParseFloat(q, lineEnd, domainMax[2])) {
+                return false;
+            }
+            foundDomain = true;
+        } else if (MatchKeyword(q, lineEnd, "LUT_3D_INPUT_RANGE")) {
+            // Resolve 的写法：所有通道共用一个范围
+            float rangeMin = 0.0f;
+            float rangeMax = 1.0f;
+            if (!ParseFloat(q, lineEnd, rangeMin) || !ParseFloat(q, lineEnd, rangeMax)) {
+                return false;
+            }
+            std::fill(domainMin, domainMin + 3, rangeMin);
+            std::fill(domainMax, domainMax + 3, rangeMax);
+            foundDomain = true;
+        } else if (MatchKeyword(q, lineEnd, "LUT_1D_SIZE")) {
+            std::cerr << "[CubeLUT] 1D LUTs are not supported" << std::endl;
+            return false;
+        }
+        // 其他关键字（TITLE 等）忽略
+    }
+
+    if (expectedValues == 0 || parsedValues != expectedValues) {
+        std::cerr << "[CubeLUT] Expected " << expectedValues / 3 << " entries, got " << parsedValues / 3 << std::endl;
+        outLUT.Size = 0;
+        outLUT.Data.clear();
+        return false;
+    }
+
+    // 处理 Domain 映射（归一化到 [0, 1]）
+    if (foundDomain) {
+        for (size_t i = 0; i < outLUT.Data.size(); i += 3) {
+            for (int c = 0; c < 3; ++c) {
+                const float range = domainMax[c] - domainMin[c];
+                float value = outLUT.Data[i + c];
+                if (std::abs(range) > 1e-6f) {
+                    value = (value - domainMin[c]) / range;
+                }
+                outLUT.Data[i + c] = std::clamp(value, 0.0f, 1.0f);
+            }
+        }
+    }
+    return true;
+}
+
+CubeLUTCache& CubeLUTCache::Get() {
+    static CubeLUTCache cache;
+    return cache;
+}
+
+CubeLUTCache::CubeLUTCache() {
+    std::wstring directory = GetDefaultCacheDirectory();
+    if (!directory.empty() && EnsureDirectory(directory)) {
+        m_Directory = directory;
+    } else {
+        std::cerr << "[CubeLUT] LUT cache unavailable" << std::endl;
+    }
+}
+
+std::wstring CubeLUTCache::GetCacheFilePath(const std::wstring& filePath, uint64_t fileSize, uint64_t lastWriteTime) const {
+    if (m_Directory.empty()) {
+        return std::wstring();
+    }
+    wchar_t name[17];
+    swprintf(name, 17, L"%016llx", static_cast<unsigned long long>(HashCacheKey(filePath, fileSize, lastWriteTime)));
+    return m_Directory + L"\\" + name + kCacheExtension;
+}
+
+bool CubeLUTCache::Load(const std::wstring& filePath, CubeLUT& outLUT) {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(filePath.c_str(), GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+    const uint64_t fileSize = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    const uint64_t lastWriteTime = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+                                   attributes.ftLastWriteTime.dwLowDateTime;
+
+    const std::wstring cachePath = GetCacheFilePath(filePath, fileSize, lastWriteTime);
+    if (!cachePath.empty() && ReadCacheFile(cachePath, filePath, fileSize, lastWriteTime, outLUT)) {
+        return true;
+    }
+
+    MappedFile sourceFile;
+    if (!sourceFile.Open(filePath) || !ParseCubeLUT(sourceFile.GetData(), sourceFile.GetSize(), outLUT)) {
+        return false;
+    }
+
+    if (!cachePath.empty() && !WriteCacheFile(cachePath, filePath, fileSize, lastWriteTime, outLUT)) {
+        std::cerr << "[CubeLUT] Failed to write LUT cache file" << std::endl;
+    }
+    return true;
+}
+
+} // namespace LightroomCore
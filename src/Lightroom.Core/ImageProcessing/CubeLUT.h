@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace LightroomCore {
+
+// 解析后的 3D LUT
+// Data 为 RGB float，大小为 Size^3 * 3，顺序与 .cube 文件一致（Red 变化最快，然后 Green，最后 Blue）
+struct CubeLUT {
+    uint32_t Size = 0;
+    std::vector<float> Data;
+};
+
+// 解析 .cube 文本（逐字符扫描 + std::from_chars，除输出数组外不分配内存）
+// 支持 TITLE、LUT_3D_SIZE、DOMAIN_MIN/DOMAIN_MAX、LUT_3D_INPUT_RANGE；不支持 1D LUT
+bool ParseCubeLUT(const char* text, size_t length, CubeLUT& outLUT);
+
+// .cube 文件的二进制缓存
+// 每个 LUT 解析后写入缓存目录下的一个二进制文件（文件头 + float 数组），文件名为
+// (路径, 文件大小, 修改时间) 的哈希；再次加载同一文件时只需内存映射缓存文件并复制一次数组，
+// 不再解析文本。源文件被修改后大小/时间变化，旧缓存自然失效。
+class CubeLUTCache {
+public:
+    // 进程内共享的缓存，首次使用时在默认目录（%LOCALAPPDATA%\Lightroom\LUTCache）创建
+    static CubeLUTCache& Get();
+
+    // 加载 .cube 文件：先查缓存，未命中时解析文本并写入缓存
+    bool Load(const std::wstring& filePath, CubeLUT& outLUT);
+
+private:
+    CubeLUTCache();
+
+    std::wstring GetCacheFilePath(const std::wstring& filePath, uint64_t fileSize, uint64_t lastWriteTime) const;
+
+    std::wstring m_Directory;   // 为空表示缓存不可用（只解析不缓存）
+};
+
+} // namespace LightroomCore
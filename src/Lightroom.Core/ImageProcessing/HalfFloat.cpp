@@ -0,0 +1,183 @@
+﻿#include "HalfFloat.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <intrin.h>
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+
+namespace LightroomCore {
+
+namespace {
+
+// 每个并行任务处理的像素数
+constexpr size_t kPixelsPerTask = 64 * 1024;
+// 任务内部的中间 float 缓冲区（栈上，RGBA 共 1024 个 float）
+constexpr size_t kPixelsPerBlock = 256;
+
+bool DetectF16C() {
+    int info[4] = { 0, 0, 0, 0 };
+    __cpuid(info, 0);
+    if (info[0] < 1) {
+        return false;
+    }
+
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    const bool f16c = (info[2] & (1 << 29)) != 0;
+
+    // F16C 使用 YMM 寄存器，需要操作系统保存 AVX 状态
+    return osxsave && avx && f16c && (_xgetbv(0) & 0x6) == 0x6;
+}
+
+void FloatToHalfF16C(const float* source, uint16_t* destination, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 values = _mm256_loadu_ps(source + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+    }
+    _mm256_zeroupper();
+    for (; i < count; ++i) {
+        destination[i] = FloatToHalf(source[i]);
+    }
+}
+
+void HalfToFloatF16C(const uint16_t* source, float* destination, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(values));
+    }
+    _mm256_zeroupper();
+    for (; i < count; ++i) {
+        destination[i] = HalfToFloat(source[i]);
+    }
+}
+
+// 大图按块并行，小图直接在调用线程上执行
+template <typename Func>
+void ParallelForPixels(size_t pixelCount, const Func& func) {
+    if (pixelCount <= kPixelsPerTask) {
+        func(0, pixelCount);
+        return;
+    }
+    const uint32_t taskCount = static_cast<uint32_t>((pixelCount + kPixelsPerTask - 1) / kPixelsPerTask);
+    RenderCore::SoftwareTaskPool::Get().ParallelFor(taskCount, [&](uint32_t task) {
+        const size_t begin = static_cast<size_t>(task) * kPixelsPerTask;
+        func(begin, std::min(begin + kPixelsPerTask, pixelCount));
+    });
+}
+
+} // namespace
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    // 超出半精度范围（含 Inf）：Inf；NaN 保持为 NaN
+    if (magnitude >= 0x47800000) {
+        return sign | (magnitude > 0x7F800000 ? 0x7E00 : 0x7C00);
+    }
+
+    // 小于半精度最小正规数：借助 float 加法完成舍入，结果落在尾数低位
+    if (magnitude < 0x38800000) {
+        float scaled;
+        memcpy(&scaled, &magnitude, sizeof(scaled));
+        scaled += 0.5f;
+        uint32_t scaledBits;
+        memcpy(&scaledBits, &scaled, sizeof(scaledBits));
+        return sign | static_cast<uint16_t>(scaledBits - 0x3F000000);
+    }
+
+    // 正规数：指数重新偏置（-112），尾数按最近偶数舍入
+    const uint32_t mantissaOdd = (magnitude >> 13) & 1;
+    magnitude += 0xC8000FFF + mantissaOdd;
+    return sign | static_cast<uint16_t>(magnitude >> 13);
+}
+
+float HalfToFloat(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1F;
+    const uint32_t mantissa = value & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // 非正规数：mantissa * 2^-24
+        const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        memcpy(&bits, &magnitude, sizeof(bits));
+        bits |= sign;
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+bool IsF16CSupported() {
+    static const bool s_Supported = DetectF16C();
+    return s_Supported;
+}
+
+void FloatToHalfArray(const float* source, uint16_t* destination, size_t count) {
+    if (IsF16CSupported()) {
+        FloatToHalfF16C(source, destination, count);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        destination[i] = FloatToHalf(source[i]);
+    }
+}
+
+void HalfToFloatArray(const uint16_t* source, float* destination, size_t count) {
+    if (IsF16CSupported()) {
+        HalfToFloatF16C(source, destination, count);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        destination[i] = HalfToFloat(source[i]);
+    }
+}
+
+void ConvertRGB16ToRGBAHalf(const uint16_t* source, uint16_t* destination, size_t pixelCount) {
+    ParallelForPixels(pixelCount, [source, destination](size_t begin, size_t end) {
+        constexpr float kScale = 1.0f / 65535.0f;
+        float block[kPixelsPerBlock * 4];
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += kPixelsPerBlock) {
+            const size_t blockPixels = std::min(kPixelsPerBlock, end - blockBegin);
+            const uint16_t* src = source + blockBegin * 3;
+            for (size_t i = 0; i < blockPixels; ++i) {
+                block[i * 4 + 0] = src[i * 3 + 0] * kScale;
+                block[i * 4 + 1] = src[i * 3 + 1] * kScale;
+                block[i * 4 + 2] = src[i * 3 + 2] * kScale;
+                block[i * 4 + 3] = 1.0f;
+            }
+            FloatToHalfArray(block, destination + blockBegin * 4, blockPixels * 4);
+        }
+    });
+}
+
+void ConvertRGBAHalfToRGBA16(const uint16_t* source, uint16_t* destination, size_t pixelCount) {
+    ParallelForPixels(pixelCount, [source, destination](size_t begin, size_t end) {
+        float block[kPixelsPerBlock * 4];
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += kPixelsPerBlock) {
+            const size_t blockValues = std::min(kPixelsPerBlock, end - blockBegin) * 4;
+            HalfToFloatArray(source + blockBegin * 4, block, blockValues);
+            uint16_t* dst = destination + blockBegin * 4;
+            for (size_t i = 0; i < blockValues; ++i) {
+                // NaN 与负数都变为 0
+                const float value = block[i] > 0.0f ? std::min(block[i], 1.0f) : 0.0f;
+                dst[i] = static_cast<uint16_t>(value * 65535.0f + 0.5f);
+            }
+        }
+    });
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace LightroomCore {
+
+// 半精度浮点（IEEE 754 binary16）转换
+// 高精度管线的像素以 RGBA FP16 存放（与 PF_FloatRGBA / R16G16B16A16_FLOAT 纹理一致），
+// 相比 RGBA32F 内存带宽减半，而精度远高于 8-bit。
+// 批量转换在支持 F16C 的 CPU 上每次处理 8 个值，否则使用标量路径；整幅图像按块分发到 SoftwareTaskPool。
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+// 当前 CPU 是否支持 F16C（首次调用时检测 CPUID）
+bool IsF16CSupported();
+
+// 批量转换 count 个值
+void FloatToHalfArray(const float* source, uint16_t* destination, size_t count);
+void HalfToFloatArray(const uint16_t* source, float* destination, size_t count);
+
+// 16-bit RGB（LibRaw 输出，紧密排列）-> RGBA FP16，数值归一化到 [0, 1]，A = 1
+void ConvertRGB16ToRGBAHalf(const uint16_t* source, uint16_t* destination, size_t pixelCount);
+
+// RGBA FP16 -> RGBA 16-bit 无符号整数（clamp 到 [0, 1]），用于 16-bit PNG/TIFF 导出
+void ConvertRGBAHalfToRGBA16(const uint16_t* source, uint16_t* destination, size_t pixelCount);
+
+} // namespace LightroomCore
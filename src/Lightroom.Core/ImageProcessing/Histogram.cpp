@@ -0,0 +1,123 @@
+﻿#include "Histogram.h"
+#include "PixelConversion.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <immintrin.h>
+
+namespace LightroomCore {
+
+namespace {
+
+// 每个行带至少统计的行数（行带越多，合并私有直方图的开销越大）
+constexpr int32_t kMinRowsPerBand = 32;
+
+// Rec. 709 亮度的整数权重（0.2126, 0.7152, 0.0722 乘以 256，和为 256）
+constexpr uint32_t kLumaR = 54;
+constexpr uint32_t kLumaG = 183;
+constexpr uint32_t kLumaB = 19;
+
+inline uint8_t Luminance(uint32_t r, uint32_t g, uint32_t b) {
+    return static_cast<uint8_t>((kLumaR * r + kLumaG * g + kLumaB * b) >> 8);
+}
+
+void LuminanceRowScalar(const uint8_t* row, uint32_t count, uint8_t* outLuminance) {
+    for (uint32_t x = 0; x < count; ++x) {
+        outLuminance[x] = Luminance(row[x * 4 + 2], row[x * 4 + 1], row[x * 4 + 0]);
+    }
+}
+
+// 每次 8 个像素：字节扩展为 16 位，madd 得到 (B*wb + G*wg, R*wr + A*0)，hadd 得到每个像素的加权和
+void LuminanceRowSSSE3(const uint8_t* row, uint32_t count, uint8_t* outLuminance) {
+    const __m128i weights = _mm_setr_epi16(kLumaB, kLumaG, kLumaR, 0, kLumaB, kLumaG, kLumaR, 0);
+    const __m128i zero = _mm_setzero_si128();
+
+    uint32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        const __m128i pixels0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4));
+        const __m128i pixels1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4 + 16));
+
+        const __m128i sum0 = _mm_hadd_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(pixels0, zero), weights),
+                                            _mm_madd_epi16(_mm_unpackhi_epi8(pixels0, zero), weights));
+        const __m128i sum1 = _mm_hadd_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(pixels1, zero), weights),
+                                            _mm_madd_epi16(_mm_unpackhi_epi8(pixels1, zero), weights));
+
+        // 加权和最大 255 * 256，右移 8 位后在 [0, 255]
+        const __m128i luminance16 = _mm_packs_epi32(_mm_srli_epi32(sum0, 8), _mm_srli_epi32(sum1, 8));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(outLuminance + x), _mm_packus_epi16(luminance16, zero));
+    }
+    LuminanceRowScalar(row + x * 4, count - x, outLuminance + x);
+}
+
+} // namespace
+
+void ComputeHistogramBGRA8(const uint8_t* data, uint32_t rowPitch, uint32_t width, uint32_t height,
+                           uint32_t sampleStep, uint32_t* outHistogram) {
+    memset(outHistogram, 0, kHistogramSize * sizeof(uint32_t));
+    if (!data || width == 0 || height == 0) {
+        return;
+    }
+
+    sampleStep = std::max(1u, sampleStep);
+    const uint32_t sampledRows = (height + sampleStep - 1) / sampleStep;
+    const uint32_t sampledColumns = (width + sampleStep - 1) / sampleStep;
+    const bool useSSSE3 = (sampleStep == 1) && IsSSSE3Supported();
+
+    std::mutex mergeMutex;
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(sampledRows), kMinRowsPerBand,
+        [&](int32_t beginRow, int32_t endRow) {
+            uint32_t local[kHistogramSize] = {};
+            uint32_t* localR = local;
+            uint32_t* localG = local + kHistogramBins;
+            uint32_t* localB = local + kHistogramBins * 2;
+            uint32_t* localL = local + kHistogramBins * 3;
+
+            std::vector<uint8_t> luminance(useSSSE3 ? width : 0);
+            for (int32_t sampledY = beginRow; sampledY < endRow; ++sampledY) {
+                const uint8_t* row = data + static_cast<size_t>(sampledY) * sampleStep * rowPitch;
+
+                if (useSSSE3) {
+                    // 连续的行：先向量化计算整行亮度，再逐像素累加
+                    LuminanceRowSSSE3(row, width, luminance.data());
+                    for (uint32_t x = 0; x < width; ++x) {
+                        const uint8_t* pixel = row + x * 4;
+                        ++localB[pixel[0]];
+                        ++localG[pixel[1]];
+                        ++localR[pixel[2]];
+                        ++localL[luminance[x]];
+                    }
+                } else {
+                    for (uint32_t sampledX = 0; sampledX < sampledColumns; ++sampledX) {
+                        const uint8_t* pixel = row + static_cast<size_t>(sampledX) * sampleStep * 4;
+                        ++localB[pixel[0]];
+                        ++localG[pixel[1]];
+                        ++localR[pixel[2]];
+                        ++localL[Luminance(pixel[2], pixel[1], pixel[0])];
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            for (uint32_t i = 0; i < kHistogramSize; ++i) {
+                outHistogram[i] += local[i];
+            }
+        });
+}
+
+bool HistogramCache::Lookup(uint64_t contentKey, uint32_t sampleStep, uint32_t* outHistogram) const {
+    if (m_ContentKey == 0 || m_ContentKey != contentKey || m_SampleStep > std::max(1u, sampleStep)) {
+        return false;
+    }
+    memcpy(outHistogram, m_Histogram.data(), kHistogramSize * sizeof(uint32_t));
+    return true;
+}
+
+void HistogramCache::Store(uint64_t contentKey, uint32_t sampleStep, const uint32_t* histogram) {
+    m_ContentKey = contentKey;
+    m_SampleStep = std::max(1u, sampleStep);
+    memcpy(m_Histogram.data(), histogram, kHistogramSize * sizeof(uint32_t));
+}
+
+} // namespace LightroomCore
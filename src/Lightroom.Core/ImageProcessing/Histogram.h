@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <array>
+
+namespace LightroomCore {
+
+// 直方图布局：R, G, B, 亮度（Rec. 709）各 256 个 bin，共 1024 个 uint32
+constexpr uint32_t kHistogramBins = 256;
+constexpr uint32_t kHistogramSize = kHistogramBins * 4;
+
+// 统计 BGRA8 图像的直方图
+// sampleStep > 1 时每隔 sampleStep 行、sampleStep 列取一个像素（4 = 1/16 像素，用于拖动滑块时的实时更新）
+// 按行带分发到 SoftwareTaskPool：每个行带统计到私有直方图，最后合并，线程之间不竞争计数器
+void ComputeHistogramBGRA8(const uint8_t* data, uint32_t rowPitch, uint32_t width, uint32_t height,
+                           uint32_t sampleStep, uint32_t* outHistogram);
+
+// 按渲染内容缓存的直方图
+// 内容键相同（画面没有变化）时直接返回上次的结果；缓存的结果采样更密时也可以满足更稀疏的请求
+class HistogramCache {
+public:
+    bool Lookup(uint64_t contentKey, uint32_t sampleStep, uint32_t* outHistogram) const;
+    void Store(uint64_t contentKey, uint32_t sampleStep, const uint32_t* histogram);
+    void Invalidate() { m_ContentKey = 0; }
+
+private:
+    uint64_t m_ContentKey = 0;  // 0 表示无效
+    uint32_t m_SampleStep = 0;
+    std::array<uint32_t, kHistogramSize> m_Histogram = {};
+};
+
+} // namespace LightroomCore
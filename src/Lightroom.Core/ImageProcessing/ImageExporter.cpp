@@ -14,9 +14,12 @@
 #include <algorithm>
 
 #include "ImageExporter.h"
+#include "../RenderGraph.h"
+#include "../RenderNodes/RenderNode.h"
 #include "../d3d11rhi/D3D11RHI.h"
 #include "../d3d11rhi/D3D11Texture2D.h"
 #include "../d3d11rhi/D3D11CommandContext.h"
+#include "../d3d11rhi/SoftwareTexture2D.h"
 #include "../d3d11rhi/RHIDefinitions.h"
 #include <d3d11.h>
 #include <wrl/client.h>
@@ -34,14 +37,13 @@ ImageExporter::ImageExporter(std::shared_ptr<RenderCore::DynamicRHI> rhi)
 ImageExporter::~ImageExporter() {
 }
 
-bool ImageExporter::SaveImageDataWithWIC(const std::string& filePath,
-	const uint8_t* imageData,
-	uint32_t width,
-	uint32_t height,
-	uint32_t stride,
+// 创建 WIC 编码器与帧（文件流、容器格式、JPEG 质量），SaveImageDataWithWIC 与 ExportTiled 共用
+static bool CreateWICFrameEncoder(const std::string& filePath,
 	ExportFormat format,
-	uint32_t quality) {
-	Microsoft::WRL::ComPtr<IWICImagingFactory> wicFactory;
+	uint32_t quality,
+	Microsoft::WRL::ComPtr<IWICImagingFactory>& wicFactory,
+	Microsoft::WRL::ComPtr<IWICBitmapEncoder>& encoder,
+	Microsoft::WRL::ComPtr<IWICBitmapFrameEncode>& frameEncoder) {
 	HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wicFactory));
 	if (FAILED(hr)) return false;
 
@@ -59,15 +61,15 @@ bool ImageExporter::SaveImageDataWithWIC(const std::string& filePath,
 	if (FAILED(hr)) return false;
 
 	// 2. 创建编码器
-	GUID containerFormat = (format == ExportFormat::PNG) ? GUID_ContainerFormatPng : GUID_ContainerFormatJpeg;
-	Microsoft::WRL::ComPtr<IWICBitmapEncoder> encoder;
+	GUID containerFormat = GUID_ContainerFormatJpeg;
+	if (format == ExportFormat::PNG) containerFormat = GUID_ContainerFormatPng;
+	else if (format == ExportFormat::TIFF) containerFormat = GUID_ContainerFormatTiff;
 	hr = wicFactory->CreateEncoder(containerFormat, nullptr, &encoder);
 	if (FAILED(hr)) return false;
 	hr = encoder->Initialize(stream.Get(), WICBitmapEncoderNoCache);
 	if (FAILED(hr)) return false;
 
 	// 3. 创建帧
-	Microsoft::WRL::ComPtr<IWICBitmapFrameEncode> frameEncoder;
 	Microsoft::WRL::ComPtr<IPropertyBag2> propertyBag;
 	hr = encoder->CreateNewFrame(&frameEncoder, &propertyBag);
 	if (FAILED(hr)) return false;
@@ -86,6 +88,22 @@ bool ImageExporter::SaveImageDataWithWIC(const std::string& filePath,
 	hr = frameEncoder->Initialize(propertyBag.Get());
 	if (FAILED(hr)) return false;
 
+	return true;
+}
+
+bool ImageExporter::SaveImageDataWithWIC(const std::string& filePath,
+	const uint8_t* imageData,
+	uint32_t width,
+	uint32_t height,
+	uint32_t stride,
+	ExportFormat format,
+	uint32_t quality) {
+	Microsoft::WRL::ComPtr<IWICImagingFactory> wicFactory;
+	Microsoft::WRL::ComPtr<IWICBitmapEncoder> encoder;
+	Microsoft::WRL::ComPtr<IWICBitmapFrameEncode> frameEncoder;
+	if (!CreateWICFrameEncoder(filePath, format, quality, wicFactory, encoder, frameEncoder)) return false;
+	HRESULT hr = S_OK;
+
 	// 4. 创建一个 WIC Bitmap 包装我们的内存数据
 	Microsoft::WRL::ComPtr<IWICBitmap> wicBitmap;
 	hr = wicFactory->CreateBitmapFromMemory(
@@ -126,6 +144,46 @@ bool ImageExporter::SaveImageDataWithWIC(const std::string& filePath,
 	return true;
 }
 
+bool ImageExporter::SaveImageData16WithWIC(const std::string& filePath,
+	const uint16_t* imageData,
+	uint32_t width,
+	uint32_t height,
+	ExportFormat format) {
+	// JPEG 只有 8-bit
+	if (format == ExportFormat::JPEG) return false;
+
+	Microsoft::WRL::ComPtr<IWICImagingFactory> wicFactory;
+	Microsoft::WRL::ComPtr<IWICBitmapEncoder> encoder;
+	Microsoft::WRL::ComPtr<IWICBitmapFrameEncode> frameEncoder;
+	if (!CreateWICFrameEncoder(filePath, format, 100, wicFactory, encoder, frameEncoder)) return false;
+
+	HRESULT hr = frameEncoder->SetSize(width, height);
+	if (FAILED(hr)) return false;
+
+	// PNG 与 TIFF 编码器都原生支持 64bppRGBA，不需要格式转换
+	WICPixelFormatGUID pixelFormat = GUID_WICPixelFormat64bppRGBA;
+	hr = frameEncoder->SetPixelFormat(&pixelFormat);
+	if (FAILED(hr) || pixelFormat != GUID_WICPixelFormat64bppRGBA) {
+		std::cerr << "WIC encoder does not accept 64bppRGBA" << std::endl;
+		return false;
+	}
+
+	const UINT stride = width * 8;
+	hr = frameEncoder->WritePixels(height, stride, stride * height,
+		reinterpret_cast<BYTE*>(const_cast<uint16_t*>(imageData)));
+	if (FAILED(hr)) {
+		std::cerr << "Failed to WritePixels: 0x" << std::hex << hr << std::endl;
+		return false;
+	}
+
+	hr = frameEncoder->Commit();
+	if (FAILED(hr)) return false;
+	hr = encoder->Commit();
+	if (FAILED(hr)) return false;
+
+	return true;
+}
+
 bool ImageExporter::ReadD3D11TextureData(ID3D11Texture2D* d3d11Texture,
 	uint32_t& outWidth, uint32_t& outHeight,
 	std::vector<uint8_t>& outData, uint32_t& outStride) {
@@ -192,11 +250,23 @@ bool ImageExporter::ReadD3D11TextureData(ID3D11Texture2D* d3d11Texture,
 	if (FAILED(context->Map(stagingTex.Get(), 0, D3D11_MAP_READ, 0, &mapped))) return false;
 
 	// 6. 数据搬运
+	uint8_t* src = reinterpret_cast<uint8_t*>(mapped.pData);
+
+	// FP16 纹理（高精度管线）：原样拷贝 RGBA 半精度数据，由调用者转换
+	if (srcDesc.Format == DXGI_FORMAT_R16G16B16A16_FLOAT) {
+		outStride = outWidth * 8;
+		outData.resize(static_cast<size_t>(outStride) * outHeight);
+		for (int y = 0; y < (int)outHeight; ++y) {
+			memcpy(outData.data() + static_cast<size_t>(y) * outStride, src + static_cast<size_t>(y) * mapped.RowPitch, outStride);
+		}
+		context->Unmap(stagingTex.Get(), 0);
+		return true;
+	}
+
 	outStride = outWidth * 4;
 	outData.resize(outStride * outHeight);
 
 	uint8_t* dst = outData.data();
-	uint8_t* src = reinterpret_cast<uint8_t*>(mapped.pData);
 
 	// 检查是否需要交换红蓝通道 (RGBA -> BGRA)
 	// 通常 RenderTarget 是 RGBA，而 WIC Bitmap 最好是 BGRA
@@ -222,6 +292,176 @@ bool ImageExporter::ReadD3D11TextureData(ID3D11Texture2D* d3d11Texture,
 	context->Unmap(stagingTex.Get(), 0);
 	return true;
 }
+
+bool ImageExporter::ReadTextureData(std::shared_ptr<RenderCore::RHITexture2D> texture,
+	uint32_t& outWidth, uint32_t& outHeight,
+	std::vector<uint8_t>& outData, uint32_t& outStride) {
+
+	if (!texture) return false;
+
+	// 软件 RHI：纹理本身就在系统内存中，紧密排列，直接拷贝
+	auto* softwareTexture = dynamic_cast<RenderCore::SoftwareTexture2D*>(texture.get());
+	if (softwareTexture) {
+		if (softwareTexture->GetPixelFormat() != RenderCore::PF_B8G8R8A8 &&
+			softwareTexture->GetPixelFormat() != RenderCore::PF_FloatRGBA) return false;
+		outWidth = static_cast<uint32_t>(softwareTexture->GetSize().x);
+		outHeight = static_cast<uint32_t>(softwareTexture->GetSize().y);
+		outStride = softwareTexture->GetRowPitch();
+		const uint8_t* src = softwareTexture->GetData();
+		outData.assign(src, src + static_cast<size_t>(outStride) * outHeight);
+		return true;
+	}
+
+	auto* d3d11Texture = dynamic_cast<RenderCore::D3D11Texture2D*>(texture.get());
+	if (!d3d11Texture || !d3d11Texture->GetNativeTex()) return false;
+	return ReadD3D11TextureData(d3d11Texture->GetNativeTex(), outWidth, outHeight, outData, outStride);
+}
+bool ImageExporter::ExportTiled(ITileSource& source,
+	const std::vector<std::shared_ptr<RenderNode>>& nodes,
+	const std::string& filePath,
+	ExportFormat format,
+	uint32_t quality,
+	uint32_t tileSize) {
+	const uint32_t width = source.GetWidth();
+	const uint32_t height = source.GetHeight();
+	if (!m_RHI || width == 0 || height == 0) return false;
+
+	// 1. 收集可分块的节点，邻域为各节点邻域之和
+	//    后一个节点在块内边缘读取的是前一个节点的输出，前一个节点需要在更外一圈仍然有正确的输入
+	RenderGraph tileGraph(m_RHI);
+	std::vector<std::shared_ptr<RenderNode>> tileNodes;
+	uint32_t apron = 0;
+	for (const auto& node : nodes) {
+		if (!node || node->IsIdentity()) continue;
+		const int32_t nodeApron = node->GetTileApron();
+		if (nodeApron < 0) continue;
+		apron += static_cast<uint32_t>(nodeApron);
+		tileNodes.push_back(node);
+		tileGraph.AddNode(node);
+	}
+
+	// 节点与交互渲染图共享，退出时恢复为非分块执行
+	struct TileContextGuard {
+		std::vector<std::shared_ptr<RenderNode>>& Nodes;
+		~TileContextGuard() {
+			for (auto& node : Nodes) node->ClearTileContext();
+		}
+	} contextGuard{ tileNodes };
+
+	TileGrid grid(width, height, tileSize, apron);
+	const uint32_t padded = grid.GetPaddedTileSize();
+
+	// 所有块使用同一尺寸的输出纹理，边缘块已在读取时按 clamp 填充
+	std::shared_ptr<RenderCore::RHITexture2D> tileOutput;
+	if (!tileNodes.empty()) {
+		tileOutput = m_RHI->RHICreateTexture2D(
+			RenderCore::EPixelFormat::PF_B8G8R8A8,
+			RenderCore::ETextureCreateFlags::TexCreate_RenderTargetable | RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+			padded, padded, 1);
+		if (!tileOutput) return false;
+	}
+
+	// 2. 创建编码器，按行带写入
+	Microsoft::WRL::ComPtr<IWICImagingFactory> wicFactory;
+	Microsoft::WRL::ComPtr<IWICBitmapEncoder> encoder;
+	Microsoft::WRL::ComPtr<IWICBitmapFrameEncode> frameEncoder;
+	if (!CreateWICFrameEncoder(filePath, format, quality, wicFactory, encoder, frameEncoder)) return false;
+
+	HRESULT hr = frameEncoder->SetSize(width, height);
+	if (FAILED(hr)) return false;
+
+	// 编码器可能把格式改为它支持的格式（JPEG 为 24bpp BGR）
+	WICPixelFormatGUID pixelFormat = GUID_WICPixelFormat32bppBGRA;
+	hr = frameEncoder->SetPixelFormat(&pixelFormat);
+	if (FAILED(hr)) return false;
+	const bool packBGR = IsEqualGUID(pixelFormat, GUID_WICPixelFormat24bppBGR) != FALSE;
+	if (!packBGR && !IsEqualGUID(pixelFormat, GUID_WICPixelFormat32bppBGRA)) {
+		std::cerr << "[ImageExporter] Unsupported encoder pixel format for tiled export" << std::endl;
+		return false;
+	}
+
+	const uint32_t bandStride = width * 4;
+	std::vector<uint8_t> band(static_cast<size_t>(bandStride) * grid.TileSize);
+	std::vector<uint8_t> tileData;
+	std::vector<uint8_t> tileResult;
+	std::vector<uint8_t> packed;
+	auto commandContext = m_RHI->GetDefaultCommandContext();
+
+	for (uint32_t tileY = 0; tileY < grid.GetTilesY(); ++tileY) {
+		uint32_t bandRows = 0;
+		for (uint32_t tileX = 0; tileX < grid.GetTilesX(); ++tileX) {
+			uint32_t x, y, tileWidth, tileHeight;
+			grid.GetTileRect(tileX, tileY, x, y, tileWidth, tileHeight);
+			bandRows = tileHeight;
+
+			if (!ReadPaddedTile(source, grid, tileX, tileY, tileData)) {
+				std::cerr << "[ImageExporter] Failed to read tile " << tileX << "," << tileY << std::endl;
+				return false;
+			}
+
+			// 无可分块节点时直接写出原图像素
+			const uint8_t* result = tileData.data();
+			uint32_t resultStride = padded * 4;
+
+			if (!tileNodes.empty()) {
+				auto tileInput = m_RHI->RHICreateTexture2D(
+					RenderCore::EPixelFormat::PF_B8G8R8A8,
+					RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+					padded, padded, 1, tileData.data(), padded * 4);
+				if (!tileInput) return false;
+
+				for (auto& node : tileNodes) {
+					node->SetTileContext(width, height,
+						static_cast<int32_t>(x) - static_cast<int32_t>(apron),
+						static_cast<int32_t>(y) - static_cast<int32_t>(apron));
+				}
+				tileGraph.InvalidateCache();
+				if (!tileGraph.Execute(tileInput, tileOutput, padded, padded)) return false;
+				if (commandContext) commandContext->FlushCommands();
+
+				uint32_t readWidth, readHeight;
+				if (!ReadTextureData(tileOutput, readWidth, readHeight, tileResult, resultStride)) return false;
+				result = tileResult.data();
+			}
+
+			// 只保留块内部（去掉邻域）
+			for (uint32_t row = 0; row < tileHeight; ++row) {
+				memcpy(band.data() + static_cast<size_t>(row) * bandStride + x * 4,
+					result + static_cast<size_t>(row + apron) * resultStride + apron * 4,
+					tileWidth * 4);
+			}
+		}
+
+		// 3. 写出当前行带
+		if (packBGR) {
+			const uint32_t packedStride = width * 3;
+			packed.resize(static_cast<size_t>(packedStride) * bandRows);
+			for (uint32_t row = 0; row < bandRows; ++row) {
+				const uint8_t* src = band.data() + static_cast<size_t>(row) * bandStride;
+				uint8_t* dst = packed.data() + static_cast<size_t>(row) * packedStride;
+				for (uint32_t col = 0; col < width; ++col) {
+					dst[col * 3 + 0] = src[col * 4 + 0];
+					dst[col * 3 + 1] = src[col * 4 + 1];
+					dst[col * 3 + 2] = src[col * 4 + 2];
+				}
+			}
+			hr = frameEncoder->WritePixels(bandRows, packedStride, packedStride * bandRows, packed.data());
+		} else {
+			hr = frameEncoder->WritePixels(bandRows, bandStride, bandStride * bandRows, band.data());
+		}
+		if (FAILED(hr)) {
+			std::cerr << "Failed to WritePixels: 0x" << std::hex << hr << std::endl;
+			return false;
+		}
+	}
+
+	hr = frameEncoder->Commit();
+	if (FAILED(hr)) return false;
+	hr = encoder->Commit();
+	if (FAILED(hr)) return false;
+
+	return true;
+}
 } // namespace LightroomCore
 
  
\ No newline at end of file
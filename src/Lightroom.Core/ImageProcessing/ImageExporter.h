@@ -2,16 +2,20 @@
 
 #include "../d3d11rhi/DynamicRHI.h"
 #include "../d3d11rhi/RHITexture2D.h"
+#include "TiledImage.h"
 #include <string>
 #include <memory>
 #include <vector>
 
 namespace LightroomCore {
 
+class RenderNode;
+
 // 图片导出格式
 enum class ExportFormat {
     PNG,
-    JPEG
+    JPEG,
+    TIFF
 };
 
 // 图片导出器：从渲染目标纹理导出图片到文件
@@ -23,7 +27,7 @@ public:
     // 从 D3D11 纹理直接读取数据（用于共享纹理）
     // d3d11Texture: D3D11 纹理指针
     // width, height: 纹理尺寸
-    // outData: 输出的像素数据（BGRA32 格式）
+    // outData: 输出的像素数据（BGRA32 格式；R16G16B16A16_FLOAT 纹理输出原始 RGBA FP16）
     // outStride: 输出行字节数
     // 返回是否成功
     bool ReadD3D11TextureData(ID3D11Texture2D* d3d11Texture,
@@ -32,6 +36,14 @@ public:
                               std::vector<uint8_t>& outData,
                               uint32_t& outStride);
 
+    // 从 RHI 纹理读取数据（D3D11 走 staging 回读，软件 RHI 直接拷贝系统内存）
+    // 参数含义同 ReadD3D11TextureData
+    bool ReadTextureData(std::shared_ptr<RenderCore::RHITexture2D> texture,
+                         uint32_t& width,
+                         uint32_t& height,
+                         std::vector<uint8_t>& outData,
+                         uint32_t& outStride);
+
     // 使用 WIC 保存图片数据（公共方法，供 SDK 使用）
     bool SaveImageDataWithWIC(const std::string& filePath,
                              const uint8_t* imageData,
@@ -41,6 +53,24 @@ public:
                              ExportFormat format,
                              uint32_t quality);
 
+    // 保存 16-bit 图片（RGBA 16-bit 无符号整数，紧密排列），只支持 PNG 和 TIFF
+    bool SaveImageData16WithWIC(const std::string& filePath,
+                                const uint16_t* imageData,
+                                uint32_t width,
+                                uint32_t height,
+                                ExportFormat format);
+
+    // 分块流式导出（用于超出纹理尺寸或内存限制的大图）
+    // 按 tileSize 行带从分块源读取全分辨率像素，逐块（带邻域）执行可分块的节点，
+    // 并通过 WIC WritePixels 逐行带写入文件，峰值内存只与图像宽度和块尺寸有关
+    // 依赖整幅图像的视图节点（GetTileApron() < 0，例如 ScaleNode）会被跳过，导出内容始终为完整原图
+    bool ExportTiled(ITileSource& source,
+                     const std::vector<std::shared_ptr<RenderNode>>& nodes,
+                     const std::string& filePath,
+                     ExportFormat format,
+                     uint32_t quality,
+                     uint32_t tileSize = kDefaultTileSize);
+
 private:
     std::shared_ptr<RenderCore::DynamicRHI> m_RHI;
 };
@@ -1,8 +1,10 @@
 ﻿#pragma once
 
 #include "../d3d11rhi/DynamicRHI.h"
+#include "TiledImage.h"
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace LightroomCore {
 
@@ -13,6 +15,35 @@ enum class ImageFormat {
     RAW        // CR2, NEF, ARW, DNG, etc. (LibRaw)
 };
 
+// CPU 端的解码结果，不依赖 RHI，可在后台线程生成后再到渲染线程创建纹理
+struct DecodedImage {
+    RenderCore::EPixelFormat Format = RenderCore::EPixelFormat::PF_B8G8R8A8;  // BGRA8，或高精度模式的 RGBA FP16（PF_FloatRGBA）
+    std::vector<uint8_t> Data;      // 按 Format 紧密排列的像素（大图时为缩小的代理图像）
+    uint32_t Width = 0;             // Data 的尺寸
+    uint32_t Height = 0;
+    uint32_t FullWidth = 0;         // 全分辨率尺寸
+    uint32_t FullHeight = 0;
+    std::shared_ptr<ITileSource> TileSource;  // 大图的全分辨率分块源
+};
+
+// 从解码结果创建着色器资源纹理
+inline std::shared_ptr<RenderCore::RHITexture2D> CreateTextureFromDecodedImage(
+    std::shared_ptr<RenderCore::DynamicRHI> rhi, const DecodedImage& image) {
+    if (!rhi || image.Data.empty() || image.Width == 0 || image.Height == 0) {
+        return nullptr;
+    }
+    const uint32_t bytesPerPixel = (image.Format == RenderCore::EPixelFormat::PF_FloatRGBA) ? 8 : 4;
+    return rhi->RHICreateTexture2D(
+        image.Format,
+        RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+        image.Width,
+        image.Height,
+        1,  // NumMips
+        const_cast<uint8_t*>(image.Data.data()),
+        image.Width * bytesPerPixel
+    );
+}
+
 // 图片加载器接口（策略模式）
 class IImageLoader {
 public:
@@ -30,8 +61,19 @@ public:
     // 获取图片格式
     virtual ImageFormat GetFormat() const = 0;
 
-    // 获取最后加载的图片尺寸
+    // 获取最后加载的图片尺寸（全分辨率）
     virtual void GetImageInfo(uint32_t& width, uint32_t& height) const = 0;
+
+    // 最后加载图片的全分辨率分块源
+    // 仅当图片需要分块处理（RequiresTiledProcessing）时有效，此时 Load 返回的是缩小的代理纹理
+    virtual std::shared_ptr<ITileSource> GetTileSource() const { return nullptr; }
+
+    // 在 CPU 上解码缩略图（BGRA8，紧密排列，保持宽高比缩小到 maxWidth x maxHeight 以内）
+    // 不创建纹理、不修改加载器状态，可在任意线程上调用
+    virtual bool LoadThumbnail(const std::wstring& filePath, uint32_t maxWidth, uint32_t maxHeight,
+                               std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+        return false;
+    }
 };
 
 } // namespace LightroomCore
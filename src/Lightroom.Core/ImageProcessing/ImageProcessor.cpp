@@ -20,6 +20,7 @@ ImageProcessor::ImageProcessor(std::shared_ptr<RenderCore::DynamicRHI> rhi)
     , m_LastImageWidth(0)
     , m_LastImageHeight(0)
     , m_LastFormat(ImageFormat::Unknown)
+    , m_HighPrecision(false)
 {
     // 创建加载器实例
     m_StandardLoader = std::make_unique<StandardImageLoader>();
@@ -73,8 +74,43 @@ std::shared_ptr<RenderCore::RHITexture2D> ImageProcessor::LoadImageFromFile(cons
     }
 
     // 更新最后加载的图片信息
+    UpdateLastImageInfo(loader);
+    return texture;
+}
+
+std::shared_ptr<RenderCore::RHITexture2D> ImageProcessor::LoadPreviewFromFile(const std::wstring& imagePath) {
+    if (!m_RAWLoader->CanLoad(imagePath)) {
+        // 标准格式解码本身就很快，不区分预览和完整质量
+        return LoadImageFromFile(imagePath);
+    }
+
+    RAWImageLoader* rawLoader = static_cast<RAWImageLoader*>(m_RAWLoader.get());
+    auto texture = rawLoader->LoadPreview(imagePath, m_RHI);
+    if (!texture) {
+        return nullptr;
+    }
+
+    UpdateLastImageInfo(rawLoader);
+    return texture;
+}
+
+bool ImageProcessor::DecodeImageFile(const std::wstring& imagePath, DecodedImage& outImage, bool highPrecision) {
+    RAWImageLoader rawLoader;
+    if (rawLoader.CanLoad(imagePath)) {
+        return RAWImageLoader::DecodeImage(imagePath, outImage, highPrecision);
+    }
+    return false;
+}
+
+void ImageProcessor::SetHighPrecision(bool enable) {
+    m_HighPrecision = enable;
+    static_cast<RAWImageLoader*>(m_RAWLoader.get())->SetHighPrecision(enable);
+}
+
+void ImageProcessor::UpdateLastImageInfo(IImageLoader* loader) {
     loader->GetImageInfo(m_LastImageWidth, m_LastImageHeight);
     m_LastFormat = loader->GetFormat();
+    m_LastTileSource = loader->GetTileSource();
 
     // 如果是 RAW 格式，保存 RAW 信息
     if (m_LastFormat == ImageFormat::RAW) {
@@ -89,7 +125,21 @@ std::shared_ptr<RenderCore::RHITexture2D> ImageProcessor::LoadImageFromFile(cons
         // 清除 RAW 信息
         m_LastRAWInfo.reset();
     }
-    return texture;
+}
+
+bool ImageProcessor::LoadThumbnail(const std::wstring& imagePath, uint32_t maxWidth, uint32_t maxHeight,
+                                   std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    // 与 SelectLoader 相同的优先级：先 RAW，后标准格式
+    RAWImageLoader rawLoader;
+    if (rawLoader.CanLoad(imagePath)) {
+        return rawLoader.LoadThumbnail(imagePath, maxWidth, maxHeight, outData, outWidth, outHeight);
+    }
+
+    StandardImageLoader standardLoader;
+    if (standardLoader.CanLoad(imagePath)) {
+        return standardLoader.LoadThumbnail(imagePath, maxWidth, maxHeight, outData, outWidth, outHeight);
+    }
+    return false;
 }
 
 bool ImageProcessor::IsRAWFormat(const std::wstring& filePath) const {
@@ -5,6 +5,7 @@
 #include "RAWImageInfo.h"
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace LightroomCore {
 
@@ -22,12 +23,29 @@ public:
     // 从文件加载图片到 RHI 纹理
     std::shared_ptr<RenderCore::RHITexture2D> LoadImageFromFile(const std::wstring& imagePath);
 
+    // 加载快速预览纹理（渐进式加载的第一阶段）
+    // RAW 文件使用内嵌预览或半尺寸去马赛克，其他格式与 LoadImageFromFile 相同
+    std::shared_ptr<RenderCore::RHITexture2D> LoadPreviewFromFile(const std::wstring& imagePath);
+
+    // 在 CPU 上以最高质量完整解码（渐进式加载的第二阶段）
+    // 每次调用使用独立的加载器实例，可在后台线程调用；目前只有 RAW 格式需要，其他格式返回 false
+    static bool DecodeImageFile(const std::wstring& imagePath, DecodedImage& outImage, bool highPrecision = false);
+
+    // 高精度模式：之后加载的 RAW 图片使用 RGBA FP16 纹理（标准 8-bit 格式不受影响）
+    void SetHighPrecision(bool enable);
+    bool IsHighPrecision() const { return m_HighPrecision; }
+
     // 获取最后加载的图片尺寸
     void GetLastImageSize(uint32_t& width, uint32_t& height) const {
         width = m_LastImageWidth;
         height = m_LastImageHeight;
     }
 
+    // 在 CPU 上解码缩略图（BGRA8，紧密排列，缩小到 maxWidth x maxHeight 以内）
+    // 每次调用使用独立的加载器实例，可在多个线程上并发调用
+    static bool LoadThumbnail(const std::wstring& imagePath, uint32_t maxWidth, uint32_t maxHeight,
+                              std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight);
+
     // 检查文件是否为 RAW 格式
     bool IsRAWFormat(const std::wstring& filePath) const;
 
@@ -37,6 +55,9 @@ public:
     // 获取最后加载的图片格式
     ImageFormat GetLastImageFormat() const { return m_LastFormat; }
 
+    // 最后加载图片的全分辨率分块源（仅大图有效，此时 LoadImageFromFile 返回的是代理纹理）
+    std::shared_ptr<ITileSource> GetLastTileSource() const { return m_LastTileSource; }
+
     // RAW-specific: 获取 RAW 信息（仅在加载 RAW 文件后有效）
     const RAWImageInfo* GetRAWInfo() const {
         return (m_LastFormat == ImageFormat::RAW) ? m_LastRAWInfo.get() : nullptr;
@@ -47,16 +68,23 @@ private:
     uint32_t m_LastImageWidth;
     uint32_t m_LastImageHeight;
     ImageFormat m_LastFormat;
+    bool m_HighPrecision;
 
     // 加载器实例
     std::unique_ptr<IImageLoader> m_StandardLoader;
     std::unique_ptr<IImageLoader> m_RAWLoader;
 
+    // 大图的分块源
+    std::shared_ptr<ITileSource> m_LastTileSource;
+
     // RAW 信息（仅在加载 RAW 文件时有效）
     std::unique_ptr<RAWImageInfo> m_LastRAWInfo;
 
     // 选择适当的加载器
     IImageLoader* SelectLoader(const std::wstring& filePath);
+
+    // 加载成功后记录加载器的尺寸、格式、分块源和 RAW 信息
+    void UpdateLastImageInfo(IImageLoader* loader);
 };
 
 } // namespace LightroomCore
@@ -17,6 +17,8 @@ LibRawWrapper::LibRawWrapper()
     :     m_Processor(nullptr)
     , m_Data(nullptr)
     , m_IsOpen(false)
+    , m_IsUnpacked(false)
+    , m_DemosaicAlgorithm(DemosaicAlgorithm::HighQuality)
 {
 #ifdef LIBRAW_AVAILABLE
     // 使用 C++ API: LibRaw 类
@@ -47,8 +49,9 @@ LibRawWrapper::~LibRawWrapper() {
 #endif
 }
 
-bool LibRawWrapper::OpenFile(const std::wstring& filePath) {
+bool LibRawWrapper::OpenFile(const std::wstring& filePath, bool unpackData) {
     m_IsOpen = false;
+    m_IsUnpacked = false;
     m_LastError.clear();
 
 #ifdef LIBRAW_AVAILABLE
@@ -68,20 +71,45 @@ bool LibRawWrapper::OpenFile(const std::wstring& filePath) {
         return false;
     }
 
+    m_IsOpen = true;
+    if (unpackData && !EnsureUnpacked()) {
+        processor->recycle();
+        m_IsOpen = false;
+        return false;
+    }
+    return true;
+#else
+    // 占位实现：返回 false，表示 LibRaw 未集成
+    m_LastError = "LibRaw not integrated. Please download and integrate LibRaw library.";
+    return false;
+#endif
+}
+
+bool LibRawWrapper::EnsureUnpacked() {
+    if (!m_IsOpen) {
+        m_LastError = "No file opened";
+        return false;
+    }
+    if (m_IsUnpacked) {
+        return true;
+    }
+
+#ifdef LIBRAW_AVAILABLE
+    LibRaw* processor = reinterpret_cast<LibRaw*>(m_Processor);
+
     // 解包 RAW 数据
-    ret = processor->unpack();
+    int ret = processor->unpack();
     if (ret != LIBRAW_SUCCESS) {
         m_LastError = "Failed to unpack RAW data: ";
         m_LastError += libraw_strerror(ret);
-        processor->recycle();
         return false;
     }
 
-    m_IsOpen = true;
+    m_IsUnpacked = true;
     return true;
 #else
-    // 占位实现：返回 false，表示 LibRaw 未集成
-    m_LastError = "LibRaw not integrated. Please download and integrate LibRaw library.";
+    // 占位实现
+    m_LastError = "LibRaw not integrated";
     return false;
 #endif
 }
@@ -158,8 +186,7 @@ bool LibRawWrapper::ExtractMetadata(RAWImageInfo& outInfo) {
 }
 
 bool LibRawWrapper::UnpackRAW(std::vector<uint16_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
-    if (!m_IsOpen) {
-        m_LastError = "No file opened";
+    if (!EnsureUnpacked()) {
         return false;
     }
 
@@ -194,24 +221,18 @@ bool LibRawWrapper::UnpackRAW(std::vector<uint16_t>& outData, uint32_t& outWidth
 #endif
 }
 
-bool LibRawWrapper::ProcessRAW(std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
-    if (!m_IsOpen) {
-        m_LastError = "No file opened";
-        return false;
-    }
-
+void* LibRawWrapper::RunProcessing(bool halfSize, int outputBps) {
 #ifdef LIBRAW_AVAILABLE
     if (!m_Processor) {
         m_LastError = "LibRaw processor not available";
-        return false;
+        return nullptr;
     }
 
     LibRaw* processor = reinterpret_cast<LibRaw*>(m_Processor);
-    libraw_data_t* data = reinterpret_cast<libraw_data_t*>(m_Data);
 
     // 设置处理参数
     // 使用高质量去马赛克算法
-    processor->imgdata.params.output_bps = 8;  // 输出 8-bit（dcraw_make_mem_image 会使用此设置）
+    processor->imgdata.params.output_bps = outputBps;  // 输出位深（dcraw_make_mem_image 会使用此设置）
     processor->imgdata.params.use_camera_wb = 1;  // 使用相机白平衡
     processor->imgdata.params.use_auto_wb = 0;  // 不使用自动白平衡
     processor->imgdata.params.highlight = 0;  // 高光恢复模式：0=clip, 1=unclip, 2=blend, 3=rebuild
@@ -223,17 +244,21 @@ bool LibRawWrapper::ProcessRAW(std::vector<uint8_t>& outData, uint32_t& outWidth
     processor->imgdata.params.no_auto_scale = 0;  // 启用自动色彩缩放（重要！）
     processor->imgdata.params.output_color = 1;  // sRGB 色彩空间
     // gamma 曲线：使用标准 sRGB gamma (2.2)
+    // 16-bit 输出使用同一曲线，渲染节点的数值含义与 8-bit 路径一致，只是没有量化
     processor->imgdata.params.gamm[0] = 1.0 / 2.222;  // gamma 值
     processor->imgdata.params.gamm[1] = 4.5;  // slope
     processor->imgdata.params.bright = 1.0;  // 亮度调整倍数（1.0 = 不调整，让自动亮度工作）
-    processor->imgdata.params.user_qual = 3;  // 去马赛克质量：0=fast, 1=normal, 2=high, 3=best
+    // 去马赛克质量：0=fast, 1=normal, 2=high, 3=best
+    // 半尺寸模式不做插值，质量参数不起作用
+    processor->imgdata.params.half_size = halfSize ? 1 : 0;
+    processor->imgdata.params.user_qual = halfSize ? 0 : 3;
 
     // 步骤 1: 转换为图像格式
     int ret = processor->raw2image();
     if (ret != LIBRAW_SUCCESS) {
         m_LastError = "Failed to convert raw2image: ";
         m_LastError += libraw_strerror(ret);
-        return false;
+        return nullptr;
     }
 
     // 步骤 2: 进行去马赛克和色彩处理
@@ -241,7 +266,7 @@ bool LibRawWrapper::ProcessRAW(std::vector<uint8_t>& outData, uint32_t& outWidth
     if (ret != LIBRAW_SUCCESS) {
         m_LastError = "Failed to process RAW data: ";
         m_LastError += libraw_strerror(ret);
-        return false;
+        return nullptr;
     }
 
     // 步骤 3: 使用 dcraw_make_mem_image 获取处理后的图像
@@ -255,46 +280,234 @@ bool LibRawWrapper::ProcessRAW(std::vector<uint8_t>& outData, uint32_t& outWidth
         } else {
             m_LastError += "processedImage is null";
         }
-        return false;
+        return nullptr;
     }
 
-    // 步骤 4: 获取处理后的图像尺寸
-    outWidth = processedImage->width;
-    outHeight = processedImage->height;
-    uint32_t pixelCount = outWidth * outHeight;
-
-    // 步骤 5: 检查图像格式
+    // 检查图像格式
     if (processedImage->colors != 3) {
         m_LastError = "Unsupported color format (expected RGB)";
         processor->dcraw_clear_mem(processedImage);
+        return nullptr;
+    }
+    return processedImage;
+#else
+    // 占位实现
+    m_LastError = "LibRaw not integrated";
+    return nullptr;
+#endif
+}
+
+bool LibRawWrapper::FillBayerParams(bool halfSize, BayerDevelopParams& outParams) const {
+#ifdef LIBRAW_AVAILABLE
+    const LibRaw* processor = reinterpret_cast<const LibRaw*>(m_Processor);
+    const libraw_data_t& data = processor->imgdata;
+
+    // 只处理 2x2 重复的 Bayer 排列；X-Trans（filters = 9）、Leaf（filters = 1）、Foveon / 线性 DNG（没有 raw_image）、
+    // Fuji SuperCCD（旋转 45° 的传感器）和非方形像素交给 LibRaw
+    const unsigned filters = data.idata.filters;
+    if (!data.rawdata.raw_image || filters < 1000 || data.idata.colors != 3 ||
+        data.rawdata.ioparams.fuji_width != 0 || data.sizes.pixel_aspect != 1.0 ||
+        data.sizes.width < 4 || data.sizes.height < 4) {
         return false;
     }
 
-    // 步骤 6: 复制 RGB 数据
-    // processedImage->data 已经是 8-bit RGB 数据（根据 output_bps=8 设置）
-    // dcraw_make_mem_image 已经通过 color.curve 应用了 gamma 校正
-    if (processedImage->bits == 8) {
-        // 8-bit RGB 数据，直接复制
-        outData.resize(pixelCount * 3);
-        memcpy(outData.data(), processedImage->data, pixelCount * 3);
-    } else if (processedImage->bits == 16) {
-        // 16-bit RGB 数据，需要转换为 8-bit
-        outData.resize(pixelCount * 3);
-        const uint16_t* srcData = reinterpret_cast<const uint16_t*>(processedImage->data);
-        for (uint32_t i = 0; i < pixelCount; ++i) {
-            outData[i * 3 + 0] = static_cast<uint8_t>(srcData[i * 3 + 0] >> 8);  // R
-            outData[i * 3 + 1] = static_cast<uint8_t>(srcData[i * 3 + 1] >> 8);  // G
-            outData[i * 3 + 2] = static_cast<uint8_t>(srcData[i * 3 + 2] >> 8);  // B
+    // filters 每两位描述一个位置的颜色（8 行 x 2 列），要求按 2x2 重复；颜色 3 是第二个绿色
+    auto rawColor = [filters](int row, int col) {
+        return static_cast<int>((filters >> ((((row << 1) & 14) | (col & 1)) << 1)) & 3);
+    };
+    for (int row = 2; row < 8; ++row) {
+        for (int col = 0; col < 2; ++col) {
+            if (rawColor(row, col) != rawColor(row & 1, col)) {
+                return false;
+            }
         }
-    } else {
-        m_LastError = "Unsupported bit depth";
-        processor->dcraw_clear_mem(processedImage);
+    }
+
+    // 每个位置的黑电平：公共值 + 按颜色的值 + 按位置的图案（cblack[4] x cblack[5]，只支持能按 2x2 重复的图案）
+    const unsigned patternRows = data.color.cblack[4];
+    const unsigned patternCols = data.color.cblack[5];
+    const bool hasPattern = patternRows > 0 && patternCols > 0;
+    if (hasPattern && (2 % patternRows != 0 || 2 % patternCols != 0)) {
         return false;
     }
 
+    // 使用相机白平衡（与 RunProcessing 的 use_camera_wb = 1 相同），无效时退回日光白平衡
+    const float* multipliers = data.color.cam_mul[0] > 0.00001f ? data.color.cam_mul : data.color.pre_mul;
+
+    const size_t rawPitch = data.sizes.raw_pitch / sizeof(uint16_t);
+    outParams.RawData = data.rawdata.raw_image + data.sizes.top_margin * rawPitch + data.sizes.left_margin;
+    outParams.RawPitch = rawPitch;
+    outParams.Width = data.sizes.width;
+    outParams.Height = data.sizes.height;
+    for (int row = 0; row < 2; ++row) {
+        for (int col = 0; col < 2; ++col) {
+            const int color = rawColor(row, col);
+            outParams.Pattern[row][col] = static_cast<uint8_t>(color == 3 ? 1 : color);
+            float black = static_cast<float>(data.color.black + data.color.cblack[color]);
+            if (hasPattern) {
+                black += data.color.cblack[6 + (row % patternRows) * patternCols + col % patternCols];
+            }
+            outParams.Black[row][col] = black;
+        }
+    }
+    outParams.WhiteLevel = static_cast<float>(data.color.maximum);
+    for (int c = 0; c < 3; ++c) {
+        outParams.Multipliers[c] = (c == 1 && multipliers[1] <= 0.0f) ? 1.0f : multipliers[c];
+        for (int k = 0; k < 3; ++k) {
+            outParams.CameraToRGB[c][k] = data.color.rgb_cam[c][k];
+        }
+    }
+    outParams.Flip = data.sizes.flip;
+    outParams.HalfSize = halfSize;
+    outParams.Algorithm = m_DemosaicAlgorithm;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LibRawWrapper::ProcessRAWDirect(int outputBps, bool halfSize, const ProcessedImageConsumer& consumer) {
+    if (!EnsureUnpacked()) {
+        return false;
+    }
+
+#ifdef LIBRAW_AVAILABLE
+    // Bayer 传感器：自有的多线程显影，不经过 raw2image / dcraw_process
+    BayerDevelopParams bayerParams;
+    if (FillBayerParams(halfSize, bayerParams)) {
+        std::vector<uint8_t> rgbData;
+        uint32_t width = 0, height = 0;
+        if (!BayerDemosaic::Develop(bayerParams, static_cast<uint32_t>(outputBps), rgbData, width, height)) {
+            m_LastError = "Failed to demosaic RAW data";
+            return false;
+        }
+        m_LastError.clear();
+        const bool success = consumer(rgbData.data(), width, height, static_cast<uint32_t>(outputBps));
+        if (!success && m_LastError.empty()) {
+            m_LastError = "Failed to convert processed image";
+        }
+        return success;
+    }
+
+    LibRaw* processor = reinterpret_cast<LibRaw*>(m_Processor);
+    libraw_processed_image_t* processedImage = reinterpret_cast<libraw_processed_image_t*>(RunProcessing(halfSize, outputBps));
+    if (!processedImage) {
+        return false;
+    }
+
+    bool success = false;
+    if (processedImage->bits != 8 && processedImage->bits != 16) {
+        m_LastError = "Unsupported bit depth";
+    } else {
+        m_LastError.clear();
+        success = consumer(processedImage->data, processedImage->width, processedImage->height, processedImage->bits);
+        if (!success && m_LastError.empty()) {
+            m_LastError = "Failed to convert processed image";
+        }
+    }
+
     // 清理内存
     processor->dcraw_clear_mem(processedImage);
-    return true;
+    return success;
+#else
+    // 占位实现
+    m_LastError = "LibRaw not integrated";
+    return false;
+#endif
+}
+
+bool LibRawWrapper::ProcessRAW(std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight, bool halfSize) {
+    return ProcessRAWDirect(8, halfSize, [&](const uint8_t* data, uint32_t width, uint32_t height, uint32_t bits) {
+        outWidth = width;
+        outHeight = height;
+        const size_t valueCount = static_cast<size_t>(width) * height * 3;
+        outData.resize(valueCount);
+
+        // dcraw_make_mem_image 已经通过 color.curve 应用了 gamma 校正
+        if (bits == 8) {
+            memcpy(outData.data(), data, valueCount);
+        } else {
+            // 16-bit RGB 数据，需要转换为 8-bit
+            const uint16_t* srcData = reinterpret_cast<const uint16_t*>(data);
+            for (size_t i = 0; i < valueCount; ++i) {
+                outData[i] = static_cast<uint8_t>(srcData[i] >> 8);
+            }
+        }
+        return true;
+    });
+}
+
+bool LibRawWrapper::ProcessRAW16(std::vector<uint16_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    return ProcessRAWDirect(16, false, [&](const uint8_t* data, uint32_t width, uint32_t height, uint32_t bits) {
+        if (bits != 16) {
+            m_LastError = "Unsupported bit depth";
+            return false;
+        }
+        outWidth = width;
+        outHeight = height;
+        const size_t valueCount = static_cast<size_t>(width) * height * 3;
+        outData.resize(valueCount);
+        memcpy(outData.data(), data, valueCount * sizeof(uint16_t));
+        return true;
+    });
+}
+
+bool LibRawWrapper::ExtractEmbeddedThumbnail(const std::wstring& filePath, EmbeddedThumbnail& outThumbnail) {
+    // 只解析文件头，不调用 unpack()
+    if (!OpenFile(filePath, false)) {
+        return false;
+    }
+
+    bool success = ExtractEmbeddedThumbnail(outThumbnail);
+
+#ifdef LIBRAW_AVAILABLE
+    reinterpret_cast<LibRaw*>(m_Processor)->recycle();
+#endif
+    m_IsOpen = false;
+    return success;
+}
+
+bool LibRawWrapper::ExtractEmbeddedThumbnail(EmbeddedThumbnail& outThumbnail) {
+    if (!m_IsOpen) {
+        m_LastError = "No file opened";
+        return false;
+    }
+
+#ifdef LIBRAW_AVAILABLE
+    LibRaw* processor = reinterpret_cast<LibRaw*>(m_Processor);
+
+    int ret = processor->unpack_thumb();
+    if (ret != LIBRAW_SUCCESS) {
+        m_LastError = "Failed to unpack thumbnail: ";
+        m_LastError += libraw_strerror(ret);
+        return false;
+    }
+
+    libraw_processed_image_t* thumbnail = processor->dcraw_make_mem_thumb(&ret);
+    if (ret != LIBRAW_SUCCESS || !thumbnail) {
+        m_LastError = "Failed to make memory thumbnail";
+        return false;
+    }
+
+    bool success = true;
+    if (thumbnail->type == LIBRAW_IMAGE_JPEG) {
+        outThumbnail.IsJPEG = true;
+        outThumbnail.Width = processor->imgdata.thumbnail.twidth;
+        outThumbnail.Height = processor->imgdata.thumbnail.theight;
+        outThumbnail.Data.assign(thumbnail->data, thumbnail->data + thumbnail->data_size);
+    } else if (thumbnail->type == LIBRAW_IMAGE_BITMAP && thumbnail->colors == 3 && thumbnail->bits == 8) {
+        outThumbnail.IsJPEG = false;
+        outThumbnail.Width = thumbnail->width;
+        outThumbnail.Height = thumbnail->height;
+        outThumbnail.Data.assign(thumbnail->data, thumbnail->data + static_cast<size_t>(thumbnail->width) * thumbnail->height * 3);
+    } else {
+        m_LastError = "Unsupported thumbnail format";
+        success = false;
+    }
+    outThumbnail.Flip = processor->imgdata.sizes.flip;
+
+    processor->dcraw_clear_mem(thumbnail);
+    return success;
 #else
     // 占位实现
     m_LastError = "LibRaw not integrated";
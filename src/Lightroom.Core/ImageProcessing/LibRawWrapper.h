@@ -1,9 +1,11 @@
 ﻿#pragma once
 
 #include "RAWImageInfo.h"
+#include "BayerDemosaic.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 
 #ifdef LIBRAW_AVAILABLE
 #ifndef WIN32_LEAN_AND_MEAN
@@ -23,6 +25,15 @@
 
 namespace LightroomCore {
 
+// RAW 文件内嵌的预览图
+struct EmbeddedThumbnail {
+    std::vector<uint8_t> Data;  // JPEG 码流，或 8-bit RGB 像素
+    bool IsJPEG = false;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    int Flip = 0;               // LibRaw sizes.flip：0=不旋转，3=180°，5=逆时针 90°，6=顺时针 90°
+};
+
 // LibRaw 包装类，提供简化的接口
 class LibRawWrapper {
 public:
@@ -30,7 +41,8 @@ public:
     ~LibRawWrapper();
 
     // 打开 RAW 文件
-    bool OpenFile(const std::wstring& filePath);
+    // unpackData 为 false 时只解析文件头（元数据、内嵌预览可用），RAW 数据在首次处理时再解包
+    bool OpenFile(const std::wstring& filePath, bool unpackData = true);
 
     // 提取元数据
     bool ExtractMetadata(RAWImageInfo& outInfo);
@@ -40,8 +52,32 @@ public:
     bool UnpackRAW(std::vector<uint16_t>& outData, uint32_t& outWidth, uint32_t& outHeight);
 
     // 处理 RAW 数据（解包 + 去马赛克 + 转换为 RGB）
+    // Bayer 传感器使用多线程的 BayerDemosaic，其他传感器（X-Trans、Foveon、线性 DNG 等）回退到 LibRaw 的 dcraw_process
     // 返回 8-bit RGB 数据
-    bool ProcessRAW(std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight);
+    // halfSize 为 true 时每个 2x2 Bayer 单元直接合成一个像素（半分辨率，无需插值），用于快速预览
+    bool ProcessRAW(std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight, bool halfSize = false);
+
+    // 与 ProcessRAW 相同的处理（同一 gamma 曲线），但保留 16-bit 精度，用于高精度管线
+    // 返回 16-bit RGB 数据（紧密排列）
+    bool ProcessRAW16(std::vector<uint16_t>& outData, uint32_t& outWidth, uint32_t& outHeight);
+
+    // 处理结果的只读视图：data 指向 LibRaw 内部的 RGB 缓冲区（紧密排列，bits 为 8 或 16），
+    // 只在回调期间有效；回调返回 false 表示失败
+    using ProcessedImageConsumer = std::function<bool(const uint8_t* data, uint32_t width, uint32_t height, uint32_t bits)>;
+
+    // 与 ProcessRAW / ProcessRAW16 相同的处理，但不复制结果，调用者直接从 LibRaw 的缓冲区转换到最终格式
+    bool ProcessRAWDirect(int outputBps, bool halfSize, const ProcessedImageConsumer& consumer);
+
+    // 只读取内嵌预览图（不解包 RAW 数据），用于快速生成缩略图
+    // 独立于 OpenFile，调用后需要重新 OpenFile 才能处理 RAW 数据
+    bool ExtractEmbeddedThumbnail(const std::wstring& filePath, EmbeddedThumbnail& outThumbnail);
+
+    // 读取当前已打开文件的内嵌预览图，不影响后续的 ProcessRAW
+    bool ExtractEmbeddedThumbnail(EmbeddedThumbnail& outThumbnail);
+
+    // 完整分辨率去马赛克使用的算法（默认 HighQuality；半尺寸处理不插值，不受影响）
+    void SetDemosaicAlgorithm(DemosaicAlgorithm algorithm) { m_DemosaicAlgorithm = algorithm; }
+    DemosaicAlgorithm GetDemosaicAlgorithm() const { return m_DemosaicAlgorithm; }
 
     // 获取错误信息
     const char* GetError() const;
@@ -50,10 +86,22 @@ public:
     bool IsOpen() const;
 
 private:
+    // 确保 RAW 数据已解包（OpenFile 时未解包的情况）
+    bool EnsureUnpacked();
+
+    // 设置处理参数并执行去马赛克，返回 libraw_processed_image_t*（失败时为 nullptr）
+    // 调用者负责 dcraw_clear_mem
+    void* RunProcessing(bool halfSize, int outputBps);
+
+    // 从解包后的数据填充 Bayer 显影参数；不是标准 2x2 Bayer 排列时返回 false（不设置错误），由调用者回退到 LibRaw
+    bool FillBayerParams(bool halfSize, BayerDevelopParams& outParams) const;
+
     void* m_Processor;  // LibRaw* (当 LIBRAW_AVAILABLE 时)
     void* m_Data;       // libraw_data_t* (当 LIBRAW_AVAILABLE 时)
     std::string m_LastError;
     bool m_IsOpen;
+    bool m_IsUnpacked;
+    DemosaicAlgorithm m_DemosaicAlgorithm;
 };
 
 } // namespace LightroomCore
@@ -0,0 +1,253 @@
+﻿// 缩略图相关 API 实现
+// 此文件包含持久化缩略图缓存的 SDK API 实现
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+
+#include "../LightroomSDK.h"
+#include "../LightroomSDK_Internal.h"
+#include "ImageProcessor.h"
+#include "ThumbnailCache.h"
+#include "ThumbnailWorkerPool.h"
+#include "../VideoProcessing/FFmpegSoftwareVideoLoader.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstring>
+
+// 缩略图缓存（首次使用时在默认目录打开，可通过 SetThumbnailCacheDirectory 更改）
+static std::shared_ptr<LightroomCore::ThumbnailCache> g_ThumbnailCache;
+static std::mutex g_ThumbnailCacheMutex;
+
+// 进行中的批量生成任务（用于取消）
+struct ThumbnailBatch {
+    std::atomic<bool> Cancelled{ false };
+    std::atomic<uint32_t> Remaining{ 0 };
+    ThumbnailBatchCallback Callback = nullptr;
+    void* UserData = nullptr;
+    uint32_t MaxWidth = 0;
+    uint32_t MaxHeight = 0;
+};
+static std::unordered_map<uint32_t, std::shared_ptr<ThumbnailBatch>> g_ThumbnailBatches;
+static std::mutex g_ThumbnailBatchesMutex;
+static std::atomic<uint32_t> g_NextThumbnailBatchId{ 1 };
+
+static std::wstring Utf8ToWide(const char* text) {
+    int length = MultiByteToWideChar(CP_UTF8, 0, text, -1, nullptr, 0);
+    if (length <= 0) {
+        return std::wstring();
+    }
+    std::wstring result(length - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text, -1, &result[0], length);
+    return result;
+}
+
+static std::wstring GetDefaultThumbnailCacheDirectory() {
+    wchar_t buffer[MAX_PATH];
+    DWORD length = GetEnvironmentVariableW(L"LOCALAPPDATA", buffer, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH) {
+        length = GetTempPathW(MAX_PATH, buffer);
+        if (length == 0 || length >= MAX_PATH) {
+            return std::wstring();
+        }
+    }
+    std::wstring directory(buffer, length);
+    if (directory.back() != L'\\') {
+        directory += L'\\';
+    }
+    return directory + L"Lightroom\\ThumbnailCache";
+}
+
+// 返回共享指针：SetThumbnailCacheDirectory 替换缓存时，正在使用旧缓存的调用仍然安全
+std::shared_ptr<LightroomCore::ThumbnailCache> GetThumbnailCache() {
+    std::lock_guard<std::mutex> lock(g_ThumbnailCacheMutex);
+    if (!g_ThumbnailCache) {
+        g_ThumbnailCache = std::make_shared<LightroomCore::ThumbnailCache>();
+        std::wstring directory = GetDefaultThumbnailCacheDirectory();
+        if (directory.empty() || !g_ThumbnailCache->Open(directory)) {
+            std::cerr << "[SDK] Thumbnail cache unavailable" << std::endl;
+        }
+    }
+    return g_ThumbnailCache->IsOpen() ? g_ThumbnailCache : nullptr;
+}
+
+void CloseThumbnailCache() {
+    {
+        // 未开始的批量任务直接以失败回调结束
+        std::lock_guard<std::mutex> lock(g_ThumbnailBatchesMutex);
+        for (auto& batch : g_ThumbnailBatches) {
+            batch.second->Cancelled = true;
+        }
+    }
+    // 等待队列中的任务全部回调（已取消的只做失败回调）并回收工作线程，之后不会再有回调
+    LightroomCore::ThumbnailWorkerPool::Shutdown();
+
+    std::lock_guard<std::mutex> lock(g_ThumbnailCacheMutex);
+    g_ThumbnailCache.reset();
+}
+
+// 生成一张缩略图：先查询缓存，未命中时在 CPU 上解码（不使用 RHI，可在工作线程上调用）并写入缓存
+// 图片：RAW 使用内嵌预览，JPEG 按 1/2、1/4、1/8 分辨率解码；视频：只解码第一个关键帧
+static bool GenerateThumbnail(const std::wstring& wFilePath, const char* filePath, uint32_t maxWidth, uint32_t maxHeight,
+                              std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    auto cache = GetThumbnailCache();
+    LightroomCore::ThumbnailCacheKey key;
+    const bool hasKey = cache && LightroomCore::ThumbnailCache::MakeKey(wFilePath, filePath, maxWidth, maxHeight, key);
+    if (hasKey && cache->Lookup(key, outWidth, outHeight, nullptr, 0)) {
+        outData.resize(static_cast<size_t>(outWidth) * outHeight * 4);
+        if (cache->Lookup(key, outWidth, outHeight, outData.data(), outData.size())) {
+            return true;
+        }
+    }
+
+    bool generated = false;
+    if (IsVideoFormat(filePath)) {
+        generated = LightroomCore::FFmpegSoftwareVideoLoader::DecodeKeyframeThumbnail(
+            wFilePath, maxWidth, maxHeight, outData, outWidth, outHeight);
+    } else {
+        generated = LightroomCore::ImageProcessor::LoadThumbnail(wFilePath, maxWidth, maxHeight, outData, outWidth, outHeight);
+    }
+
+    if (generated && hasKey) {
+        cache->Store(key, outData.data(), outWidth, outHeight);
+    }
+    return generated;
+}
+
+bool SetThumbnailCacheDirectory(const char* directory) {
+    if (!directory) {
+        return false;
+    }
+
+    std::wstring wDirectory = Utf8ToWide(directory);
+    if (wDirectory.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_ThumbnailCacheMutex);
+    g_ThumbnailCache = std::make_shared<LightroomCore::ThumbnailCache>();
+    return g_ThumbnailCache->Open(wDirectory);
+}
+
+bool GetCachedThumbnail(const char* filePath, uint32_t maxDimension, uint32_t* outWidth, uint32_t* outHeight, uint8_t* outData, uint32_t outDataSize) {
+    if (!filePath || !outWidth || !outHeight || maxDimension == 0) {
+        return false;
+    }
+
+    auto cache = GetThumbnailCache();
+    if (!cache) {
+        return false;
+    }
+
+    LightroomCore::ThumbnailCacheKey key;
+    if (!LightroomCore::ThumbnailCache::MakeKey(Utf8ToWide(filePath), filePath, maxDimension, maxDimension, key)) {
+        return false;
+    }
+    return cache->Lookup(key, *outWidth, *outHeight, outData, outDataSize);
+}
+
+bool GetThumbnail(const char* filePath, uint32_t maxDimension, uint32_t* outWidth, uint32_t* outHeight, uint8_t* outData, uint32_t outDataSize) {
+    if (!filePath || !outWidth || !outHeight || !outData || maxDimension == 0) {
+        return false;
+    }
+
+    try {
+        std::vector<uint8_t> thumbnailData;
+        uint32_t width, height;
+        if (!GenerateThumbnail(Utf8ToWide(filePath), filePath, maxDimension, maxDimension, thumbnailData, width, height)) {
+            return false;
+        }
+
+        *outWidth = width;
+        *outHeight = height;
+        if (outDataSize < thumbnailData.size()) {
+            return false;
+        }
+        memcpy(outData, thumbnailData.data(), thumbnailData.size());
+        return true;
+    }
+    catch (const std::exception& e) {
+        return false;
+    }
+}
+
+uint32_t GenerateThumbnailsBatch(const char** filePaths, uint32_t count, uint32_t maxWidth, uint32_t maxHeight, ThumbnailBatchCallback callback, void* userData) {
+    if (!filePaths || count == 0 || !callback || maxWidth == 0 || maxHeight == 0) {
+        return 0;
+    }
+
+    auto batch = std::make_shared<ThumbnailBatch>();
+    batch->Callback = callback;
+    batch->UserData = userData;
+    batch->MaxWidth = maxWidth;
+    batch->MaxHeight = maxHeight;
+    batch->Remaining = count;
+
+    const uint32_t batchId = g_NextThumbnailBatchId.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(g_ThumbnailBatchesMutex);
+        g_ThumbnailBatches[batchId] = batch;
+    }
+
+    // 调用返回后路径数组可能被释放，每个任务持有自己的副本
+    std::vector<LightroomCore::ThumbnailWorkerPool::Task> tasks;
+    tasks.reserve(count);
+    for (uint32_t index = 0; index < count; ++index) {
+        std::string path = filePaths[index] ? filePaths[index] : "";
+        tasks.push_back([batch, batchId, index, path]() {
+            std::vector<uint8_t> thumbnailData;
+            uint32_t width = 0, height = 0;
+            bool success = false;
+            if (!batch->Cancelled && !path.empty()) {
+                try {
+                    success = GenerateThumbnail(Utf8ToWide(path.c_str()), path.c_str(), batch->MaxWidth, batch->MaxHeight,
+                                                thumbnailData, width, height);
+                }
+                catch (const std::exception& e) {
+                    success = false;
+                }
+            }
+
+            // 完成顺序与提交顺序无关，index 对应 filePaths 中的位置
+            batch->Callback(batchId, index, path.c_str(), success,
+                            success ? width : 0, success ? height : 0,
+                            success ? thumbnailData.data() : nullptr, batch->UserData);
+
+            if (batch->Remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(g_ThumbnailBatchesMutex);
+                g_ThumbnailBatches.erase(batchId);
+            }
+        });
+    }
+
+    if (!LightroomCore::ThumbnailWorkerPool::Get().Submit(std::move(tasks))) {
+        // SDK 正在关闭：任务未执行，不会有回调
+        std::lock_guard<std::mutex> lock(g_ThumbnailBatchesMutex);
+        g_ThumbnailBatches.erase(batchId);
+        return 0;
+    }
+    return batchId;
+}
+
+void CancelThumbnailBatch(uint32_t batchId) {
+    std::lock_guard<std::mutex> lock(g_ThumbnailBatchesMutex);
+    auto it = g_ThumbnailBatches.find(batchId);
+    if (it != g_ThumbnailBatches.end()) {
+        it->second->Cancelled = true;
+    }
+}
+
+bool ClearThumbnailCache() {
+    auto cache = GetThumbnailCache();
+    return cache && cache->Clear();
+}
@@ -0,0 +1,90 @@
+﻿#include "PixelConversion.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <intrin.h>
+#include <immintrin.h>
+
+namespace LightroomCore {
+
+namespace {
+
+// 每个行带至少处理的行数（太小的行带调度开销大于转换本身）
+constexpr int32_t kMinRowsPerBand = 16;
+
+bool DetectSSSE3() {
+    int info[4] = { 0, 0, 0, 0 };
+    __cpuid(info, 0);
+    if (info[0] < 1) {
+        return false;
+    }
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+}
+
+void ConvertRGBRowToBGRAScalar(const uint8_t* source, uint8_t* destination, size_t pixelCount) {
+    for (size_t i = 0; i < pixelCount; ++i) {
+        destination[i * 4 + 0] = source[i * 3 + 2];  // B
+        destination[i * 4 + 1] = source[i * 3 + 1];  // G
+        destination[i * 4 + 2] = source[i * 3 + 0];  // R
+        destination[i * 4 + 3] = 255;                // A
+    }
+}
+
+void ConvertRGBRowToBGRASSSE3(const uint8_t* source, uint8_t* destination, size_t pixelCount) {
+    // 4 个 RGB 像素（12 字节）-> 4 个 BGRA 像素，A 位置先填 0 再与 alpha 掩码相或
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+    size_t i = 0;
+    for (; i + 16 <= pixelCount; i += 16) {
+        // 16 个像素正好是 3 个 16 字节的加载
+        const __m128i* src = reinterpret_cast<const __m128i*>(source + i * 3);
+        const __m128i in0 = _mm_loadu_si128(src + 0);   // 字节 0-15
+        const __m128i in1 = _mm_loadu_si128(src + 1);   // 字节 16-31
+        const __m128i in2 = _mm_loadu_si128(src + 2);   // 字节 32-47
+
+        const __m128i pixels0 = in0;                        // 像素 0-3：字节 0-11
+        const __m128i pixels1 = _mm_alignr_epi8(in1, in0, 12);  // 像素 4-7：字节 12-23
+        const __m128i pixels2 = _mm_alignr_epi8(in2, in1, 8);   // 像素 8-11：字节 24-35
+        const __m128i pixels3 = _mm_srli_si128(in2, 4);         // 像素 12-15：字节 36-47
+
+        __m128i* dst = reinterpret_cast<__m128i*>(destination + i * 4);
+        _mm_storeu_si128(dst + 0, _mm_or_si128(_mm_shuffle_epi8(pixels0, shuffle), alpha));
+        _mm_storeu_si128(dst + 1, _mm_or_si128(_mm_shuffle_epi8(pixels1, shuffle), alpha));
+        _mm_storeu_si128(dst + 2, _mm_or_si128(_mm_shuffle_epi8(pixels2, shuffle), alpha));
+        _mm_storeu_si128(dst + 3, _mm_or_si128(_mm_shuffle_epi8(pixels3, shuffle), alpha));
+    }
+    ConvertRGBRowToBGRAScalar(source + i * 3, destination + i * 4, pixelCount - i);
+}
+
+} // namespace
+
+bool IsSSSE3Supported() {
+    static const bool s_Supported = DetectSSSE3();
+    return s_Supported;
+}
+
+void ConvertRGBRowToBGRA(const uint8_t* source, uint8_t* destination, size_t pixelCount) {
+    if (IsSSSE3Supported()) {
+        ConvertRGBRowToBGRASSSE3(source, destination, pixelCount);
+    } else {
+        ConvertRGBRowToBGRAScalar(source, destination, pixelCount);
+    }
+}
+
+void ConvertRGBToBGRA(const uint8_t* source, size_t sourceStride,
+                      uint8_t* destination, size_t destinationStride,
+                      uint32_t width, uint32_t height) {
+    if (!source || !destination || width == 0 || height == 0) {
+        return;
+    }
+
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(height), kMinRowsPerBand,
+        [=](int32_t beginRow, int32_t endRow) {
+            for (int32_t y = beginRow; y < endRow; ++y) {
+                ConvertRGBRowToBGRA(source + static_cast<size_t>(y) * sourceStride,
+                                    destination + static_cast<size_t>(y) * destinationStride, width);
+            }
+        });
+}
+
+} // namespace LightroomCore
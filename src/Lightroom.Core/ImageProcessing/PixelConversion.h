@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace LightroomCore {
+
+// 8-bit 像素格式转换
+// RGB8（LibRaw、WIC 24bpp 输出）-> BGRA8（PF_B8G8R8A8 纹理）
+// 支持 SSSE3 的 CPU 上用字节重排指令每次转换 16 个像素，否则使用标量路径
+
+// 当前 CPU 是否支持 SSSE3（首次调用时检测 CPUID）
+bool IsSSSE3Supported();
+
+// 转换一行（A = 255）
+void ConvertRGBRowToBGRA(const uint8_t* source, uint8_t* destination, size_t pixelCount);
+
+// 转换整幅图像，按行带分发到 SoftwareTaskPool
+void ConvertRGBToBGRA(const uint8_t* source, size_t sourceStride,
+                      uint8_t* destination, size_t destinationStride,
+                      uint32_t width, uint32_t height);
+
+} // namespace LightroomCore
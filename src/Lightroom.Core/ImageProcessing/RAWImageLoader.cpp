@@ -10,15 +10,20 @@
 #include <windows.h>
 
 #include "RAWImageLoader.h"
+#include "StandardImageLoader.h"
+#include "HalfFloat.h"
+#include "PixelConversion.h"
 #include <iostream>
 #include <algorithm>
 #include <string>
+#include <cstring>
 
 namespace LightroomCore {
 
 RAWImageLoader::RAWImageLoader()
     : m_LastImageWidth(0)
     , m_LastImageHeight(0)
+    , m_HighPrecision(false)
 {
     // 初始化 RAW 信息
     m_RAWInfo = RAWImageInfo();
@@ -109,44 +114,243 @@ std::shared_ptr<RenderCore::RHITexture2D> RAWImageLoader::Load(
     // 当前使用选项 1，后续可以切换到选项 2
     
     // 处理 RAW 数据（去马赛克 + 转换为 RGB）
+    // 大图（全景、中画幅）：RGB 数据交给分块源持有，纹理只放缩小的代理
+    // 不再生成整幅 BGRA 副本，导出时按块转换
+    m_TileSource.reset();
+    DecodedImage decoded;
+    if (!ProcessOpenFile(*m_LibRawWrapper, m_HighPrecision, false, decoded)) {
+        return nullptr;
+    }
+
+    // 使用 RHI 接口创建纹理
+    auto texture = CreateTextureFromDecodedImage(rhi, decoded);
+    if (!texture) {
+        return nullptr;
+    }
+    m_TileSource = decoded.TileSource;
+    return texture;
+}
+
+bool RAWImageLoader::ProcessOpenFile(LibRawWrapper& wrapper, bool highPrecision, bool halfSize, DecodedImage& outImage) {
+    // 直接从 LibRaw 的输出缓冲区转换到上传缓冲区（DecodedImage::Data），不再经过中间的 RGB 副本
+    const bool success = wrapper.ProcessRAWDirect(highPrecision ? 16 : 8, halfSize,
+        [&outImage](const uint8_t* data, uint32_t width, uint32_t height, uint32_t bits) {
+            return BuildDecodedImage(data, width, height, bits, outImage);
+        });
+    if (!success) {
+        std::cerr << "[RAWImageLoader] " << wrapper.GetError() << std::endl;
+    }
+    return success;
+}
+
+bool RAWImageLoader::BuildDecodedImage(const uint8_t* rgbData, uint32_t width, uint32_t height, uint32_t bits, DecodedImage& outImage) {
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    outImage.FullWidth = width;
+    outImage.FullHeight = height;
+    outImage.TileSource.reset();
+
+    // 大图（全景、中画幅）：RGB 数据交给分块源持有，纹理只放缩小的代理
+    // 分块源和代理都是 8-bit，FP16 整幅纹理也超出尺寸限制
+    if (RequiresTiledProcessing(width, height)) {
+        std::vector<uint8_t> rgb8(pixelCount * 3);
+        if (bits == 16) {
+            const uint16_t* rgb16 = reinterpret_cast<const uint16_t*>(rgbData);
+            for (size_t i = 0; i < rgb8.size(); ++i) {
+                rgb8[i] = static_cast<uint8_t>(rgb16[i] >> 8);
+            }
+        } else {
+            memcpy(rgb8.data(), rgbData, rgb8.size());
+        }
+
+        outImage.Format = RenderCore::EPixelFormat::PF_B8G8R8A8;
+        auto source = std::make_shared<MemoryRGBTileSource>(std::move(rgb8), width, height);
+        if (!BuildProxyImage(*source, kProxyMaxDimension, kProxyMaxDimension, outImage.Data, outImage.Width, outImage.Height)) {
+            return false;
+        }
+        outImage.TileSource = source;
+        return true;
+    }
+
+    if (bits == 16) {
+        // 16-bit RGB -> RGBA FP16
+        outImage.Format = RenderCore::EPixelFormat::PF_FloatRGBA;
+        outImage.Data.resize(pixelCount * 8);
+        ConvertRGB16ToRGBAHalf(reinterpret_cast<const uint16_t*>(rgbData),
+                               reinterpret_cast<uint16_t*>(outImage.Data.data()), pixelCount);
+    } else {
+        // 转换 RGB 到 BGRA（RHI 期望的格式）
+        outImage.Format = RenderCore::EPixelFormat::PF_B8G8R8A8;
+        outImage.Data.resize(pixelCount * 4);
+        ConvertRGBToBGRA(rgbData, static_cast<size_t>(width) * 3, outImage.Data.data(), static_cast<size_t>(width) * 4, width, height);
+    }
+    outImage.Width = width;
+    outImage.Height = height;
+    return true;
+}
+
+void RAWImageLoader::GetImageInfo(uint32_t& width, uint32_t& height) const {
+    width = m_LastImageWidth;
+    height = m_LastImageHeight;
+}
+
+// 按 LibRaw 的 flip 值旋转 BGRA 图像（3=180°，5=逆时针 90°，6=顺时针 90°）
+static void ApplyFlip(std::vector<uint8_t>& data, uint32_t& width, uint32_t& height, int flip) {
+    if (flip != 3 && flip != 5 && flip != 6) {
+        return;
+    }
+
+    const bool swapAxes = (flip != 3);
+    const uint32_t rotatedWidth = swapAxes ? height : width;
+    const uint32_t rotatedHeight = swapAxes ? width : height;
+    std::vector<uint8_t> rotated(data.size());
+    const uint32_t* src = reinterpret_cast<const uint32_t*>(data.data());
+    uint32_t* dst = reinterpret_cast<uint32_t*>(rotated.data());
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint32_t dx, dy;
+            if (flip == 3) {
+                dx = width - 1 - x;
+                dy = height - 1 - y;
+            } else if (flip == 6) {
+                dx = height - 1 - y;
+                dy = x;
+            } else {
+                dx = y;
+                dy = width - 1 - x;
+            }
+            dst[static_cast<size_t>(dy) * rotatedWidth + dx] = src[static_cast<size_t>(y) * width + x];
+        }
+    }
+    data.swap(rotated);
+    width = rotatedWidth;
+    height = rotatedHeight;
+}
+
+bool RAWImageLoader::LoadThumbnail(const std::wstring& filePath, uint32_t maxWidth, uint32_t maxHeight,
+                                   std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    // 使用独立的 LibRaw 实例，不影响当前加载的图片
+    LibRawWrapper wrapper;
+
+    // 1. 优先使用相机写入的内嵌 JPEG 预览：只读取文件头和预览数据，不解包、不去马赛克
+    EmbeddedThumbnail embedded;
+    if (wrapper.ExtractEmbeddedThumbnail(filePath, embedded)) {
+        // 旋转 90° 时先按交换后的尺寸解码，旋转后再符合 maxWidth x maxHeight
+        const bool swapAxes = (embedded.Flip == 5 || embedded.Flip == 6);
+        const uint32_t decodeMaxWidth = swapAxes ? maxHeight : maxWidth;
+        const uint32_t decodeMaxHeight = swapAxes ? maxWidth : maxHeight;
+
+        // 预览图比请求的尺寸还小时（部分机型只有 160x120 的预览）回退到完整解码
+        const bool largeEnough = embedded.Width == 0 || embedded.Height == 0 ||
+                                 embedded.Width >= decodeMaxWidth || embedded.Height >= decodeMaxHeight;
+        if (largeEnough) {
+            bool decoded = false;
+            if (embedded.IsJPEG) {
+                decoded = StandardImageLoader::LoadThumbnailFromMemory(embedded.Data.data(), embedded.Data.size(),
+                                                                       decodeMaxWidth, decodeMaxHeight,
+                                                                       outData, outWidth, outHeight);
+            } else {
+                MemoryRGBTileSource source(std::move(embedded.Data), embedded.Width, embedded.Height);
+                decoded = BuildProxyImage(source, decodeMaxWidth, decodeMaxHeight, outData, outWidth, outHeight);
+            }
+            if (decoded) {
+                ApplyFlip(outData, outWidth, outHeight, embedded.Flip);
+                return true;
+            }
+        }
+    }
+
+    // 2. 没有可用的预览图：完整解码后缩小（结果会被大幅缩小，使用最快的双线性去马赛克）
+    if (!wrapper.OpenFile(filePath)) {
+        return false;
+    }
+    wrapper.SetDemosaicAlgorithm(DemosaicAlgorithm::Bilinear);
+
     std::vector<uint8_t> rgbData;
     uint32_t processedWidth, processedHeight;
-    if (!m_LibRawWrapper->ProcessRAW(rgbData, processedWidth, processedHeight)) {
+    if (!wrapper.ProcessRAW(rgbData, processedWidth, processedHeight)) {
+        return false;
+    }
+
+    // 按条带盒式缩小，同时完成 RGB -> BGRA 转换
+    MemoryRGBTileSource source(std::move(rgbData), processedWidth, processedHeight);
+    return BuildProxyImage(source,
+                           maxWidth > 0 ? maxWidth : processedWidth,
+                           maxHeight > 0 ? maxHeight : processedHeight,
+                           outData, outWidth, outHeight);
+}
+
+// 内嵌预览的长边至少达到这个尺寸才用作快速预览，否则使用半尺寸去马赛克
+static constexpr uint32_t kMinEmbeddedPreviewDimension = 1024;
+
+std::shared_ptr<RenderCore::RHITexture2D> RAWImageLoader::LoadPreview(
+    const std::wstring& filePath,
+    std::shared_ptr<RenderCore::DynamicRHI> rhi) {
+
+    if (!rhi) {
         return nullptr;
     }
 
-    // 转换 RGB 到 BGRA（RHI 期望的格式）
-    std::vector<uint8_t> bgraData(processedWidth * processedHeight * 4);
-    for (uint32_t i = 0; i < processedWidth * processedHeight; ++i) {
-        bgraData[i * 4 + 0] = rgbData[i * 3 + 2];  // B
-        bgraData[i * 4 + 1] = rgbData[i * 3 + 1];  // G
-        bgraData[i * 4 + 2] = rgbData[i * 3 + 0];  // R
-        bgraData[i * 4 + 3] = 255;                  // A
+    // 只解析文件头：元数据和内嵌预览都不需要解包 RAW 数据
+    if (!m_LibRawWrapper->OpenFile(filePath, false)) {
+        return nullptr;
+    }
+    if (!ExtractRAWMetadata(filePath)) {
+        return nullptr;
     }
+    m_TileSource.reset();
 
-    // 使用 RHI 接口创建纹理
-    uint32_t stride = processedWidth * 4;  // BGRA = 4 bytes per pixel
-    auto texture = rhi->RHICreateTexture2D(
-        RenderCore::EPixelFormat::PF_B8G8R8A8,
-        RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
-        processedWidth,
-        processedHeight,
-        1,  // NumMips
-        bgraData.data(),
-        stride
-    );
+    DecodedImage preview;
+
+    // 1. 相机写入的内嵌 JPEG 预览（通常是全尺寸或 1/4 尺寸），解码只需几十毫秒
+    EmbeddedThumbnail embedded;
+    if (m_LibRawWrapper->ExtractEmbeddedThumbnail(embedded) &&
+        std::max(embedded.Width, embedded.Height) >= kMinEmbeddedPreviewDimension) {
+        bool decoded = false;
+        if (embedded.IsJPEG) {
+            decoded = StandardImageLoader::LoadThumbnailFromMemory(embedded.Data.data(), embedded.Data.size(),
+                                                                   kProxyMaxDimension, kProxyMaxDimension,
+                                                                   preview.Data, preview.Width, preview.Height);
+        } else {
+            MemoryRGBTileSource source(std::move(embedded.Data), embedded.Width, embedded.Height);
+            decoded = BuildProxyImage(source, kProxyMaxDimension, kProxyMaxDimension,
+                                      preview.Data, preview.Width, preview.Height);
+        }
+        if (decoded) {
+            ApplyFlip(preview.Data, preview.Width, preview.Height, embedded.Flip);
+        } else {
+            preview.Data.clear();
+        }
+    }
 
+    // 2. 没有可用的预览图：半尺寸去马赛克（跳过插值，约为完整处理的 1/4 耗时）
+    if (preview.Data.empty()) {
+        if (!ProcessOpenFile(*m_LibRawWrapper, false, true, preview)) {
+            return nullptr;
+        }
+        // 半尺寸图像不作为导出源
+        preview.TileSource.reset();
+    }
+
+    auto texture = CreateTextureFromDecodedImage(rhi, preview);
     if (!texture) {
         return nullptr;
     }
+    m_LastImageWidth = preview.Width;
+    m_LastImageHeight = preview.Height;
     return texture;
 }
 
-void RAWImageLoader::GetImageInfo(uint32_t& width, uint32_t& height) const {
-    width = m_LastImageWidth;
-    height = m_LastImageHeight;
+bool RAWImageLoader::DecodeImage(const std::wstring& filePath, DecodedImage& outImage, bool highPrecision) {
+    // 使用独立的 LibRaw 实例，不影响当前加载的图片
+    LibRawWrapper wrapper;
+    if (!wrapper.OpenFile(filePath)) {
+        std::cerr << "[RAWImageLoader] " << wrapper.GetError() << std::endl;
+        return false;
+    }
+    return ProcessOpenFile(wrapper, highPrecision, false, outImage);
 }
 
+
 bool RAWImageLoader::LoadRAWData(const std::wstring& filePath,
                                  std::vector<uint16_t>& rawData,
                                  uint32_t& outWidth,
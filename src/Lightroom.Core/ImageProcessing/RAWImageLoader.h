@@ -20,9 +20,28 @@ public:
         std::shared_ptr<RenderCore::DynamicRHI> rhi) override;
     ImageFormat GetFormat() const override { return ImageFormat::RAW; }
     void GetImageInfo(uint32_t& width, uint32_t& height) const override;
+    std::shared_ptr<ITileSource> GetTileSource() const override { return m_TileSource; }
+    bool LoadThumbnail(const std::wstring& filePath, uint32_t maxWidth, uint32_t maxHeight,
+                       std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) override;
 
     // RAW-specific methods
     const RAWImageInfo& GetRAWInfo() const { return m_RAWInfo; }
+
+    // 快速预览：优先使用内嵌 JPEG 预览，没有足够大的预览时使用半尺寸去马赛克
+    // 同时提取元数据；GetImageInfo 返回预览纹理的尺寸
+    std::shared_ptr<RenderCore::RHITexture2D> LoadPreview(
+        const std::wstring& filePath,
+        std::shared_ptr<RenderCore::DynamicRHI> rhi);
+
+    // 在 CPU 上以最高质量完整解码（不创建纹理、不修改加载器状态，可在后台线程调用）
+    // 每次调用使用独立的 LibRaw 实例，多个文件可以在不同线程上同时解码（例如多个渲染目标的渐进式加载）
+    // highPrecision 为 true 时输出 RGBA FP16（见 SetHighPrecision）
+    static bool DecodeImage(const std::wstring& filePath, DecodedImage& outImage, bool highPrecision = false);
+
+    // 高精度模式：LibRaw 输出 16-bit，纹理使用 RGBA FP16（PF_FloatRGBA），调整不再作用于 8-bit 量化数据
+    // 需要分块处理的超大图仍使用 8-bit（内存占用）
+    void SetHighPrecision(bool enable) { m_HighPrecision = enable; }
+    bool IsHighPrecision() const { return m_HighPrecision; }
     
     // 加载 RAW 数据（16-bit Bayer pattern）
     // 返回 true 表示成功，rawData 包含原始 Bayer 数据
@@ -36,12 +55,23 @@ private:
     uint32_t m_LastImageWidth;
     uint32_t m_LastImageHeight;
     std::unique_ptr<LibRawWrapper> m_LibRawWrapper;
+    bool m_HighPrecision;
+
+    // 大图的全分辨率 RGB 数据（按块转换为 BGRA）
+    std::shared_ptr<ITileSource> m_TileSource;
 
     // 检查文件扩展名是否为 RAW 格式
     bool IsRAWFormat(const std::wstring& filePath) const;
 
     // 从文件路径提取元数据
     bool ExtractRAWMetadata(const std::wstring& filePath);
+
+    // LibRaw 输出的 RGB 数据（8 或 16 bit）-> 解码结果
+    // 8-bit 转为 BGRA8，16-bit 转为 RGBA FP16，大图转为分块源 + 代理图像
+    static bool BuildDecodedImage(const uint8_t* rgbData, uint32_t width, uint32_t height, uint32_t bits, DecodedImage& outImage);
+
+    // 按精度模式解码当前打开的文件（halfSize 用于快速预览）
+    static bool ProcessOpenFile(LibRawWrapper& wrapper, bool highPrecision, bool halfSize, DecodedImage& outImage);
 };
 
 } // namespace LightroomCore
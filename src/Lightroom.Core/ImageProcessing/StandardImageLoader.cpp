@@ -10,6 +10,7 @@
 #include <windows.h>
 #include <wincodec.h>
 #include <comdef.h>
+#include <wrl/client.h>
 
 #include "StandardImageLoader.h"
 #include <iostream>
@@ -20,6 +21,72 @@
 
 namespace LightroomCore {
 
+// WIC 分块源：保持解码器与格式转换器打开，按矩形区域解码为 BGRA
+class WICTileSource : public ITileSource {
+public:
+    static std::shared_ptr<WICTileSource> Open(const std::wstring& imagePath) {
+        auto source = std::make_shared<WICTileSource>();
+
+        // 初始化 WIC
+        HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&source->m_Factory));
+        if (FAILED(hr)) {
+            return nullptr;
+        }
+
+        // 创建解码器（元数据按需读取，像素按区域解码）
+        hr = source->m_Factory->CreateDecoderFromFilename(imagePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &source->m_Decoder);
+        if (FAILED(hr)) {
+            return nullptr;
+        }
+
+        // 获取第一帧
+        Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+        hr = source->m_Decoder->GetFrame(0, &frame);
+        if (FAILED(hr)) {
+            return nullptr;
+        }
+
+        UINT width, height;
+        hr = frame->GetSize(&width, &height);
+        if (FAILED(hr) || width == 0 || height == 0) {
+            return nullptr;
+        }
+        source->m_Width = width;
+        source->m_Height = height;
+
+        // 转换格式为 BGRA32
+        hr = source->m_Factory->CreateFormatConverter(&source->m_Converter);
+        if (FAILED(hr)) {
+            return nullptr;
+        }
+        hr = source->m_Converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+        if (FAILED(hr)) {
+            return nullptr;
+        }
+        return source;
+    }
+
+    uint32_t GetWidth() const override { return m_Width; }
+    uint32_t GetHeight() const override { return m_Height; }
+
+    bool ReadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                    uint8_t* dst, uint32_t dstStride) override {
+        if (!dst || x + width > m_Width || y + height > m_Height) {
+            return false;
+        }
+        WICRect rect = { static_cast<INT>(x), static_cast<INT>(y), static_cast<INT>(width), static_cast<INT>(height) };
+        const UINT bufferSize = dstStride * (height - 1) + width * 4;
+        return SUCCEEDED(m_Converter->CopyPixels(&rect, dstStride, bufferSize, dst));
+    }
+
+private:
+    Microsoft::WRL::ComPtr<IWICImagingFactory> m_Factory;
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> m_Decoder;
+    Microsoft::WRL::ComPtr<IWICFormatConverter> m_Converter;
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+};
+
 StandardImageLoader::StandardImageLoader()
     : m_LastImageWidth(0)
     , m_LastImageHeight(0)
@@ -86,16 +153,36 @@ std::shared_ptr<RenderCore::RHITexture2D> StandardImageLoader::Load(
         return nullptr;
     }
 
-    // 使用 WIC 加载图片数据
-    std::vector<uint8_t> imageData;
-    uint32_t width, height, stride;
-    if (!LoadImageDataWithWIC(filePath, imageData, width, height, stride)) {
+    // 打开 WIC 解码器
+    m_TileSource.reset();
+    auto source = WICTileSource::Open(filePath);
+    if (!source) {
         return nullptr;
     }
 
+    uint32_t width = source->GetWidth();
+    uint32_t height = source->GetHeight();
     m_LastImageWidth = width;
     m_LastImageHeight = height;
 
+    std::vector<uint8_t> imageData;
+    uint32_t stride;
+    if (RequiresTiledProcessing(width, height)) {
+        // 大图：纹理只放缩小的代理，全分辨率像素在导出时按块解码
+        if (!BuildProxyImage(*source, kProxyMaxDimension, kProxyMaxDimension, imageData, width, height)) {
+            return nullptr;
+        }
+        stride = width * 4;
+        m_TileSource = source;
+    } else {
+        // 复制像素数据
+        stride = width * 4;  // BGRA32 = 4 bytes per pixel
+        imageData.resize(static_cast<size_t>(stride) * height);
+        if (!source->ReadRegion(0, 0, width, height, imageData.data(), stride)) {
+            return nullptr;
+        }
+    }
+
     // 使用 RHI 接口创建纹理
     auto texture = rhi->RHICreateTexture2D(
         RenderCore::EPixelFormat::PF_B8G8R8A8,
@@ -118,65 +205,144 @@ void StandardImageLoader::GetImageInfo(uint32_t& width, uint32_t& height) const
     height = m_LastImageHeight;
 }
 
-bool StandardImageLoader::LoadImageDataWithWIC(const std::wstring& imagePath, 
-                                                std::vector<uint8_t>& outData,
-                                                uint32_t& outWidth, 
-                                                uint32_t& outHeight, 
-                                                uint32_t& outStride) {
-    // 初始化 WIC
-    Microsoft::WRL::ComPtr<IWICImagingFactory> wicFactory;
-    HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wicFactory));
+// 解码缩略图：支持 IWICBitmapSourceTransform 的解码器（JPEG）直接以 1/2、1/4、1/8 分辨率解码，
+// 再用 Fant 缩放到目标尺寸，避免解码整幅全分辨率图像
+static bool DecodeThumbnailFrame(IWICImagingFactory* factory, IWICBitmapFrameDecode* frame,
+                                 uint32_t maxWidth, uint32_t maxHeight,
+                                 std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    UINT width, height;
+    HRESULT hr = frame->GetSize(&width, &height);
+    if (FAILED(hr) || width == 0 || height == 0) {
+        return false;
+    }
+    ComputeFitSize(width, height, maxWidth, maxHeight, outWidth, outHeight);
+
+    Microsoft::WRL::ComPtr<IWICBitmapSource> source = frame;
+
+    Microsoft::WRL::ComPtr<IWICBitmapSourceTransform> transform;
+    if (SUCCEEDED(frame->QueryInterface(IID_PPV_ARGS(&transform)))) {
+        // 选择不小于目标尺寸的最小缩放级别
+        UINT reducedWidth = width;
+        UINT reducedHeight = height;
+        for (UINT divisor = 8; divisor > 1; divisor /= 2) {
+            UINT candidateWidth = (width + divisor - 1) / divisor;
+            UINT candidateHeight = (height + divisor - 1) / divisor;
+            if (candidateWidth >= outWidth && candidateHeight >= outHeight &&
+                SUCCEEDED(transform->GetClosestSize(&candidateWidth, &candidateHeight)) &&
+                candidateWidth >= outWidth && candidateHeight >= outHeight) {
+                reducedWidth = candidateWidth;
+                reducedHeight = candidateHeight;
+                break;
+            }
+        }
+
+        WICPixelFormatGUID reducedFormat = GUID_WICPixelFormat32bppBGRA;
+        if ((reducedWidth != width || reducedHeight != height) &&
+            SUCCEEDED(transform->GetClosestPixelFormat(&reducedFormat))) {
+            Microsoft::WRL::ComPtr<IWICComponentInfo> componentInfo;
+            Microsoft::WRL::ComPtr<IWICPixelFormatInfo> formatInfo;
+            UINT bitsPerPixel = 0;
+            if (SUCCEEDED(factory->CreateComponentInfo(reducedFormat, &componentInfo)) &&
+                SUCCEEDED(componentInfo.As(&formatInfo)) &&
+                SUCCEEDED(formatInfo->GetBitsPerPixel(&bitsPerPixel)) && bitsPerPixel > 0) {
+                const UINT stride = (reducedWidth * bitsPerPixel + 7) / 8;
+                std::vector<uint8_t> reduced(static_cast<size_t>(stride) * reducedHeight);
+                Microsoft::WRL::ComPtr<IWICBitmap> reducedBitmap;
+                if (SUCCEEDED(transform->CopyPixels(nullptr, reducedWidth, reducedHeight, &reducedFormat,
+                                                    WICBitmapTransformRotate0, stride,
+                                                    static_cast<UINT>(reduced.size()), reduced.data())) &&
+                    SUCCEEDED(factory->CreateBitmapFromMemory(reducedWidth, reducedHeight, reducedFormat, stride,
+                                                              static_cast<UINT>(reduced.size()), reduced.data(),
+                                                              &reducedBitmap))) {
+                    source = reducedBitmap;
+                }
+            }
+        }
+    }
+
+    // 缩放在解码管线内完成，不需要整幅全分辨率缓冲区
+    Microsoft::WRL::ComPtr<IWICBitmapScaler> scaler;
+    hr = factory->CreateBitmapScaler(&scaler);
+    if (FAILED(hr)) {
+        return false;
+    }
+    hr = scaler->Initialize(source.Get(), outWidth, outHeight, WICBitmapInterpolationModeFant);
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+    hr = factory->CreateFormatConverter(&converter);
+    if (FAILED(hr)) {
+        return false;
+    }
+    hr = converter->Initialize(scaler.Get(), GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    const UINT stride = outWidth * 4;
+    outData.resize(static_cast<size_t>(stride) * outHeight);
+    hr = converter->CopyPixels(nullptr, stride, static_cast<UINT>(outData.size()), outData.data());
+    return SUCCEEDED(hr);
+}
+
+bool StandardImageLoader::LoadThumbnail(const std::wstring& filePath, uint32_t maxWidth, uint32_t maxHeight,
+                                        std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    Microsoft::WRL::ComPtr<IWICImagingFactory> factory;
+    HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
     if (FAILED(hr)) {
         return false;
     }
 
-    // 创建解码器
     Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
-    hr = wicFactory->CreateDecoderFromFilename(imagePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder);
+    hr = factory->CreateDecoderFromFilename(filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
     if (FAILED(hr)) {
         return false;
     }
 
-    // 获取第一帧
     Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
     hr = decoder->GetFrame(0, &frame);
     if (FAILED(hr)) {
         return false;
     }
+    return DecodeThumbnailFrame(factory.Get(), frame.Get(), maxWidth, maxHeight, outData, outWidth, outHeight);
+}
 
-    // 获取图片尺寸
-    UINT width, height;
-    hr = frame->GetSize(&width, &height);
-    if (FAILED(hr)) {
+bool StandardImageLoader::LoadThumbnailFromMemory(const uint8_t* data, size_t size, uint32_t maxWidth, uint32_t maxHeight,
+                                                  std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    if (!data || size == 0) {
         return false;
     }
 
-    outWidth = width;
-    outHeight = height;
-
-    // 转换格式为 BGRA32
-    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
-    hr = wicFactory->CreateFormatConverter(&converter);
+    Microsoft::WRL::ComPtr<IWICImagingFactory> factory;
+    HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
     if (FAILED(hr)) {
         return false;
     }
 
-    hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+    Microsoft::WRL::ComPtr<IWICStream> stream;
+    hr = factory->CreateStream(&stream);
+    if (FAILED(hr)) {
+        return false;
+    }
+    hr = stream->InitializeFromMemory(const_cast<BYTE*>(data), static_cast<DWORD>(size));
     if (FAILED(hr)) {
         return false;
     }
 
-    // 复制像素数据
-    outStride = width * 4;  // BGRA32 = 4 bytes per pixel
-    uint32_t bufferSize = outStride * height;
-    outData.resize(bufferSize);
-
-    hr = converter->CopyPixels(nullptr, outStride, bufferSize, outData.data());
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+    hr = factory->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &decoder);
     if (FAILED(hr)) {
         return false;
     }
 
-    return true;
+    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+    hr = decoder->GetFrame(0, &frame);
+    if (FAILED(hr)) {
+        return false;
+    }
+    return DecodeThumbnailFrame(factory.Get(), frame.Get(), maxWidth, maxHeight, outData, outWidth, outHeight);
 }
 
 } // namespace LightroomCore
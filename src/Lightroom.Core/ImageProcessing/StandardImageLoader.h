@@ -17,18 +17,21 @@ public:
         std::shared_ptr<RenderCore::DynamicRHI> rhi) override;
     ImageFormat GetFormat() const override { return ImageFormat::Standard; }
     void GetImageInfo(uint32_t& width, uint32_t& height) const override;
+    std::shared_ptr<ITileSource> GetTileSource() const override { return m_TileSource; }
+    bool LoadThumbnail(const std::wstring& filePath, uint32_t maxWidth, uint32_t maxHeight,
+                       std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) override;
 
-private:
-    // 使用 WIC 加载图片数据到内存
-    bool LoadImageDataWithWIC(const std::wstring& imagePath, 
-                               std::vector<uint8_t>& outData, 
-                               uint32_t& outWidth, 
-                               uint32_t& outHeight, 
-                               uint32_t& outStride);
+    // 从内存中的编码图片（例如 RAW 内嵌的 JPEG 预览）解码缩略图
+    static bool LoadThumbnailFromMemory(const uint8_t* data, size_t size, uint32_t maxWidth, uint32_t maxHeight,
+                                        std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight);
 
+private:
     uint32_t m_LastImageWidth;
     uint32_t m_LastImageHeight;
 
+    // 大图的 WIC 分块源（保持解码器打开，按区域解码）
+    std::shared_ptr<ITileSource> m_TileSource;
+
     // 检查文件扩展名是否为标准图片格式
     bool IsStandardImageFormat(const std::wstring& filePath) const;
 };
@@ -0,0 +1,376 @@
+﻿// 防止 Winsock 冲突 - 必须在包含任何 Windows 头文件之前
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+
+#include "ThumbnailCache.h"
+#include <iostream>
+#include <cstring>
+
+namespace LightroomCore {
+
+namespace {
+
+constexpr uint32_t kPackMagic = 0x4B505254;     // 'TRPK'
+constexpr uint32_t kPackVersion = 1;
+constexpr uint32_t kRecordMagic = 0x43455254;   // 'TREC'
+constexpr uint64_t kDefaultMaxPackSize = 2ull * 1024 * 1024 * 1024;
+
+struct PackFileHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t Reserved;
+};
+
+// 每条记录：记录头 + 路径（UTF-8，无结尾 0）+ BGRA 像素
+struct PackRecordHeader {
+    uint32_t Magic;
+    uint32_t PathLength;
+    uint64_t FileSize;
+    uint64_t LastWriteTime;
+    uint32_t MaxWidth;
+    uint32_t MaxHeight;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t DataSize;
+    uint32_t Reserved;
+};
+
+static_assert(sizeof(PackFileHeader) == 16, "PackFileHeader layout changed");
+static_assert(sizeof(PackRecordHeader) == 48, "PackRecordHeader layout changed");
+
+bool RecordMatchesKey(const PackRecordHeader& record, const char* recordPath, const ThumbnailCacheKey& key) {
+    return record.FileSize == key.FileSize &&
+           record.LastWriteTime == key.LastWriteTime &&
+           record.MaxWidth == key.MaxWidth &&
+           record.MaxHeight == key.MaxHeight &&
+           record.PathLength == key.Path.size() &&
+           memcmp(recordPath, key.Path.data(), key.Path.size()) == 0;
+}
+
+bool WriteAt(HANDLE file, uint64_t offset, const void* data, size_t size) {
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(offset);
+    if (!SetFilePointerEx(file, position, nullptr, FILE_BEGIN)) {
+        return false;
+    }
+    DWORD written = 0;
+    return WriteFile(file, data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+}
+
+} // namespace
+
+ThumbnailCache::ThumbnailCache()
+    : m_File(INVALID_HANDLE_VALUE)
+    , m_Mapping(nullptr)
+    , m_View(nullptr)
+    , m_MappedSize(0)
+    , m_PackSize(0)
+    , m_MaxPackSize(kDefaultMaxPackSize)
+{
+}
+
+ThumbnailCache::~ThumbnailCache() {
+    Close();
+}
+
+bool ThumbnailCache::Open(const std::wstring& directory) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (m_File != INVALID_HANDLE_VALUE) {
+        UnmapLocked();
+        CloseHandle(m_File);
+        m_File = INVALID_HANDLE_VALUE;
+        m_Index.clear();
+    }
+
+    // 逐级创建目录
+    for (size_t pos = directory.find_first_of(L"\\/", 3); pos != std::wstring::npos;
+         pos = directory.find_first_of(L"\\/", pos + 1)) {
+        CreateDirectoryW(directory.substr(0, pos).c_str(), nullptr);
+    }
+    CreateDirectoryW(directory.c_str(), nullptr);
+
+    std::wstring packPath = directory;
+    if (!packPath.empty() && packPath.back() != L'\\' && packPath.back() != L'/') {
+        packPath += L'\\';
+    }
+    packPath += L"thumbnails.lrpack";
+
+    // 只允许一个写入者；其他进程打开失败时缓存不可用，但不影响缩略图生成
+    m_File = CreateFileW(packPath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                         nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_File == INVALID_HANDLE_VALUE) {
+        std::cerr << "[ThumbnailCache] Failed to open pack file, error " << GetLastError() << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_File, &fileSize)) {
+        CloseHandle(m_File);
+        m_File = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    m_PackSize = static_cast<uint64_t>(fileSize.QuadPart);
+
+    if (m_PackSize < sizeof(PackFileHeader) || !RemapLocked()) {
+        return ResetPackLocked();
+    }
+
+    const auto* header = reinterpret_cast<const PackFileHeader*>(m_View);
+    if (header->Magic != kPackMagic || header->Version != kPackVersion) {
+        return ResetPackLocked();
+    }
+
+    BuildIndexLocked();
+    return true;
+}
+
+void ThumbnailCache::Close() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    UnmapLocked();
+    if (m_File != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_File);
+        m_File = INVALID_HANDLE_VALUE;
+    }
+    m_Index.clear();
+    m_PackSize = 0;
+}
+
+bool ThumbnailCache::IsOpen() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_File != INVALID_HANDLE_VALUE;
+}
+
+size_t ThumbnailCache::GetEntryCount() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Index.size();
+}
+
+bool ThumbnailCache::MakeKey(const std::wstring& filePath, const std::string& utf8Path,
+                             uint32_t maxWidth, uint32_t maxHeight, ThumbnailCacheKey& outKey) {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(filePath.c_str(), GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+
+    outKey.Path = utf8Path;
+    outKey.FileSize = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    outKey.LastWriteTime = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+                           attributes.ftLastWriteTime.dwLowDateTime;
+    outKey.MaxWidth = maxWidth;
+    outKey.MaxHeight = maxHeight;
+    return true;
+}
+
+bool ThumbnailCache::Lookup(const ThumbnailCacheKey& key, uint32_t& outWidth, uint32_t& outHeight,
+                            uint8_t* outData, size_t outDataSize) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_File == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    auto it = m_Index.find(HashKey(key));
+    if (it == m_Index.end()) {
+        return false;
+    }
+
+    const uint64_t recordOffset = it->second;
+    if (recordOffset + sizeof(PackRecordHeader) > m_MappedSize) {
+        // 记录是映射之后追加的，重新映射整个文件
+        if (!RemapLocked()) {
+            return false;
+        }
+    }
+
+    PackRecordHeader record;
+    memcpy(&record, m_View + recordOffset, sizeof(record));
+    const uint64_t pathOffset = recordOffset + sizeof(PackRecordHeader);
+    const uint64_t dataOffset = pathOffset + record.PathLength;
+    if (dataOffset + record.DataSize > m_MappedSize && !RemapLocked()) {
+        return false;
+    }
+
+    // 哈希冲突时以完整键为准
+    if (!RecordMatchesKey(record, reinterpret_cast<const char*>(m_View + pathOffset), key)) {
+        return false;
+    }
+
+    outWidth = record.Width;
+    outHeight = record.Height;
+    if (!outData) {
+        return true;
+    }
+    if (outDataSize < record.DataSize) {
+        return false;
+    }
+    memcpy(outData, m_View + dataOffset, record.DataSize);
+    return true;
+}
+
+bool ThumbnailCache::Store(const ThumbnailCacheKey& key, const uint8_t* data, uint32_t width, uint32_t height) {
+    if (!data || width == 0 || height == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_File == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    PackRecordHeader record = {};
+    record.Magic = kRecordMagic;
+    record.PathLength = static_cast<uint32_t>(key.Path.size());
+    record.FileSize = key.FileSize;
+    record.LastWriteTime = key.LastWriteTime;
+    record.MaxWidth = key.MaxWidth;
+    record.MaxHeight = key.MaxHeight;
+    record.Width = width;
+    record.Height = height;
+    record.DataSize = width * height * 4;
+
+    const size_t recordSize = sizeof(PackRecordHeader) + record.PathLength + record.DataSize;
+    if (m_PackSize + recordSize > m_MaxPackSize) {
+        // 简单淘汰：包文件过大时整体清空，由后续访问重新填充
+        if (!ResetPackLocked()) {
+            return false;
+        }
+    }
+
+    // 整条记录一次写入，中断时只会留下可被截断的尾部
+    std::vector<uint8_t> buffer(recordSize);
+    memcpy(buffer.data(), &record, sizeof(record));
+    memcpy(buffer.data() + sizeof(record), key.Path.data(), record.PathLength);
+    memcpy(buffer.data() + sizeof(record) + record.PathLength, data, record.DataSize);
+
+    if (!WriteAt(m_File, m_PackSize, buffer.data(), buffer.size())) {
+        std::cerr << "[ThumbnailCache] Failed to append record, error " << GetLastError() << std::endl;
+        return false;
+    }
+
+    m_Index[HashKey(key)] = m_PackSize;
+    m_PackSize += recordSize;
+    return true;
+}
+
+bool ThumbnailCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_File == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    return ResetPackLocked();
+}
+
+bool ThumbnailCache::ResetPackLocked() {
+    UnmapLocked();
+    m_Index.clear();
+
+    PackFileHeader header = {};
+    header.Magic = kPackMagic;
+    header.Version = kPackVersion;
+    if (!WriteAt(m_File, 0, &header, sizeof(header)) || !SetEndOfFile(m_File)) {
+        std::cerr << "[ThumbnailCache] Failed to reset pack file, error " << GetLastError() << std::endl;
+        CloseHandle(m_File);
+        m_File = INVALID_HANDLE_VALUE;
+        m_PackSize = 0;
+        return false;
+    }
+    m_PackSize = sizeof(header);
+    return true;
+}
+
+bool ThumbnailCache::RemapLocked() {
+    UnmapLocked();
+    if (m_PackSize == 0) {
+        return false;
+    }
+
+    m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_Mapping) {
+        return false;
+    }
+    m_View = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_View) {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+        return false;
+    }
+    m_MappedSize = m_PackSize;
+    return true;
+}
+
+void ThumbnailCache::UnmapLocked() {
+    if (m_View) {
+        UnmapViewOfFile(m_View);
+        m_View = nullptr;
+    }
+    if (m_Mapping) {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+    }
+    m_MappedSize = 0;
+}
+
+void ThumbnailCache::BuildIndexLocked() {
+    m_Index.clear();
+
+    uint64_t offset = sizeof(PackFileHeader);
+    while (offset + sizeof(PackRecordHeader) <= m_MappedSize) {
+        PackRecordHeader record;
+        memcpy(&record, m_View + offset, sizeof(record));
+        const uint64_t recordSize = sizeof(PackRecordHeader) + record.PathLength + record.DataSize;
+        if (record.Magic != kRecordMagic ||
+            record.DataSize != static_cast<uint64_t>(record.Width) * record.Height * 4 ||
+            offset + recordSize > m_MappedSize) {
+            break;
+        }
+
+        ThumbnailCacheKey key;
+        key.Path.assign(reinterpret_cast<const char*>(m_View + offset + sizeof(PackRecordHeader)), record.PathLength);
+        key.FileSize = record.FileSize;
+        key.LastWriteTime = record.LastWriteTime;
+        key.MaxWidth = record.MaxWidth;
+        key.MaxHeight = record.MaxHeight;
+        m_Index[HashKey(key)] = offset;
+
+        offset += recordSize;
+    }
+
+    // 截断上次写入中断留下的不完整记录
+    if (offset < m_PackSize) {
+        std::cerr << "[ThumbnailCache] Truncating " << (m_PackSize - offset) << " bytes of incomplete records" << std::endl;
+        UnmapLocked();
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(offset);
+        if (SetFilePointerEx(m_File, position, nullptr, FILE_BEGIN) && SetEndOfFile(m_File)) {
+            m_PackSize = offset;
+        }
+        RemapLocked();
+    }
+}
+
+uint64_t ThumbnailCache::HashKey(const ThumbnailCacheKey& key) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(key.Path.data(), key.Path.size());
+    mix(&key.FileSize, sizeof(key.FileSize));
+    mix(&key.LastWriteTime, sizeof(key.LastWriteTime));
+    mix(&key.MaxWidth, sizeof(key.MaxWidth));
+    mix(&key.MaxHeight, sizeof(key.MaxHeight));
+    return hash;
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+namespace LightroomCore {
+
+// 缩略图缓存键：文件路径 + 文件大小 + 修改时间 + 请求的最大尺寸
+// 文件被修改后大小/时间变化，旧记录自然失效
+struct ThumbnailCacheKey {
+    std::string Path;           // UTF-8 路径
+    uint64_t FileSize = 0;
+    uint64_t LastWriteTime = 0; // FILETIME
+    uint32_t MaxWidth = 0;
+    uint32_t MaxHeight = 0;
+};
+
+// 持久化缩略图缓存
+// 所有缩略图（缩小后的 BGRA8，紧密排列）追加写入同一个包文件，文件通过内存映射读取；
+// 打开时扫描包文件建立内存索引，命中时只需一次哈希查找和一次 memcpy。
+// 包文件只追加不修改：同一键的新记录覆盖索引中的旧记录，写入中断留下的不完整尾部在下次打开时截断。
+class ThumbnailCache {
+public:
+    ThumbnailCache();
+    ~ThumbnailCache();
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+    // 打开（或创建）指定目录下的包文件
+    bool Open(const std::wstring& directory);
+    void Close();
+    bool IsOpen() const;
+
+    // 根据文件当前的大小与修改时间生成缓存键，文件不存在时返回 false
+    static bool MakeKey(const std::wstring& filePath, const std::string& utf8Path,
+                        uint32_t maxWidth, uint32_t maxHeight, ThumbnailCacheKey& outKey);
+
+    // 查找缩略图；outData 为空时只返回尺寸
+    // outDataSize 小于 width * height * 4 时返回 false（尺寸仍会写出）
+    bool Lookup(const ThumbnailCacheKey& key, uint32_t& outWidth, uint32_t& outHeight,
+                uint8_t* outData, size_t outDataSize);
+
+    // 写入缩略图（BGRA8，紧密排列）
+    bool Store(const ThumbnailCacheKey& key, const uint8_t* data, uint32_t width, uint32_t height);
+
+    // 清空缓存（截断包文件）
+    bool Clear();
+
+    // 包文件大小上限，超过后清空重建（默认 2 GB）
+    void SetMaxPackSize(uint64_t maxPackSize) { m_MaxPackSize = maxPackSize; }
+
+    size_t GetEntryCount() const;
+
+private:
+    bool ResetPackLocked();
+    bool RemapLocked();
+    void UnmapLocked();
+    void BuildIndexLocked();
+
+    static uint64_t HashKey(const ThumbnailCacheKey& key);
+
+    mutable std::mutex m_Mutex;
+    void* m_File;           // HANDLE
+    void* m_Mapping;        // HANDLE
+    const uint8_t* m_View;
+    uint64_t m_MappedSize;
+    uint64_t m_PackSize;    // 有效数据末尾（新记录的写入位置）
+    uint64_t m_MaxPackSize;
+
+    // 键哈希 -> 记录在包文件中的偏移
+    std::unordered_map<uint64_t, uint64_t> m_Index;
+};
+
+} // namespace LightroomCore
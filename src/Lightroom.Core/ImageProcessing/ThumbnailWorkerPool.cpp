@@ -0,0 +1,148 @@
+﻿#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <objbase.h>
+
+#include "ThumbnailWorkerPool.h"
+#include <algorithm>
+
+namespace LightroomCore {
+
+static std::unique_ptr<ThumbnailWorkerPool> g_ThumbnailWorkerPool;
+static std::mutex g_ThumbnailWorkerPoolMutex;
+
+ThumbnailWorkerPool& ThumbnailWorkerPool::Get() {
+    std::lock_guard<std::mutex> lock(g_ThumbnailWorkerPoolMutex);
+    if (!g_ThumbnailWorkerPool) {
+        g_ThumbnailWorkerPool = std::make_unique<ThumbnailWorkerPool>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    return *g_ThumbnailWorkerPool;
+}
+
+void ThumbnailWorkerPool::Shutdown() {
+    std::unique_ptr<ThumbnailWorkerPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(g_ThumbnailWorkerPoolMutex);
+        pool = std::move(g_ThumbnailWorkerPool);
+    }
+    // 析构函数执行完剩余任务并 join 工作线程
+    pool.reset();
+}
+
+ThumbnailWorkerPool::ThumbnailWorkerPool(uint32_t numWorkers)
+    : m_NextQueue(0)
+    , m_PendingTasks(0)
+    , m_Stop(false)
+{
+    numWorkers = std::max(1u, numWorkers);
+    m_Queues.reserve(numWorkers);
+    for (uint32_t i = 0; i < numWorkers; ++i) {
+        m_Queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    m_Workers.reserve(numWorkers);
+    for (uint32_t i = 0; i < numWorkers; ++i) {
+        m_Workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+ThumbnailWorkerPool::~ThumbnailWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Stop = true;
+    }
+    m_WakeCondition.notify_all();
+    for (auto& worker : m_Workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+bool ThumbnailWorkerPool::Submit(std::vector<Task>&& tasks) {
+    if (tasks.empty()) {
+        return true;
+    }
+    {
+        // 先计数再入队：停止中的工作线程看到计数不为 0 就不会在任务入队前退出
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        if (m_Stop) {
+            return false;
+        }
+        m_PendingTasks.fetch_add(static_cast<int64_t>(tasks.size()));
+    }
+
+    // 从上次的位置继续轮流分配，多个批次同时进行时也能均匀分布
+    const uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+    uint32_t queueIndex = m_NextQueue.fetch_add(static_cast<uint32_t>(tasks.size())) % queueCount;
+    for (auto& task : tasks) {
+        WorkerQueue& queue = *m_Queues[queueIndex];
+        {
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            queue.Tasks.push_back(std::move(task));
+        }
+        queueIndex = (queueIndex + 1) % queueCount;
+    }
+
+    m_WakeCondition.notify_all();
+    return true;
+}
+
+bool ThumbnailWorkerPool::PopLocal(uint32_t workerIndex, Task& outTask) {
+    WorkerQueue& queue = *m_Queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    if (queue.Tasks.empty()) {
+        return false;
+    }
+    outTask = std::move(queue.Tasks.front());
+    queue.Tasks.pop_front();
+    return true;
+}
+
+bool ThumbnailWorkerPool::Steal(uint32_t workerIndex, Task& outTask) {
+    const uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+    for (uint32_t offset = 1; offset < queueCount; ++offset) {
+        WorkerQueue& queue = *m_Queues[(workerIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        if (!queue.Tasks.empty()) {
+            outTask = std::move(queue.Tasks.back());
+            queue.Tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThumbnailWorkerPool::WorkerLoop(uint32_t workerIndex) {
+    // WIC 解码需要 COM
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    const bool comInitialized = SUCCEEDED(hr);
+
+    for (;;) {
+        Task task;
+        if (PopLocal(workerIndex, task) || Steal(workerIndex, task)) {
+            m_PendingTasks.fetch_sub(1);
+            task();
+            continue;
+        }
+
+        // 停止时仍要执行完队列中的任务（每个任务都负责自己的完成回调），队列为空才退出
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_WakeCondition.wait(lock, [this]() { return m_Stop || m_PendingTasks.load() > 0; });
+        if (m_Stop && m_PendingTasks.load() <= 0) {
+            break;
+        }
+    }
+
+    if (comInitialized) {
+        CoUninitialize();
+    }
+}
+
+} // namespace LightroomCore
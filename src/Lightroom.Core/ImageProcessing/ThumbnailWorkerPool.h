@@ -0,0 +1,63 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LightroomCore {
+
+// 缩略图批量生成使用的工作窃取线程池
+// 每个工作线程有自己的任务队列：从自己队列的头部取任务，空闲时从其他队列的尾部窃取，
+// 文件大小/格式差异造成的耗时不均会被自动摊平。
+// 与 SoftwareTaskPool（渲染用的并行 for）分开，长时间的解码任务不会阻塞渲染。
+class ThumbnailWorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    // SDK 内共享的线程池，线程数等于硬件线程数；首次使用（或 Shutdown 之后再次使用）时创建
+    static ThumbnailWorkerPool& Get();
+
+    // 停止共享线程池：已提交的任务全部执行完后回收工作线程（ShutdownSDK 调用）
+    // 调用前应先让任务进入取消状态，使剩余任务只做失败回调而不再解码
+    static void Shutdown();
+
+    explicit ThumbnailWorkerPool(uint32_t numWorkers);
+    ~ThumbnailWorkerPool();
+
+    ThumbnailWorkerPool(const ThumbnailWorkerPool&) = delete;
+    ThumbnailWorkerPool& operator=(const ThumbnailWorkerPool&) = delete;
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+    // 提交一批任务（轮流分配到各工作线程的队列），立即返回
+    // 线程池正在停止时不接受任务，返回 false（任务不会执行）
+    bool Submit(std::vector<Task>&& tasks);
+
+private:
+    struct WorkerQueue {
+        std::mutex Mutex;
+        std::deque<Task> Tasks;
+    };
+
+    void WorkerLoop(uint32_t workerIndex);
+    bool PopLocal(uint32_t workerIndex, Task& outTask);
+    bool Steal(uint32_t workerIndex, Task& outTask);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+    std::atomic<uint32_t> m_NextQueue;
+
+    // 队列中尚未取走的任务数，用于空闲线程休眠；停止时工作线程等到它为 0 才退出
+    std::atomic<int64_t> m_PendingTasks;
+    std::mutex m_WakeMutex;
+    std::condition_variable m_WakeCondition;
+    bool m_Stop;
+};
+
+} // namespace LightroomCore
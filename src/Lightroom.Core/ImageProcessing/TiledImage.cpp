@@ -0,0 +1,145 @@
+﻿#include "TiledImage.h"
+#include "PixelConversion.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace LightroomCore {
+
+MemoryRGBTileSource::MemoryRGBTileSource(std::vector<uint8_t>&& rgbData, uint32_t width, uint32_t height)
+    : m_RGBData(std::move(rgbData))
+    , m_Width(width)
+    , m_Height(height)
+{
+}
+
+bool MemoryRGBTileSource::ReadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                     uint8_t* dst, uint32_t dstStride) {
+    if (!dst || x + width > m_Width || y + height > m_Height ||
+        m_RGBData.size() < static_cast<size_t>(m_Width) * m_Height * 3) {
+        return false;
+    }
+
+    for (uint32_t row = 0; row < height; ++row) {
+        const uint8_t* src = m_RGBData.data() + (static_cast<size_t>(y + row) * m_Width + x) * 3;
+        ConvertRGBRowToBGRA(src, dst + static_cast<size_t>(row) * dstStride, width);
+    }
+    return true;
+}
+
+TileGrid::TileGrid(uint32_t imageWidth, uint32_t imageHeight, uint32_t tileSize, uint32_t apron)
+    : ImageWidth(imageWidth)
+    , ImageHeight(imageHeight)
+    , TileSize(tileSize > 0 ? tileSize : kDefaultTileSize)
+    , Apron(apron)
+{
+}
+
+void TileGrid::GetTileRect(uint32_t tileX, uint32_t tileY, uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const {
+    x = tileX * TileSize;
+    y = tileY * TileSize;
+    width = std::min(TileSize, ImageWidth - x);
+    height = std::min(TileSize, ImageHeight - y);
+}
+
+bool ReadPaddedTile(ITileSource& source, const TileGrid& grid, uint32_t tileX, uint32_t tileY,
+                    std::vector<uint8_t>& outData) {
+    const uint32_t padded = grid.GetPaddedTileSize();
+    const uint32_t stride = padded * 4;
+    outData.resize(static_cast<size_t>(stride) * padded);
+
+    uint32_t x, y, width, height;
+    grid.GetTileRect(tileX, tileY, x, y, width, height);
+
+    // 实际可读的区域：块内部加邻域，裁剪到图像范围
+    const uint32_t readX0 = (x > grid.Apron) ? x - grid.Apron : 0;
+    const uint32_t readY0 = (y > grid.Apron) ? y - grid.Apron : 0;
+    const uint32_t readX1 = std::min(x + width + grid.Apron, grid.ImageWidth);
+    const uint32_t readY1 = std::min(y + height + grid.Apron, grid.ImageHeight);
+
+    // 缓冲区坐标 (0, 0) 对应图像坐标 (x - Apron, y - Apron)
+    const uint32_t offsetX = readX0 + grid.Apron - x;
+    const uint32_t offsetY = readY0 + grid.Apron - y;
+    uint8_t* readDst = outData.data() + static_cast<size_t>(offsetY) * stride + offsetX * 4;
+    if (!source.ReadRegion(readX0, readY0, readX1 - readX0, readY1 - readY0, readDst, stride)) {
+        return false;
+    }
+
+    // 左右两侧按 clamp 复制边界像素
+    const uint32_t validX0 = offsetX;
+    const uint32_t validX1 = offsetX + (readX1 - readX0);
+    const uint32_t validY0 = offsetY;
+    const uint32_t validY1 = offsetY + (readY1 - readY0);
+    for (uint32_t row = validY0; row < validY1; ++row) {
+        uint8_t* line = outData.data() + static_cast<size_t>(row) * stride;
+        for (uint32_t col = 0; col < validX0; ++col) {
+            memcpy(line + col * 4, line + validX0 * 4, 4);
+        }
+        for (uint32_t col = validX1; col < padded; ++col) {
+            memcpy(line + col * 4, line + (validX1 - 1) * 4, 4);
+        }
+    }
+
+    // 上下两侧复制整行
+    for (uint32_t row = 0; row < validY0; ++row) {
+        memcpy(outData.data() + static_cast<size_t>(row) * stride,
+               outData.data() + static_cast<size_t>(validY0) * stride, stride);
+    }
+    for (uint32_t row = validY1; row < padded; ++row) {
+        memcpy(outData.data() + static_cast<size_t>(row) * stride,
+               outData.data() + static_cast<size_t>(validY1 - 1) * stride, stride);
+    }
+    return true;
+}
+
+bool BuildProxyImage(ITileSource& source, uint32_t maxWidth, uint32_t maxHeight,
+                     std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+    const uint32_t width = source.GetWidth();
+    const uint32_t height = source.GetHeight();
+    if (width == 0 || height == 0 || maxWidth == 0 || maxHeight == 0) {
+        return false;
+    }
+
+    // 整数盒式缩小：factor x factor 个源像素平均为一个代理像素
+    const uint32_t factor = std::max((width + maxWidth - 1) / maxWidth, (height + maxHeight - 1) / maxHeight);
+    outWidth = (width + factor - 1) / factor;
+    outHeight = (height + factor - 1) / factor;
+    outData.assign(static_cast<size_t>(outWidth) * outHeight * 4, 0);
+
+    const uint32_t stripStride = width * 4;
+    std::vector<uint8_t> strip(static_cast<size_t>(stripStride) * factor);
+    std::vector<uint32_t> sums(static_cast<size_t>(outWidth) * 4);
+
+    for (uint32_t outY = 0; outY < outHeight; ++outY) {
+        const uint32_t y0 = outY * factor;
+        const uint32_t rows = std::min(factor, height - y0);
+        if (!source.ReadRegion(0, y0, width, rows, strip.data(), stripStride)) {
+            std::cerr << "[TiledImage] Failed to read strip at row " << y0 << std::endl;
+            return false;
+        }
+
+        std::fill(sums.begin(), sums.end(), 0u);
+        for (uint32_t row = 0; row < rows; ++row) {
+            const uint8_t* src = strip.data() + static_cast<size_t>(row) * stripStride;
+            for (uint32_t x = 0; x < width; ++x) {
+                uint32_t* sum = &sums[(x / factor) * 4];
+                sum[0] += src[x * 4 + 0];
+                sum[1] += src[x * 4 + 1];
+                sum[2] += src[x * 4 + 2];
+                sum[3] += src[x * 4 + 3];
+            }
+        }
+
+        uint8_t* dst = outData.data() + static_cast<size_t>(outY) * outWidth * 4;
+        for (uint32_t outX = 0; outX < outWidth; ++outX) {
+            const uint32_t cols = std::min(factor, width - outX * factor);
+            const uint32_t count = cols * rows;
+            for (int c = 0; c < 4; ++c) {
+                dst[outX * 4 + c] = static_cast<uint8_t>((sums[outX * 4 + c] + count / 2) / count);
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace LightroomCore
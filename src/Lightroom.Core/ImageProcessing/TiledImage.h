@@ -0,0 +1,102 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace LightroomCore {
+
+// D3D11 单张 2D 纹理的最大边长（D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION）
+constexpr uint32_t kMaxTextureDimension = 16384;
+
+// 超过该像素数的图片走分块路径（显示用缩小的代理纹理，导出按块流式处理）
+constexpr uint64_t kTiledImagePixelThreshold = 64ull * 1024 * 1024;
+
+// 大图代理纹理的最大边长
+constexpr uint32_t kProxyMaxDimension = 8192;
+
+// 默认分块尺寸
+constexpr uint32_t kDefaultTileSize = 512;
+
+// 图片是否需要走分块路径（超出纹理尺寸限制或像素数过大）
+inline bool RequiresTiledProcessing(uint32_t width, uint32_t height) {
+    return width > kMaxTextureDimension || height > kMaxTextureDimension ||
+           static_cast<uint64_t>(width) * height > kTiledImagePixelThreshold;
+}
+
+// 保持宽高比缩小到 maxWidth x maxHeight 以内（不放大，0 表示该方向不限制）
+inline void ComputeFitSize(uint32_t width, uint32_t height, uint32_t maxWidth, uint32_t maxHeight,
+                           uint32_t& outWidth, uint32_t& outHeight) {
+    double scale = 1.0;
+    if (maxWidth > 0 && width > maxWidth) {
+        scale = static_cast<double>(maxWidth) / width;
+    }
+    if (maxHeight > 0 && height * scale > maxHeight) {
+        scale = static_cast<double>(maxHeight) / height;
+    }
+    outWidth = scale < 1.0 ? static_cast<uint32_t>(width * scale + 0.5) : width;
+    outHeight = scale < 1.0 ? static_cast<uint32_t>(height * scale + 0.5) : height;
+    if (outWidth == 0) outWidth = 1;
+    if (outHeight == 0) outHeight = 1;
+}
+
+// 分块图像源：按区域读取全分辨率 BGRA8 像素，无需一次性把整幅图放入内存或纹理
+class ITileSource {
+public:
+    virtual ~ITileSource() = default;
+
+    virtual uint32_t GetWidth() const = 0;
+    virtual uint32_t GetHeight() const = 0;
+
+    // 读取 [x, x + width) x [y, y + height) 区域（必须位于图像范围内）到 dst（BGRA8）
+    virtual bool ReadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                            uint8_t* dst, uint32_t dstStride) = 0;
+};
+
+// 内存中的 8-bit RGB 图像（例如 LibRaw 的输出），读取时按区域转换为 BGRA，避免整幅 BGRA 副本
+class MemoryRGBTileSource : public ITileSource {
+public:
+    MemoryRGBTileSource(std::vector<uint8_t>&& rgbData, uint32_t width, uint32_t height);
+
+    uint32_t GetWidth() const override { return m_Width; }
+    uint32_t GetHeight() const override { return m_Height; }
+    bool ReadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                    uint8_t* dst, uint32_t dstStride) override;
+
+private:
+    std::vector<uint8_t> m_RGBData;
+    uint32_t m_Width;
+    uint32_t m_Height;
+};
+
+// 分块网格：把图像划分为 TileSize x TileSize 的块，每块四周带 Apron 像素的邻域
+// 邻域供模糊/清晰度等邻域滤镜使用，写回时只保留块内部
+struct TileGrid {
+    uint32_t ImageWidth = 0;
+    uint32_t ImageHeight = 0;
+    uint32_t TileSize = kDefaultTileSize;
+    uint32_t Apron = 0;
+
+    TileGrid(uint32_t imageWidth, uint32_t imageHeight, uint32_t tileSize, uint32_t apron);
+
+    uint32_t GetTilesX() const { return (ImageWidth + TileSize - 1) / TileSize; }
+    uint32_t GetTilesY() const { return (ImageHeight + TileSize - 1) / TileSize; }
+
+    // 带邻域的块纹理边长（所有块使用同一尺寸，边缘块用边界像素填充）
+    uint32_t GetPaddedTileSize() const { return TileSize + Apron * 2; }
+
+    // 第 (tileX, tileY) 块的内部区域
+    void GetTileRect(uint32_t tileX, uint32_t tileY, uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const;
+};
+
+// 读取块内部及其邻域到 PaddedTileSize x PaddedTileSize 的 BGRA 缓冲区
+// 超出图像范围的部分按 clamp 寻址复制边界像素（与采样器的 AM_Clamp 行为一致）
+bool ReadPaddedTile(ITileSource& source, const TileGrid& grid, uint32_t tileX, uint32_t tileY,
+                    std::vector<uint8_t>& outData);
+
+// 按条带读取分块源并按整数倍盒式缩小，生成不超过 maxWidth x maxHeight 的 BGRA 代理图像
+// 峰值内存只有一个条带加上代理图像本身
+bool BuildProxyImage(ITileSource& source, uint32_t maxWidth, uint32_t maxHeight,
+                     std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight);
+
+} // namespace LightroomCore
@@ -5,27 +5,41 @@
 #include "ImageProcessing/ImageLoader.h"
 #include "ImageProcessing/RAWImageInfo.h"
 #include "ImageProcessing/ImageExporter.h"
+#include "ImageProcessing/HalfFloat.h"
+#include "ImageProcessing/Histogram.h"
+#include "ImageProcessing/CubeLUT.h"
 #include "RenderTargetManager.h"
 #include "RenderGraph.h"
+#include "ResourceBudget.h"
 #include "RenderNodes/RenderNode.h"
 #include "RenderNodes/ScaleNode.h"
 #include "RenderNodes/ImageAdjustNode.h"
 #include "RenderNodes/FilterNode.h"
+#include "RenderNodes/NoiseReductionNode.h"
+#include "RenderNodes/LensCorrectionNode.h"
+#include "RenderNodes/GrainNode.h"
+#include "RenderNodes/LUTKernel.h"
 #include "VideoProcessing/VideoProcessor.h"
 #include "VideoProcessing/VideoExporter.h"
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <memory>
 #include <cstring>
 #include <algorithm>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <cmath>
 
 #include "d3d11rhi/Common.h"
 #include "d3d11rhi/DynamicRHI.h"
 #include "d3d11rhi/D3D11RHI.h"
 #include "d3d11rhi/D3D11Texture2D.h"
+#include "d3d11rhi/SoftwareRHI.h"
+#include "d3d11rhi/SoftwareTexture2D.h"
+#include "d3d11rhi/SoftwareTaskPool.h"
 #include "d3d11rhi/RHIRenderTarget.h"
 #include <d3d11.h>
 #include <algorithm>
@@ -52,7 +66,47 @@ static std::unique_ptr<ImageProcessor> g_ImageProcessor = nullptr;
 static std::unique_ptr<RenderTargetManager> g_RenderTargetManagerPtr = nullptr;  // 生命周期管理
 LightroomCore::RenderTargetManager* g_RenderTargetManager = nullptr;  // 视频 API 需要访问（指向 g_RenderTargetManagerPtr）
 
+// 渐进式加载的后台解码线程：由 SDK 持有，渲染目标销毁时只取消回调，ShutdownSDK 时取消并等待全部结束
+struct ProgressiveLoadThread {
+    std::thread Thread;
+    std::shared_ptr<ProgressiveLoadState> State;
+};
+static std::vector<ProgressiveLoadThread> g_ProgressiveLoadThreads;
+static std::mutex g_ProgressiveLoadThreadsMutex;
+
+static void StartProgressiveLoadThread(std::shared_ptr<ProgressiveLoadState> state, std::thread&& thread) {
+    std::lock_guard<std::mutex> lock(g_ProgressiveLoadThreadsMutex);
+    // 顺便回收已经返回的线程
+    for (auto it = g_ProgressiveLoadThreads.begin(); it != g_ProgressiveLoadThreads.end();) {
+        if (it->State->bThreadExited) {
+            it->Thread.join();
+            it = g_ProgressiveLoadThreads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    g_ProgressiveLoadThreads.push_back({ std::move(thread), std::move(state) });
+}
+
+static void JoinProgressiveLoadThreads() {
+    std::vector<ProgressiveLoadThread> threads;
+    {
+        std::lock_guard<std::mutex> lock(g_ProgressiveLoadThreadsMutex);
+        threads.swap(g_ProgressiveLoadThreads);
+    }
+    for (auto& entry : threads) {
+        entry.State->Cancel();
+        if (entry.Thread.joinable()) {
+            entry.Thread.join();
+        }
+    }
+}
+
 bool InitSDK() {
+    return InitSDKWithBackend(RenderBackend_Auto);
+}
+
+bool InitSDKWithBackend(uint32_t backend) {
     try {
         // 0. 初始化 COM（WIC 需要）
         HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
@@ -60,17 +114,25 @@ bool InitSDK() {
             return false;
         }
         
-        // 1. 创建 D3D11 RHI
-        g_DynamicRHI = PlatformCreateDynamicRHI(RHIAPIType::E_D3D11);
+        // 1. 创建 RHI：默认 D3D11，没有可用 GPU 时回退到 CPU 软件 RHI（无界面批处理/导出）
+        if (backend != RenderBackend_Software) {
+            g_DynamicRHI = PlatformCreateDynamicRHI(RHIAPIType::E_D3D11);
+        }
+        if (!g_DynamicRHI && backend != RenderBackend_D3D11) {
+            if (backend == RenderBackend_Auto) {
+                std::cerr << "[SDK] D3D11 unavailable, falling back to software RHI" << std::endl;
+            }
+            g_DynamicRHI = PlatformCreateDynamicRHI(RHIAPIType::E_Software);
+        }
         if (!g_DynamicRHI) {
             return false;
         }
         g_DynamicRHI->Init();
         
-        // 2. 初始化 D3D9 互操作
+        // 2. 初始化 D3D9 互操作（仅 GPU 模式需要：软件 RHI 没有可共享给 WPF 的表面）
         g_D3D9Interop = std::make_unique<LightroomCore::D3D9Interop>();
         g_D3D9InteropPtr = g_D3D9Interop.get();  // 设置指针供视频 API 使用
-        if (!g_D3D9Interop->Initialize()) {
+        if (!IsSoftwareRHI(g_DynamicRHI.get()) && !g_D3D9Interop->Initialize()) {
             return false;
         }
         
@@ -92,13 +154,20 @@ bool InitSDK() {
 void ShutdownSDK() {
     g_D3D9InteropPtr = nullptr;  // 清除指针
     
+    // 等待后台解码结束（已取消，不再回调），之后不会有线程访问 SDK 状态
+    JoinProgressiveLoadThreads();
+    
     // 清理所有渲染目标数据
+    for (auto& entry : g_RenderTargetData) {
+        LightroomCore::ResourceBudget::Get().Unregister(entry.first);
+    }
     g_RenderTargetData.clear();
     
     // 清理管理器
     g_RenderTargetManager = nullptr;
     g_RenderTargetManagerPtr.reset();
     g_ImageProcessor.reset();
+    CloseThumbnailCache();
     
     // 清理 D3D9 互操作
     if (g_D3D9Interop) {
@@ -117,10 +186,44 @@ void ShutdownSDK() {
     CoUninitialize();
 }
 
+bool IsSoftwareRendering() {
+    return g_DynamicRHI && IsSoftwareRHI(g_DynamicRHI.get());
+}
+
 int GetSDKVersion() {
     return 100; // v1.0.0
 }
 
+void SetMemoryBudget(uint64_t budgetBytes) {
+    LightroomCore::ResourceBudget::Get().SetBudget(budgetBytes);
+}
+
+bool GetMemoryStats(MemoryStats* outStats) {
+    if (!outStats) {
+        return false;
+    }
+    
+    LightroomCore::ResourceMemoryStats stats = LightroomCore::ResourceBudget::Get().GetStats();
+    outStats->gpuBytes = stats.GPUBytes;
+    outStats->systemBytes = stats.SystemBytes;
+    outStats->textureCount = stats.TextureCount;
+    outStats->cacheCount = stats.EvictableCount;
+    outStats->budgetBytes = stats.BudgetBytes;
+    outStats->evictions = stats.EvictionCount;
+    return true;
+}
+
+// 释放渲染目标中可以重建的纹理（渲染图中间结果、节点内部纹理、代理金字塔）
+// 图像纹理本身需要重新解码才能恢复，不在回收范围内
+static void EvictRenderTargetCaches(RenderTargetData& data) {
+    if (data.RenderGraph) {
+        data.RenderGraph->ReleaseResources();
+    }
+    if (data.Proxies) {
+        data.Proxies->Clear();
+    }
+}
+
 void* CreateRenderTarget(uint32_t width, uint32_t height) {
     if (!g_RenderTargetManager) {
         return nullptr;
@@ -138,8 +241,12 @@ void* CreateRenderTarget(uint32_t width, uint32_t height) {
     // 存储渲染目标数据
     auto data = std::make_unique<RenderTargetData>();
     data->RenderGraph = std::move(renderGraph);
+    RenderTargetData* dataPtr = data.get();
     g_RenderTargetData[handle] = std::move(data);
     
+    // 登记到内存预算：其他渲染目标需要内存时回收这里的缓存
+    LightroomCore::ResourceBudget::Get().Register(handle, [dataPtr]() { EvictRenderTargetCaches(*dataPtr); });
+    
     return handle;
 }
 
@@ -147,6 +254,7 @@ void DestroyRenderTarget(void* renderTargetHandle) {
     if (!renderTargetHandle) return;
     
     // 清理渲染目标数据
+    LightroomCore::ResourceBudget::Get().Unregister(renderTargetHandle);
     g_RenderTargetData.erase(renderTargetHandle);
     
     // 销毁渲染目标
@@ -164,6 +272,157 @@ void* GetRenderTargetSharedHandle(void* renderTargetHandle) {
     return g_RenderTargetManager->GetD3D9SharedHandle(renderTargetHandle);
 }
 
+// 转换路径为宽字符（UTF-8，失败时按 ANSI 代码页）
+static std::wstring ToWidePath(const char* path) {
+    UINT codePage = CP_UTF8;
+    int pathLen = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+    if (pathLen <= 0) {
+        codePage = CP_ACP;
+        pathLen = MultiByteToWideChar(CP_ACP, 0, path, -1, nullptr, 0);
+        if (pathLen <= 0) {
+            return std::wstring();
+        }
+    }
+    std::wstring wpath(pathLen, L'\0');
+    MultiByteToWideChar(codePage, 0, path, -1, &wpath[0], pathLen);
+    if (!wpath.empty() && wpath.back() == L'\0') {
+        wpath.pop_back();
+    }
+    return wpath;
+}
+
+// 停止调整参数超过该时长后回到全分辨率渲染
+static constexpr auto kProxyIdleDelay = std::chrono::milliseconds(200);
+
+// 加载图片后立即构建代理金字塔，第一次拖动滑块时不需要等待
+static void BuildProxyPyramid(RenderTargetData& data) {
+    if (!data.ImageTexture || data.bIsVideo) {
+        return;
+    }
+    if (!data.Proxies) {
+        data.Proxies = std::make_unique<LightroomCore::ProxyPyramid>(g_DynamicRHI);
+    }
+    data.Proxies->Build(data.ImageTexture);
+}
+
+// 记录一次交互编辑（滑块拖动等），之后的 kProxyIdleDelay 内从代理分辨率渲染
+static void MarkInteractiveEdit(RenderTargetData& data) {
+    data.LastInteractiveEdit = std::chrono::steady_clock::now();
+}
+
+// 选择渲染图的输入纹理：交互编辑期间使用足够覆盖显示尺寸的最小代理，空闲时使用全分辨率图像
+// 应用每帧都会调用 RenderToTarget，停止操作后的下一帧自动以全分辨率重新渲染
+static std::shared_ptr<RenderCore::RHITexture2D> SelectRenderInput(RenderTargetData& data, uint32_t targetWidth, uint32_t targetHeight) {
+    if (!data.bProxyEditing || !data.Proxies) {
+        return data.ImageTexture;
+    }
+    if (std::chrono::steady_clock::now() - data.LastInteractiveEdit > kProxyIdleDelay) {
+        return data.ImageTexture;
+    }
+    
+    // 代理可能已被内存预算回收，需要时重新构建（未回收时不做任何事）
+    BuildProxyPyramid(data);
+    
+    // 放大显示时需要更多源像素
+    const double zoom = std::max(1.0, data.ViewZoom);
+    const uint32_t requiredWidth = static_cast<uint32_t>(std::ceil(targetWidth * zoom));
+    const uint32_t requiredHeight = static_cast<uint32_t>(std::ceil(targetHeight * zoom));
+    return data.Proxies->Select(data.ImageTexture, requiredWidth, requiredHeight);
+}
+
+// 为新加载的图片重建渲染图：图像调整 + 缩放
+static void SetupImageRenderGraph(RenderTargetData& data, uint32_t imageWidth, uint32_t imageHeight) {
+    data.ImageWidth = imageWidth;
+    data.ImageHeight = imageHeight;
+    
+    // 清除旧的渲染图
+    data.RenderGraph->Clear();
+    data.RenderGraph->SetIntermediateFormat(data.bHighPrecision ? RenderCore::EPixelFormat::PF_FloatRGBA
+                                                                : RenderCore::EPixelFormat::PF_B8G8R8A8);
+    
+    // 镜头校正是几何变换，最先执行（参数为 0 时渲染图跳过该节点）
+    auto lensNode = std::make_shared<LensCorrectionNode>(g_DynamicRHI);
+    lensNode->SetInputImageSize(imageWidth, imageHeight);
+    data.RenderGraph->AddNode(lensNode);
+
+    // 降噪在所有调整之前执行（强度为 0 时渲染图跳过该节点）
+    data.RenderGraph->AddNode(std::make_shared<NoiseReductionNode>(g_DynamicRHI));
+    
+    // 添加通用的图像调整节点（适用于 RAW 和标准图片）
+    auto adjustNode = std::make_shared<ImageAdjustNode>(g_DynamicRHI);
+    ImageAdjustParams defaultParams;
+    memset(&defaultParams, 0, sizeof(ImageAdjustParams));
+    defaultParams.temperature = 5500.0f;  // 默认日光色温
+    adjustNode->SetAdjustParams(defaultParams);
+    data.RenderGraph->AddNode(adjustNode);
+    
+    // 颗粒叠加在全部颜色调整（包括之后插入的滤镜）之后（强度为 0 时渲染图跳过该节点）
+    auto grainNode = std::make_shared<GrainNode>(g_DynamicRHI);
+    grainNode->SetInputImageSize(imageWidth, imageHeight);
+    data.RenderGraph->AddNode(grainNode);
+    
+    // 总是添加缩放节点以支持缩放和平移功能
+    auto scaleNode = std::make_shared<ScaleNode>(g_DynamicRHI);
+    scaleNode->SetInputImageSize(imageWidth, imageHeight);
+    data.RenderGraph->AddNode(scaleNode);
+    
+    BuildProxyPyramid(data);
+}
+
+// 渐进式加载：后台解码完成后，在调用线程（渲染线程）上创建纹理并替换预览
+// wait 为 true 时阻塞等待后台解码结束
+static void ApplyProgressiveLoadResult(RenderTargetData& data, bool wait) {
+    auto state = data.ProgressiveLoad;
+    if (!state) {
+        return;
+    }
+    
+    std::unique_lock<std::mutex> lock(state->Mutex);
+    if (wait) {
+        state->Condition.wait(lock, [&state]() { return state->bFinished; });
+    }
+    if (!state->bFinished) {
+        return;
+    }
+    
+    // 失败时保留预览纹理
+    data.ProgressiveLoad.reset();
+    if (!state->bSucceeded) {
+        std::cerr << "[SDK] Progressive load: full quality decode failed, keeping preview" << std::endl;
+        return;
+    }
+    
+    LightroomCore::DecodedImage result = std::move(state->Result);
+    auto texture = LightroomCore::CreateTextureFromDecodedImage(g_DynamicRHI, result);
+    if (!texture) {
+        return;
+    }
+    data.ImageTexture = texture;
+    data.TileSource = result.TileSource;
+    data.ImageWidth = result.FullWidth;
+    data.ImageHeight = result.FullHeight;
+    BuildProxyPyramid(data);
+    
+    if (data.RenderGraph) {
+        for (size_t i = 0; i < data.RenderGraph->GetNodeCount(); ++i) {
+            auto scaleNode = std::dynamic_pointer_cast<ScaleNode>(data.RenderGraph->GetNode(i));
+            if (scaleNode) {
+                scaleNode->SetInputImageSize(data.ImageWidth, data.ImageHeight);
+            }
+            auto lensNode = std::dynamic_pointer_cast<LensCorrectionNode>(data.RenderGraph->GetNode(i));
+            if (lensNode) {
+                lensNode->SetInputImageSize(data.ImageWidth, data.ImageHeight);
+            }
+            auto grainNode = std::dynamic_pointer_cast<GrainNode>(data.RenderGraph->GetNode(i));
+            if (grainNode) {
+                grainNode->SetInputImageSize(data.ImageWidth, data.ImageHeight);
+            }
+        }
+        // 输入纹理已更换，缓存的中间结果失效
+        data.RenderGraph->InvalidateCache();
+    }
+}
+
 bool LoadImageToTarget(void* renderTargetHandle, const char* imagePath) {
     if (!renderTargetHandle || !g_ImageProcessor || !imagePath) {
         return false;
@@ -181,6 +440,8 @@ bool LoadImageToTarget(void* renderTargetHandle, const char* imagePath) {
     
     try {
         // 使用图片处理器加载图片
+        data->CancelProgressiveLoad();
+        g_ImageProcessor->SetHighPrecision(data->bHighPrecision);
         data->ImageTexture = g_ImageProcessor->LoadImageFromFile(imagePath);
         if (!data->ImageTexture) {
             return false;
@@ -188,6 +449,8 @@ bool LoadImageToTarget(void* renderTargetHandle, const char* imagePath) {
         
         data->bHasImage = true;
         data->ImageFormat = g_ImageProcessor->GetLastImageFormat();
+        // 超大图片：ImageTexture 只是显示用的代理，导出时从分块源读取全分辨率像素
+        data->TileSource = g_ImageProcessor->GetLastTileSource();
         
         // 如果是 RAW 格式，保存 RAW 信息
         if (data->ImageFormat == LightroomCore::ImageFormat::RAW) {
@@ -204,24 +467,106 @@ bool LoadImageToTarget(void* renderTargetHandle, const char* imagePath) {
         if (renderTargetInfo) {
             uint32_t imageWidth, imageHeight;
             g_ImageProcessor->GetLastImageSize(imageWidth, imageHeight);
+            SetupImageRenderGraph(*data, imageWidth, imageHeight);
+        }
+        
+        return true;
+    }
+    catch (const std::exception& e) {
+        return false;
+    }
+}
+
+bool LoadImageProgressive(void* renderTargetHandle, const char* imagePath, ProgressiveLoadCallback callback, void* userData) {
+    if (!renderTargetHandle || !g_ImageProcessor || !imagePath) {
+        return false;
+    }
+    
+    auto it = g_RenderTargetData.find(renderTargetHandle);
+    if (it == g_RenderTargetData.end()) {
+        return false;
+    }
+    
+    auto& data = it->second;
+    if (!data) {
+        return false;
+    }
+    
+    std::wstring wpath = ToWidePath(imagePath);
+    if (wpath.empty()) {
+        return false;
+    }
+    
+    try {
+        // 第一阶段：快速预览（RAW 为内嵌 JPEG 或半尺寸去马赛克）
+        data->CancelProgressiveLoad();
+        g_ImageProcessor->SetHighPrecision(data->bHighPrecision);
+        data->ImageTexture = g_ImageProcessor->LoadPreviewFromFile(wpath);
+        if (!data->ImageTexture) {
+            return false;
+        }
+        
+        data->bHasImage = true;
+        data->ImageFormat = g_ImageProcessor->GetLastImageFormat();
+        data->TileSource = g_ImageProcessor->GetLastTileSource();
+        
+        if (data->ImageFormat == LightroomCore::ImageFormat::RAW) {
+            const LightroomCore::RAWImageInfo* rawInfo = g_ImageProcessor->GetRAWInfo();
+            if (rawInfo) {
+                data->RAWInfo = std::make_unique<LightroomCore::RAWImageInfo>(*rawInfo);
+            }
+        } else {
+            data->RAWInfo.reset();
+        }
+        
+        if (g_RenderTargetManager->GetRenderTargetInfo(renderTargetHandle)) {
+            uint32_t imageWidth, imageHeight;
+            g_ImageProcessor->GetLastImageSize(imageWidth, imageHeight);
+            SetupImageRenderGraph(*data, imageWidth, imageHeight);
+        }
+        
+        // 标准格式已经是完整质量
+        if (data->ImageFormat != LightroomCore::ImageFormat::RAW) {
+            if (callback) {
+                callback(renderTargetHandle, true, userData);
+            }
+            return true;
+        }
+        
+        // 第二阶段：后台线程完整质量解码，结果在下一次 RenderToTarget 时替换预览纹理
+        auto state = std::make_shared<ProgressiveLoadState>();
+        data->ProgressiveLoad = state;
+        const bool highPrecision = data->bHighPrecision;
+        std::thread thread([state, wpath, highPrecision, renderTargetHandle, callback, userData]() {
+            LightroomCore::DecodedImage decoded;
+            bool success = false;
+            if (!state->bCancelled) {
+                try {
+                    success = LightroomCore::ImageProcessor::DecodeImageFile(wpath, decoded, highPrecision);
+                }
+                catch (const std::exception& e) {
+                    success = false;
+                }
+            }
             
-            // 清除旧的渲染图
-            data->RenderGraph->Clear();
-            
-            // 添加通用的图像调整节点（适用于 RAW 和标准图片）
-            auto adjustNode = std::make_shared<ImageAdjustNode>(g_DynamicRHI);
-            ImageAdjustParams defaultParams;
-            memset(&defaultParams, 0, sizeof(ImageAdjustParams));
-            defaultParams.temperature = 5500.0f;  // 默认日光色温
-            adjustNode->SetAdjustParams(defaultParams);
-            data->RenderGraph->AddNode(adjustNode);
-            
-            // 总是添加缩放节点以支持缩放和平移功能
-            auto scaleNode = std::make_shared<ScaleNode>(g_DynamicRHI);
-            scaleNode->SetInputImageSize(imageWidth, imageHeight);
-            data->RenderGraph->AddNode(scaleNode);
+            {
+                std::lock_guard<std::mutex> lock(state->Mutex);
+                state->Result = std::move(decoded);
+                state->bSucceeded = success;
+                state->bFinished = true;
+            }
+            state->Condition.notify_all();
             
-        }
+            {
+                // 与 CancelProgressiveLoad 互斥：渲染目标销毁后不会再回调
+                std::lock_guard<std::recursive_mutex> lock(state->CallbackMutex);
+                if (callback && !state->bCancelled) {
+                    callback(renderTargetHandle, success, userData);
+                }
+            }
+            state->bThreadExited = true;
+        });
+        StartProgressiveLoadThread(state, std::move(thread));
         
         return true;
     }
@@ -230,6 +575,31 @@ bool LoadImageToTarget(void* renderTargetHandle, const char* imagePath) {
     }
 }
 
+bool SetHighPrecisionMode(void* renderTargetHandle, bool enable) {
+    if (!renderTargetHandle || !g_DynamicRHI) {
+        return false;
+    }
+    
+    // 软件后端的节点 CPU 实现只处理 BGRA8
+    if (enable && IsSoftwareRHI(g_DynamicRHI.get())) {
+        return false;
+    }
+    
+    auto it = g_RenderTargetData.find(renderTargetHandle);
+    if (it == g_RenderTargetData.end() || !it->second) {
+        return false;
+    }
+    
+    auto& data = it->second;
+    data->bHighPrecision = enable;
+    // 中间结果格式立即切换；图片纹理的精度在下次加载时生效（视频帧始终为 8-bit）
+    if (data->RenderGraph && !data->bIsVideo) {
+        data->RenderGraph->SetIntermediateFormat(enable ? RenderCore::EPixelFormat::PF_FloatRGBA
+                                                        : RenderCore::EPixelFormat::PF_B8G8R8A8);
+    }
+    return true;
+}
+
 bool RenderToTarget(void* renderTargetHandle) {
     if (!renderTargetHandle || !g_RenderTargetManager) {
         return false;
@@ -245,6 +615,10 @@ bool RenderToTarget(void* renderTargetHandle) {
         return false;
     }
     
+    // 渲染之前检查内存预算：超出时回收最久未渲染的其他渲染目标的缓存
+    LightroomCore::ResourceBudget::Get().Touch(renderTargetHandle);
+    LightroomCore::ResourceBudget::Get().Enforce(renderTargetHandle);
+    
     try {
         auto* renderTargetInfo = g_RenderTargetManager->GetRenderTargetInfo(renderTargetHandle);
         if (!renderTargetInfo) {
@@ -257,6 +631,9 @@ bool RenderToTarget(void* renderTargetHandle) {
             return false;
         }
         
+        // Front Buffer 新内容的键（未执行渲染图时为 0）
+        uint64_t contentKey = 0;
+        
         // 如果是视频，使用视频渲染逻辑
         if (data->bIsVideo && data->VideoProcessor) {
             // 获取当前帧（不推进到下一帧，只是渲染当前帧）
@@ -267,6 +644,8 @@ bool RenderToTarget(void* renderTargetHandle) {
             
             if (frameTexture && data->RenderGraph) {
                 data->ImageTexture = frameTexture;
+                // 解码器可能复用同一纹理承载新帧，中间结果不能沿用
+                data->RenderGraph->InvalidateCache();
                 
                 // 执行渲染图到Back Buffer
                 if (!data->RenderGraph->Execute(
@@ -276,18 +655,25 @@ bool RenderToTarget(void* renderTargetHandle) {
                         renderTargetInfo->Height)) {
                     return false;
                 }
+                contentKey = data->RenderGraph->GetOutputKey();
             }
         }
         // 如果有图片，执行渲染图
         else if (data->bHasImage && data->ImageTexture) {
+            // 渐进式加载的完整质量图像已就绪时替换预览纹理
+            ApplyProgressiveLoadResult(*data, false);
+            
+            auto inputTexture = SelectRenderInput(*data, renderTargetInfo->Width, renderTargetInfo->Height);
+            
             // 执行渲染图到Back Buffer
             if (!data->RenderGraph->Execute(
-                    data->ImageTexture,
+                    inputTexture,
                     outputTexture,
                     renderTargetInfo->Width,
                     renderTargetInfo->Height)) {
                 return false;
             }
+            contentKey = data->RenderGraph->GetOutputKey();
         } else {
             // 没有图片，清除Back Buffer为黑色
             auto commandContext = g_DynamicRHI->GetDefaultCommandContext();
@@ -322,6 +708,7 @@ bool RenderToTarget(void* renderTargetHandle) {
         }
         
         // 【双缓冲+拷贝策略】将Back Buffer的内容复制到Front Buffer
+        data->PresentedContentKey = contentKey;
         return g_RenderTargetManager->PresentBackBuffer(renderTargetHandle);
     }
     catch (const std::exception& e) {
@@ -353,6 +740,8 @@ void SetRenderTargetZoom(void* renderTargetHandle, double zoomLevel, double panX
         return;
     }
     
+    data->ViewZoom = zoomLevel;
+    
     // 查找 ScaleNode 并设置缩放参数
     for (size_t i = 0; i < data->RenderGraph->GetNodeCount(); ++i) {
         auto node = data->RenderGraph->GetNode(i);
@@ -372,9 +761,7 @@ void SetRenderTargetZoom(void* renderTargetHandle, double zoomLevel, double panX
                         }
                     } else {
                         // 图片
-                        uint32_t imageWidth, imageHeight;
-                        g_ImageProcessor->GetLastImageSize(imageWidth, imageHeight);
-                        scaleNode->SetInputImageSize(imageWidth, imageHeight);
+                        scaleNode->SetInputImageSize(data->ImageWidth, data->ImageHeight);
                     }
                 }
             }
@@ -460,6 +847,39 @@ bool GetRAWMetadata(void* renderTargetHandle, RAWImageMetadata* outMetadata) {
     return true;
 }
 
+// 降噪由独立的 NoiseReductionNode 处理，强度取自 ImageAdjustParams::noiseReduction
+static void SetNoiseReductionStrength(RenderTargetData& data, float strength) {
+    for (size_t i = 0; i < data.RenderGraph->GetNodeCount(); ++i) {
+        auto noiseReductionNode = std::dynamic_pointer_cast<NoiseReductionNode>(data.RenderGraph->GetNode(i));
+        if (noiseReductionNode) {
+            noiseReductionNode->SetStrength(strength);
+            return;
+        }
+    }
+}
+
+// 镜头校正由独立的 LensCorrectionNode 处理，参数取自 ImageAdjustParams::lensDistortion / chromaticAberration
+static void SetLensCorrectionParams(RenderTargetData& data, float distortion, float chromaticAberration) {
+    for (size_t i = 0; i < data.RenderGraph->GetNodeCount(); ++i) {
+        auto lensNode = std::dynamic_pointer_cast<LensCorrectionNode>(data.RenderGraph->GetNode(i));
+        if (lensNode) {
+            lensNode->SetParams(distortion, chromaticAberration);
+            return;
+        }
+    }
+}
+
+// 颗粒由独立的 GrainNode 处理（图片与视频渲染图中都有），参数取自 ImageAdjustParams::grain
+static void SetGrainAmount(RenderTargetData& data, float amount) {
+    for (size_t i = 0; i < data.RenderGraph->GetNodeCount(); ++i) {
+        auto grainNode = std::dynamic_pointer_cast<GrainNode>(data.RenderGraph->GetNode(i));
+        if (grainNode) {
+            grainNode->SetAmount(amount);
+            return;
+        }
+    }
+}
+
 void SetImageAdjustParams(void* renderTargetHandle, const ImageAdjustParams* params) {
     if (!renderTargetHandle || !params) {
         return;
@@ -475,6 +895,10 @@ void SetImageAdjustParams(void* renderTargetHandle, const ImageAdjustParams* par
         return;
     }
     
+    SetNoiseReductionStrength(*data, params->noiseReduction);
+    SetLensCorrectionParams(*data, params->lensDistortion, params->chromaticAberration);
+    SetGrainAmount(*data, params->grain);
+    
     // 查找 ImageAdjustNode 并设置参数
     for (size_t i = 0; i < data->RenderGraph->GetNodeCount(); ++i) {
         auto node = data->RenderGraph->GetNode(i);
@@ -482,12 +906,26 @@ void SetImageAdjustParams(void* renderTargetHandle, const ImageAdjustParams* par
             auto adjustNode = std::dynamic_pointer_cast<ImageAdjustNode>(node);
             if (adjustNode) {
                 adjustNode->SetAdjustParams(*params);
+                MarkInteractiveEdit(*data);
             }
             break;
         }
     }
 }
 
+void SetProxyEditing(void* renderTargetHandle, bool enable) {
+    if (!renderTargetHandle) {
+        return;
+    }
+    
+    auto it = g_RenderTargetData.find(renderTargetHandle);
+    if (it == g_RenderTargetData.end() || !it->second) {
+        return;
+    }
+    
+    it->second->bProxyEditing = enable;
+}
+
 void ResetImageAdjustParams(void* renderTargetHandle) {
     if (!renderTargetHandle) {
         return;
@@ -503,6 +941,10 @@ void ResetImageAdjustParams(void* renderTargetHandle) {
         return;
     }
     
+    SetNoiseReductionStrength(*data, 0.0f);
+    SetLensCorrectionParams(*data, 0.0f, 0.0f);
+    SetGrainAmount(*data, 0.0f);
+    
     // 查找 ImageAdjustNode 并重置为默认值
     for (size_t i = 0; i < data->RenderGraph->GetNodeCount(); ++i) {
         auto node = data->RenderGraph->GetNode(i);
@@ -519,7 +961,10 @@ void ResetImageAdjustParams(void* renderTargetHandle) {
     }
 }
 
-bool GetHistogramData(void* renderTargetHandle, uint32_t* outHistogram) {
+// 辅助函数：统计 Front Buffer（实际显示的内容）的直方图
+// sampleStep: 1 = 全部像素，N = 每 N 行、N 列取一个像素
+// 画面自上次统计后没有变化时直接返回缓存的结果
+static bool ComputeFrontBufferHistogram(void* renderTargetHandle, uint32_t sampleStep, uint32_t* outHistogram) {
     if (!renderTargetHandle || !outHistogram) {
         return false;
     }
@@ -540,6 +985,12 @@ bool GetHistogramData(void* renderTargetHandle, uint32_t* outHistogram) {
         return false;
     }
     
+    sampleStep = std::max(1u, sampleStep);
+    const uint64_t contentKey = data->PresentedContentKey;
+    if (data->Histogram.Lookup(contentKey, sampleStep, outHistogram)) {
+        return true;
+    }
+    
     try {
         // 获取渲染后的输出纹理（这是实际显示的内容，应该用于直方图计算）
         // 注意：应该读取Front Buffer的内容（实际显示的内容），而不是Back Buffer
@@ -554,6 +1005,19 @@ bool GetHistogramData(void* renderTargetHandle, uint32_t* outHistogram) {
             return false;
         }
         
+        // 软件 RHI：Front Buffer 就在系统内存中，直接统计
+        auto* softwareTexture = dynamic_cast<RenderCore::SoftwareTexture2D*>(frontTexture.get());
+        if (softwareTexture) {
+            if (softwareTexture->GetPixelFormat() != RenderCore::PF_B8G8R8A8) {
+                return false;
+            }
+            LightroomCore::ComputeHistogramBGRA8(softwareTexture->GetData(), softwareTexture->GetRowPitch(),
+                                                 softwareTexture->GetSize().x, softwareTexture->GetSize().y,
+                                                 sampleStep, outHistogram);
+            data->Histogram.Store(contentKey, sampleStep, outHistogram);
+            return true;
+        }
+        
         // 获取 D3D11 纹理
         RenderCore::D3D11DynamicRHI* d3d11RHI = dynamic_cast<RenderCore::D3D11DynamicRHI*>(g_DynamicRHI.get());
         if (!d3d11RHI) {
@@ -589,71 +1053,49 @@ bool GetHistogramData(void* renderTargetHandle, uint32_t* outHistogram) {
             return false;
         }
         
-        // 创建 staging texture 用于读取数据
         ID3D11Device* device = d3d11RHI->GetDevice();
         ID3D11DeviceContext* context = d3d11RHI->GetDeviceContext();
         
-        D3D11_TEXTURE2D_DESC stagingDesc = texDesc;
-        stagingDesc.Usage = D3D11_USAGE_STAGING;
-        stagingDesc.BindFlags = 0;
-        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-        stagingDesc.MiscFlags = 0;
-        stagingDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;  // 确保staging texture是BGRA格式
-        
-        Microsoft::WRL::ComPtr<ID3D11Texture2D> stagingTexture;
-        HRESULT hr = device->CreateTexture2D(&stagingDesc, nullptr, stagingTexture.GetAddressOf());
-        if (FAILED(hr)) {
-            return false;
+        // staging texture 按渲染目标缓存，只在尺寸变化时重建
+        if (data->HistogramStaging) {
+            D3D11_TEXTURE2D_DESC existingDesc;
+            data->HistogramStaging->GetDesc(&existingDesc);
+            if (existingDesc.Width != texDesc.Width || existingDesc.Height != texDesc.Height) {
+                data->HistogramStaging.Reset();
+            }
+        }
+        if (!data->HistogramStaging) {
+            D3D11_TEXTURE2D_DESC stagingDesc = texDesc;
+            stagingDesc.Usage = D3D11_USAGE_STAGING;
+            stagingDesc.BindFlags = 0;
+            stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+            stagingDesc.MiscFlags = 0;
+            stagingDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;  // 确保staging texture是BGRA格式
+            
+            HRESULT hr = device->CreateTexture2D(&stagingDesc, nullptr, data->HistogramStaging.GetAddressOf());
+            if (FAILED(hr)) {
+                return false;
+            }
         }
         
         // 从 GPU 拷贝到 staging texture
-        context->CopyResource(stagingTexture.Get(), nativeTex);
+        context->CopyResource(data->HistogramStaging.Get(), nativeTex);
         
         // 确保GPU命令执行完成
         context->Flush();
         
         // 映射并读取数据
         D3D11_MAPPED_SUBRESOURCE mapped;
-        hr = context->Map(stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mapped);
+        HRESULT hr = context->Map(data->HistogramStaging.Get(), 0, D3D11_MAP_READ, 0, &mapped);
         if (FAILED(hr)) {
             return false;
         }
         
-        // 初始化直方图数组（256 bins * 4 channels: R, G, B, Luminance）
-        memset(outHistogram, 0, 256 * 4 * sizeof(uint32_t));
-        
-        // 采样像素（为了性能，只采样部分像素）
-        uint32_t sampleStep = std::max(1u, std::max(texDesc.Width / 256, texDesc.Height / 256));
+        LightroomCore::ComputeHistogramBGRA8(static_cast<const uint8_t*>(mapped.pData), mapped.RowPitch,
+                                             texDesc.Width, texDesc.Height, sampleStep, outHistogram);
         
-        const uint8_t* srcData = static_cast<const uint8_t*>(mapped.pData);
-        uint32_t bytesPerPixel = 4;  // BGRA = 4 bytes per pixel
-        
-        for (uint32_t y = 0; y < texDesc.Height; y += sampleStep) {
-            for (uint32_t x = 0; x < texDesc.Width; x += sampleStep) {
-                uint32_t pixelOffset = y * mapped.RowPitch + x * bytesPerPixel;
-                
-                // 确保不越界
-                if (pixelOffset + bytesPerPixel > mapped.RowPitch * texDesc.Height) {
-                    continue;
-                }
-                
-                uint8_t b = srcData[pixelOffset + 0];
-                uint8_t g = srcData[pixelOffset + 1];
-                uint8_t r = srcData[pixelOffset + 2];
-                
-                // 计算亮度 (使用 Rec. 709 标准)
-                float luminance = 0.2126f * r + 0.7152f * g + 0.0722f * b;
-                uint8_t lum = static_cast<uint8_t>(luminance);
-                
-                // 更新直方图
-                outHistogram[r]++;           // R channel
-                outHistogram[256 + g]++;    // G channel
-                outHistogram[512 + b]++;    // B channel
-                outHistogram[768 + lum]++;  // Luminance
-            }
-        }
-        
-        context->Unmap(stagingTexture.Get(), 0);
+        context->Unmap(data->HistogramStaging.Get(), 0);
+        data->Histogram.Store(contentKey, sampleStep, outHistogram);
         return true;
     }
     catch (const std::exception& e) {
@@ -662,6 +1104,14 @@ bool GetHistogramData(void* renderTargetHandle, uint32_t* outHistogram) {
     }
 }
 
+bool GetHistogramData(void* renderTargetHandle, uint32_t* outHistogram) {
+    return ComputeFrontBufferHistogram(renderTargetHandle, 1, outHistogram);
+}
+
+bool GetHistogramDataSampled(void* renderTargetHandle, uint32_t sampleStep, uint32_t* outHistogram) {
+    return ComputeFrontBufferHistogram(renderTargetHandle, sampleStep, outHistogram);
+}
+
 // 辅助函数：查找渲染图中的 FilterNode
 static std::shared_ptr<FilterNode> FindFilterNode(void* renderTargetHandle) {
     if (!renderTargetHandle) {
@@ -706,7 +1156,7 @@ bool LoadFilterLUT(void* renderTargetHandle, uint32_t lutSize, const float* lutD
             filterNode = std::make_shared<FilterNode>(g_DynamicRHI);
             
             // 查找 ImageAdjustNode 的位置，在其后插入 FilterNode
-            // 渲染图顺序：ImageAdjust -> Filter -> Scale
+            // 渲染图顺序：NoiseReduction -> ImageAdjust -> Filter -> Scale
             size_t insertIndex = 0;
             for (size_t i = 0; i < renderGraph->GetNodeCount(); ++i) {
                 auto node = renderGraph->GetNode(i);
@@ -808,6 +1258,11 @@ void SetFilterIntensity(void* renderTargetHandle, float intensity) {
     auto filterNode = FindFilterNode(renderTargetHandle);
     if (filterNode) {
         filterNode->SetIntensity(intensity);
+        
+        auto it = g_RenderTargetData.find(renderTargetHandle);
+        if (it != g_RenderTargetData.end() && it->second) {
+            MarkInteractiveEdit(*it->second);
+        }
     }
 }
 
@@ -843,6 +1298,108 @@ void RemoveFilter(void* renderTargetHandle) {
     }
 }
 
+uint32_t RenderFilterPreviews(void* renderTargetHandle, const char** lutPaths, uint32_t count,
+                              uint32_t tileWidth, uint32_t tileHeight, uint8_t** outBuffers) {
+    if (!renderTargetHandle || !lutPaths || !outBuffers || count == 0 || tileWidth == 0 || tileHeight == 0) {
+        return 0;
+    }
+    
+    auto it = g_RenderTargetData.find(renderTargetHandle);
+    if (it == g_RenderTargetData.end() || !it->second || !it->second->RenderGraph) {
+        return 0;
+    }
+    
+    auto& data = it->second;
+    if (!data->ImageTexture || (!data->bHasImage && !data->bIsVideo)) {
+        return 0;
+    }
+    
+    try {
+        ApplyProgressiveLoadResult(*data, false);
+        
+        // 1. 只执行一次调整后的代理图：只取滤镜位置（ImageAdjust 之后）上游的节点，
+        //    颗粒等滤镜之后的节点不能先于 LUT 执行；再用自适应缩放输出到预览尺寸
+        LightroomCore::RenderGraph proxyGraph(g_DynamicRHI);
+        for (size_t i = 0; i < data->RenderGraph->GetNodeCount(); ++i) {
+            auto node = data->RenderGraph->GetNode(i);
+            if (!node || strcmp(node->GetName(), "Scale") == 0) {
+                continue;
+            }
+            if (strcmp(node->GetName(), "Filter") == 0) {
+                break;
+            }
+            proxyGraph.AddNode(node);
+            if (strcmp(node->GetName(), "ImageAdjust") == 0) {
+                break;
+            }
+        }
+        auto fitNode = std::make_shared<ScaleNode>(g_DynamicRHI);
+        auto imageSize = data->ImageTexture->GetSize();
+        fitNode->SetInputImageSize(data->ImageWidth ? data->ImageWidth : static_cast<uint32_t>(imageSize.x),
+                                   data->ImageHeight ? data->ImageHeight : static_cast<uint32_t>(imageSize.y));
+        proxyGraph.AddNode(fitNode);
+        
+        auto proxyTexture = g_DynamicRHI->RHICreateTexture2D(
+            RenderCore::EPixelFormat::PF_B8G8R8A8,
+            RenderCore::ETextureCreateFlags::TexCreate_RenderTargetable | RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+            tileWidth,
+            tileHeight,
+            1
+        );
+        if (!proxyTexture || !proxyGraph.Execute(data->ImageTexture, proxyTexture, tileWidth, tileHeight)) {
+            return 0;
+        }
+        
+        auto commandContext = g_DynamicRHI->GetDefaultCommandContext();
+        if (commandContext) {
+            commandContext->FlushCommands();
+        }
+        
+        LightroomCore::ImageExporter exporter(g_DynamicRHI);
+        uint32_t proxyWidth, proxyHeight, proxyStride;
+        std::vector<uint8_t> proxyData;
+        if (!exporter.ReadTextureData(proxyTexture, proxyWidth, proxyHeight, proxyData, proxyStride) ||
+            proxyWidth != tileWidth || proxyHeight != tileHeight) {
+            return 0;
+        }
+        
+        // 2. 所有 LUT 在 CPU 上并行应用到同一张代理图（每个 LUT 一个任务，LUT 经二进制缓存加载）
+        //    插值方式与实际应用滤镜的 FilterNode 一致：GPU 为三线性采样，软件后端为四面体插值
+        const LightroomCore::LUTInterpolation interpolation = IsSoftwareRHI(g_DynamicRHI.get())
+            ? LightroomCore::LUTInterpolation::Tetrahedral
+            : LightroomCore::LUTInterpolation::Trilinear;
+        
+        std::atomic<uint32_t> rendered{ 0 };
+        RenderCore::SoftwareTaskPool::Get().ParallelFor(count, [&](uint32_t index) {
+            uint8_t* tile = outBuffers[index];
+            if (!tile) {
+                return;
+            }
+            
+            LightroomCore::CubeLUT lut;
+            const bool loaded = lutPaths[index] &&
+                                LightroomCore::CubeLUTCache::Get().Load(ToWidePath(lutPaths[index]), lut);
+            if (loaded) {
+                LightroomCore::LUTKernel kernel(lut.Data.data(), lut.Size, interpolation, 1.0f);
+                if (kernel.Process(proxyData.data(), proxyStride, tile, tileWidth * 4, tileWidth, tileHeight)) {
+                    rendered.fetch_add(1);
+                    return;
+                }
+            }
+            
+            // 加载失败的预览显示未加滤镜的代理图
+            for (uint32_t y = 0; y < tileHeight; ++y) {
+                memcpy(tile + static_cast<size_t>(y) * tileWidth * 4, proxyData.data() + static_cast<size_t>(y) * proxyStride, tileWidth * 4);
+            }
+        });
+        return rendered.load();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[SDK] Exception rendering filter previews: " << e.what() << std::endl;
+        return 0;
+    }
+}
+
 bool ExportImage(void* renderTargetHandle, const char* filePath, const char* format, uint32_t quality) {
     if (!renderTargetHandle || !filePath || !format) {
         return false;
@@ -871,6 +1428,8 @@ bool ExportImage(void* renderTargetHandle, const char* filePath, const char* for
         exportFormat = LightroomCore::ExportFormat::PNG;
     } else if (formatStr == "jpeg" || formatStr == "jpg") {
         exportFormat = LightroomCore::ExportFormat::JPEG;
+    } else if (formatStr == "tiff" || formatStr == "tif") {
+        exportFormat = LightroomCore::ExportFormat::TIFF;
     } else {
         return false;
     }
@@ -884,14 +1443,35 @@ bool ExportImage(void* renderTargetHandle, const char* filePath, const char* for
         return false;
     }
     
+    // 渐进式加载尚未完成时等待完整质量图像，不导出预览
+    ApplyProgressiveLoadResult(*data, true);
+    
+    // 超大图片：按块流式执行渲染图并逐行带写入文件
+    if (data->TileSource && data->RenderGraph) {
+        try {
+            std::vector<std::shared_ptr<LightroomCore::RenderNode>> nodes;
+            for (size_t i = 0; i < data->RenderGraph->GetNodeCount(); ++i) {
+                nodes.push_back(data->RenderGraph->GetNode(i));
+            }
+            LightroomCore::ImageExporter exporter(g_DynamicRHI);
+            return exporter.ExportTiled(*data->TileSource, nodes, filePath, exportFormat, quality);
+        }
+        catch (const std::exception& e) {
+            return false;
+        }
+    }
+    
     // 获取原图分辨率（用于导出）
     auto originalSize = data->ImageTexture->GetSize();
     uint32_t originalWidth = originalSize.x;
     uint32_t originalHeight = originalSize.y;
     
+    // 高精度模式导出 PNG/TIFF 时，最后一个节点直接输出 FP16，回读后转换为 16-bit
+    const bool export16Bit = data->bHighPrecision && exportFormat != LightroomCore::ExportFormat::JPEG;
+    
     // 创建原图分辨率的临时渲染目标纹理（用于导出）
     auto exportTexture = g_DynamicRHI->RHICreateTexture2D(
-        RenderCore::EPixelFormat::PF_B8G8R8A8,
+        export16Bit ? RenderCore::EPixelFormat::PF_FloatRGBA : RenderCore::EPixelFormat::PF_B8G8R8A8,
         RenderCore::ETextureCreateFlags::TexCreate_RenderTargetable | RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
         originalWidth,
         originalHeight,
@@ -928,30 +1508,26 @@ bool ExportImage(void* renderTargetHandle, const char* filePath, const char* for
         return false;
     }
     
-    // 获取导出纹理的 D3D11 原生纹理
-    auto d3d11ExportTexture = std::dynamic_pointer_cast<RenderCore::D3D11Texture2D>(exportTexture);
-    if (!d3d11ExportTexture) {
-        return false;
-    }
-    
-    ID3D11Texture2D* d3d11Texture = d3d11ExportTexture->GetNativeTex();
-    if (!d3d11Texture) {
-        return false;
-    }
-    
     // 创建导出器并导出
     try {
         LightroomCore::ImageExporter exporter(g_DynamicRHI);
         
-        // 从 D3D11 纹理读取数据（原图分辨率）
+        // 从导出纹理读取数据（原图分辨率，D3D11 与软件 RHI 通用）
         uint32_t realWidth, realHeight, stride;
         std::vector<uint8_t> imageData;
 
         // 调用函数读取原图分辨率的数据
-        if (!exporter.ReadD3D11TextureData(d3d11Texture, realWidth, realHeight, imageData, stride)) {
+        if (!exporter.ReadTextureData(exportTexture, realWidth, realHeight, imageData, stride)) {
             return false;
         }
 
+        if (export16Bit) {
+            const size_t pixelCount = static_cast<size_t>(realWidth) * realHeight;
+            std::vector<uint16_t> rgba16(pixelCount * 4);
+            LightroomCore::ConvertRGBAHalfToRGBA16(reinterpret_cast<const uint16_t*>(imageData.data()), rgba16.data(), pixelCount);
+            return exporter.SaveImageData16WithWIC(filePath, rgba16.data(), realWidth, realHeight, exportFormat);
+        }
+
         // 保存原图分辨率的数据
         return exporter.SaveImageDataWithWIC(filePath, imageData.data(), realWidth, realHeight, stride, exportFormat, quality);
     }
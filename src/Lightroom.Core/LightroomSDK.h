@@ -13,12 +13,26 @@ extern "C" {
     // 初始化SDK
     LIGHTROOM_API bool InitSDK();
 
+    // 使用指定渲染后端初始化SDK
+    // backend: RenderBackend 枚举值（定义在 LightroomSDKTypes.h 中）
+    // 软件后端没有 D3D9 共享表面，GetRenderTargetSharedHandle 返回 nullptr，只适用于导出/批处理
+    LIGHTROOM_API bool InitSDKWithBackend(uint32_t backend);
+
+    // 当前是否运行在 CPU 软件渲染后端上
+    LIGHTROOM_API bool IsSoftwareRendering();
+
     // 释放SDK资源
     LIGHTROOM_API void ShutdownSDK();
     
     // 获取SDK版本（重命名避免与 Windows API 冲突）
     LIGHTROOM_API int GetSDKVersion();
 
+    // 纹理内存预算（字节，所有渲染目标合计，默认 2 GB，0 = 不限制）
+    // 超出预算时，最久未渲染的渲染目标释放可重建的缓存（渲染图中间结果、代理图像），下次渲染时重新创建
+    // 已加载的图片与视频帧纹理不会被回收，只计入 GetMemoryStats 的总量
+    LIGHTROOM_API void SetMemoryBudget(uint64_t budgetBytes);
+    LIGHTROOM_API bool GetMemoryStats(struct MemoryStats* outStats);
+
     // D3D11 渲染接口 - 图片编辑区渲染目标
     // 创建渲染目标纹理（用于图片编辑区，支持共享以便在 WPF 中显示）
     LIGHTROOM_API void* CreateRenderTarget(uint32_t width, uint32_t height);
@@ -32,6 +46,21 @@ extern "C" {
     // 加载图片到渲染目标
     LIGHTROOM_API bool LoadImageToTarget(void* renderTargetHandle, const char* imagePath);
     
+    // 渐进式加载图片
+    // RAW 文件：立即显示内嵌 JPEG 预览（或半尺寸去马赛克），同时在后台线程进行完整质量的去马赛克，
+    // 完成后回调；之后的下一次 RenderToTarget 自动替换为完整质量的图像（ExportImage 会等待完整图像）
+    // 其他格式与 LoadImageToTarget 相同，返回前即回调
+    // 回调可能在后台线程上调用；再次加载、销毁渲染目标或 ShutdownSDK 返回后不再回调
+    // （这些调用会等待正在执行的回调返回，回调中不要同步等待调用它们的线程）
+    typedef void (*ProgressiveLoadCallback)(void* renderTargetHandle, bool success, void* userData);
+    LIGHTROOM_API bool LoadImageProgressive(void* renderTargetHandle, const char* imagePath, ProgressiveLoadCallback callback, void* userData);
+    
+    // 高精度模式（默认关闭）
+    // 开启后 RAW 以 16-bit 解码并以 RGBA FP16 纹理保存，渲染图的中间结果也使用 FP16，
+    // 大幅曝光/阴影调整不再出现色带；ExportImage 导出 PNG/TIFF 时写入 16-bit
+    // 对之后加载的图片生效；软件渲染后端不支持，返回 false
+    LIGHTROOM_API bool SetHighPrecisionMode(void* renderTargetHandle, bool enable);
+    
     // 渲染到渲染目标纹理（双缓冲+拷贝策略）
     LIGHTROOM_API bool RenderToTarget(void* renderTargetHandle);
     
@@ -58,11 +87,19 @@ extern "C" {
     // 重置图像调整参数为默认值
     LIGHTROOM_API void ResetImageAdjustParams(void* renderTargetHandle);
     
+    // 交互编辑代理（默认开启）：调整参数后的短时间内从缩小的代理图像渲染，
+    // 停止操作约 200ms 后下一次 RenderToTarget 自动以全分辨率渲染
+    LIGHTROOM_API void SetProxyEditing(void* renderTargetHandle, bool enable);
+    
     // 获取直方图数据（从渲染后的纹理读取）
     // outHistogram: 输出数组，大小为 256 * 4 (R, G, B, Luminance)，每个通道 256 个值
     // 返回是否成功
     LIGHTROOM_API bool GetHistogramData(void* renderTargetHandle, uint32_t* outHistogram);
     
+    // 获取降采样的直方图（每 sampleStep 行、sampleStep 列取一个像素，4 = 1/16 像素）
+    // 用于拖动滑块时的实时更新；画面没有变化时两个接口都直接返回缓存的结果
+    LIGHTROOM_API bool GetHistogramDataSampled(void* renderTargetHandle, uint32_t sampleStep, uint32_t* outHistogram);
+    
     // 滤镜相关 API
     // 加载 LUT 滤镜到渲染目标
     // lutSize: LUT 尺寸（例如 32 表示 32x32x32 的 3D LUT）
@@ -81,6 +118,16 @@ extern "C" {
     // 移除滤镜（从渲染图中移除 FilterNode）
     LIGHTROOM_API void RemoveFilter(void* renderTargetHandle);
     
+    // 批量生成滤镜预览（滤镜选择器的预览条）
+    // 当前调整后的图像只渲染一次（按比例适应 tileWidth x tileHeight），然后在 CPU 上并行应用所有 LUT
+    // 预览只包含滤镜之前的处理（颗粒等滤镜之后的效果不显示），插值方式与当前渲染后端的 FilterNode 相同
+    // lutPaths: .cube 文件路径数组（UTF-8 编码），count 个
+    // outBuffers: count 个输出缓冲区，每个大小为 tileWidth * tileHeight * 4（BGRA8，紧密排列）；
+    //             LUT 加载失败时对应的缓冲区写入未加滤镜的预览
+    // 返回成功应用滤镜的预览数量
+    LIGHTROOM_API uint32_t RenderFilterPreviews(void* renderTargetHandle, const char** lutPaths, uint32_t count,
+                                                uint32_t tileWidth, uint32_t tileHeight, uint8_t** outBuffers);
+    
     // 视频相关 API
     // 打开视频文件到渲染目标
     // videoPath: 视频文件路径（UTF-8 编码）
@@ -117,6 +164,15 @@ extern "C" {
     // 返回当前时间戳，如果未打开视频则返回 -1
     LIGHTROOM_API int64_t GetCurrentVideoTimestamp(void* renderTargetHandle);
     
+    // 设置视频预解码队列容量（帧数，0 = 默认 6 帧）
+    // 软件解码时由后台线程提前解码，队列越长越能吸收单帧解码耗时的波动，内存占用也越大
+    // 对当前视频立即生效，之后打开的视频同样使用该值
+    LIGHTROOM_API void SetVideoDecodeQueueCapacity(void* renderTargetHandle, uint32_t capacity);
+    
+    // 获取视频预解码队列统计（队列深度、累计解码帧数、欠载次数）
+    // 硬件解码路径没有解码队列，返回 false
+    LIGHTROOM_API bool GetVideoDecodeQueueStats(void* renderTargetHandle, struct VideoDecodeQueueStats* outStats);
+    
     // 检查文件是否为视频格式
     // filePath: 文件路径（UTF-8 编码）
     // 返回是否为视频格式
@@ -132,12 +188,50 @@ extern "C" {
     // 返回是否成功，如果成功，outData包含像素数据
     LIGHTROOM_API bool ExtractVideoThumbnail(const char* videoPath, uint32_t* outWidth, uint32_t* outHeight, uint8_t* outData, uint32_t maxWidth, uint32_t maxHeight);
     
+    // 缩略图缓存相关 API
+    // 缩略图（BGRA32，长边不超过 maxDimension）持久化在磁盘上的单个包文件中，
+    // 缓存键为 文件路径 + 文件大小 + 修改时间 + maxDimension，文件修改后自动失效
+    
+    // 设置缩略图缓存目录（UTF-8 编码），默认 %LOCALAPPDATA%\Lightroom\ThumbnailCache
+    LIGHTROOM_API bool SetThumbnailCacheDirectory(const char* directory);
+    
+    // 只查询缓存，不解码文件（命中时只有一次内存拷贝）
+    // filePath: 图片或视频文件路径（UTF-8 编码）
+    // outData: 输出像素数据（BGRA32），为 nullptr 时只返回尺寸
+    // outDataSize: outData 的字节数，小于 width*height*4 时返回 false
+    // 返回是否命中
+    LIGHTROOM_API bool GetCachedThumbnail(const char* filePath, uint32_t maxDimension, uint32_t* outWidth, uint32_t* outHeight, uint8_t* outData, uint32_t outDataSize);
+    
+    // 获取缩略图：先查询缓存，未命中时解码文件（图片在 CPU 上缩小解码，视频取第一个关键帧）并写入缓存
+    // 参数同 GetCachedThumbnail，outData 不能为空，建议大小 maxDimension*maxDimension*4
+    LIGHTROOM_API bool GetThumbnail(const char* filePath, uint32_t maxDimension, uint32_t* outWidth, uint32_t* outHeight, uint8_t* outData, uint32_t outDataSize);
+    
+    // 清空缩略图缓存
+    LIGHTROOM_API bool ClearThumbnailCache();
+    
+    // 批量生成缩略图（异步）
+    // 在后台线程池（线程数 = CPU 核心数）上并行生成，每个文件完成后立即回调，回调顺序与输入顺序无关
+    // RAW 使用内嵌 JPEG 预览，JPEG 按降低的分辨率解码，视频只解码第一个关键帧；结果同样写入缩略图缓存
+    // 回调在工作线程上调用，data 只在回调期间有效（BGRA32，width*height*4 字节），失败或取消时 success 为 false
+    typedef void (*ThumbnailBatchCallback)(uint32_t batchId, uint32_t index, const char* filePath, bool success,
+                                           uint32_t width, uint32_t height, const uint8_t* data, void* userData);
+    
+    // filePaths: 文件路径数组（UTF-8 编码），调用返回后即可释放
+    // maxWidth/maxHeight: 缩略图尺寸上限（保持宽高比）
+    // 返回批次 ID（用于取消），参数无效或 SDK 正在关闭时返回 0（不回调）；否则每个文件恰好回调一次，
+    // ShutdownSDK 会等待所有回调完成（未开始的文件以 success = false 回调）
+    LIGHTROOM_API uint32_t GenerateThumbnailsBatch(const char** filePaths, uint32_t count, uint32_t maxWidth, uint32_t maxHeight, ThumbnailBatchCallback callback, void* userData);
+    
+    // 取消批量生成：尚未开始的文件以 success=false 回调
+    LIGHTROOM_API void CancelThumbnailBatch(uint32_t batchId);
+    
     // 导出图片相关 API
     // 从渲染目标导出图片到文件
     // renderTargetHandle: 渲染目标句柄
     // filePath: 输出文件路径（UTF-8 编码）
-    // format: 导出格式（"png" 或 "jpeg"）
-    // quality: JPEG 质量（1-100，仅对 JPEG 有效，PNG 忽略此参数）
+    // format: 导出格式（"png"、"jpeg" 或 "tiff"）
+    // quality: JPEG 质量（1-100，仅对 JPEG 有效，PNG/TIFF 忽略此参数）
+    // 高精度模式下 PNG/TIFF 为 16-bit
     // 返回是否成功
     LIGHTROOM_API bool ExportImage(void* renderTargetHandle, const char* filePath, const char* format, uint32_t quality);
     
@@ -94,6 +94,13 @@ extern "C" {
         float blueSaturation;    // 蓝色饱和度 (-100 to +100)
     };
 
+    // 渲染后端枚举（C 兼容，InitSDKWithBackend 使用）
+    enum RenderBackend {
+        RenderBackend_Auto = 0,      // 优先 D3D11，不可用时回退到软件渲染
+        RenderBackend_D3D11 = 1,
+        RenderBackend_Software = 2   // CPU 软件渲染（无 GPU 的批处理/导出机器）
+    };
+
     // 视频格式枚举（C 兼容）
     enum VideoFormat {
         VideoFormat_Unknown = 0,
@@ -113,4 +120,22 @@ extern "C" {
         VideoFormat format;
         bool hasAudio;
     };
+
+    // 视频预解码队列统计
+    struct VideoDecodeQueueStats {
+        uint32_t queueDepth;      // 已解码、等待显示的帧数
+        uint32_t queueCapacity;   // 队列容量
+        uint64_t framesDecoded;   // 解码线程累计输出的帧数
+        uint64_t underruns;       // 取帧时队列为空、需要等待解码的次数
+    };
+
+    // 纹理内存统计（所有渲染目标合计）
+    struct MemoryStats {
+        uint64_t gpuBytes;        // GPU 纹理与渲染目标
+        uint64_t systemBytes;     // 软件渲染后端的纹理（系统内存）
+        uint32_t textureCount;
+        uint32_t cacheCount;      // 参与回收的渲染目标缓存数量
+        uint64_t budgetBytes;     // 预算（0 = 不限制）
+        uint64_t evictions;       // 累计回收次数
+    };
 }
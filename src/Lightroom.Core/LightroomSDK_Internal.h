@@ -8,10 +8,18 @@
 #include "RenderGraph.h"
 #include "ImageProcessing/ImageLoader.h"
 #include "ImageProcessing/RAWImageInfo.h"
+#include "ImageProcessing/Histogram.h"
+#include "ProxyPyramid.h"
 #include "VideoProcessing/VideoProcessor.h"
 #include "VideoProcessing/VideoExporter.h"
 #include <memory>
 #include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <d3d11.h>
+#include <wrl/client.h>
 
 namespace RenderCore {
     class DynamicRHI;
@@ -23,6 +31,27 @@ namespace LightroomCore {
     class VideoProcessor;
 }
 
+// 渐进式加载的后台解码状态（由后台线程和渲染目标共同持有）
+// 后台线程只写入 CPU 端的解码结果，纹理在渲染线程上创建，避免跨线程使用设备上下文
+struct ProgressiveLoadState {
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    bool bFinished = false;                 // 后台解码已结束（无论成功与否）
+    bool bSucceeded = false;
+    std::atomic<bool> bCancelled{ false };  // 渲染目标已加载其他内容或已销毁
+    std::atomic<bool> bThreadExited{ false };  // 后台线程已返回，可以立即 join
+    LightroomCore::DecodedImage Result;
+    
+    // 完成回调与取消互斥：Cancel 返回后回调不会再开始，也不会仍在执行
+    // 使用递归锁，回调内可以重入 SDK（例如加载新图片时取消自身）
+    std::recursive_mutex CallbackMutex;
+    
+    void Cancel() {
+        std::lock_guard<std::recursive_mutex> lock(CallbackMutex);
+        bCancelled = true;
+    }
+};
+
 // 渲染目标关联的渲染图（每个渲染目标可以有独立的渲染图）
 struct RenderTargetData {
     std::shared_ptr<RenderCore::RHITexture2D> ImageTexture;  // 加载的图片纹理
@@ -30,16 +59,44 @@ struct RenderTargetData {
     bool bHasImage;
     LightroomCore::ImageFormat ImageFormat;      // 图片格式（Standard 或 RAW）
     std::unique_ptr<LightroomCore::RAWImageInfo> RAWInfo;  // RAW 信息（仅在 RAW 格式时有效）
+    std::shared_ptr<LightroomCore::ITileSource> TileSource;  // 大图的全分辨率分块源（ImageTexture 为代理）
+    uint32_t ImageWidth;   // 当前显示图像的尺寸（缩放节点的输入尺寸）
+    uint32_t ImageHeight;
+    bool bHighPrecision;   // 高精度模式：RAW 使用 FP16 纹理，渲染图中间结果使用 FP16
+    
+    // 交互编辑代理：调整参数后的短时间内从代理分辨率渲染，停止操作后自动回到全分辨率
+    std::unique_ptr<LightroomCore::ProxyPyramid> Proxies;
+    bool bProxyEditing;
+    std::chrono::steady_clock::time_point LastInteractiveEdit;
+    double ViewZoom;       // SetRenderTargetZoom 设置的缩放，代理至少要覆盖 目标尺寸 x 缩放
+    
+    // 渐进式加载：后台完整解码尚未替换到 ImageTexture 时有效
+    std::shared_ptr<ProgressiveLoadState> ProgressiveLoad;
     
     // 视频相关
     std::unique_ptr<LightroomCore::VideoProcessor> VideoProcessor;
     bool bIsVideo;
     std::string VideoFilePath;  // 视频文件路径（UTF-8编码），用于导出时创建独立的VideoProcessor
+    uint32_t VideoDecodeQueueCapacity;  // 预解码队列容量（0 = 默认），打开视频时应用
+    
+    // 直方图
+    uint64_t PresentedContentKey;  // Front Buffer 当前内容的键（渲染图输出键，0 表示未知）
+    LightroomCore::HistogramCache Histogram;
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> HistogramStaging;  // D3D11 回读用的 staging 纹理，尺寸不变时复用
     
     // 视频导出相关
     std::unique_ptr<LightroomCore::VideoExporter> VideoExporter;
     
-    RenderTargetData() : bHasImage(false), ImageFormat(LightroomCore::ImageFormat::Unknown), bIsVideo(false) {}
+    RenderTargetData() : bHasImage(false), ImageFormat(LightroomCore::ImageFormat::Unknown), ImageWidth(0), ImageHeight(0), bHighPrecision(false), bProxyEditing(true), ViewZoom(1.0), bIsVideo(false), VideoDecodeQueueCapacity(0), PresentedContentKey(0) {}
+    ~RenderTargetData() { CancelProgressiveLoad(); }
+    
+    // 放弃进行中的渐进式加载（返回后不再回调；后台线程由 SDK 持有，ShutdownSDK 时等待结束）
+    void CancelProgressiveLoad() {
+        if (ProgressiveLoad) {
+            ProgressiveLoad->Cancel();
+            ProgressiveLoad.reset();
+        }
+    }
 };
 
 // 前向声明
@@ -58,3 +115,11 @@ namespace LightroomCore {
 }
 extern LightroomCore::D3D9Interop* g_D3D9InteropPtr;
 
+// 缩略图缓存（在 LightroomSDK_Thumbnail.cpp 中定义）
+namespace LightroomCore {
+    class ThumbnailCache;
+}
+// 获取全局缩略图缓存（首次调用时打开默认目录），不可用时返回 nullptr
+std::shared_ptr<LightroomCore::ThumbnailCache> GetThumbnailCache();
+void CloseThumbnailCache();
+
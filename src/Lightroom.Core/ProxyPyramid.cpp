@@ -0,0 +1,85 @@
+﻿#include "ProxyPyramid.h"
+#include "RenderNodes/DownsampleNode.h"
+#include <iostream>
+
+namespace LightroomCore {
+
+ProxyPyramid::ProxyPyramid(std::shared_ptr<RenderCore::DynamicRHI> rhi)
+    : m_RHI(rhi)
+{
+}
+
+ProxyPyramid::~ProxyPyramid() {
+    Clear();
+}
+
+void ProxyPyramid::Clear() {
+    m_Levels.clear();
+    m_Source.reset();
+}
+
+bool ProxyPyramid::Build(std::shared_ptr<RenderCore::RHITexture2D> source) {
+    if (!m_RHI || !source) {
+        return false;
+    }
+    if (m_Source.lock() == source) {
+        return true;
+    }
+    Clear();
+
+    if (!m_DownsampleNode) {
+        m_DownsampleNode = std::make_shared<DownsampleNode>(m_RHI);
+    }
+
+    std::shared_ptr<RenderCore::RHITexture2D> previous = source;
+    for (uint32_t level = 0; level < kMaxLevels; ++level) {
+        const core::vec2i size = previous->GetSize();
+        const uint32_t width = static_cast<uint32_t>(size.x) / 2;
+        const uint32_t height = static_cast<uint32_t>(size.y) / 2;
+        if (width < kMinProxySize || height < kMinProxySize) {
+            break;
+        }
+
+        auto texture = m_RHI->RHICreateTexture2D(
+            source->GetPixelFormat(),
+            RenderCore::ETextureCreateFlags::TexCreate_RenderTargetable | RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+            width,
+            height,
+            1
+        );
+        if (!texture || !m_DownsampleNode->Execute(previous, texture, width, height)) {
+            std::cerr << "[ProxyPyramid] Failed to build level " << (level + 1) << std::endl;
+            break;
+        }
+        m_Levels.push_back(texture);
+        previous = texture;
+    }
+
+    auto commandContext = m_RHI->GetDefaultCommandContext();
+    if (commandContext) {
+        commandContext->FlushCommands();
+    }
+
+    m_Source = source;
+    return !m_Levels.empty();
+}
+
+std::shared_ptr<RenderCore::RHITexture2D> ProxyPyramid::Select(std::shared_ptr<RenderCore::RHITexture2D> source,
+                                                               uint32_t requiredWidth, uint32_t requiredHeight) const {
+    if (!source || m_Source.lock() != source) {
+        return source;
+    }
+
+    // 层级越往后越小，取最后一个仍然满足需要的
+    std::shared_ptr<RenderCore::RHITexture2D> selected = source;
+    for (const auto& level : m_Levels) {
+        const core::vec2i size = level->GetSize();
+        if (static_cast<uint32_t>(size.x) < requiredWidth || static_cast<uint32_t>(size.y) < requiredHeight) {
+            break;
+        }
+        selected = level;
+    }
+    return selected;
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,38 @@
+﻿#pragma once
+
+#include "d3d11rhi/DynamicRHI.h"
+#include "d3d11rhi/RHITexture2D.h"
+#include <memory>
+#include <vector>
+
+namespace LightroomCore {
+
+class DownsampleNode;
+
+// 交互编辑用的代理金字塔：1/2、1/4、1/8 分辨率的输入纹理
+// 拖动滑块时渲染图从满足显示需要的最小代理开始执行，停止操作后再回到全分辨率
+class ProxyPyramid {
+public:
+    explicit ProxyPyramid(std::shared_ptr<RenderCore::DynamicRHI> rhi);
+    ~ProxyPyramid();
+
+    // 为 source 构建代理（逐级 2x 缩小，短边小于 kMinProxySize 时停止）
+    // source 与上次相同时不重建
+    bool Build(std::shared_ptr<RenderCore::RHITexture2D> source);
+    void Clear();
+
+    // 返回宽高都不小于 requiredWidth x requiredHeight 的最小层级；没有合适的代理时返回 source
+    std::shared_ptr<RenderCore::RHITexture2D> Select(std::shared_ptr<RenderCore::RHITexture2D> source,
+                                                     uint32_t requiredWidth, uint32_t requiredHeight) const;
+
+    static constexpr uint32_t kMaxLevels = 3;
+    static constexpr uint32_t kMinProxySize = 256;
+
+private:
+    std::shared_ptr<RenderCore::DynamicRHI> m_RHI;
+    std::shared_ptr<DownsampleNode> m_DownsampleNode;
+    std::weak_ptr<RenderCore::RHITexture2D> m_Source;
+    std::vector<std::shared_ptr<RenderCore::RHITexture2D>> m_Levels;  // 从 1/2 开始逐级缩小
+};
+
+} // namespace LightroomCore
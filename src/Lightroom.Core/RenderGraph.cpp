@@ -3,6 +3,7 @@
 #include "../d3d11rhi/D3D11RHI.h"
 #include "../d3d11rhi/D3D11Texture2D.h"
 #include <iostream>
+#include <algorithm>
 
 namespace LightroomCore {
 
@@ -23,36 +24,154 @@ namespace LightroomCore {
 
 	void RenderGraph::Clear() {
 		m_Nodes.clear();
+		ReleaseResources();
+		m_LastKeys.clear();
+		m_RetainIndex = kNoRetain;
+		// 新节点可能复用旧节点的地址，递增版本号避免与旧的输出键相同
+		++m_InputVersion;
+		m_OutputKey = 0;
+	}
+
+	void RenderGraph::InvalidateCache() {
+		++m_InputVersion;
+		std::fill(m_TextureKeys.begin(), m_TextureKeys.end(), 0);
+	}
+
+	void RenderGraph::ReleaseResources() {
 		m_TexturePool.clear();
+		m_TextureKeys.clear();
+		m_NodeSlots.clear();
+		m_PlanActive.clear();
+		m_PlanRetain = kNoRetain;
+		for (auto& node : m_Nodes) {
+			if (node) {
+				node->ReleaseResources();
+			}
+		}
+	}
+
+	void RenderGraph::SetIntermediateFormat(RenderCore::EPixelFormat format) {
+		if (format == m_IntermediateFormat) {
+			return;
+		}
+		m_IntermediateFormat = format;
+		// 旧格式的纹理在 GetCachedTexture 中按需重建
+		InvalidateCache();
 	}
 
 	bool RenderGraph::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
 		std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
 		uint32_t width, uint32_t height) {
+		m_OutputKey = 0;
 		if (!m_RHI || !inputTexture || !outputTarget || m_Nodes.empty()) {
 			return false;
 		}
 
+		// 计算每个节点输出的缓存键：上游键 + 节点实例 + 节点参数哈希
+		// 输入键由输入纹理、输入版本号和输出尺寸组成
+		const size_t lastIndex = m_Nodes.size() - 1;
+		std::vector<uint64_t> keys(m_Nodes.size());
+		const RenderCore::RHITexture2D* inputIdentity = inputTexture.get();
+		uint64_t upstreamKey = HashValue(inputIdentity, HashValue(m_InputVersion, 0));
+		upstreamKey = HashValue(width, upstreamKey);
+		upstreamKey = HashValue(height, upstreamKey);
+		for (size_t i = 0; i < m_Nodes.size(); ++i) {
+			const RenderNode* nodeIdentity = m_Nodes[i].get();
+			upstreamKey = HashValue(nodeIdentity, upstreamKey);
+			upstreamKey = HashValue(m_Nodes[i]->GetParamsHash(), upstreamKey);
+			keys[i] = (upstreamKey != 0) ? upstreamKey : 1;
+		}
+
 		if (m_Nodes.size() == 1) {
-			return m_Nodes[0]->Execute(inputTexture, outputTarget, width, height);
+			m_Nodes[0]->FoldNext(nullptr);
+			if (!m_Nodes[0]->Execute(inputTexture, outputTarget, width, height)) {
+				return false;
+			}
+			m_OutputKey = keys[0];
+			return true;
+		}
+
+		// 参数变化的第一个节点：保留它的输入（最近的上游执行节点的输出），连续拖动同一个滑块时上游不重新执行
+		// 输入变化（视频帧、代理切换）时所有键都变化，不保留任何中间结果
+		std::vector<uint8_t> active(m_Nodes.size());
+		for (size_t i = 0; i < m_Nodes.size(); ++i) {
+			active[i] = (i == lastIndex || !m_Nodes[i]->IsIdentity()) ? 1 : 0;
+		}
+
+		// 相邻的执行节点尝试合并：被合并的节点不执行，合并它的节点输出等同于它的输出，沿用它的键
+		size_t outputIndex = lastIndex;
+		for (size_t i = 0; i < m_Nodes.size(); ++i) {
+			size_t next = i + 1;
+			while (next < m_Nodes.size() && !active[next]) {
+				++next;
+			}
+			if (!active[i] || next >= m_Nodes.size()) {
+				m_Nodes[i]->FoldNext(nullptr);
+				continue;
+			}
+			if (m_Nodes[i]->FoldNext(m_Nodes[next])) {
+				active[next] = 0;
+				keys[i] = keys[next];
+				if (next == lastIndex) {
+					outputIndex = i;
+				}
+			}
+		}
+
+		size_t firstChanged = 0;
+		if (m_LastKeys.size() == keys.size()) {
+			while (firstChanged < keys.size() && m_LastKeys[firstChanged] == keys[firstChanged]) {
+				++firstChanged;
+			}
+		}
+		if (firstChanged < keys.size()) {
+			m_RetainIndex = kNoRetain;
+			for (size_t i = std::min(firstChanged, outputIndex); i-- > 0;) {
+				if (active[i]) {
+					m_RetainIndex = i;
+					break;
+				}
+			}
 		}
+		m_LastKeys = keys;
 
+		if (m_NodeSlots.size() != m_Nodes.size() || active != m_PlanActive || m_RetainIndex != m_PlanRetain) {
+			PlanTransientTextures(active, outputIndex, m_RetainIndex, keys);
+		}
+
+		// 找到最靠后的、内容仍然有效的中间结果，从它的下一个节点开始执行
+		// 键包含整条上游链，因此命中的缓存一定对应相同的输入和参数
+		size_t startIndex = 0;
 		std::shared_ptr<RenderCore::RHITexture2D> currentInput = inputTexture;
+		for (size_t i = outputIndex; i-- > 0;) {
+			const int32_t slot = m_NodeSlots[i];
+			if (slot >= 0 && m_TextureKeys[slot] == keys[i] && m_TexturePool[slot]) {
+				startIndex = i + 1;
+				currentInput = m_TexturePool[slot];
+				break;
+			}
+		}
+
 		std::shared_ptr<RenderCore::RHITexture2D> currentOutput = nullptr;
+		for (size_t i = startIndex; i < m_Nodes.size(); ++i) {
+			bool isLastNode = (i == outputIndex);
 
-		size_t poolIndex = 0;
-		for (size_t i = 0; i < m_Nodes.size(); ++i) {
-			bool isLastNode = (i == m_Nodes.size() - 1);
+			// 恒等节点和被合并的节点直接把输入传给下一个节点（它的参数哈希仍计入下游的键）
+			if (!active[i]) {
+				continue;
+			}
 
+			const int32_t slot = m_NodeSlots[i];
 			if (isLastNode) {
 				currentOutput = outputTarget;
 			}
 			else {
-				currentOutput = GetCachedTexture(width, height, poolIndex);
-				poolIndex++;
+				currentOutput = GetCachedTexture(width, height, slot);
 				if (!currentOutput) {
 					return false;
 				}
+				// 执行期间内容不确定，先标记为无效（槽位中原来的结果被覆盖）
+				m_TextureKeys[slot] = 0;
 			}
 
 			{
@@ -60,30 +179,77 @@ namespace LightroomCore {
 					return false;
 				}
 			}
+			if (!isLastNode) {
+				m_TextureKeys[slot] = keys[i];
+			}
 			currentInput = currentOutput;
 		}
 
+		m_OutputKey = keys[lastIndex];
 		return true;
 	}
 
-	std::shared_ptr<RenderCore::RHITexture2D> RenderGraph::GetCachedTexture(uint32_t width, uint32_t height, size_t index) {
-		if (index < m_TexturePool.size()) {
-			auto existingTex = m_TexturePool[index];
-			if (existingTex) {
-				// 2. 检查尺寸是否匹配
-				auto* d3dTex = dynamic_cast<RenderCore::D3D11Texture2D*>(existingTex.get());
-				if (d3dTex) {
-					D3D11_TEXTURE2D_DESC desc;
-					d3dTex->GetNativeTex()->GetDesc(&desc);
-					if (desc.Width == width && desc.Height == height) {
-						return existingTex;
-					}
+	void RenderGraph::PlanTransientTextures(const std::vector<uint8_t>& active, size_t outputIndex, size_t retainIndex,
+											const std::vector<uint64_t>& keys) {
+		// 需要中间纹理的节点（执行且不写入输出目标）按执行顺序编号为 step
+		// 第 step 个结果在 step 写入、在 step + 1 被读取，之后即可复用；保留的结果存活到最后
+		// 按开始时间顺序分配（区间分配），链式执行时退化为两张纹理交替使用
+		std::vector<size_t> slotLastUse;  // 每个槽位当前占用者最后被读取的 step
+		m_NodeSlots.assign(m_Nodes.size(), -1);
+
+		size_t step = 0;
+		for (size_t i = 0; i < outputIndex; ++i) {
+			if (!active[i]) {
+				continue;
+			}
+			const size_t lastUse = (i == retainIndex) ? kNoRetain : step + 1;
+
+			// 空闲槽位中优先选择已经保存该结果的，计划变化时仍能命中缓存
+			int32_t chosen = -1;
+			for (size_t slot = 0; slot < slotLastUse.size(); ++slot) {
+				if (slotLastUse[slot] >= step) {
+					continue;
+				}
+				if (chosen < 0) {
+					chosen = static_cast<int32_t>(slot);
 				}
+				if (slot < m_TextureKeys.size() && m_TextureKeys[slot] == keys[i]) {
+					chosen = static_cast<int32_t>(slot);
+					break;
+				}
+			}
+			if (chosen < 0) {
+				chosen = static_cast<int32_t>(slotLastUse.size());
+				slotLastUse.push_back(0);
+			}
+			slotLastUse[chosen] = lastUse;
+			m_NodeSlots[i] = chosen;
+			++step;
+		}
+
+		// 多出的槽位立即释放；保留的槽位中的纹理和缓存键沿用
+		m_TexturePool.resize(slotLastUse.size());
+		m_TextureKeys.resize(slotLastUse.size(), 0);
+		m_PlanActive = active;
+		m_PlanRetain = retainIndex;
+	}
+
+	std::shared_ptr<RenderCore::RHITexture2D> RenderGraph::GetCachedTexture(uint32_t width, uint32_t height, size_t slot) {
+		auto existingTex = m_TexturePool[slot];
+		if (existingTex) {
+			// 尺寸和格式都匹配时复用（通过 RHI 接口，D3D11 与软件后端通用）
+			core::vec2i size = existingTex->GetSize();
+			if (size.x == static_cast<int32_t>(width) && size.y == static_cast<int32_t>(height) &&
+				existingTex->GetPixelFormat() == m_IntermediateFormat) {
+				return existingTex;
 			}
 		}
 
+		// 先释放旧纹理，避免新旧两张同时占用内存
+		m_TexturePool[slot].reset();
+		m_TextureKeys[slot] = 0;
 		auto newTexture = m_RHI->RHICreateTexture2D(
-			RenderCore::EPixelFormat::PF_B8G8R8A8,
+			m_IntermediateFormat,
 			RenderCore::ETextureCreateFlags::TexCreate_RenderTargetable | RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
 			width,
 			height,
@@ -93,12 +259,7 @@ namespace LightroomCore {
 		if (!newTexture)
 			return nullptr;
 
-		if (index < m_TexturePool.size()) {
-			m_TexturePool[index] = newTexture;
-		}
-		else {
-			m_TexturePool.push_back(newTexture);
-		}
+		m_TexturePool[slot] = newTexture;
 		return newTexture;
 	}
 
@@ -23,10 +23,33 @@ public:
     // inputTexture: 输入纹理
     // outputTarget: 输出渲染目标纹理
     // width, height: 输出尺寸
+    // 中间结果按 (上游哈希, 节点参数哈希) 缓存，只从第一个参数变化的节点开始重新执行；
+    // 最后一个节点总是执行（输出目标每次可能不同）；IsIdentity() 为 true 的中间节点被跳过，
+    // 被前一个节点合并（RenderNode::FoldNext）的节点也被跳过
+    // 中间纹理按生命周期复用：链式执行时只有相邻两个结果同时存活，交替使用两张纹理，
+    // 另外保留最近一次参数变化的节点的输入，连续调整同一节点时上游不重新执行
     bool Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
                  std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
                  uint32_t width, uint32_t height);
 
+    // 输入纹理内容被原地更新时（例如视频帧复用同一纹理）调用，使所有缓存的中间结果失效
+    void InvalidateCache();
+
+    // 释放中间结果纹理和各节点内部的纹理（内存预算回收时调用），下次执行时重新创建并完整渲染
+    void ReleaseResources();
+
+    // 最近一次成功执行的输出内容键（输入、全部节点及其参数、输出尺寸的哈希，0 表示未知）
+    // 键相同说明输出画面相同，可用于缓存基于输出计算的结果（例如直方图）
+    uint64_t GetOutputKey() const { return m_OutputKey; }
+
+    // 中间结果纹理格式（默认 PF_B8G8R8A8）
+    // 高精度模式使用 PF_FloatRGBA，节点之间传递 FP16 数据，多次调整叠加不会产生色带
+    void SetIntermediateFormat(RenderCore::EPixelFormat format);
+    RenderCore::EPixelFormat GetIntermediateFormat() const { return m_IntermediateFormat; }
+
+    // 当前分配的中间纹理数量
+    size_t GetTransientTextureCount() const { return m_TexturePool.size(); }
+
     // 获取节点数量
     size_t GetNodeCount() const { return m_Nodes.size(); }
 
@@ -39,10 +62,32 @@ public:
     }
 
 private:
-	std::shared_ptr<RenderCore::RHITexture2D> GetCachedTexture(uint32_t width, uint32_t height, size_t index);
+	static constexpr size_t kNoRetain = static_cast<size_t>(-1);
+
+	// 根据各节点输出的生命周期为中间结果分配纹理槽位（m_NodeSlots）
+	// active[i] 表示节点 i 会执行，outputIndex 为写入输出目标的节点；
+	// retainIndex 的输出一直存活到图执行结束，不被其他结果覆盖
+	void PlanTransientTextures(const std::vector<uint8_t>& active, size_t outputIndex, size_t retainIndex,
+							   const std::vector<uint64_t>& keys);
+	std::shared_ptr<RenderCore::RHITexture2D> GetCachedTexture(uint32_t width, uint32_t height, size_t slot);
 	std::shared_ptr<RenderCore::DynamicRHI> m_RHI;
 	std::vector<std::shared_ptr<RenderNode>> m_Nodes;
+	// 中间纹理槽位（多个节点的输出分时复用同一张纹理）
 	std::vector<std::shared_ptr<RenderCore::RHITexture2D>> m_TexturePool;
+	// m_TexturePool[slot] 当前内容对应的缓存键（0 表示无效）
+	std::vector<uint64_t> m_TextureKeys;
+	// 节点输出所在的槽位，-1 表示不需要中间纹理（恒等节点、最后一个节点）
+	std::vector<int32_t> m_NodeSlots;
+	// 生成 m_NodeSlots 时的执行节点与保留节点，二者不变时沿用
+	std::vector<uint8_t> m_PlanActive;
+	size_t m_PlanRetain = kNoRetain;
+	// 上一次执行的各节点键，用于找出参数变化的节点
+	std::vector<uint64_t> m_LastKeys;
+	size_t m_RetainIndex = kNoRetain;
+	// 输入版本号，InvalidateCache 时递增
+	uint64_t m_InputVersion = 0;
+	uint64_t m_OutputKey = 0;
+	RenderCore::EPixelFormat m_IntermediateFormat = RenderCore::EPixelFormat::PF_B8G8R8A8;
 };
 
 } // namespace LightroomCore
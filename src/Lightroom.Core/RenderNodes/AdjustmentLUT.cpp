@@ -0,0 +1,106 @@
+﻿#include "AdjustmentLUT.h"
+#include "LUTKernel.h"
+#include "../ImageProcessing/HalfFloat.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <algorithm>
+
+namespace LightroomCore {
+
+bool AdjustmentLUT::Compile(const ImageAdjustConstantBuffer& params, const AdjustmentLUTFilter* filter, uint32_t size) {
+    const ImageAdjustKernel kernel(params);
+    const bool applyFilter = filter && filter->Data && filter->Size >= 2 && filter->Intensity > 0.0f;
+    if (size < 2 || (!kernel.HasPointAdjustments() && !applyFilter)) {
+        Clear();
+        return false;
+    }
+
+    m_Size = size;
+    m_Data.resize(static_cast<size_t>(size) * size * size * 3);
+
+    LUTKernel filterKernel(applyFilter ? filter->Data : nullptr, applyFilter ? filter->Size : 0,
+                           LUTInterpolation::Tetrahedral, 1.0f);
+    const float intensity = applyFilter ? std::min(filter->Intensity, 1.0f) : 0.0f;
+    const float scale = 1.0f / static_cast<float>(size - 1);
+
+    // 每个 B 切片一个任务：切片内 size^2 个格点展开为 SoA，一次送入 SIMD 路径
+    RenderCore::SoftwareTaskPool::Get().ParallelFor(size, [&](uint32_t blue) {
+        const int32_t count = static_cast<int32_t>(size * size);
+        std::vector<float> scratch(static_cast<size_t>(count) * (applyFilter ? 6 : 3));
+        float* r = scratch.data();
+        float* g = r + count;
+        float* b = g + count;
+        for (uint32_t green = 0; green < size; ++green) {
+            for (uint32_t red = 0; red < size; ++red) {
+                const uint32_t index = green * size + red;
+                r[index] = red * scale;
+                g[index] = green * scale;
+                b[index] = blue * scale;
+            }
+        }
+
+        kernel.EvaluatePoints(r, g, b, count);
+
+        float* outR = r;
+        float* outG = g;
+        float* outB = b;
+        if (applyFilter) {
+            // 未合并时滤镜读取的是 ImageAdjust 裁剪后的输出
+            for (int32_t i = 0; i < count; ++i) {
+                r[i] = std::min(std::max(r[i], 0.0f), 1.0f);
+                g[i] = std::min(std::max(g[i], 0.0f), 1.0f);
+                b[i] = std::min(std::max(b[i], 0.0f), 1.0f);
+            }
+            outR = b + count;
+            outG = outR + count;
+            outB = outG + count;
+            filterKernel.InterpolateRow(r, g, b, outR, outG, outB, count);
+            for (int32_t i = 0; i < count; ++i) {
+                outR[i] = r[i] + (outR[i] - r[i]) * intensity;
+                outG[i] = g[i] + (outG[i] - g[i]) * intensity;
+                outB[i] = b[i] + (outB[i] - b[i]) * intensity;
+            }
+        }
+
+        float* slice = m_Data.data() + static_cast<size_t>(blue) * count * 3;
+        for (int32_t i = 0; i < count; ++i) {
+            slice[i * 3 + 0] = outR[i];
+            slice[i * 3 + 1] = outG[i];
+            slice[i * 3 + 2] = outB[i];
+        }
+    });
+    return true;
+}
+
+void AdjustmentLUT::Clear() {
+    m_Data.clear();
+    m_Data.shrink_to_fit();
+    m_Size = 0;
+}
+
+bool AdjustmentLUT::ConvertTo2DHalf(std::vector<uint16_t>& outData) const {
+    if (m_Data.empty()) {
+        return false;
+    }
+
+    const size_t size = m_Size;
+    const size_t width = size * size;
+    std::vector<float> texels(width * size * 4);
+    for (size_t blue = 0; blue < size; ++blue) {
+        for (size_t green = 0; green < size; ++green) {
+            const float* src = m_Data.data() + ((blue * size + green) * size) * 3;
+            float* dst = texels.data() + (green * width + blue * size) * 4;
+            for (size_t red = 0; red < size; ++red) {
+                dst[red * 4 + 0] = src[red * 3 + 0];
+                dst[red * 4 + 1] = src[red * 3 + 1];
+                dst[red * 4 + 2] = src[red * 3 + 2];
+                dst[red * 4 + 3] = 1.0f;
+            }
+        }
+    }
+
+    outData.resize(texels.size());
+    FloatToHalfArray(texels.data(), outData.data(), texels.size());
+    return true;
+}
+
+} // namespace LightroomCore
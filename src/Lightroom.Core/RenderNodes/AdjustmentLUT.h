@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include "ImageAdjustKernel.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace LightroomCore {
+
+// 合并到调整之后的滤镜 LUT（FilterNode 加载的 .cube 数据）
+struct AdjustmentLUTFilter {
+    const float* Data = nullptr;    // RGB float，大小为 Size^3 * 3，Red 变化最快
+    uint32_t Size = 0;
+    float Intensity = 1.0f;         // 0.0 = 不应用，1.0 = 完全应用
+};
+
+// 调整编译器：把 ImageAdjust 的逐点部分（色温、曝光、高光/阴影/白色/黑色、对比度、饱和度），
+// 以及可选的滤镜 LUT，预先计算为一张 3D LUT。
+// 参数变化时重新编译一次（格点按 B 切片分发到 SoftwareTaskPool，每个切片用 ImageAdjustKernel 的 SIMD 路径计算），
+// 之后每个像素只需一次插值查表，与启用了多少个滑块无关。
+class AdjustmentLUT {
+public:
+    // 33^3 时查表误差低于 8-bit 量化（GPU 路径，RGBA FP16 纹理），导出等 CPU 路径使用 65^3
+    static constexpr uint32_t kPreviewSize = 33;
+    static constexpr uint32_t kExportSize = 65;
+
+    // 编译 params 的逐点部分，filter 不为空时在其后叠加滤镜（滤镜的输入先裁剪到 [0, 1]）
+    // 没有任何逐点调整也没有滤镜时返回 false 并清空 LUT，调用方直接跳过查表
+    bool Compile(const ImageAdjustConstantBuffer& params, const AdjustmentLUTFilter* filter, uint32_t size);
+    void Clear();
+
+    bool IsEmpty() const { return m_Data.empty(); }
+    const float* GetData() const { return m_Data.empty() ? nullptr : m_Data.data(); }
+    uint32_t GetSize() const { return m_Size; }
+
+    // GPU 纹理数据：与 FilterNode 相同的 2D 切片布局（宽 Size * Size，B 沿 X 方向分块；高 Size 对应 G），
+    // 每个纹素为 RGBA FP16（PF_FloatRGBA）
+    bool ConvertTo2DHalf(std::vector<uint16_t>& outData) const;
+
+private:
+    std::vector<float> m_Data;  // RGB float，Red 变化最快
+    uint32_t m_Size = 0;
+};
+
+} // namespace LightroomCore
@@ -0,0 +1,114 @@
+﻿#include "DownsampleNode.h"
+#include "SoftwareNodeUtils.h"
+#include <iostream>
+#include <vector>
+
+namespace LightroomCore {
+
+DownsampleNode::DownsampleNode(std::shared_ptr<RenderCore::DynamicRHI> rhi)
+    : RenderNode(rhi)
+{
+    InitializeShaderResources();
+}
+
+DownsampleNode::~DownsampleNode() {
+    m_Shader.VS.Reset();
+    m_Shader.PS.Reset();
+    m_Shader.InputLayout.Reset();
+    m_Shader.Blob.Reset();
+}
+
+bool DownsampleNode::InitializeShaderResources() {
+    if (m_ShaderResourcesInitialized || !m_RHI || IsSoftwareRHI()) {
+        return m_ShaderResourcesInitialized;
+    }
+
+    const char* vsCode = R"(
+        struct VSInput {
+            float2 Position : POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        struct VSOutput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        VSOutput main(VSInput input) {
+            VSOutput output;
+            output.Position = float4(input.Position, 0.0, 1.0);
+            output.TexCoord = input.TexCoord;
+            return output;
+        }
+    )";
+
+    const char* psCode = R"(
+        Texture2D InputTexture : register(t0);
+        SamplerState InputSampler : register(s0);
+        struct PSInput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        float4 main(PSInput input) : SV_TARGET {
+            return InputTexture.Sample(InputSampler, input.TexCoord);
+        }
+    )";
+
+    if (!CompileShaders(vsCode, psCode, m_Shader)) {
+        std::cerr << "[DownsampleNode] Failed to compile shaders" << std::endl;
+        return false;
+    }
+
+    m_ShaderResourcesInitialized = true;
+    m_CurrentShader = &m_Shader;
+    return true;
+}
+
+void DownsampleNode::SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) {
+    m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, 0, inputTexture);
+    m_CommandContext->RHISetShaderSampler(RenderCore::EShaderFrequency::SF_Pixel, 0, m_CommonSamplerState);
+}
+
+bool DownsampleNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                             std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                             uint32_t width, uint32_t height) {
+    if (IsSoftwareRHI()) {
+        return ExecuteSoftware(inputTexture, outputTarget, width, height);
+    }
+
+    if (!m_ShaderResourcesInitialized) {
+        return false;
+    }
+
+    m_CurrentShader = &m_Shader;
+    return RenderNode::Execute(inputTexture, outputTarget, width, height);
+}
+
+bool DownsampleNode::ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                     std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                     uint32_t width, uint32_t height) {
+    RenderCore::SoftwareTexture2D* input = GetSoftwareTexture(inputTexture);
+    RenderCore::SoftwareTexture2D* output = GetSoftwareTexture(outputTarget);
+    if (!IsSoftwareBGRA8Pair(input, output, width, height) || width == 0 || height == 0) {
+        return false;
+    }
+
+    // 与 GPU 相同的映射：输出像素中心 -> 纹理坐标 -> 输入纹素空间
+    const float scaleX = static_cast<float>(input->GetSize().x) / static_cast<float>(width);
+    const float scaleY = static_cast<float>(input->GetSize().y) / static_cast<float>(height);
+    std::vector<float> sourceX(width);
+    for (uint32_t x = 0; x < width; ++x) {
+        sourceX[x] = (x + 0.5f) * scaleX;
+    }
+
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t rowBegin, int32_t rowEnd) {
+        for (int32_t y = rowBegin; y < rowEnd; ++y) {
+            const float sourceY = (y + 0.5f) * scaleY;
+            uint8_t* dst = output->GetRow(y);
+            for (uint32_t x = 0; x < width; ++x, dst += 4) {
+                SampleBilinearBGRA8(input, sourceX[x], sourceY, dst);
+            }
+        }
+    });
+    return true;
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include "RenderNode.h"
+#include <memory>
+
+namespace LightroomCore {
+
+// 缩小节点：把输入纹理整幅重采样到输出尺寸（双线性）
+// 输出恰好为输入一半时每个输出像素落在 2x2 输入像素中心，等价于 2x2 盒式滤波，用于逐级构建代理金字塔
+class DownsampleNode : public RenderNode {
+public:
+    DownsampleNode(std::shared_ptr<RenderCore::DynamicRHI> rhi);
+    virtual ~DownsampleNode();
+
+    virtual bool Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                        std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                        uint32_t width, uint32_t height) override;
+
+    virtual const char* GetName() const override { return "Downsample"; }
+
+protected:
+    virtual void SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) override;
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) override;
+
+private:
+    bool InitializeShaderResources();
+
+    CompiledShader m_Shader;
+    bool m_ShaderResourcesInitialized = false;
+};
+
+} // namespace LightroomCore
@@ -1,4 +1,7 @@
 ﻿#include "FilterNode.h"
+#include "LUTKernel.h"
+#include "SoftwareNodeUtils.h"
+#include "../ImageProcessing/CubeLUT.h"
 #include "../d3d11rhi/D3D11RHI.h"
 #include "../d3d11rhi/D3D11UniformBuffer.h"
 #include "../d3d11rhi/D3D11Texture2D.h"
@@ -9,8 +12,6 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <cstring>
 #include <vector>
@@ -38,7 +39,7 @@ FilterNode::~FilterNode() {
 }
 
 bool FilterNode::InitializeShaderResources() {
-    if (m_ShaderResourcesInitialized || !m_RHI) {
+    if (m_ShaderResourcesInitialized || !m_RHI || IsSoftwareRHI()) {
         return m_ShaderResourcesInitialized;
     }
 
@@ -269,6 +270,10 @@ bool FilterNode::LoadLUT(uint32_t lutSize, const float* lutData) {
     }
 
     m_LUTSize = lutSize;
+    ++m_LUTVersion;
+    
+    // CPU 路径（软件 RHI）直接使用浮点 LUT
+    m_LUTData.assign(lutData, lutData + static_cast<size_t>(lutSize) * lutSize * lutSize * 3);
     
     // 更新 Constant Buffer
     if (m_CommandContext && m_ParamsBuffer) {
@@ -287,10 +292,19 @@ bool FilterNode::LoadLUTFromTexture(std::shared_ptr<RenderCore::RHITexture2D> lu
 
     m_LUTTexture = lutTexture;
     m_LUTSize = lutSize;
+    ++m_LUTVersion;
+    m_LUTData.clear();  // 只有纹理，CPU 路径不可用
     
     return true;
 }
 
+uint64_t FilterNode::GetParamsHash() const {
+    uint64_t hash = RenderNode::GetParamsHash();
+    hash = HashValue(m_LUTVersion, hash);
+    hash = HashValue(m_LUTSize, hash);
+    return HashValue(m_Intensity, hash);
+}
+
 bool FilterNode::LoadLUTFromFile(const char* filePath) {
     if (!filePath) {
         return false;
@@ -319,83 +333,14 @@ bool FilterNode::LoadLUTFromFile(const char* filePath) {
         }
     }
 
-    // 打开文件（使用宽字符路径）
-    std::filebuf fileBuf;
-    if (!fileBuf.open(wFilePath, std::ios::in)) {
-        return false;
-    }
-    std::istream file(&fileBuf);
-
-    uint32_t lutSize = 0;
-    float domainMin[3] = { 0.0f, 0.0f, 0.0f };
-    float domainMax[3] = { 1.0f, 1.0f, 1.0f };
-    std::vector<float> lutData; // 存储 RGB 浮点数
-    
-    std::string line;
-    bool foundLUTSize = false;
-    bool foundDomainMin = false;
-    bool foundDomainMax = false;
-    
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
-        line.erase(0, line.find_first_not_of(" \t\r\n"));
-        line.erase(line.find_last_not_of(" \t\r\n") + 1);
-        if (line.empty()) continue;
-        
-        if (line.find("LUT_3D_SIZE") == 0) {
-            std::istringstream iss(line);
-            std::string token;
-            iss >> token >> lutSize;
-            foundLUTSize = true;
-            if (lutSize > 0) lutData.reserve(lutSize * lutSize * lutSize * 3);
-            continue;
-        }
-        if (line.find("DOMAIN_MIN") == 0) {
-            std::istringstream iss(line);
-            std::string token;
-            iss >> token >> domainMin[0] >> domainMin[1] >> domainMin[2];
-            foundDomainMin = true;
-            continue;
-        }
-        if (line.find("DOMAIN_MAX") == 0) {
-            std::istringstream iss(line);
-            std::string token;
-            iss >> token >> domainMax[0] >> domainMax[1] >> domainMax[2];
-            foundDomainMax = true;
-            continue;
-        }
-        
-        if (foundLUTSize) {
-            std::istringstream iss(line);
-            float r, g, b;
-            if (iss >> r >> g >> b) {
-                lutData.push_back(r);
-                lutData.push_back(g);
-                lutData.push_back(b);
-            }
-        }
-    }
-    fileBuf.close();
-
-    if (!foundLUTSize || lutData.size() != lutSize * lutSize * lutSize * 3) {
+    // 解析结果按文件缓存为二进制，重复加载同一 LUT 时不再解析文本
+    CubeLUT lut;
+    if (!CubeLUTCache::Get().Load(wFilePath, lut)) {
         return false;
     }
 
-    // 处理 Domain 映射
-    if (foundDomainMin && foundDomainMax) {
-         for (size_t i = 0; i < lutData.size(); i += 3) {
-             // 简单的归一化
-             for(int c=0; c<3; ++c) {
-                 float range = domainMax[c] - domainMin[c];
-                 if(abs(range) > 1e-6) 
-                    lutData[i+c] = (lutData[i+c] - domainMin[c]) / range;
-                 lutData[i+c] = std::clamp(lutData[i+c], 0.0f, 1.0f);
-             }
-         }
-    }
-
     // 关键调用：加载数据
-    return LoadLUT(lutSize, lutData.data());
+    return LoadLUT(lut.Size, lut.Data.data());
 }
 
 void FilterNode::UpdateConstantBuffers(uint32_t width, uint32_t height) {
@@ -426,6 +371,10 @@ void FilterNode::SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> in
 bool FilterNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
                         std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
                         uint32_t width, uint32_t height) {
+    if (IsSoftwareRHI()) {
+        return ExecuteSoftware(inputTexture, outputTarget, width, height);
+    }
+
     if (!m_ShaderResourcesInitialized) return false;
     if (!m_LUTTexture || m_LUTSize == 0) return false; // 允许静默失败或透传
 
@@ -433,4 +382,24 @@ bool FilterNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
     return RenderNode::Execute(inputTexture, outputTarget, width, height);
 }
 
+bool FilterNode::ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) {
+    auto* input = GetSoftwareTexture(inputTexture);
+    auto* output = GetSoftwareTexture(outputTarget);
+    if (!IsSoftwareBGRA8Pair(input, output, width, height) ||
+        input->GetSize().x < static_cast<int32_t>(width) || input->GetSize().y < static_cast<int32_t>(height)) {
+        std::cerr << "[FilterNode] Unsupported texture for CPU path" << std::endl;
+        return false;
+    }
+    if (m_LUTData.empty() || m_LUTSize < 2) {
+        return false;
+    }
+
+    // 逐像素运算，输入/输出尺寸一致；CPU 路径使用四面体插值
+    LUTKernel kernel(m_LUTData.data(), m_LUTSize, LUTInterpolation::Tetrahedral, m_Intensity);
+    return kernel.Process(input->GetData(), input->GetRowPitch(), output->GetData(), output->GetRowPitch(),
+                          width, height);
+}
+
 } // namespace LightroomCore
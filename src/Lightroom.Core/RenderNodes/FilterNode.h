@@ -18,6 +18,10 @@ public:
                         uint32_t width, uint32_t height) override;
 
     virtual const char* GetName() const override { return "Filter"; }
+    virtual uint64_t GetParamsHash() const override;
+
+    // LUT 是逐像素运算，不需要邻域
+    virtual int32_t GetTileApron() const override { return 0; }
 
     // 从数据创建 LUT 纹理
     // lutSize: LUT 尺寸（例如 32 表示 32x32x32 的 3D LUT）
@@ -39,7 +43,15 @@ public:
     uint32_t GetLUTSize() const { return m_LUTSize; }
     std::shared_ptr<RenderCore::RHITexture2D> GetLUTTexture() const { return m_LUTTexture; }
 
+    // 浮点 LUT 数据（LoadLUTFromTexture 加载时为 nullptr），ImageAdjustNode 合并滤镜时使用
+    const float* GetLUTData() const { return m_LUTData.empty() ? nullptr : m_LUTData.data(); }
+    uint32_t GetLUTVersion() const { return m_LUTVersion; }
+
 protected:
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) override;
+
     virtual void UpdateConstantBuffers(uint32_t width, uint32_t height) override;
     virtual void SetConstantBuffers() override;
     virtual void SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) override;
@@ -63,7 +75,9 @@ private:
     std::shared_ptr<RenderCore::RHIUniformBuffer> m_ParamsBuffer;
     std::shared_ptr<RenderCore::RHITexture2D> m_LUTTexture;
     
+    std::vector<float> m_LUTData;  // CPU 路径使用的浮点 LUT（LoadLUTFromTexture 时为空）
     uint32_t m_LUTSize = 0;
+    uint32_t m_LUTVersion = 0;  // 每次加载 LUT 递增，用于参数哈希
     float m_Intensity = 1.0f;
     bool m_ShaderResourcesInitialized = false;
 };
@@ -0,0 +1,278 @@
+﻿#include "GaussianBlurKernel.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace LightroomCore {
+
+namespace {
+
+// 垂直遍列条宽度（float 个数）：列条的若干行同时留在 L1 中
+constexpr uint32_t kStripWidth = 64;
+
+inline const float* RowAt(const float* base, size_t rowPitch, int32_t y) {
+    return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(base) + static_cast<size_t>(y) * rowPitch);
+}
+
+inline float* RowAt(float* base, size_t rowPitch, int32_t y) {
+    return reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(base) + static_cast<size_t>(y) * rowPitch);
+}
+
+// acc = a * weight
+inline void MulRow(float* acc, const float* a, float weight, uint32_t count) {
+    const __m128 w = _mm_set1_ps(weight);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(acc + i, _mm_mul_ps(_mm_loadu_ps(a + i), w));
+    }
+    for (; i < count; ++i) {
+        acc[i] = a[i] * weight;
+    }
+}
+
+// acc += (a + b) * weight
+inline void AddPairRow(float* acc, const float* a, const float* b, float weight, uint32_t count) {
+    const __m128 w = _mm_set1_ps(weight);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 sum = _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(sum, w)));
+    }
+    for (; i < count; ++i) {
+        acc[i] += (a[i] + b[i]) * weight;
+    }
+}
+
+// acc += add - sub
+inline void SlideRow(float* acc, const float* add, const float* sub, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 delta = _mm_sub_ps(_mm_loadu_ps(add + i), _mm_loadu_ps(sub + i));
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), delta));
+    }
+    for (; i < count; ++i) {
+        acc[i] += add[i] - sub[i];
+    }
+}
+
+// 一行的盒式模糊（clamp 寻址），滑动窗口每个像素一次加法一次减法
+void BoxBlurLine(const float* source, float* destination, int32_t count, int32_t radius) {
+    const int32_t last = count - 1;
+    float acc = 0.0f;
+    for (int32_t i = -radius; i <= radius; ++i) {
+        acc += source[std::min(std::max(i, 0), last)];
+    }
+    const float scale = 1.0f / static_cast<float>(2 * radius + 1);
+
+    // 窗口完全落在行内的区间不需要 clamp
+    const int32_t interiorBegin = std::min(radius, count);
+    const int32_t interiorEnd = std::max(interiorBegin, count - radius - 1);
+    int32_t x = 0;
+    for (; x < interiorBegin; ++x) {
+        destination[x] = acc * scale;
+        acc += source[std::min(x + radius + 1, last)] - source[0];
+    }
+    for (; x < interiorEnd; ++x) {
+        destination[x] = acc * scale;
+        acc += source[x + radius + 1] - source[x - radius];
+    }
+    for (; x < count; ++x) {
+        destination[x] = acc * scale;
+        acc += source[last] - source[std::max(x - radius, 0)];
+    }
+}
+
+// 列条的盒式模糊：rows 行、每行 count 个连续 float（列条暂存区），逐行推进整条累加器
+void BoxBlurStrip(const float* source, float* destination, float* acc, uint32_t count, int32_t rows, int32_t radius) {
+    const int32_t last = rows - 1;
+    std::memset(acc, 0, count * sizeof(float));
+    for (int32_t i = -radius; i <= radius; ++i) {
+        const float* row = source + static_cast<size_t>(std::min(std::max(i, 0), last)) * count;
+        for (uint32_t c = 0; c < count; ++c) {
+            acc[c] += row[c];
+        }
+    }
+    const float scale = 1.0f / static_cast<float>(2 * radius + 1);
+    for (int32_t y = 0; y < rows; ++y) {
+        MulRow(destination + static_cast<size_t>(y) * count, acc, scale, count);
+        const float* add = source + static_cast<size_t>(std::min(y + radius + 1, last)) * count;
+        const float* sub = source + static_cast<size_t>(std::max(y - radius, 0)) * count;
+        SlideRow(acc, add, sub, count);
+    }
+}
+
+} // namespace
+
+GaussianBlurKernel::GaussianBlurKernel(float sigma)
+    : m_Sigma(std::max(sigma, 0.0f))
+    , m_UseBoxCascade(false)
+    , m_BoxPassCount(kBoxPassCount)
+    , m_BoxRadius{ 0, 0, 0 }
+{
+    if (m_Sigma >= kBoxCascadeMinSigma) {
+        // 3 次盒式模糊的宽度：在 wl 与 wl + 2 两种奇数宽度之间分配，使总方差等于 sigma^2
+        m_UseBoxCascade = true;
+        const float variance = m_Sigma * m_Sigma;
+        const int32_t n = kBoxPassCount;
+        int32_t lower = static_cast<int32_t>(std::floor(std::sqrt(12.0f * variance / n + 1.0f)));
+        if (lower % 2 == 0) {
+            --lower;
+        }
+        const float idealLowerCount = (12.0f * variance - n * lower * lower - 4.0f * n * lower - 3.0f * n) /
+                                      (-4.0f * lower - 4.0f);
+        const int32_t lowerCount = static_cast<int32_t>(std::lround(idealLowerCount));
+        for (int32_t i = 0; i < n; ++i) {
+            const int32_t size = (i < lowerCount) ? lower : lower + 2;
+            m_BoxRadius[i] = (size - 1) / 2;
+        }
+        return;
+    }
+
+    // 直接卷积：核半径 ceil(3σ)，sigma 为 0 时退化为复制
+    const int32_t radius = static_cast<int32_t>(std::ceil(3.0f * m_Sigma));
+    m_Weights.resize(static_cast<size_t>(radius) + 1);
+    float sum = 0.0f;
+    for (int32_t k = 0; k <= radius; ++k) {
+        const float weight = (m_Sigma > 0.0f) ? std::exp(-0.5f * k * k / (m_Sigma * m_Sigma)) : 1.0f;
+        m_Weights[k] = weight;
+        sum += (k == 0) ? weight : 2.0f * weight;
+    }
+    for (float& weight : m_Weights) {
+        weight /= sum;
+    }
+}
+
+int32_t GaussianBlurKernel::GetSupportRadius() const {
+    if (m_UseBoxCascade) {
+        int32_t radius = 0;
+        for (int32_t pass = 0; pass < m_BoxPassCount; ++pass) {
+            radius += m_BoxRadius[pass];
+        }
+        return radius;
+    }
+    return static_cast<int32_t>(m_Weights.size()) - 1;
+}
+
+bool GaussianBlurKernel::BoxFilter(const float* source, size_t sourceRowPitch, float* destination, size_t destinationRowPitch,
+                                   uint32_t width, uint32_t height, int32_t radius) {
+    GaussianBlurKernel kernel(0.0f);
+    kernel.m_UseBoxCascade = true;
+    kernel.m_BoxPassCount = 1;
+    kernel.m_BoxRadius[0] = std::max(radius, 0);
+    return kernel.Process(source, sourceRowPitch, destination, destinationRowPitch, width, height);
+}
+
+bool GaussianBlurKernel::Process(const float* source, size_t sourceRowPitch, float* destination, size_t destinationRowPitch,
+                                 uint32_t width, uint32_t height) const {
+    if (!source || !destination || width == 0 || height == 0) {
+        return false;
+    }
+
+    // 水平遍结果（紧密排列）；source 在两遍之间已读完，因此允许原地处理
+    std::vector<float> horizontal(static_cast<size_t>(width) * height);
+    auto& pool = RenderCore::SoftwareTaskPool::Get();
+    pool.ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t beginRow, int32_t endRow) {
+        BlurRowsHorizontal(source, sourceRowPitch, horizontal.data(), width, beginRow, endRow);
+    });
+
+    if (m_UseBoxCascade) {
+        // 盒式级联沿列方向是串行的滑动窗口，按列条并行
+        const uint32_t stripCount = (width + kStripWidth - 1) / kStripWidth;
+        pool.ParallelFor(stripCount, [&](uint32_t strip) {
+            const uint32_t beginColumn = strip * kStripWidth;
+            const uint32_t endColumn = std::min(beginColumn + kStripWidth, width);
+            BlurStripVertical(horizontal.data(), destination, destinationRowPitch, width, height, beginColumn, endColumn);
+        });
+    } else {
+        // 直接卷积每个输出行只读取相邻的若干整行，按行带并行即可
+        pool.ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t beginRow, int32_t endRow) {
+            BlurRowsVertical(horizontal.data(), destination, destinationRowPitch, width, height, beginRow, endRow);
+        });
+    }
+    return true;
+}
+
+void GaussianBlurKernel::BlurRowsHorizontal(const float* source, size_t sourceRowPitch, float* destination,
+                                            uint32_t width, int32_t beginRow, int32_t endRow) const {
+    const int32_t count = static_cast<int32_t>(width);
+
+    if (m_UseBoxCascade) {
+        std::vector<float> line(width * 2);
+        float* current = line.data();
+        float* next = current + width;
+        for (int32_t y = beginRow; y < endRow; ++y) {
+            std::memcpy(current, RowAt(source, sourceRowPitch, y), width * sizeof(float));
+            for (int32_t pass = 0; pass < m_BoxPassCount; ++pass) {
+                float* output = (pass == m_BoxPassCount - 1) ? destination + static_cast<size_t>(y) * width : next;
+                BoxBlurLine(current, output, count, m_BoxRadius[pass]);
+                std::swap(current, next);
+            }
+        }
+        return;
+    }
+
+    // 直接卷积：先把一行按 clamp 寻址扩展到两侧，内层循环不再需要边界判断
+    const int32_t radius = static_cast<int32_t>(m_Weights.size()) - 1;
+    std::vector<float> padded(static_cast<size_t>(count) + 2 * radius);
+    for (int32_t y = beginRow; y < endRow; ++y) {
+        const float* row = RowAt(source, sourceRowPitch, y);
+        for (int32_t i = 0; i < radius; ++i) {
+            padded[i] = row[0];
+            padded[radius + count + i] = row[count - 1];
+        }
+        std::memcpy(padded.data() + radius, row, width * sizeof(float));
+
+        float* output = destination + static_cast<size_t>(y) * width;
+        const float* center = padded.data() + radius;
+        MulRow(output, center, m_Weights[0], width);
+        for (int32_t k = 1; k <= radius; ++k) {
+            AddPairRow(output, center - k, center + k, m_Weights[k], width);
+        }
+    }
+}
+
+void GaussianBlurKernel::BlurStripVertical(const float* source, float* destination, size_t destinationRowPitch,
+                                           uint32_t width, uint32_t height, uint32_t beginColumn, uint32_t endColumn) const {
+    const uint32_t count = endColumn - beginColumn;
+    const int32_t rows = static_cast<int32_t>(height);
+
+    // 列条暂存：height 行 x count 列，两块交替作为每次盒式模糊的输入/输出
+    std::vector<float> scratch(static_cast<size_t>(count) * height * 2 + count);
+    float* current = scratch.data();
+    float* next = current + static_cast<size_t>(count) * height;
+    float* acc = next + static_cast<size_t>(count) * height;
+
+    for (int32_t y = 0; y < rows; ++y) {
+        std::memcpy(current + static_cast<size_t>(y) * count, source + static_cast<size_t>(y) * width + beginColumn,
+                    count * sizeof(float));
+    }
+    for (int32_t pass = 0; pass < m_BoxPassCount; ++pass) {
+        BoxBlurStrip(current, next, acc, count, rows, m_BoxRadius[pass]);
+        std::swap(current, next);
+    }
+    for (int32_t y = 0; y < rows; ++y) {
+        std::memcpy(RowAt(destination, destinationRowPitch, y) + beginColumn, current + static_cast<size_t>(y) * count,
+                    count * sizeof(float));
+    }
+}
+
+void GaussianBlurKernel::BlurRowsVertical(const float* source, float* destination, size_t destinationRowPitch,
+                                          uint32_t width, uint32_t height, int32_t beginRow, int32_t endRow) const {
+    const int32_t radius = static_cast<int32_t>(m_Weights.size()) - 1;
+    const int32_t last = static_cast<int32_t>(height) - 1;
+    auto rowAt = [&](int32_t y) {
+        return source + static_cast<size_t>(std::min(std::max(y, 0), last)) * width;
+    };
+
+    for (int32_t y = beginRow; y < endRow; ++y) {
+        float* output = RowAt(destination, destinationRowPitch, y);
+        MulRow(output, rowAt(y), m_Weights[0], width);
+        for (int32_t k = 1; k <= radius; ++k) {
+            AddPairRow(output, rowAt(y - k), rowAt(y + k), m_Weights[k], width);
+        }
+    }
+}
+
+} // namespace LightroomCore
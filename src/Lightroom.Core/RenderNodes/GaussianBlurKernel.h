@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace LightroomCore {
+
+// 单通道 float 图像的高斯模糊（可分离：水平一遍 + 垂直一遍，clamp 寻址）
+// sigma 较小时直接使用截断到 3σ 的高斯核；较大时用 3 次盒式模糊级联近似（滑动窗口求和，耗时与半径无关）。
+// 水平遍按行带并行；垂直遍按固定宽度的列条并行，列条内逐行推进，访问连续并按 SSE 向量化。
+class GaussianBlurKernel {
+public:
+    explicit GaussianBlurKernel(float sigma);
+
+    // 模糊一个平面（行跨度以字节为单位）；source 与 destination 可以是同一块内存
+    bool Process(const float* source, size_t sourceRowPitch, float* destination, size_t destinationRowPitch,
+                 uint32_t width, uint32_t height) const;
+
+    float GetSigma() const { return m_Sigma; }
+    bool UsesBoxCascade() const { return m_UseBoxCascade; }
+
+    // 每个方向上影响结果的像素数（分块执行所需的邻域）
+    int32_t GetSupportRadius() const;
+
+    // 单次盒式均值滤波（窗口 (2 * radius + 1)^2，clamp 寻址），与模糊共用同一套按行/列条并行的实现
+    static bool BoxFilter(const float* source, size_t sourceRowPitch, float* destination, size_t destinationRowPitch,
+                          uint32_t width, uint32_t height, int32_t radius);
+
+    // sigma 不小于该值时使用盒式模糊级联
+    static constexpr float kBoxCascadeMinSigma = 2.0f;
+    static constexpr int32_t kBoxPassCount = 3;
+
+private:
+    void BlurRowsHorizontal(const float* source, size_t sourceRowPitch, float* destination,
+                            uint32_t width, int32_t beginRow, int32_t endRow) const;
+    void BlurStripVertical(const float* source, float* destination, size_t destinationRowPitch,
+                           uint32_t width, uint32_t height, uint32_t beginColumn, uint32_t endColumn) const;
+    void BlurRowsVertical(const float* source, float* destination, size_t destinationRowPitch,
+                          uint32_t width, uint32_t height, int32_t beginRow, int32_t endRow) const;
+
+    float m_Sigma;
+    bool m_UseBoxCascade;
+    std::vector<float> m_Weights;           // 直接卷积：中心及一侧的权重（已归一化）
+    int32_t m_BoxPassCount;                 // 盒式级联的次数（高斯近似为 kBoxPassCount，BoxFilter 为 1）
+    int32_t m_BoxRadius[kBoxPassCount];     // 盒式级联：每次盒式模糊的半径
+};
+
+} // namespace LightroomCore
@@ -0,0 +1,258 @@
+﻿#include "GaussianBlurNode.h"
+#include "GaussianBlurKernel.h"
+#include "SoftwareNodeUtils.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace LightroomCore {
+
+// Constant buffer 结构体（必须 16 字节对齐）
+struct __declspec(align(16)) GaussianBlurConstantBuffer {
+    float TexelStep[2];     // 一个输出像素在当前方向上对应的纹理坐标步长
+    int32_t TapCount;       // Taps 中的有效项数（含中心）
+    float Padding;
+    float Taps[GaussianBlurNode::kMaxTaps][4];  // x = 偏移（像素），y = 权重；Taps[0] 为中心
+};
+
+// 由 sigma 生成合并后的采样表：离散核 k 与 k + 1 合并为一次位于加权中点的双线性采样
+static int32_t BuildGaussianTaps(float sigma, float taps[GaussianBlurNode::kMaxTaps][4]) {
+    const int32_t maxRadius = 2 * static_cast<int32_t>(GaussianBlurNode::kMaxTaps - 1);
+    const int32_t radius = (sigma > 0.0f) ? std::min(static_cast<int32_t>(std::ceil(3.0f * sigma)), maxRadius) : 0;
+
+    std::vector<float> weights(static_cast<size_t>(radius) + 2, 0.0f);
+    float sum = 0.0f;
+    for (int32_t k = 0; k <= radius; ++k) {
+        weights[k] = (sigma > 0.0f) ? std::exp(-0.5f * k * k / (sigma * sigma)) : 1.0f;
+        sum += (k == 0) ? weights[k] : 2.0f * weights[k];
+    }
+
+    taps[0][0] = 0.0f;
+    taps[0][1] = weights[0] / sum;
+    int32_t count = 1;
+    for (int32_t k = 1; k <= radius; k += 2) {
+        const float weightA = weights[k];
+        const float weightB = weights[k + 1];
+        const float weight = weightA + weightB;
+        taps[count][0] = (k * weightA + (k + 1) * weightB) / weight;
+        taps[count][1] = weight / sum;
+        ++count;
+    }
+    return count;
+}
+
+GaussianBlurNode::GaussianBlurNode(std::shared_ptr<RenderCore::DynamicRHI> rhi)
+    : RenderNode(rhi)
+{
+    InitializeShaderResources();
+}
+
+GaussianBlurNode::~GaussianBlurNode() {
+    CleanupShaderResources();
+}
+
+bool GaussianBlurNode::InitializeShaderResources() {
+    if (m_ShaderResourcesInitialized || !m_RHI || IsSoftwareRHI()) {
+        return m_ShaderResourcesInitialized;
+    }
+
+    const char* vsCode = R"(
+        struct VSInput {
+            float2 Position : POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        struct VSOutput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        VSOutput main(VSInput input) {
+            VSOutput output;
+            output.Position = float4(input.Position, 0.0, 1.0);
+            output.TexCoord = input.TexCoord;
+            return output;
+        }
+    )";
+
+    const char* psCode = R"(
+        cbuffer BlurParams : register(b0) {
+            float2 TexelStep;
+            int TapCount;
+            float Padding;
+            float4 Taps[32];
+        };
+        Texture2D InputTexture : register(t0);
+        SamplerState InputSampler : register(s0);
+        struct PSInput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        float4 main(PSInput input) : SV_TARGET {
+            float4 result = InputTexture.Sample(InputSampler, input.TexCoord) * Taps[0].y;
+            [loop]
+            for (int i = 1; i < TapCount; ++i) {
+                float2 offset = TexelStep * Taps[i].x;
+                result += (InputTexture.Sample(InputSampler, input.TexCoord + offset) +
+                           InputTexture.Sample(InputSampler, input.TexCoord - offset)) * Taps[i].y;
+            }
+            return result;
+        }
+    )";
+
+    if (!CompileShaders(vsCode, psCode, m_Shader)) {
+        std::cerr << "[GaussianBlurNode] Failed to compile shaders" << std::endl;
+        return false;
+    }
+
+    m_ParamsBuffer = m_RHI->RHICreateUniformBuffer(sizeof(GaussianBlurConstantBuffer));
+    if (!m_ParamsBuffer) {
+        std::cerr << "[GaussianBlurNode] Failed to create constant buffer" << std::endl;
+        return false;
+    }
+
+    m_ShaderResourcesInitialized = true;
+    m_CurrentShader = &m_Shader;
+    return true;
+}
+
+void GaussianBlurNode::CleanupShaderResources() {
+    m_ParamsBuffer.reset();
+    m_IntermediateTexture.reset();
+    m_Shader.VS.Reset();
+    m_Shader.PS.Reset();
+    m_Shader.InputLayout.Reset();
+    m_Shader.Blob.Reset();
+    m_ShaderResourcesInitialized = false;
+}
+
+uint64_t GaussianBlurNode::GetParamsHash() const {
+    return HashValue(m_Sigma, RenderNode::GetParamsHash());
+}
+
+int32_t GaussianBlurNode::GetTileApron() const {
+    // 3σ 截断 + 双线性采样 1 像素
+    return static_cast<int32_t>(std::ceil(3.0f * m_Sigma)) + 1;
+}
+
+bool GaussianBlurNode::EnsureIntermediateTexture(uint32_t width, uint32_t height) {
+    if (m_IntermediateTexture) {
+        const core::vec2i size = m_IntermediateTexture->GetSize();
+        if (static_cast<uint32_t>(size.x) == width && static_cast<uint32_t>(size.y) == height) {
+            return true;
+        }
+    }
+
+    // 中间结果使用 FP16，避免两遍之间量化到 8 位
+    m_IntermediateTexture = m_RHI->RHICreateTexture2D(
+        RenderCore::EPixelFormat::PF_FloatRGBA,
+        RenderCore::ETextureCreateFlags::TexCreate_RenderTargetable | RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+        width,
+        height,
+        1
+    );
+    return m_IntermediateTexture != nullptr;
+}
+
+void GaussianBlurNode::UpdateConstantBuffers(uint32_t width, uint32_t height) {
+    if (!m_ParamsBuffer || !m_CommandContext) {
+        return;
+    }
+
+    GaussianBlurConstantBuffer cbData = {};
+    cbData.TexelStep[0] = m_HorizontalPass ? 1.0f / static_cast<float>(width) : 0.0f;
+    cbData.TexelStep[1] = m_HorizontalPass ? 0.0f : 1.0f / static_cast<float>(height);
+    cbData.TapCount = BuildGaussianTaps(m_Sigma, cbData.Taps);
+    m_CommandContext->RHIUpdateUniformBuffer(m_ParamsBuffer, &cbData);
+}
+
+void GaussianBlurNode::SetConstantBuffers() {
+    if (m_ParamsBuffer) {
+        m_CommandContext->RHISetShaderUniformBuffer(RenderCore::EShaderFrequency::SF_Pixel, 0, m_ParamsBuffer);
+    }
+}
+
+void GaussianBlurNode::SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) {
+    m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, 0, inputTexture);
+    m_CommandContext->RHISetShaderSampler(RenderCore::EShaderFrequency::SF_Pixel, 0, m_CommonSamplerState);
+}
+
+bool GaussianBlurNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                               std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                               uint32_t width, uint32_t height) {
+    if (IsSoftwareRHI()) {
+        return ExecuteSoftware(inputTexture, outputTarget, width, height);
+    }
+
+    if (!m_ShaderResourcesInitialized || !EnsureIntermediateTexture(width, height)) {
+        return false;
+    }
+
+    m_CurrentShader = &m_Shader;
+
+    m_HorizontalPass = true;
+    if (!RenderNode::Execute(inputTexture, m_IntermediateTexture, width, height)) {
+        return false;
+    }
+    m_HorizontalPass = false;
+    return RenderNode::Execute(m_IntermediateTexture, outputTarget, width, height);
+}
+
+bool GaussianBlurNode::ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                       std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                       uint32_t width, uint32_t height) {
+    RenderCore::SoftwareTexture2D* input = GetSoftwareTexture(inputTexture);
+    RenderCore::SoftwareTexture2D* output = GetSoftwareTexture(outputTarget);
+    if (!IsSoftwareBGRA8Pair(input, output, width, height) || width == 0 || height == 0) {
+        return false;
+    }
+
+    // 展开为 B、G、R 三个 float 平面；输入尺寸与输出不同时与 GPU 一样按纹理坐标重采样
+    const size_t planeSize = static_cast<size_t>(width) * height;
+    std::vector<float> planes(planeSize * 3);
+    const bool resample = input->GetSize().x != static_cast<int32_t>(width) || input->GetSize().y != static_cast<int32_t>(height);
+    const float scaleX = static_cast<float>(input->GetSize().x) / static_cast<float>(width);
+    const float scaleY = static_cast<float>(input->GetSize().y) / static_cast<float>(height);
+    auto& pool = RenderCore::SoftwareTaskPool::Get();
+    pool.ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t rowBegin, int32_t rowEnd) {
+        for (int32_t y = rowBegin; y < rowEnd; ++y) {
+            const uint8_t* src = input->GetRow(y);
+            uint8_t* dst = output->GetRow(y);
+            const size_t rowOffset = static_cast<size_t>(y) * width;
+            for (uint32_t x = 0; x < width; ++x) {
+                uint8_t pixel[4];
+                if (resample) {
+                    SampleBilinearBGRA8(input, (x + 0.5f) * scaleX, (y + 0.5f) * scaleY, pixel);
+                } else {
+                    std::copy(src + x * 4, src + x * 4 + 4, pixel);
+                }
+                planes[rowOffset + x] = pixel[0] / 255.0f;
+                planes[planeSize + rowOffset + x] = pixel[1] / 255.0f;
+                planes[planeSize * 2 + rowOffset + x] = pixel[2] / 255.0f;
+                dst[x * 4 + 3] = pixel[3];
+            }
+        }
+    });
+
+    const GaussianBlurKernel kernel(m_Sigma);
+    const size_t rowPitch = static_cast<size_t>(width) * sizeof(float);
+    for (int c = 0; c < 3; ++c) {
+        float* plane = planes.data() + planeSize * c;
+        kernel.Process(plane, rowPitch, plane, rowPitch, width, height);
+    }
+
+    pool.ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t rowBegin, int32_t rowEnd) {
+        for (int32_t y = rowBegin; y < rowEnd; ++y) {
+            uint8_t* dst = output->GetRow(y);
+            const size_t rowOffset = static_cast<size_t>(y) * width;
+            for (uint32_t x = 0; x < width; ++x) {
+                for (int c = 0; c < 3; ++c) {
+                    const float value = std::min(std::max(planes[planeSize * c + rowOffset + x], 0.0f), 1.0f);
+                    dst[x * 4 + c] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+                }
+            }
+        }
+    });
+    return true;
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include "RenderNode.h"
+#include "../d3d11rhi/RHIUniformBuffer.h"
+#include <memory>
+
+namespace LightroomCore {
+
+// 可分离高斯模糊节点：水平一遍写入内部的 FP16 中间纹理，垂直一遍写入输出
+// 每遍使用双线性采样合并相邻两个权重（N 个纹素只需约 N/2 次采样），sigma 以输出像素为单位。
+// 软件 RHI 下使用 GaussianBlurKernel（大 sigma 时为盒式模糊级联，耗时与半径无关）。
+class GaussianBlurNode : public RenderNode {
+public:
+    GaussianBlurNode(std::shared_ptr<RenderCore::DynamicRHI> rhi);
+    virtual ~GaussianBlurNode();
+
+    virtual bool Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                        std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                        uint32_t width, uint32_t height) override;
+
+    virtual const char* GetName() const override { return "GaussianBlur"; }
+    virtual uint64_t GetParamsHash() const override;
+    virtual int32_t GetTileApron() const override;
+    virtual void ReleaseResources() override { m_IntermediateTexture.reset(); }
+
+    void SetSigma(float sigma) { m_Sigma = sigma; }
+    float GetSigma() const { return m_Sigma; }
+
+    // 每遍最多的采样数（中心 + 每侧 kMaxTaps - 1 个合并采样），超出的核尾部被截断
+    static constexpr uint32_t kMaxTaps = 32;
+
+protected:
+    virtual void UpdateConstantBuffers(uint32_t width, uint32_t height) override;
+    virtual void SetConstantBuffers() override;
+    virtual void SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) override;
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) override;
+
+private:
+    bool InitializeShaderResources();
+    void CleanupShaderResources();
+    bool EnsureIntermediateTexture(uint32_t width, uint32_t height);
+
+    float m_Sigma = 0.0f;
+    bool m_HorizontalPass = true;
+
+    CompiledShader m_Shader;
+    std::shared_ptr<RenderCore::RHIUniformBuffer> m_ParamsBuffer;
+    std::shared_ptr<RenderCore::RHITexture2D> m_IntermediateTexture;
+    bool m_ShaderResourcesInitialized = false;
+};
+
+} // namespace LightroomCore
@@ -0,0 +1,208 @@
+﻿#include "GrainKernel.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace LightroomCore {
+
+namespace {
+
+constexpr uint32_t kTileMask = GrainKernel::kTileSize - 1;
+constexpr int32_t kRoundingBias = 4096;
+static_assert((GrainKernel::kTileSize & kTileMask) == 0, "Noise tile size must be a power of two");
+
+// 可分离高斯模糊，环绕寻址（结果仍可平铺）
+void BlurWrap(std::vector<float>& tile, float sigma) {
+    const int32_t radius = static_cast<int32_t>(std::ceil(3.0f * sigma));
+    std::vector<float> weights(radius * 2 + 1);
+    float sum = 0.0f;
+    for (int32_t i = -radius; i <= radius; ++i) {
+        weights[i + radius] = std::exp(-0.5f * static_cast<float>(i * i) / (sigma * sigma));
+        sum += weights[i + radius];
+    }
+    for (float& weight : weights) {
+        weight /= sum;
+    }
+
+    const uint32_t size = GrainKernel::kTileSize;
+    std::vector<float> temp(tile.size());
+    for (uint32_t y = 0; y < size; ++y) {
+        const float* row = tile.data() + static_cast<size_t>(y) * size;
+        for (uint32_t x = 0; x < size; ++x) {
+            float value = 0.0f;
+            for (int32_t i = -radius; i <= radius; ++i) {
+                value += row[(x + i) & kTileMask] * weights[i + radius];
+            }
+            temp[static_cast<size_t>(y) * size + x] = value;
+        }
+    }
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            float value = 0.0f;
+            for (int32_t i = -radius; i <= radius; ++i) {
+                value += temp[static_cast<size_t>((y + i) & kTileMask) * size + x] * weights[i + radius];
+            }
+            tile[static_cast<size_t>(y) * size + x] = value;
+        }
+    }
+}
+
+// 第 level 张噪声：白噪声 -> 模糊到约 2^level 纹素的颗粒 -> 减去 4 倍宽度的模糊（去除低频斑块）-> 归一化
+// 使用固定种子，每次运行生成相同的噪声
+std::vector<float> BuildNoiseTile(uint32_t level) {
+    const size_t count = static_cast<size_t>(GrainKernel::kTileSize) * GrainKernel::kTileSize;
+    std::vector<float> tile(count);
+    std::mt19937 random(0x4752414Eu + level);
+    for (float& value : tile) {
+        value = static_cast<float>(random() >> 8) * (1.0f / 16777216.0f) - 0.5f;
+    }
+
+    const float grainSize = static_cast<float>(1u << level);
+    if (level > 0) {
+        BlurWrap(tile, 0.5f * grainSize);
+    }
+    std::vector<float> lowFrequency = tile;
+    BlurWrap(lowFrequency, 2.0f * grainSize);
+
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        tile[i] -= lowFrequency[i];
+        sum += tile[i];
+        sumSquares += static_cast<double>(tile[i]) * tile[i];
+    }
+    const double mean = sum / count;
+    const double deviation = std::sqrt(std::max(sumSquares / count - mean * mean, 1e-12));
+    for (float& value : tile) {
+        value = static_cast<float>((value - mean) / deviation);
+    }
+    return tile;
+}
+
+struct NoiseBank {
+    NoiseBank() {
+        for (uint32_t level = 0; level < GrainKernel::kLevelCount; ++level) {
+            Tiles[level] = BuildNoiseTile(level);
+        }
+    }
+    std::vector<float> Tiles[GrainKernel::kLevelCount];
+};
+
+// 帧号 -> 噪声平移（整数纹素），相邻帧的平移互不相关
+inline void GetFrameOffset(uint64_t frameIndex, float& offsetX, float& offsetY) {
+    uint64_t z = frameIndex + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    offsetX = static_cast<float>(z & kTileMask);
+    offsetY = static_cast<float>((z >> 32) & kTileMask);
+}
+
+inline float WrapTexel(float v) {
+    const float size = static_cast<float>(GrainKernel::kTileSize);
+    v = std::fmod(v, size);
+    return v < 0.0f ? v + size : v;
+}
+
+} // namespace
+
+const float* GrainKernel::GetNoiseTile(uint32_t level) {
+    // 局部静态变量：首次调用时生成，初始化由编译器保证线程安全
+    static const NoiseBank bank;
+    return bank.Tiles[std::min(level, kLevelCount - 1)].data();
+}
+
+GrainKernel::Sampling GrainKernel::GetSampling(float amount, uint64_t frameIndex, const Mapping& mapping) {
+    Sampling sampling;
+    if (mapping.FullWidth <= 0.0f || mapping.FullHeight <= 0.0f) {
+        return sampling;
+    }
+
+    // 颗粒大小（完整图像像素）与一个输出像素覆盖的颗粒数
+    const float grainSize = std::max(1.0f, std::max(mapping.FullWidth, mapping.FullHeight) / kReferenceEdge);
+    const float pixelScale = std::max(mapping.PixelScaleX, mapping.PixelScaleY);
+    const float outputGrain = grainSize / pixelScale;
+
+    // 选择颗粒与输出像素大小最接近的噪声；缩小预览时颗粒小于一个像素，按平均效果降低幅度
+    uint32_t level = 0;
+    while (level + 1 < kLevelCount && outputGrain >= static_cast<float>(2u << level)) {
+        ++level;
+    }
+    const float texelsPerPixel = static_cast<float>(1u << level) / grainSize;
+
+    float frameOffsetX = 0.0f;
+    float frameOffsetY = 0.0f;
+    GetFrameOffset(frameIndex, frameOffsetX, frameOffsetY);
+
+    sampling.Level = level;
+    sampling.StepX = mapping.PixelScaleX * texelsPerPixel;
+    sampling.StepY = mapping.PixelScaleY * texelsPerPixel;
+    sampling.OriginX = WrapTexel(mapping.OffsetX * texelsPerPixel + frameOffsetX);
+    sampling.OriginY = WrapTexel(mapping.OffsetY * texelsPerPixel + frameOffsetY);
+    sampling.Amplitude = std::min(std::max(amount, 0.0f), 100.0f) / 100.0f * kMaxAmplitude * std::min(outputGrain, 1.0f);
+    return sampling;
+}
+
+bool GrainKernel::Process(const Sampling& sampling, const uint8_t* source, size_t sourceRowPitch,
+                          uint8_t* destination, size_t destinationRowPitch, uint32_t width, uint32_t height) {
+    if (!source || !destination || width == 0 || height == 0) {
+        return false;
+    }
+
+    // 按亮度（8 位）查表的叠加幅度：中间调为 1，两端为 kEndpointWeight
+    float weights[256];
+    for (int i = 0; i < 256; ++i) {
+        const float luma = i / 255.0f;
+        weights[i] = sampling.Amplitude * 255.0f * (kEndpointWeight + (1.0f - kEndpointWeight) * 4.0f * luma * (1.0f - luma));
+    }
+
+    // 噪声的列坐标只与 x 有关，所有行共用（与 GPU 双线性采样一致：纹素中心在 +0.5）
+    std::vector<int32_t> columns(static_cast<size_t>(width) * 2);
+    std::vector<float> columnFractions(width);
+    for (uint32_t x = 0; x < width; ++x) {
+        const float nx = sampling.OriginX + (x + 0.5f) * sampling.StepX - 0.5f;
+        const float fx0 = std::floor(nx);
+        const int32_t ix = static_cast<int32_t>(fx0);
+        columns[x * 2] = ix & kTileMask;
+        columns[x * 2 + 1] = (ix + 1) & kTileMask;
+        columnFractions[x] = nx - fx0;
+    }
+
+    const float* tile = GetNoiseTile(sampling.Level);
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t beginRow, int32_t endRow) {
+        for (int32_t y = beginRow; y < endRow; ++y) {
+            const float ny = sampling.OriginY + (y + 0.5f) * sampling.StepY - 0.5f;
+            const float fy0 = std::floor(ny);
+            const float fy = ny - fy0;
+            const int32_t iy = static_cast<int32_t>(fy0);
+            const float* row0 = tile + static_cast<size_t>(iy & kTileMask) * kTileSize;
+            const float* row1 = tile + static_cast<size_t>((iy + 1) & kTileMask) * kTileSize;
+
+            const uint8_t* in = source + static_cast<size_t>(y) * sourceRowPitch;
+            uint8_t* out = destination + static_cast<size_t>(y) * destinationRowPitch;
+            for (uint32_t x = 0; x < width; ++x) {
+                const int32_t x0 = columns[x * 2];
+                const int32_t x1 = columns[x * 2 + 1];
+                const float fx = columnFractions[x];
+                const float top = row0[x0] + (row0[x1] - row0[x0]) * fx;
+                const float bottom = row1[x0] + (row1[x1] - row1[x0]) * fx;
+                const float noise = top + (bottom - top) * fy;
+
+                // BGRA：Rec.709 亮度的整数近似；输入为整数，先取整偏移再相加与相加后取整相同
+                // 偏移远小于 kRoundingBias，加上后截断即为向下取整
+                const uint8_t* p = in + x * 4;
+                const uint32_t luma = (p[0] * 19u + p[1] * 183u + p[2] * 54u) >> 8;
+                const int32_t delta = static_cast<int32_t>(noise * weights[luma] + (kRoundingBias + 0.5f)) - kRoundingBias;
+                for (int c = 0; c < 3; ++c) {
+                    out[x * 4 + c] = static_cast<uint8_t>(std::min(std::max(p[c] + delta, 0), 255));
+                }
+                out[x * 4 + 3] = p[3];
+            }
+        }
+    });
+    return true;
+}
+
+} // namespace LightroomCore
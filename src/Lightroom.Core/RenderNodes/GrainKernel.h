@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace LightroomCore {
+
+// 胶片颗粒（ImageAdjustParams::grain）
+// 颗粒取自进程内共享的噪声库：kLevelCount 张 kTileSize x kTileSize 的可平铺噪声，第 l 张的颗粒约为 2^l 纹素。
+// 噪声为白噪声经环绕高斯模糊后减去更宽的模糊（带通，低频被去除，接近蓝噪声），归一化为零均值、单位标准差；
+// 首次使用时生成一次，之后逐像素只需一次双线性查表，不再逐像素调用随机数。
+// 噪声坐标以完整图像像素计算，预览、分块导出与整幅渲染的颗粒位置一致；视频按帧号平移噪声，颗粒逐帧变化。
+// 叠加方式：rgb += noise * amplitude * weight(luma)，中间调最强，高光/阴影减弱。
+class GrainKernel {
+public:
+    // 输出像素到完整图像像素坐标的映射（与 LensCorrectionKernel::Mapping 相同的约定）
+    struct Mapping {
+        float FullWidth = 0.0f;     // 完整图像尺寸，决定颗粒大小
+        float FullHeight = 0.0f;
+        float OffsetX = 0.0f;       // 输出 (0, 0) 像素左上角在完整图像中的位置
+        float OffsetY = 0.0f;
+        float PixelScaleX = 1.0f;   // 一个输出像素对应的完整图像像素数
+        float PixelScaleY = 1.0f;
+    };
+
+    // 由参数与映射得到的采样方式：输出像素中心 (x + 0.5, y + 0.5) 对应的噪声纹素坐标为 Origin + (x + 0.5) * Step
+    struct Sampling {
+        uint32_t Level = 0;
+        float OriginX = 0.0f;
+        float OriginY = 0.0f;
+        float StepX = 1.0f;
+        float StepY = 1.0f;
+        float Amplitude = 0.0f;     // 中间调处的最大偏移（0-1 颜色值）
+    };
+
+    static bool IsIdentity(float amount) { return amount <= 0.0f; }
+
+    // amount: 0 - 100；frameIndex: 视频帧号（图片为 0）
+    static Sampling GetSampling(float amount, uint64_t frameIndex, const Mapping& mapping);
+
+    // 噪声库中的一张噪声（行优先 kTileSize x kTileSize float），首次调用时生成全部噪声；线程安全
+    static const float* GetNoiseTile(uint32_t level);
+
+    // BGRA8 -> BGRA8（source 至少 width x height）；source 与 destination 可以相同
+    static bool Process(const Sampling& sampling, const uint8_t* source, size_t sourceRowPitch,
+                        uint8_t* destination, size_t destinationRowPitch, uint32_t width, uint32_t height);
+
+    static constexpr uint32_t kTileSize = 256;
+    static constexpr uint32_t kLevelCount = 3;
+    // 滑块为 100 时中间调的噪声幅度（噪声标准差为 1）
+    static constexpr float kMaxAmplitude = 0.12f;
+    // 长边为该像素数的图像颗粒约为 1 像素，更大的图像颗粒按比例变粗
+    static constexpr float kReferenceEdge = 2048.0f;
+    // 纯黑/纯白处颗粒强度相对中间调的比例
+    static constexpr float kEndpointWeight = 0.25f;
+};
+
+} // namespace LightroomCore
@@ -0,0 +1,235 @@
+﻿#include "GrainNode.h"
+#include "SoftwareNodeUtils.h"
+#include "../d3d11rhi/D3D11RHI.h"
+#include <iostream>
+
+namespace LightroomCore {
+
+// Constant buffer 结构体（必须 16 字节对齐）
+struct __declspec(align(16)) GrainConstantBuffer {
+    float NoiseOrigin[2];   // 输出像素 (0, 0) 左上角对应的噪声纹素坐标
+    float NoiseStep[2];     // 每个输出像素对应的噪声纹素数
+    float Amplitude;
+    float EndpointWeight;
+    float TileSize;
+    float Padding;
+};
+
+GrainNode::GrainNode(std::shared_ptr<RenderCore::DynamicRHI> rhi)
+    : RenderNode(rhi)
+{
+    InitializeShaderResources();
+}
+
+GrainNode::~GrainNode() {
+    CleanupShaderResources();
+}
+
+bool GrainNode::InitializeShaderResources() {
+    if (m_ShaderResourcesInitialized || !m_RHI || IsSoftwareRHI()) {
+        return m_ShaderResourcesInitialized;
+    }
+
+    const char* vsCode = R"(
+        struct VSInput {
+            float2 Position : POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        struct VSOutput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        VSOutput main(VSInput input) {
+            VSOutput output;
+            output.Position = float4(input.Position, 0.0, 1.0);
+            output.TexCoord = input.TexCoord;
+            return output;
+        }
+    )";
+
+    // 与 GrainKernel::Process 相同：噪声按 Rec.709 亮度加权（中间调最强）叠加到 RGB
+    const char* psCode = R"(
+        cbuffer GrainParams : register(b0) {
+            float2 NoiseOrigin;
+            float2 NoiseStep;
+            float Amplitude;
+            float EndpointWeight;
+            float TileSize;
+            float Padding;
+        };
+        Texture2D InputTexture : register(t0);
+        Texture2D NoiseTexture : register(t1);
+        SamplerState InputSampler : register(s0);
+        SamplerState NoiseSampler : register(s1);   // 环绕寻址
+        struct PSInput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+
+        float4 main(PSInput input) : SV_TARGET {
+            float4 color = InputTexture.Sample(InputSampler, input.TexCoord);
+            float2 noisePos = NoiseOrigin + input.Position.xy * NoiseStep;
+            float noise = NoiseTexture.SampleLevel(NoiseSampler, noisePos / TileSize, 0).r;
+            float luma = dot(color.rgb, float3(0.2126, 0.7152, 0.0722));
+            float weight = EndpointWeight + (1.0 - EndpointWeight) * 4.0 * luma * (1.0 - luma);
+            color.rgb = saturate(color.rgb + noise * Amplitude * weight);
+            return color;
+        }
+    )";
+
+    if (!CompileShaders(vsCode, psCode, m_Shader)) {
+        std::cerr << "[GrainNode] Failed to compile shaders" << std::endl;
+        return false;
+    }
+
+    m_ParamsBuffer = m_RHI->RHICreateUniformBuffer(sizeof(GrainConstantBuffer));
+    if (!m_ParamsBuffer) {
+        std::cerr << "[GrainNode] Failed to create constant buffer" << std::endl;
+        return false;
+    }
+
+    // 噪声可平铺，坐标超出一张噪声时环绕
+    RenderCore::SamplerStateInitializerRHI samplerInit(
+        RenderCore::SF_Bilinear,
+        RenderCore::AM_Wrap,
+        RenderCore::AM_Wrap,
+        RenderCore::AM_Wrap
+    );
+    m_NoiseSampler = m_RHI->RHICreateSamplerState(samplerInit);
+    if (!m_NoiseSampler) {
+        std::cerr << "[GrainNode] Failed to create noise sampler" << std::endl;
+        return false;
+    }
+
+    m_ShaderResourcesInitialized = true;
+    return true;
+}
+
+void GrainNode::CleanupShaderResources() {
+    m_ParamsBuffer.reset();
+    m_NoiseSampler.reset();
+    m_Shader.VS.Reset();
+    m_Shader.PS.Reset();
+    m_Shader.InputLayout.Reset();
+    m_Shader.Blob.Reset();
+    GrainNode::ReleaseResources();
+    m_ShaderResourcesInitialized = false;
+}
+
+void GrainNode::ReleaseResources() {
+    for (auto& texture : m_NoiseTextures) {
+        texture.reset();
+    }
+}
+
+void GrainNode::SetInputImageSize(uint32_t width, uint32_t height) {
+    m_ImageWidth = width;
+    m_ImageHeight = height;
+}
+
+uint64_t GrainNode::GetParamsHash() const {
+    uint64_t hash = RenderNode::GetParamsHash();
+    hash = HashValue(m_Amount, hash);
+    hash = HashValue(m_FrameIndex, hash);
+    hash = HashValue(m_ImageWidth, hash);
+    hash = HashValue(m_ImageHeight, hash);
+    return hash;
+}
+
+GrainKernel::Sampling GrainNode::GetSampling(uint32_t width, uint32_t height) const {
+    GrainKernel::Mapping mapping;
+    if (m_TileFullWidth > 0 && m_TileFullHeight > 0) {
+        // 分块：输出像素与完整图像像素一一对应
+        mapping.FullWidth = static_cast<float>(m_TileFullWidth);
+        mapping.FullHeight = static_cast<float>(m_TileFullHeight);
+        mapping.OffsetX = static_cast<float>(m_TileOffsetX);
+        mapping.OffsetY = static_cast<float>(m_TileOffsetY);
+    } else {
+        // 整幅：输出是拉伸到 width x height 的整幅图像
+        mapping.FullWidth = static_cast<float>(m_ImageWidth > 0 ? m_ImageWidth : width);
+        mapping.FullHeight = static_cast<float>(m_ImageHeight > 0 ? m_ImageHeight : height);
+        mapping.PixelScaleX = mapping.FullWidth / static_cast<float>(width);
+        mapping.PixelScaleY = mapping.FullHeight / static_cast<float>(height);
+    }
+    return GrainKernel::GetSampling(m_Amount, m_FrameIndex, mapping);
+}
+
+void GrainNode::UpdateConstantBuffers(uint32_t width, uint32_t height) {
+    if (!m_ParamsBuffer || !m_CommandContext) {
+        return;
+    }
+
+    GrainConstantBuffer cbData = {};
+    cbData.NoiseOrigin[0] = m_Sampling.OriginX;
+    cbData.NoiseOrigin[1] = m_Sampling.OriginY;
+    cbData.NoiseStep[0] = m_Sampling.StepX;
+    cbData.NoiseStep[1] = m_Sampling.StepY;
+    cbData.Amplitude = m_Sampling.Amplitude;
+    cbData.EndpointWeight = GrainKernel::kEndpointWeight;
+    cbData.TileSize = static_cast<float>(GrainKernel::kTileSize);
+    m_CommandContext->RHIUpdateUniformBuffer(m_ParamsBuffer, &cbData);
+}
+
+void GrainNode::SetConstantBuffers() {
+    if (m_ParamsBuffer) {
+        m_CommandContext->RHISetShaderUniformBuffer(RenderCore::EShaderFrequency::SF_Pixel, 0, m_ParamsBuffer);
+    }
+}
+
+void GrainNode::SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) {
+    m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, 0, inputTexture);
+    m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, 1, m_NoiseTextures[m_Sampling.Level]);
+    m_CommandContext->RHISetShaderSampler(RenderCore::EShaderFrequency::SF_Pixel, 0, m_CommonSamplerState);
+    m_CommandContext->RHISetShaderSampler(RenderCore::EShaderFrequency::SF_Pixel, 1, m_NoiseSampler);
+}
+
+bool GrainNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                        std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                        uint32_t width, uint32_t height) {
+    if (IsSoftwareRHI()) {
+        return ExecuteSoftware(inputTexture, outputTarget, width, height);
+    }
+
+    if (!m_ShaderResourcesInitialized || width == 0 || height == 0) {
+        return false;
+    }
+
+    // 强度为 0 时幅度为 0，作为最后一个节点或单独执行时输出等于输入
+    m_Sampling = GetSampling(width, height);
+    auto& noiseTexture = m_NoiseTextures[m_Sampling.Level];
+    if (!noiseTexture) {
+        noiseTexture = m_RHI->RHICreateTexture2D(
+            RenderCore::EPixelFormat::PF_R32_FLOAT,
+            RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+            GrainKernel::kTileSize,
+            GrainKernel::kTileSize,
+            1,
+            const_cast<float*>(GrainKernel::GetNoiseTile(m_Sampling.Level)),
+            GrainKernel::kTileSize * sizeof(float)
+        );
+        if (!noiseTexture) {
+            std::cerr << "[GrainNode] Failed to create noise texture" << std::endl;
+            return false;
+        }
+    }
+
+    m_CurrentShader = &m_Shader;
+    return RenderNode::Execute(inputTexture, outputTarget, width, height);
+}
+
+bool GrainNode::ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                uint32_t width, uint32_t height) {
+    RenderCore::SoftwareTexture2D* input = GetSoftwareTexture(inputTexture);
+    RenderCore::SoftwareTexture2D* output = GetSoftwareTexture(outputTarget);
+    if (!IsSoftwareBGRA8Pair(input, output, width, height) || width == 0 || height == 0 ||
+        input->GetSize().x < static_cast<int32_t>(width) || input->GetSize().y < static_cast<int32_t>(height)) {
+        std::cerr << "[GrainNode] Unsupported texture for CPU path" << std::endl;
+        return false;
+    }
+
+    return GrainKernel::Process(GetSampling(width, height), input->GetRow(0), input->GetRowPitch(),
+                                output->GetRow(0), output->GetRowPitch(), width, height);
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "RenderNode.h"
+#include "GrainKernel.h"
+#include "../d3d11rhi/RHIUniformBuffer.h"
+#include "../d3d11rhi/RHIState.h"
+#include <memory>
+
+namespace LightroomCore {
+
+// 胶片颗粒节点：从共享噪声库（GrainKernel）采样并按亮度叠加，位于调整与滤镜之后、视图缩放之前
+// GPU 路径把用到的噪声上传为 R32F 纹理（t1），以环绕寻址的双线性采样器读取；逐像素只有一次额外采样。
+// 视频每帧调用 SetFrameIndex 平移噪声，颗粒逐帧变化；强度为 0 时渲染图跳过该节点。
+class GrainNode : public RenderNode {
+public:
+    GrainNode(std::shared_ptr<RenderCore::DynamicRHI> rhi);
+    virtual ~GrainNode();
+
+    virtual bool Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                        std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                        uint32_t width, uint32_t height) override;
+
+    virtual const char* GetName() const override { return "Grain"; }
+    virtual uint64_t GetParamsHash() const override;
+    // 逐点运算，噪声坐标由分块上下文换算为完整图像像素，不需要邻域
+    virtual int32_t GetTileApron() const override { return 0; }
+    virtual bool IsIdentity() const override { return GrainKernel::IsIdentity(m_Amount); }
+    virtual void ReleaseResources() override;
+
+    // amount: 0 - 100
+    void SetAmount(float amount) { m_Amount = amount; }
+    float GetAmount() const { return m_Amount; }
+
+    // 视频帧号（图片保持为 0）
+    void SetFrameIndex(uint64_t frameIndex) { m_FrameIndex = frameIndex; }
+
+    // 原图尺寸：中间纹理是拉伸到输出尺寸的整幅图像，颗粒大小以原图像素计算
+    void SetInputImageSize(uint32_t width, uint32_t height);
+    uint32_t GetInputImageWidth() const { return m_ImageWidth; }
+    uint32_t GetInputImageHeight() const { return m_ImageHeight; }
+
+protected:
+    virtual void UpdateConstantBuffers(uint32_t width, uint32_t height) override;
+    virtual void SetConstantBuffers() override;
+    virtual void SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) override;
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) override;
+
+private:
+    bool InitializeShaderResources();
+    void CleanupShaderResources();
+
+    // 输出尺寸为 width x height 时的噪声采样方式（考虑分块上下文）
+    GrainKernel::Sampling GetSampling(uint32_t width, uint32_t height) const;
+
+    float m_Amount = 0.0f;
+    uint64_t m_FrameIndex = 0;
+    uint32_t m_ImageWidth = 0;
+    uint32_t m_ImageHeight = 0;
+
+    // 当前执行使用的采样方式（Execute 中计算，UpdateConstantBuffers 上传）
+    GrainKernel::Sampling m_Sampling;
+    // 按需创建的噪声纹理，下标为噪声库中的级别
+    std::shared_ptr<RenderCore::RHITexture2D> m_NoiseTextures[GrainKernel::kLevelCount];
+
+    CompiledShader m_Shader;
+    std::shared_ptr<RenderCore::RHIUniformBuffer> m_ParamsBuffer;
+    std::shared_ptr<RenderCore::RHISamplerState> m_NoiseSampler;
+    bool m_ShaderResourcesInitialized = false;
+};
+
+} // namespace LightroomCore
@@ -0,0 +1,972 @@
+﻿#include "ImageAdjustKernel.h"
+#include "GaussianBlurKernel.h"
+#include "LUTKernel.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <intrin.h>
+#include <immintrin.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace LightroomCore {
+
+namespace {
+
+// 与 shader 中的 ONE_THIRD 保持同一字面值
+constexpr float kOneThird = 0.3333333f;
+constexpr float kTwoThirds = 2.0f * kOneThird;
+
+// ============================================
+// 标量辅助函数（逐点调整的参考公式，AdjustmentLUT 据此编译 GPU 与 CPU 共用的 LUT）
+// ============================================
+
+inline float Saturate(float v) {
+    // 与 SSE max/min 的 NaN 语义一致：NaN -> 0
+    v = (v > 0.0f) ? v : 0.0f;
+    return (v < 1.0f) ? v : 1.0f;
+}
+
+inline float SrgbToLinear(float srgb) {
+    if (srgb <= 0.04045f) {
+        return srgb / 12.92f;
+    }
+    return std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+}
+
+inline float LinearToSrgb(float linear) {
+    if (linear <= 0.0031308f) {
+        return linear * 12.92f;
+    }
+    return 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+}
+
+// GEGL 色温转换算法（有理多项式拟合）
+void ConvertKToRGB(float temperature, float rgb[3]) {
+    static const float kCoeffs[3][12] = {
+        {
+            6.9389923563552169e-01f,  2.7719388100974670e+03f,
+            2.0999316761104289e+07f, -4.8889434162208414e+09f,
+            -1.1899785506796783e+07f, -4.7418427686099203e+04f,
+            1.0000000000000000e+00f,  3.5434394338546258e+03f,
+            -5.6159353379127791e+05f,  2.7369467137870544e+08f,
+            1.6295814912940913e+08f,  4.3975072422421846e+05f
+        },
+        {
+            9.5417426141210926e-01f,  2.2041043287098860e+03f,
+            -3.0142332673634286e+06f, -3.5111986367681120e+03f,
+            -5.7030969525354260e+00f,  6.1810926909962016e-01f,
+            1.0000000000000000e+00f,  1.3728609973644000e+03f,
+            1.3099184987576159e+06f, -2.1757404458816318e+03f,
+            -2.3892456292510311e+00f,  8.1079012401293249e-01f
+        },
+        {
+            -7.1151622540856201e+10f,  3.3728185802339764e+16f,
+            -7.9396187338868539e+19f,  2.9699115135330123e+22f,
+            -9.7520399221734228e+22f, -2.9250107732225114e+20f,
+            1.0000000000000000e+00f,  1.3888666482167408e+16f,
+            2.3899765140914549e+19f,  1.4583606312383295e+23f,
+            1.9766018324502894e+22f,  2.9395068478016189e+18f
+        }
+    };
+
+    // 温度范围限定（1500K-11500K）
+    const float temp = std::min(std::max(temperature, 1500.0f), 11500.0f);
+    for (int c = 0; c < 3; ++c) {
+        float nomin = kCoeffs[c][0];
+        for (int d = 1; d < 6; ++d) {
+            nomin = nomin * temp + kCoeffs[c][d];
+        }
+        float denom = kCoeffs[c][6];
+        for (int d = 1; d < 6; ++d) {
+            denom = denom * temp + kCoeffs[c][6 + d];
+        }
+        float value = nomin / denom;
+        if (value < 1e-5f) value = 1e-5f;
+        if (value > 100.0f) value = 100.0f;
+        rgb[c] = value;
+    }
+}
+
+// 计算色温调整系数（以 6500K 标准日光为基准）
+void CalculateTempAdjustCoeffs(float intendedTemp, float coeffs[3]) {
+    const float originalTemp = 6500.0f;
+    if (std::abs(originalTemp - intendedTemp) < 0.1f) {
+        coeffs[0] = coeffs[1] = coeffs[2] = 1.0f;
+        return;
+    }
+
+    float originalRgb[3];
+    float intendedRgb[3];
+    ConvertKToRGB(originalTemp, originalRgb);
+    ConvertKToRGB(intendedTemp, intendedRgb);
+    for (int c = 0; c < 3; ++c) {
+        coeffs[c] = originalRgb[c] / intendedRgb[c];
+    }
+}
+
+// 色温对单个通道的作用：sRGB -> 线性 -> 乘系数 -> 裁剪 -> sRGB
+inline float ApplyTemperatureChannel(float value, float coeff) {
+    return LinearToSrgb(Saturate(SrgbToLinear(value) * coeff));
+}
+
+// ============================================
+// SIMD 抽象：同一份模板代码实例化为标量 / SSE4.1 / AVX2 三条路径
+// 运算顺序与 shader 一致且不使用 FMA，三条路径的结果逐位相同
+// ============================================
+
+struct ScalarOps {
+    using V = float;
+    using M = bool;
+    static constexpr int Width = 1;
+    static __forceinline V Load(const float* p) { return *p; }
+    static __forceinline void Store(float* p, V v) { *p = v; }
+    static __forceinline V Set(float v) { return v; }
+    static __forceinline V Add(V a, V b) { return a + b; }
+    static __forceinline V Sub(V a, V b) { return a - b; }
+    static __forceinline V Mul(V a, V b) { return a * b; }
+    static __forceinline V Div(V a, V b) { return a / b; }
+    static __forceinline V Min(V a, V b) { return (a < b) ? a : b; }
+    static __forceinline V Max(V a, V b) { return (a > b) ? a : b; }
+    static __forceinline V Floor(V a) { return std::floor(a); }
+    static __forceinline M Lt(V a, V b) { return a < b; }
+    static __forceinline M Gt(V a, V b) { return a > b; }
+    static __forceinline M Eq(V a, V b) { return a == b; }
+    static __forceinline V Select(M m, V a, V b) { return m ? a : b; }
+    // index 为整数值的浮点数
+    static __forceinline V Gather(const float* table, V index) { return table[static_cast<int32_t>(index)]; }
+};
+
+struct SSE41Ops {
+    using V = __m128;
+    using M = __m128;
+    static constexpr int Width = 4;
+    static __forceinline V Load(const float* p) { return _mm_loadu_ps(p); }
+    static __forceinline void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static __forceinline V Set(float v) { return _mm_set1_ps(v); }
+    static __forceinline V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static __forceinline V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static __forceinline V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static __forceinline V Div(V a, V b) { return _mm_div_ps(a, b); }
+    static __forceinline V Min(V a, V b) { return _mm_min_ps(a, b); }
+    static __forceinline V Max(V a, V b) { return _mm_max_ps(a, b); }
+    static __forceinline V Floor(V a) { return _mm_floor_ps(a); }
+    static __forceinline M Lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static __forceinline M Gt(V a, V b) { return _mm_cmpgt_ps(a, b); }
+    static __forceinline M Eq(V a, V b) { return _mm_cmpeq_ps(a, b); }
+    static __forceinline V Select(M m, V a, V b) { return _mm_blendv_ps(b, a, m); }
+    static __forceinline V Gather(const float* table, V index) {
+        const __m128i i = _mm_cvttps_epi32(index);
+        return _mm_setr_ps(table[_mm_extract_epi32(i, 0)], table[_mm_extract_epi32(i, 1)],
+                           table[_mm_extract_epi32(i, 2)], table[_mm_extract_epi32(i, 3)]);
+    }
+};
+
+struct AVX2Ops {
+    using V = __m256;
+    using M = __m256;
+    static constexpr int Width = 8;
+    static __forceinline V Load(const float* p) { return _mm256_loadu_ps(p); }
+    static __forceinline void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static __forceinline V Set(float v) { return _mm256_set1_ps(v); }
+    static __forceinline V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static __forceinline V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static __forceinline V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static __forceinline V Div(V a, V b) { return _mm256_div_ps(a, b); }
+    static __forceinline V Min(V a, V b) { return _mm256_min_ps(a, b); }
+    static __forceinline V Max(V a, V b) { return _mm256_max_ps(a, b); }
+    static __forceinline V Floor(V a) { return _mm256_floor_ps(a); }
+    static __forceinline M Lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static __forceinline M Gt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static __forceinline M Eq(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static __forceinline V Select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+    static __forceinline V Gather(const float* table, V index) {
+        return _mm256_i32gather_ps(table, _mm256_cvttps_epi32(index), 4);
+    }
+};
+
+template <class O>
+struct PixelMath {
+    using V = typename O::V;
+    using M = typename O::M;
+
+    static __forceinline V Saturate(V v) {
+        return O::Min(O::Max(v, O::Set(0.0f)), O::Set(1.0f));
+    }
+
+    static __forceinline V Frac(V v) {
+        return O::Sub(v, O::Floor(v));
+    }
+
+    // HLSL lerp(a, b, t) = a + t * (b - a)
+    static __forceinline V Lerp(V a, V b, V t) {
+        return O::Add(a, O::Mul(t, O::Sub(b, a)));
+    }
+
+    static __forceinline V SmoothStep01(V x) {
+        const V t = Saturate(x);
+        return O::Mul(O::Mul(t, t), O::Sub(O::Set(3.0f), O::Mul(O::Set(2.0f), t)));
+    }
+
+    static __forceinline V Luminance(V r, V g, V b) {
+        return O::Add(O::Add(O::Mul(r, O::Set(0.299f)), O::Mul(g, O::Set(0.587f))), O::Mul(b, O::Set(0.114f)));
+    }
+
+    // 对 mask 内的像素乘以 factor；blend 为 true 时按 curve 在原色与结果之间插值，最后裁剪到 [0, 1]
+    static __forceinline void ScaleMasked(V& r, V& g, V& b, M mask, V factor, V curve, bool blend) {
+        V nr = O::Mul(r, factor);
+        V ng = O::Mul(g, factor);
+        V nb = O::Mul(b, factor);
+        if (blend) {
+            nr = Lerp(r, nr, curve);
+            ng = Lerp(g, ng, curve);
+            nb = Lerp(b, nb, curve);
+        }
+        r = O::Select(mask, Saturate(nr), r);
+        g = O::Select(mask, Saturate(ng), g);
+        b = O::Select(mask, Saturate(nb), b);
+    }
+
+    // 1.0 + amount * curve * scale
+    static __forceinline V AmountFactor(float amount, V curve, float scale) {
+        return O::Add(O::Set(1.0f), O::Mul(O::Mul(O::Set(amount), curve), O::Set(scale)));
+    }
+
+    static __forceinline void AdjustHighlights(V& r, V& g, V& b, float amount) {
+        const V lum = Luminance(r, g, b);
+        const M mask = O::Gt(lum, O::Set(0.4f));
+        const V curve = SmoothStep01(O::Div(O::Sub(lum, O::Set(0.4f)), O::Set(0.6f)));
+        if (amount < 0.0f) {
+            ScaleMasked(r, g, b, mask, Saturate(AmountFactor(amount, curve, 1.5f)), curve, false);
+        } else {
+            ScaleMasked(r, g, b, mask, AmountFactor(amount, curve, 0.8f), curve, true);
+        }
+    }
+
+    static __forceinline void AdjustShadows(V& r, V& g, V& b, float amount) {
+        const V lum = Luminance(r, g, b);
+        const M mask = O::Lt(lum, O::Set(0.6f));
+        const V curve = SmoothStep01(O::Div(O::Sub(O::Set(0.6f), lum), O::Set(0.6f)));
+        if (amount > 0.0f) {
+            ScaleMasked(r, g, b, mask, AmountFactor(amount, curve, 1.5f), curve, true);
+        } else {
+            ScaleMasked(r, g, b, mask, Saturate(AmountFactor(amount, curve, 1.2f)), curve, false);
+        }
+    }
+
+    static __forceinline void AdjustWhites(V& r, V& g, V& b, float amount) {
+        const V lum = Luminance(r, g, b);
+        const M mask = O::Gt(lum, O::Set(0.7f));
+        const V weight = O::Div(O::Sub(lum, O::Set(0.7f)), O::Set(0.3f));
+        const V curve = O::Mul(weight, weight);
+        if (amount > 0.0f) {
+            ScaleMasked(r, g, b, mask, AmountFactor(amount, curve, 0.3f), curve, true);
+        } else {
+            ScaleMasked(r, g, b, mask, AmountFactor(amount, curve, 0.5f), curve, false);
+        }
+    }
+
+    static __forceinline void AdjustBlacks(V& r, V& g, V& b, float amount) {
+        const V lum = Luminance(r, g, b);
+        const M mask = O::Lt(lum, O::Set(0.3f));
+        const V weight = O::Div(O::Sub(O::Set(0.3f), lum), O::Set(0.3f));
+        const V curve = O::Mul(weight, weight);
+        if (amount > 0.0f) {
+            ScaleMasked(r, g, b, mask, AmountFactor(amount, curve, 0.5f), curve, true);
+        } else {
+            ScaleMasked(r, g, b, mask, AmountFactor(amount, curve, 1.0f), curve, false);
+        }
+    }
+
+    static __forceinline V AdjustContrastChannel(V c, V factor) {
+        const V half = O::Set(0.5f);
+        return Saturate(O::Add(O::Mul(factor, O::Sub(c, half)), half));
+    }
+
+    static __forceinline V HueToRGB(V f1, V f2, V hue) {
+        hue = Frac(hue);
+        const V diff = O::Sub(f2, f1);
+        const V rising = O::Add(f1, O::Mul(O::Mul(diff, O::Set(6.0f)), hue));
+        const V falling = O::Add(f1, O::Mul(O::Mul(diff, O::Sub(O::Set(kTwoThirds), hue)), O::Set(6.0f)));
+        const V result = O::Select(O::Lt(O::Mul(O::Set(3.0f), hue), O::Set(2.0f)), falling, f1);
+        return O::Select(O::Lt(O::Mul(O::Set(6.0f), hue), O::Set(1.0f)), rising,
+               O::Select(O::Lt(O::Mul(O::Set(2.0f), hue), O::Set(1.0f)), f2, result));
+    }
+
+    // RGB -> HSL，色相与饱和度在 [0, 1)（无色差像素两者都为 0）
+    static __forceinline void RGBToHSL(V r, V g, V b, V& hue, V& sat, V& lightness) {
+        const V fmin = O::Min(O::Min(r, g), b);
+        const V fmax = O::Max(O::Max(r, g), b);
+        const V delta = O::Sub(fmax, fmin);
+        lightness = O::Mul(O::Add(fmax, fmin), O::Set(0.5f));
+        const M chromatic = O::Gt(delta, O::Set(0.0001f));
+
+        // 无色差像素的除法结果会被 chromatic 掩码丢弃
+        sat = O::Select(O::Lt(lightness, O::Set(0.5f)),
+                        O::Div(delta, O::Add(fmax, fmin)),
+                        O::Div(delta, O::Sub(O::Sub(O::Set(2.0f), fmax), fmin)));
+
+        const V halfDelta = O::Div(delta, O::Set(2.0f));
+        const V deltaR = O::Div(O::Add(O::Div(O::Sub(fmax, r), O::Set(6.0f)), halfDelta), delta);
+        const V deltaG = O::Div(O::Add(O::Div(O::Sub(fmax, g), O::Set(6.0f)), halfDelta), delta);
+        const V deltaB = O::Div(O::Add(O::Div(O::Sub(fmax, b), O::Set(6.0f)), halfDelta), delta);
+        hue = O::Select(O::Eq(r, fmax), O::Sub(deltaB, deltaG),
+              O::Select(O::Eq(g, fmax), O::Sub(O::Add(O::Set(kOneThird), deltaR), deltaB),
+                                        O::Sub(O::Add(O::Set(kTwoThirds), deltaG), deltaR)));
+        hue = Frac(O::Add(hue, O::Set(1.0f)));
+
+        hue = O::Select(chromatic, hue, O::Set(0.0f));
+        sat = O::Select(chromatic, sat, O::Set(0.0f));
+    }
+
+    static __forceinline void HSLToRGB(V hue, V sat, V lightness, V& r, V& g, V& b) {
+        const M grey = O::Lt(sat, O::Set(0.0001f));
+        const V f2 = O::Select(O::Lt(lightness, O::Set(0.5f)),
+                               O::Mul(lightness, O::Add(O::Set(1.0f), sat)),
+                               O::Sub(O::Add(lightness, sat), O::Mul(sat, lightness)));
+        const V f1 = O::Sub(O::Mul(O::Set(2.0f), lightness), f2);
+
+        r = O::Select(grey, lightness, HueToRGB(f1, f2, O::Add(hue, O::Set(kOneThird))));
+        g = O::Select(grey, lightness, HueToRGB(f1, f2, hue));
+        b = O::Select(grey, lightness, HueToRGB(f1, f2, O::Sub(hue, O::Set(kOneThird))));
+    }
+
+    // RGB -> HSL -> 调整饱和度 -> RGB
+    static __forceinline void AdjustSaturation(V& r, V& g, V& b, float saturationFactor) {
+        V hue, sat, lightness;
+        RGBToHSL(r, g, b, hue, sat, lightness);
+        sat = Saturate(O::Mul(sat, O::Set(saturationFactor)));
+        HSLToRGB(hue, sat, lightness, r, g, b);
+    }
+
+    // HSL 调整：按像素色相查三张表（相邻两项线性插值），不需要三角函数
+    // 明亮度偏移乘以原饱和度，灰色像素不受影响
+    static __forceinline void AdjustHSL(V& r, V& g, V& b, const ImageAdjustKernel::PointParams& p) {
+        V hue, sat, lightness;
+        RGBToHSL(r, g, b, hue, sat, lightness);
+
+        const V index = O::Min(O::Mul(hue, O::Set(static_cast<float>(ImageAdjustKernel::kHueTableSize))),
+                               O::Set(static_cast<float>(ImageAdjustKernel::kHueTableSize) - 0.001f));
+        const V index0 = O::Floor(index);
+        const V t = O::Sub(index, index0);
+        const V hueShift = Lerp(O::Gather(p.HueShift, index0), O::Gather(p.HueShift + 1, index0), t);
+        const V satScale = Lerp(O::Gather(p.HueSaturation, index0), O::Gather(p.HueSaturation + 1, index0), t);
+        const V lumShift = Lerp(O::Gather(p.HueLuminance, index0), O::Gather(p.HueLuminance + 1, index0), t);
+
+        lightness = Saturate(O::Add(lightness, O::Mul(lumShift, sat)));
+        sat = Saturate(O::Mul(sat, O::Add(O::Set(1.0f), satScale)));
+        hue = Frac(O::Add(hue, hueShift));
+        HSLToRGB(hue, sat, lightness, r, g, b);
+    }
+
+    // 对 [begin, end) 中的像素执行逐点调整，返回第一个未处理的索引（不足一个向量宽度的尾部留给调用方）
+    // Ops 为编译期的 ImageAdjustOp 位掩码：未激活的步骤不会出现在循环中
+    template <uint32_t Ops>
+    static int32_t AdjustPoints(const ImageAdjustKernel::PointParams& p, float* rp, float* gp, float* bp,
+                                int32_t begin, int32_t end) {
+        const V exposure = O::Set(p.ExposureScale);
+        const V contrast = O::Set(p.ContrastFactor);
+
+        int32_t i = begin;
+        for (; i + O::Width <= end; i += O::Width) {
+            V r = O::Load(rp + i);
+            V g = O::Load(gp + i);
+            V b = O::Load(bp + i);
+
+            if constexpr ((Ops & ImageAdjustOp_Exposure) != 0) {
+                r = O::Mul(r, exposure);
+                g = O::Mul(g, exposure);
+                b = O::Mul(b, exposure);
+            }
+            if constexpr ((Ops & ImageAdjustOp_Tone) != 0) {
+                // 四个影调滑块合为一位，单个滑块为 0 时的判断对整行一致，分支预测几乎没有代价
+                if (p.Highlights != 0.0f) {
+                    AdjustHighlights(r, g, b, p.Highlights);
+                }
+                if (p.Shadows != 0.0f) {
+                    AdjustShadows(r, g, b, p.Shadows);
+                }
+                if (p.Whites != 0.0f) {
+                    AdjustWhites(r, g, b, p.Whites);
+                }
+                if (p.Blacks != 0.0f) {
+                    AdjustBlacks(r, g, b, p.Blacks);
+                }
+            }
+            if constexpr ((Ops & ImageAdjustOp_Contrast) != 0) {
+                r = AdjustContrastChannel(r, contrast);
+                g = AdjustContrastChannel(g, contrast);
+                b = AdjustContrastChannel(b, contrast);
+            }
+            if constexpr ((Ops & ImageAdjustOp_HSL) != 0) {
+                AdjustHSL(r, g, b, p);
+            }
+            if constexpr ((Ops & ImageAdjustOp_Saturation) != 0) {
+                AdjustSaturation(r, g, b, p.SaturationFactor);
+            }
+
+            O::Store(rp + i, r);
+            O::Store(gp + i, g);
+            O::Store(bp + i, b);
+        }
+        return i;
+    }
+};
+
+// 逐点内核按曝光、影调、对比度、HSL、饱和度五位特化（色温只依赖单个通道，在 LoadRow 中查表处理）
+constexpr uint32_t kPointKernelShift = 1;
+constexpr uint32_t kPointKernelOps = ImageAdjustOp_Exposure | ImageAdjustOp_Tone | ImageAdjustOp_Contrast |
+                                     ImageAdjustOp_HSL | ImageAdjustOp_Saturation;
+constexpr size_t kPointKernelCount = (kPointKernelOps >> kPointKernelShift) + 1;
+static_assert((kPointKernelOps >> kPointKernelShift) == kPointKernelCount - 1 && (kPointKernelCount & (kPointKernelCount - 1)) == 0,
+              "Point kernel ops must be contiguous bits");
+
+template <typename O, uint32_t Ops>
+void AdjustPointsKernel(const ImageAdjustKernel::PointParams& p, float* r, float* g, float* b, int32_t count) {
+    const int32_t done = PixelMath<O>::template AdjustPoints<Ops>(p, r, g, b, 0, count);
+    if constexpr (O::Width > 1) {
+        PixelMath<ScalarOps>::template AdjustPoints<Ops>(p, r, g, b, done, count);
+    }
+}
+
+template <typename O, size_t... Keys>
+constexpr std::array<ImageAdjustKernel::AdjustPointsFunc, sizeof...(Keys)> MakePointKernelTable(std::index_sequence<Keys...>) {
+    return { { &AdjustPointsKernel<O, static_cast<uint32_t>(Keys << kPointKernelShift)>... } };
+}
+
+// 全部特化在编译期实例化，运行时按 (SIMD 级别, 位掩码) 直接索引
+// 节点执行时逐像素只查 LUT，这些内核的收益在于参数变化时编译 33^3 / 65^3 LUT 的格点计算
+const std::array<ImageAdjustKernel::AdjustPointsFunc, kPointKernelCount> kPointKernelsScalar =
+    MakePointKernelTable<ScalarOps>(std::make_index_sequence<kPointKernelCount>());
+const std::array<ImageAdjustKernel::AdjustPointsFunc, kPointKernelCount> kPointKernelsSSE41 =
+    MakePointKernelTable<SSE41Ops>(std::make_index_sequence<kPointKernelCount>());
+const std::array<ImageAdjustKernel::AdjustPointsFunc, kPointKernelCount> kPointKernelsAVX2 =
+    MakePointKernelTable<AVX2Ops>(std::make_index_sequence<kPointKernelCount>());
+
+ImageAdjustSimdLevel DetectSimdLevel() {
+    int info[4] = { 0, 0, 0, 0 };
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    if (maxLeaf < 1) {
+        return ImageAdjustSimdLevel::Scalar;
+    }
+
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    // AVX2 需要 CPU 支持且操作系统保存 YMM 寄存器状态
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        if ((info[1] & (1 << 5)) != 0) {
+            return ImageAdjustSimdLevel::AVX2;
+        }
+    }
+    return sse41 ? ImageAdjustSimdLevel::SSE41 : ImageAdjustSimdLevel::Scalar;
+}
+
+size_t GetBytesPerPixel(ImageAdjustPixelLayout layout) {
+    switch (layout) {
+    case ImageAdjustPixelLayout::BGRA8:
+    case ImageAdjustPixelLayout::RGBA8:
+        return 4;
+    case ImageAdjustPixelLayout::RGBA32F:
+        return 16;
+    case ImageAdjustPixelLayout::PlanarRGBA32F:
+        return 4;
+    }
+    return 0;
+}
+
+bool IsValidView(const ImageAdjustImageView& view) {
+    if (view.Width == 0 || view.Height == 0 || !view.Planes[0]) {
+        return false;
+    }
+    if (view.RowPitch < view.Width * GetBytesPerPixel(view.Layout)) {
+        return false;
+    }
+    if (view.Layout == ImageAdjustPixelLayout::PlanarRGBA32F && (!view.Planes[1] || !view.Planes[2])) {
+        return false;
+    }
+    return true;
+}
+
+// 读取源图像一个纹素的原始 RGB（与 shader 采样 InputTexture 一致，不经过任何调整）
+inline void FetchTexel(const ImageAdjustImageView& view, int32_t x, int32_t y, float rgb[3]) {
+    x = std::min(std::max(x, 0), static_cast<int32_t>(view.Width) - 1);
+    y = std::min(std::max(y, 0), static_cast<int32_t>(view.Height) - 1);
+    const size_t rowOffset = static_cast<size_t>(y) * view.RowPitch;
+    switch (view.Layout) {
+    case ImageAdjustPixelLayout::BGRA8: {
+        const uint8_t* p = view.Planes[0] + rowOffset + static_cast<size_t>(x) * 4;
+        rgb[0] = p[2] / 255.0f;
+        rgb[1] = p[1] / 255.0f;
+        rgb[2] = p[0] / 255.0f;
+        break;
+    }
+    case ImageAdjustPixelLayout::RGBA8: {
+        const uint8_t* p = view.Planes[0] + rowOffset + static_cast<size_t>(x) * 4;
+        rgb[0] = p[0] / 255.0f;
+        rgb[1] = p[1] / 255.0f;
+        rgb[2] = p[2] / 255.0f;
+        break;
+    }
+    case ImageAdjustPixelLayout::RGBA32F: {
+        const float* p = reinterpret_cast<const float*>(view.Planes[0] + rowOffset) + static_cast<size_t>(x) * 4;
+        rgb[0] = p[0];
+        rgb[1] = p[1];
+        rgb[2] = p[2];
+        break;
+    }
+    case ImageAdjustPixelLayout::PlanarRGBA32F:
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] = reinterpret_cast<const float*>(view.Planes[c] + rowOffset)[x];
+        }
+        break;
+    }
+}
+
+// 由八个色带的滑块值生成按色相（每度一项）索引的色相偏移/饱和度缩放/明亮度偏移表
+// 相邻色带中心之间用 smoothstep 过渡，末项与首项相同以便插值时首尾衔接
+void BuildHueTables(const ImageAdjustConstantBuffer& params, ImageAdjustKernel::PointParams& p) {
+    constexpr int kBandCount = 8;
+    // 红、橙、黄、绿、浅绿、蓝、紫、洋红的色相中心（度）
+    static const float kBandCenters[kBandCount + 1] = { 0.0f, 30.0f, 60.0f, 120.0f, 180.0f, 240.0f, 270.0f, 300.0f, 360.0f };
+
+    float hueShift[kBandCount + 1];
+    float saturation[kBandCount + 1];
+    float luminance[kBandCount + 1];
+    // 色相已在常量缓冲中除以 100，饱和度/明亮度仍为滑块原值
+    for (int band = 0; band < kBandCount; ++band) {
+        const int index = band & 3;
+        const bool second = band >= 4;
+        hueShift[band] = (second ? params.HueAdjustments2[index] : params.HueAdjustments[index]) * ImageAdjustKernel::kMaxHueShift;
+        saturation[band] = (second ? params.SatAdjustments2[index] : params.SatAdjustments[index]) / 100.0f;
+        luminance[band] = (second ? params.LumAdjustments2[index] : params.LumAdjustments[index]) / 100.0f * ImageAdjustKernel::kMaxHueLuminance;
+    }
+    hueShift[kBandCount] = hueShift[0];
+    saturation[kBandCount] = saturation[0];
+    luminance[kBandCount] = luminance[0];
+
+    int band = 0;
+    for (int i = 0; i <= ImageAdjustKernel::kHueTableSize; ++i) {
+        const float degrees = static_cast<float>(i) * 360.0f / ImageAdjustKernel::kHueTableSize;
+        while (band < kBandCount - 1 && degrees >= kBandCenters[band + 1]) {
+            ++band;
+        }
+        float t = (degrees - kBandCenters[band]) / (kBandCenters[band + 1] - kBandCenters[band]);
+        t = std::min(std::max(t, 0.0f), 1.0f);
+        t = t * t * (3.0f - 2.0f * t);
+        p.HueShift[i] = hueShift[band] + (hueShift[band + 1] - hueShift[band]) * t;
+        p.HueSaturation[i] = saturation[band] + (saturation[band + 1] - saturation[band]) * t;
+        p.HueLuminance[i] = luminance[band] + (luminance[band + 1] - luminance[band]) * t;
+    }
+}
+
+} // namespace
+
+ImageAdjustKernel::ImageAdjustKernel(const ImageAdjustConstantBuffer& params)
+    : m_Params(params)
+    , m_SimdLevel(GetSupportedSimdLevel())
+    , m_ActiveOps(GetActiveOps(params))
+    , m_AdjustPoints(nullptr)
+    , m_ApplyTemperature(false)
+    , m_ApplyClarity(false)
+    , m_ClarityValue(0.0f)
+    , m_ClaritySigma(0.0f)
+{
+    // 1. 白平衡
+    m_ApplyTemperature = (m_ActiveOps & ImageAdjustOp_Temperature) != 0;
+    m_TemperatureCoeffs[0] = m_TemperatureCoeffs[1] = m_TemperatureCoeffs[2] = 1.0f;
+    if (m_ApplyTemperature) {
+        CalculateTempAdjustCoeffs(m_Params.Temperature, m_TemperatureCoeffs);
+    }
+    for (int c = 0; c < 3; ++c) {
+        for (int v = 0; v < 256; ++v) {
+            const float value = v / 255.0f;
+            m_ByteToFloat[c][v] = m_ApplyTemperature ? ApplyTemperatureChannel(value, m_TemperatureCoeffs[c]) : value;
+        }
+    }
+
+    // 2. 曝光
+    m_PointParams.ExposureScale = std::pow(2.0f, m_Params.Exposure);
+
+    // 3. 高光/阴影/白色/黑色（0 表示跳过）
+    auto toneAmount = [](float value) {
+        return std::abs(value) > 0.1f ? value / 100.0f : 0.0f;
+    };
+    m_PointParams.Highlights = toneAmount(m_Params.Highlights);
+    m_PointParams.Shadows = toneAmount(m_Params.Shadows);
+    m_PointParams.Whites = toneAmount(m_Params.Whites);
+    m_PointParams.Blacks = toneAmount(m_Params.Blacks);
+
+    // 4. 对比度（Photoshop 公式，Contrast 已归一化到 -1 到 1）
+    float c = m_Params.Contrast * 255.0f;
+    if (std::abs(c - 259.0f) < 0.1f) {
+        c = 258.9f;
+    }
+    m_PointParams.ContrastFactor = (259.0f * (c + 255.0f)) / (255.0f * (259.0f - c));
+
+    // 5. HSL
+    BuildHueTables(m_Params, m_PointParams);
+
+    // 6. 饱和度
+    m_PointParams.SaturationFactor = 1.0f + m_Params.Saturation / 50.0f;
+
+    // 8. 清晰度
+    m_ClarityValue = (m_Params.Sharpness / 150.0f) * 100.0f;
+    m_ApplyClarity = (m_ActiveOps & ImageAdjustOp_ClarityMask) != 0;
+    m_ClaritySigma = GetClarityBlurSigma(m_Params);
+
+    SelectPointKernel();
+}
+
+uint32_t ImageAdjustKernel::GetActiveOps(const ImageAdjustConstantBuffer& params) {
+    uint32_t ops = ImageAdjustOp_None;
+
+    // 1. 白平衡：|T - 5500| > 0.1 且 T 位于 [1500, 11500] 时才生效
+    const float temperature = params.Temperature;
+    if (std::abs(temperature - 5500.0f) > 0.1f && temperature >= 1500.0f && temperature <= 11500.0f) {
+        ops |= ImageAdjustOp_Temperature;
+    }
+    if (std::abs(params.Exposure) > 0.001f) {
+        ops |= ImageAdjustOp_Exposure;
+    }
+    if (std::abs(params.Highlights) > 0.1f || std::abs(params.Shadows) > 0.1f ||
+        std::abs(params.Whites) > 0.1f || std::abs(params.Blacks) > 0.1f) {
+        ops |= ImageAdjustOp_Tone;
+    }
+    if (std::abs(params.Contrast) > 0.001f) {
+        ops |= ImageAdjustOp_Contrast;
+    }
+    for (int band = 0; band < 4; ++band) {
+        if (std::abs(params.HueAdjustments[band]) > 0.001f || std::abs(params.HueAdjustments2[band]) > 0.001f ||
+            std::abs(params.SatAdjustments[band]) > 0.001f || std::abs(params.SatAdjustments2[band]) > 0.001f ||
+            std::abs(params.LumAdjustments[band]) > 0.001f || std::abs(params.LumAdjustments2[band]) > 0.001f) {
+            ops |= ImageAdjustOp_HSL;
+        }
+    }
+    if (std::abs(params.Saturation) > 0.001f) {
+        ops |= ImageAdjustOp_Saturation;
+    }
+
+    // 8. 清晰度：clarityValue 为 0 时结果等同于 saturate(color)，可以跳过
+    const float clarityValue = (params.Sharpness / 150.0f) * 100.0f;
+    if (clarityValue > 0.0f) {
+        ops |= ImageAdjustOp_ClaritySharpen;
+    } else if (clarityValue < 0.0f) {
+        ops |= ImageAdjustOp_ClaritySoften;
+    }
+    return ops;
+}
+
+void ImageAdjustKernel::SelectPointKernel() {
+    const size_t key = (m_ActiveOps & kPointKernelOps) >> kPointKernelShift;
+    if (m_SimdLevel == ImageAdjustSimdLevel::AVX2) {
+        m_AdjustPoints = kPointKernelsAVX2[key];
+    } else if (m_SimdLevel == ImageAdjustSimdLevel::SSE41) {
+        m_AdjustPoints = kPointKernelsSSE41[key];
+    } else {
+        m_AdjustPoints = kPointKernelsScalar[key];
+    }
+}
+
+float ImageAdjustKernel::GetClarityBlurSigma(const ImageAdjustConstantBuffer& params) {
+    const float clarityValue = (params.Sharpness / 150.0f) * 100.0f;
+    if (clarityValue == 0.0f) {
+        return 0.0f;
+    }
+    if (clarityValue < 0.0f) {
+        // 柔化
+        return std::min(std::max(-clarityValue * 0.05f, 0.5f), kMaxClaritySigma);
+    }
+    // 锐化：半径随图像尺寸（相对 1920x1080）放大
+    const float scaleFactor = std::min(params.ImageWidth / 1920.0f, params.ImageHeight / 1080.0f);
+    const float radius = (clarityValue <= 10.0f) ? 1.5f : (1.0f + clarityValue / 25.0f) * scaleFactor;
+    return std::min(std::max(radius, 0.5f), kMaxClaritySigma);
+}
+
+ImageAdjustSimdLevel ImageAdjustKernel::GetSupportedSimdLevel() {
+    static const ImageAdjustSimdLevel s_Level = DetectSimdLevel();
+    return s_Level;
+}
+
+void ImageAdjustKernel::SetSimdLevel(ImageAdjustSimdLevel level) {
+    m_SimdLevel = std::min(level, GetSupportedSimdLevel());
+    SelectPointKernel();
+}
+
+void ImageAdjustKernel::SetPointLUT(const float* lutData, uint32_t lutSize) {
+    const bool useLUT = lutData && lutSize >= 2;
+    m_PointLUT = useLUT ? lutData : nullptr;
+    m_PointLUTSize = useLUT ? lutSize : 0;
+
+    // 查表时色温已包含在 LUT 中，8 位输入只做 /255
+    for (int c = 0; c < 3; ++c) {
+        for (int v = 0; v < 256; ++v) {
+            const float value = v / 255.0f;
+            m_ByteToFloat[c][v] = (m_ApplyTemperature && !useLUT) ? ApplyTemperatureChannel(value, m_TemperatureCoeffs[c]) : value;
+        }
+    }
+}
+
+void ImageAdjustKernel::EvaluatePoints(float* r, float* g, float* b, int32_t count) const {
+    if (m_ApplyTemperature) {
+        for (int32_t i = 0; i < count; ++i) {
+            r[i] = ApplyTemperatureChannel(r[i], m_TemperatureCoeffs[0]);
+            g[i] = ApplyTemperatureChannel(g[i], m_TemperatureCoeffs[1]);
+            b[i] = ApplyTemperatureChannel(b[i], m_TemperatureCoeffs[2]);
+        }
+    }
+
+    m_AdjustPoints(m_PointParams, r, g, b, count);
+}
+
+const char* ImageAdjustKernel::GetSimdLevelName(ImageAdjustSimdLevel level) {
+    switch (level) {
+    case ImageAdjustSimdLevel::AVX2:
+        return "AVX2";
+    case ImageAdjustSimdLevel::SSE41:
+        return "SSE4.1";
+    default:
+        return "Scalar";
+    }
+}
+
+bool ImageAdjustKernel::Process(const ImageAdjustImageView& source, const ImageAdjustImageView& destination) const {
+    if (!IsValidView(source) || !IsValidView(destination)) {
+        std::cerr << "[ImageAdjustKernel] Invalid image view" << std::endl;
+        return false;
+    }
+    if (source.Width != destination.Width || source.Height != destination.Height) {
+        std::cerr << "[ImageAdjustKernel] Source and destination size mismatch" << std::endl;
+        return false;
+    }
+    if (m_ApplyClarity && source.Planes[0] == destination.Planes[0]) {
+        std::cerr << "[ImageAdjustKernel] In-place processing is not supported when clarity is enabled" << std::endl;
+        return false;
+    }
+
+    // 清晰度：先把输入图像的 RGB 整幅做一次可分离高斯模糊，逐行处理时直接读取
+    std::vector<float> blurred;
+    if (m_ApplyClarity) {
+        const size_t planeSize = static_cast<size_t>(source.Width) * source.Height;
+        blurred.resize(planeSize * 3);
+        RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(source.Height), 16,
+            [&](int32_t beginRow, int32_t endRow) {
+                for (int32_t y = beginRow; y < endRow; ++y) {
+                    const size_t rowOffset = static_cast<size_t>(y) * source.Width;
+                    for (uint32_t x = 0; x < source.Width; ++x) {
+                        float rgb[3];
+                        FetchTexel(source, static_cast<int32_t>(x), y, rgb);
+                        blurred[rowOffset + x] = rgb[0];
+                        blurred[planeSize + rowOffset + x] = rgb[1];
+                        blurred[planeSize * 2 + rowOffset + x] = rgb[2];
+                    }
+                }
+            });
+
+        const GaussianBlurKernel blurKernel(m_ClaritySigma);
+        const size_t rowPitch = static_cast<size_t>(source.Width) * sizeof(float);
+        for (int c = 0; c < 3; ++c) {
+            float* plane = blurred.data() + planeSize * c;
+            blurKernel.Process(plane, rowPitch, plane, rowPitch, source.Width, source.Height);
+        }
+    }
+
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(source.Height), 16,
+        [&](int32_t beginRow, int32_t endRow) {
+            ProcessRows(source, destination, blurred.empty() ? nullptr : blurred.data(), beginRow, endRow);
+        });
+    return true;
+}
+
+void ImageAdjustKernel::ProcessRows(const ImageAdjustImageView& source, const ImageAdjustImageView& destination,
+                                    const float* blurred, int32_t beginRow, int32_t endRow) const {
+    const uint32_t width = source.Width;
+    // 每个行带一份 SoA 暂存行，供 SIMD 路径按通道连续读写（查表时另有一组输出）
+    std::vector<float> scratch(static_cast<size_t>(width) * (m_PointLUT ? 7 : 4));
+    float* r = scratch.data();
+    float* g = r + width;
+    float* b = g + width;
+    float* a = b + width;
+    float* lutR = m_PointLUT ? a + width : r;
+    float* lutG = m_PointLUT ? lutR + width : g;
+    float* lutB = m_PointLUT ? lutG + width : b;
+
+    // 逐点部分查表：四面体插值，与 AdjustmentLUT 的格点一一对应
+    LUTKernel lutKernel(m_PointLUT, m_PointLUTSize, LUTInterpolation::Tetrahedral, 1.0f);
+    lutKernel.SetSimdLevel(m_SimdLevel);
+
+    for (int32_t y = beginRow; y < endRow; ++y) {
+        LoadRow(source, static_cast<uint32_t>(y), r, g, b, a);
+        if (m_PointLUT) {
+            lutKernel.InterpolateRow(r, g, b, lutR, lutG, lutB, static_cast<int32_t>(width));
+        } else {
+            // 未设置 LUT：节点只在没有逐点操作时如此调用（此时为空的 <0> 特化），直接使用本类时逐像素计算
+            m_AdjustPoints(m_PointParams, r, g, b, static_cast<int32_t>(width));
+        }
+        if (m_ApplyClarity) {
+            ApplyClarityRow(source, blurred, static_cast<uint32_t>(y), lutR, lutG, lutB);
+        }
+        StoreRow(destination, static_cast<uint32_t>(y), lutR, lutG, lutB, a);
+    }
+}
+
+void ImageAdjustKernel::LoadRow(const ImageAdjustImageView& source, uint32_t y,
+                                float* r, float* g, float* b, float* a) const {
+    const size_t rowOffset = static_cast<size_t>(y) * source.RowPitch;
+    const uint32_t width = source.Width;
+
+    switch (source.Layout) {
+    case ImageAdjustPixelLayout::BGRA8: {
+        const uint8_t* p = source.Planes[0] + rowOffset;
+        for (uint32_t x = 0; x < width; ++x, p += 4) {
+            b[x] = m_ByteToFloat[2][p[0]];
+            g[x] = m_ByteToFloat[1][p[1]];
+            r[x] = m_ByteToFloat[0][p[2]];
+            a[x] = p[3] / 255.0f;
+        }
+        return;
+    }
+    case ImageAdjustPixelLayout::RGBA8: {
+        const uint8_t* p = source.Planes[0] + rowOffset;
+        for (uint32_t x = 0; x < width; ++x, p += 4) {
+            r[x] = m_ByteToFloat[0][p[0]];
+            g[x] = m_ByteToFloat[1][p[1]];
+            b[x] = m_ByteToFloat[2][p[2]];
+            a[x] = p[3] / 255.0f;
+        }
+        return;
+    }
+    case ImageAdjustPixelLayout::RGBA32F: {
+        const float* p = reinterpret_cast<const float*>(source.Planes[0] + rowOffset);
+        for (uint32_t x = 0; x < width; ++x, p += 4) {
+            r[x] = p[0];
+            g[x] = p[1];
+            b[x] = p[2];
+            a[x] = p[3];
+        }
+        break;
+    }
+    case ImageAdjustPixelLayout::PlanarRGBA32F: {
+        std::memcpy(r, source.Planes[0] + rowOffset, width * sizeof(float));
+        std::memcpy(g, source.Planes[1] + rowOffset, width * sizeof(float));
+        std::memcpy(b, source.Planes[2] + rowOffset, width * sizeof(float));
+        if (source.Planes[3]) {
+            std::memcpy(a, source.Planes[3] + rowOffset, width * sizeof(float));
+        } else {
+            std::fill(a, a + width, 1.0f);
+        }
+        break;
+    }
+    }
+
+    // 浮点输入无法查表，逐像素执行色温调整（逐点部分查 LUT 时已包含色温）
+    if (m_ApplyTemperature && !m_PointLUT) {
+        for (uint32_t x = 0; x < width; ++x) {
+            r[x] = ApplyTemperatureChannel(r[x], m_TemperatureCoeffs[0]);
+            g[x] = ApplyTemperatureChannel(g[x], m_TemperatureCoeffs[1]);
+            b[x] = ApplyTemperatureChannel(b[x], m_TemperatureCoeffs[2]);
+        }
+    }
+}
+
+void ImageAdjustKernel::StoreRow(const ImageAdjustImageView& destination, uint32_t y,
+                                 const float* r, const float* g, const float* b, const float* a) const {
+    const size_t rowOffset = static_cast<size_t>(y) * destination.RowPitch;
+    const uint32_t width = destination.Width;
+
+    // 与 UNORM 渲染目标的写入一致：先裁剪到 [0, 1]，再四舍五入
+    auto toByte = [](float v) {
+        return static_cast<uint8_t>(Saturate(v) * 255.0f + 0.5f);
+    };
+
+    switch (destination.Layout) {
+    case ImageAdjustPixelLayout::BGRA8: {
+        uint8_t* p = destination.Planes[0] + rowOffset;
+        for (uint32_t x = 0; x < width; ++x, p += 4) {
+            p[0] = toByte(b[x]);
+            p[1] = toByte(g[x]);
+            p[2] = toByte(r[x]);
+            p[3] = toByte(a[x]);
+        }
+        break;
+    }
+    case ImageAdjustPixelLayout::RGBA8: {
+        uint8_t* p = destination.Planes[0] + rowOffset;
+        for (uint32_t x = 0; x < width; ++x, p += 4) {
+            p[0] = toByte(r[x]);
+            p[1] = toByte(g[x]);
+            p[2] = toByte(b[x]);
+            p[3] = toByte(a[x]);
+        }
+        break;
+    }
+    case ImageAdjustPixelLayout::RGBA32F: {
+        float* p = reinterpret_cast<float*>(destination.Planes[0] + rowOffset);
+        for (uint32_t x = 0; x < width; ++x, p += 4) {
+            p[0] = Saturate(r[x]);
+            p[1] = Saturate(g[x]);
+            p[2] = Saturate(b[x]);
+            p[3] = a[x];
+        }
+        break;
+    }
+    case ImageAdjustPixelLayout::PlanarRGBA32F: {
+        float* pr = reinterpret_cast<float*>(destination.Planes[0] + rowOffset);
+        float* pg = reinterpret_cast<float*>(destination.Planes[1] + rowOffset);
+        float* pb = reinterpret_cast<float*>(destination.Planes[2] + rowOffset);
+        for (uint32_t x = 0; x < width; ++x) {
+            pr[x] = Saturate(r[x]);
+            pg[x] = Saturate(g[x]);
+            pb[x] = Saturate(b[x]);
+        }
+        if (destination.Planes[3]) {
+            std::memcpy(destination.Planes[3] + rowOffset, a, width * sizeof(float));
+        }
+        break;
+    }
+    }
+}
+
+void ImageAdjustKernel::ApplyClarityRow(const ImageAdjustImageView& source, const float* blurred, uint32_t y,
+                                        float* r, float* g, float* b) const {
+    const size_t planeSize = static_cast<size_t>(source.Width) * source.Height;
+    const float* blurredR = blurred + static_cast<size_t>(y) * source.Width;
+    const float* blurredG = blurredR + planeSize;
+    const float* blurredB = blurredG + planeSize;
+
+    if (m_ClarityValue < 0.0f) {
+        // 柔化：直接输出输入纹理的模糊结果
+        std::memcpy(r, blurredR, source.Width * sizeof(float));
+        std::memcpy(g, blurredG, source.Width * sizeof(float));
+        std::memcpy(b, blurredB, source.Width * sizeof(float));
+        return;
+    }
+
+    // 锐化：非锐化掩码，细节取自输入纹理，叠加到当前处理后的颜色上
+    const float amount = m_ClarityValue * 0.3f;
+    for (uint32_t x = 0; x < source.Width; ++x) {
+        float original[3];
+        FetchTexel(source, static_cast<int32_t>(x), static_cast<int32_t>(y), original);
+
+        float detail = (original[0] - blurredR[x]) * 0.299f +
+                       (original[1] - blurredG[x]) * 0.587f +
+                       (original[2] - blurredB[x]) * 0.114f;
+
+        // 阈值处理：smoothstep(threshold * 0.5, threshold * 1.5, |detail| * 2)，threshold = 0.01
+        const float t = Saturate((std::abs(detail) * 2.0f - 0.005f) / (0.015f - 0.005f));
+        detail *= t * t * (3.0f - 2.0f * t);
+
+        r[x] = Saturate(r[x] + detail * amount);
+        g[x] = Saturate(g[x] + detail * amount);
+        b[x] = Saturate(b[x] + detail * amount);
+    }
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,205 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace LightroomCore {
+
+// Constant buffer 结构体（必须 16 字节对齐）
+// GPU shader 与 CPU 内核共用同一份参数布局
+struct __declspec(align(16)) ImageAdjustConstantBuffer {
+    // 基本调整
+    float Exposure;
+    float Contrast;
+    float Highlights;
+    float Shadows;
+    float Whites;
+    float Blacks;
+
+    // 白平衡（仅对 RAW 有效）
+    float Temperature;
+    float Tint;
+
+    // 颜色调整
+    float Vibrance;
+    float Saturation;
+
+    // HSL 调整 - 色相
+    float HueAdjustments[4];  // Red, Orange, Yellow, Green
+    float HueAdjustments2[4]; // Aqua, Blue, Purple, Magenta
+
+    // HSL 调整 - 饱和度
+    float SatAdjustments[4];  // Red, Orange, Yellow, Green
+    float SatAdjustments2[4]; // Aqua, Blue, Purple, Magenta
+
+    // HSL 调整 - 明亮度
+    float LumAdjustments[4];  // Red, Orange, Yellow, Green
+    float LumAdjustments2[4]; // Aqua, Blue, Purple, Magenta
+
+    // 细节调整
+    float Sharpness;
+    float NoiseReduction;
+
+    // 镜头校正
+    float LensDistortion;
+    float ChromaticAberration;
+
+    // 效果
+    float Vignette;
+    float Grain;
+
+    // 校准
+    float ShadowTint;
+    float RedHue;
+    float RedSaturation;
+    float GreenHue;
+    float GreenSaturation;
+    float BlueHue;
+    float BlueSaturation;
+
+    float ImageWidth;
+    float ImageHeight;
+    float AdjustLUTSize;    // 逐点调整 LUT 的尺寸（GPU 路径，0 表示没有逐点调整）
+    float Padding;
+};
+
+// 调整操作位掩码：由参数推导出哪些步骤不是恒等变换（ImageAdjustKernel::GetActiveOps）
+// GPU shader 按位掩码编译只包含这些步骤的变体；CPU 逐点内核同样按位掩码特化，
+// 但渲染时逐点部分已编译为 LUT（SetPointLUT），特化内核只在编译 LUT（EvaluatePoints）时逐格点运行
+enum ImageAdjustOp : uint32_t {
+    ImageAdjustOp_None           = 0,
+    ImageAdjustOp_Temperature    = 1 << 0,
+    ImageAdjustOp_Exposure       = 1 << 1,
+    ImageAdjustOp_Tone           = 1 << 2,  // 高光/阴影/白色/黑色（任意一项不为 0）
+    ImageAdjustOp_Contrast       = 1 << 3,
+    ImageAdjustOp_HSL            = 1 << 4,  // 8 个色相段的色相/饱和度/明亮度（任意一项不为 0）
+    ImageAdjustOp_Saturation     = 1 << 5,
+    ImageAdjustOp_ClaritySharpen = 1 << 6,
+    ImageAdjustOp_ClaritySoften  = 1 << 7,
+
+    // 逐点部分（AdjustmentLUT 编译的范围）
+    ImageAdjustOp_PointMask = ImageAdjustOp_Temperature | ImageAdjustOp_Exposure | ImageAdjustOp_Tone |
+                              ImageAdjustOp_Contrast | ImageAdjustOp_HSL | ImageAdjustOp_Saturation,
+    ImageAdjustOp_ClarityMask = ImageAdjustOp_ClaritySharpen | ImageAdjustOp_ClaritySoften
+};
+
+// CPU 内核支持的像素布局
+enum class ImageAdjustPixelLayout : uint8_t {
+    BGRA8,          // 交错 uint8，B G R A（与 PF_B8G8R8A8 纹理一致）
+    RGBA8,          // 交错 uint8，R G B A
+    RGBA32F,        // 交错 float，R G B A
+    PlanarRGBA32F   // 平面 float，每个通道一个平面（A 平面可为空）
+};
+
+// CPU 内核使用的 SIMD 指令级别
+enum class ImageAdjustSimdLevel : uint8_t {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+// 图像视图：交错格式只使用 Planes[0]；平面格式依次为 R、G、B、A
+struct ImageAdjustImageView {
+    ImageAdjustPixelLayout Layout = ImageAdjustPixelLayout::BGRA8;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    size_t RowPitch = 0;            // 每行字节数（平面格式下为每个平面的行字节数）
+    uint8_t* Planes[4] = { nullptr, nullptr, nullptr, nullptr };
+};
+
+// ImageAdjust 像素管线的 CPU 实现（色温、曝光、高光/阴影/白色/黑色、对比度、HSL、饱和度、清晰度）
+// 逐点运算按运行时检测到的 AVX2 / SSE4.1 / 标量路径执行，并按行带分发到 SoftwareTaskPool。
+// 清晰度所需的模糊图像由 GaussianBlurKernel 整幅预先计算（GPU 路径对应 GaussianBlurNode）。
+// 逐点部分（清晰度之前的全部步骤）是调整公式的参考实现：AdjustmentLUT 用它编译 3D LUT，
+// GPU shader 与设置了 SetPointLUT 的 CPU 路径只做一次查表。
+class ImageAdjustKernel {
+public:
+    explicit ImageAdjustKernel(const ImageAdjustConstantBuffer& params);
+
+    // 处理整幅图像；source 与 destination 尺寸必须一致，且不能是同一块内存（清晰度需要读取邻域）
+    bool Process(const ImageAdjustImageView& source, const ImageAdjustImageView& destination) const;
+
+    // 逐点部分改为查表：lutData 为 AdjustmentLUT 编译的 RGB float LUT（Red 变化最快），
+    // 调用 Process 期间必须有效；nullptr 恢复逐步骤计算
+    void SetPointLUT(const float* lutData, uint32_t lutSize);
+
+    // 对 SoA 浮点颜色（[0, 1]）执行逐点部分，结果未裁剪；供 AdjustmentLUT 计算格点
+    void EvaluatePoints(float* r, float* g, float* b, int32_t count) const;
+
+    // 是否有任何逐点调整（全部为默认值时 EvaluatePoints 不改变颜色）
+    bool HasPointAdjustments() const { return (m_ActiveOps & ImageAdjustOp_PointMask) != 0; }
+
+    // 当前参数下不是恒等变换的操作（ImageAdjustOp 位掩码）
+    static uint32_t GetActiveOps(const ImageAdjustConstantBuffer& params);
+    uint32_t GetActiveOps() const { return m_ActiveOps; }
+
+    // 当前进程可用的最高 SIMD 级别（首次调用时检测 CPUID）
+    static ImageAdjustSimdLevel GetSupportedSimdLevel();
+
+    // 强制使用指定级别（不会超过 CPU 支持的级别），用于对比校验；默认使用最高级别
+    void SetSimdLevel(ImageAdjustSimdLevel level);
+    ImageAdjustSimdLevel GetSimdLevel() const { return m_SimdLevel; }
+
+    static const char* GetSimdLevelName(ImageAdjustSimdLevel level);
+
+    // 清晰度模糊的 sigma（以输出像素为单位），GPU 与 CPU 路径共用；不需要模糊时返回 0
+    static float GetClarityBlurSigma(const ImageAdjustConstantBuffer& params);
+    static constexpr float kMaxClaritySigma = 16.0f;
+
+    // HSL：8 个色相段的设置在构造时展开为按色相索引的查找表（每度一项，末项与首项相同便于插值）
+    static constexpr int32_t kHueTableSize = 360;
+    // 滑块为 ±100 时的色相偏移（以整圈为 1）与明亮度偏移（乘以像素饱和度）
+    static constexpr float kMaxHueShift = 30.0f / 360.0f;
+    static constexpr float kMaxHueLuminance = 0.5f;
+
+    // 逐点运算使用的预计算参数（内部使用）；是否执行某一步由 ImageAdjustOp 位掩码决定
+    struct PointParams {
+        float ExposureScale;
+        float Highlights;       // 已除以 100，0 表示跳过
+        float Shadows;
+        float Whites;
+        float Blacks;
+        float ContrastFactor;
+        float SaturationFactor;
+        // 色相 -> (色相偏移, 饱和度系数 - 1, 明亮度偏移)
+        float HueShift[kHueTableSize + 1];
+        float HueSaturation[kHueTableSize + 1];
+        float HueLuminance[kHueTableSize + 1];
+    };
+    using AdjustPointsFunc = void (*)(const PointParams& params, float* r, float* g, float* b, int32_t count);
+
+private:
+    void ProcessRows(const ImageAdjustImageView& source, const ImageAdjustImageView& destination,
+                     const float* blurred, int32_t beginRow, int32_t endRow) const;
+    void LoadRow(const ImageAdjustImageView& source, uint32_t y, float* r, float* g, float* b, float* a) const;
+    void StoreRow(const ImageAdjustImageView& destination, uint32_t y,
+                  const float* r, const float* g, const float* b, const float* a) const;
+    // blurred: 输入图像 RGB 的模糊结果，三个紧密排列的平面
+    void ApplyClarityRow(const ImageAdjustImageView& source, const float* blurred, uint32_t y,
+                         float* r, float* g, float* b) const;
+
+    // 按 SIMD 级别与激活的逐点操作选择特化的逐点内核（EvaluatePoints 与未设置 LUT 时的 ProcessRows 使用）
+    void SelectPointKernel();
+
+    ImageAdjustConstantBuffer m_Params;
+    PointParams m_PointParams;
+    ImageAdjustSimdLevel m_SimdLevel;
+    uint32_t m_ActiveOps;
+    AdjustPointsFunc m_AdjustPoints;
+
+    // 逐点部分的查表（SetPointLUT），为空时逐步骤计算
+    const float* m_PointLUT = nullptr;
+    uint32_t m_PointLUTSize = 0;
+
+    // 色温（第一步）只依赖单个通道，8 位输入时直接预计算 256 级查找表（已包含 /255）
+    bool m_ApplyTemperature;
+    float m_TemperatureCoeffs[3];
+    float m_ByteToFloat[3][256];
+
+    // 清晰度（锐化/柔化）参数
+    bool m_ApplyClarity;
+    float m_ClarityValue;
+    float m_ClaritySigma;
+};
+
+} // namespace LightroomCore
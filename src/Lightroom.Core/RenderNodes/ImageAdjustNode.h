@@ -1,6 +1,9 @@
 ﻿#pragma once
 
 #include "RenderNode.h"
+#include "ImageAdjustKernel.h"
+#include "AdjustmentLUT.h"
+#include "GaussianBlurNode.h"
 #include "../LightroomSDKTypes.h"
 #include "../d3d11rhi/RHITexture2D.h"
 #include "../d3d11rhi/RHIShdader.h"
@@ -8,12 +11,18 @@
 #include "../d3d11rhi/RHIState.h"
 #include "../d3d11rhi/RHIUniformBuffer.h"
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <wrl/client.h>
 #include <d3d11.h>
 
 namespace LightroomCore {
 
+class FilterNode;
+
 // 图像调整节点：通用的图像调整处理（适用于 RAW 和标准图片）
+// 逐点调整在参数变化时编译为一张 3D LUT（AdjustmentLUT），每个像素只查一次表，之后叠加清晰度
+// GPU shader 按激活的操作（ImageAdjustOp 位掩码）编译为不同变体，未使用的步骤不出现在 shader 中
 class ImageAdjustNode : public RenderNode {
 public:
     ImageAdjustNode(std::shared_ptr<RenderCore::DynamicRHI> rhi);
@@ -24,6 +33,21 @@ public:
                         uint32_t width, uint32_t height) override;
 
     virtual const char* GetName() const override { return "ImageAdjust"; }
+    virtual uint64_t GetParamsHash() const override;
+
+    // 清晰度的高斯模糊截断在 3σ（σ 最大 kMaxClaritySigma），加双线性插值 1 像素
+    virtual int32_t GetTileApron() const override {
+        return static_cast<int32_t>(3.0f * ImageAdjustKernel::kMaxClaritySigma) + 2;
+    }
+
+    // 所有已实现的调整都为默认值时跳过（输出只是输入的 saturate）
+    virtual bool IsIdentity() const override;
+
+    virtual void ReleaseResources() override;
+
+    // 清晰度关闭时把紧随其后的 FilterNode 编译进逐点 LUT，渲染图不再单独执行滤镜
+    // （清晰度的细节叠加在滤镜之前，开启时两者不能合并）
+    virtual bool FoldNext(std::shared_ptr<RenderNode> next) override;
 
     // 设置调整参数
     void SetAdjustParams(const ImageAdjustParams& params);
@@ -36,19 +60,49 @@ protected:
     virtual void UpdateConstantBuffers(uint32_t width, uint32_t height) override;
     virtual void SetConstantBuffers() override;
     virtual void SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) override;
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) override;
 
 private:
     bool InitializeShaderResources();
     void CleanupShaderResources();
 
+    // 由 UI 参数生成 constant buffer 数据（GPU/CPU 路径共用）
+    ImageAdjustConstantBuffer BuildConstantBuffer(uint32_t width, uint32_t height) const;
+
+    // 参数或合并的滤镜变化时重新编译逐点 LUT；uploadTexture 为 true 时同时更新 GPU 纹理
+    bool UpdatePointLUT(uint32_t lutSize, bool uploadTexture);
+
+    // GPU 路径当前需要的 shader 变体（逐点 LUT、锐化/柔化），以 ImageAdjustOp 位掩码表示
+    uint32_t GetShaderOps() const;
+    // 取得（首次使用时编译）指定变体的 shader，失败返回 nullptr
+    CompiledShader* GetShaderPermutation(uint32_t shaderOps);
+
     ImageAdjustParams m_Params;
 
-    // Shader resources（使用基类的 CompiledShader）
-    CompiledShader m_Shader;
+    // Shader resources（使用基类的 CompiledShader）：同一份源码按位掩码编译的变体缓存
+    std::string m_VertexShaderCode;
+    std::string m_PixelShaderCode;
+    std::unordered_map<uint32_t, CompiledShader> m_ShaderPermutations;
 
     // Constant buffer
     std::shared_ptr<RenderCore::RHIUniformBuffer> m_ParamsBuffer;
 
+    // 清晰度：输入图像的可分离高斯模糊先渲染到 m_BlurTexture，主 shader 从 t1 读取
+    std::shared_ptr<GaussianBlurNode> m_BlurNode;
+    std::shared_ptr<RenderCore::RHITexture2D> m_BlurTexture;
+    std::shared_ptr<RenderCore::RHITexture2D> m_ClarityBlurInput;  // 当前绑定到 t1 的纹理
+
+    // 逐点调整 LUT：m_PointLUTKey 为编译时的参数、滤镜与尺寸的哈希
+    AdjustmentLUT m_PointLUT;
+    uint64_t m_PointLUTKey = 0;
+    // GPU 路径绑定到 t2 的 LUT 纹理（2D 切片布局，RGBA FP16）
+    std::shared_ptr<RenderCore::RHITexture2D> m_PointLUTTexture;
+    uint64_t m_PointLUTTextureKey = 0;
+    // FoldNext 合并进来的滤镜
+    std::shared_ptr<FilterNode> m_FoldedFilter;
+
     bool m_ShaderResourcesInitialized = false;
 };
 
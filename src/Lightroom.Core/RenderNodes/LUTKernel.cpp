@@ -0,0 +1,324 @@
+﻿#include "LUTKernel.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace LightroomCore {
+
+namespace {
+
+// 插值使用的 LUT 几何参数（偏移以 float 为单位）
+struct LUTLayout {
+    const float* Data;
+    float MaxCoord;         // Size - 1
+    float MaxBase;          // Size - 2（基准格点上限，保证 +1 不越界）
+    int32_t StrideR;        // 3
+    int32_t StrideG;        // 3 * Size
+    int32_t StrideB;        // 3 * Size^2
+};
+
+// ============================================
+// 标量路径（参考实现）
+// ============================================
+
+inline void Locate(const LUTLayout& lut, float value, int32_t& outBase, float& outFraction) {
+    const float coord = std::min(std::max(value * lut.MaxCoord, 0.0f), lut.MaxCoord);
+    const float base = std::min(std::floor(coord), lut.MaxBase);
+    outBase = static_cast<int32_t>(base);
+    outFraction = coord - base;
+}
+
+void InterpolateTrilinearScalar(const LUTLayout& lut, const float* r, const float* g, const float* b,
+                                float* outR, float* outG, float* outB, int32_t begin, int32_t count) {
+    for (int32_t x = begin; x < count; ++x) {
+        int32_t ir, ig, ib;
+        float fr, fg, fb;
+        Locate(lut, r[x], ir, fr);
+        Locate(lut, g[x], ig, fg);
+        Locate(lut, b[x], ib, fb);
+        const float* c000 = lut.Data + ir * lut.StrideR + ig * lut.StrideG + ib * lut.StrideB;
+        const float* c100 = c000 + lut.StrideR;
+        const float* c010 = c000 + lut.StrideG;
+        const float* c110 = c010 + lut.StrideR;
+        const float* c001 = c000 + lut.StrideB;
+        const float* c101 = c001 + lut.StrideR;
+        const float* c011 = c001 + lut.StrideG;
+        const float* c111 = c011 + lut.StrideR;
+
+        float result[3];
+        for (int c = 0; c < 3; ++c) {
+            const float c00 = c000[c] + (c100[c] - c000[c]) * fr;
+            const float c10 = c010[c] + (c110[c] - c010[c]) * fr;
+            const float c01 = c001[c] + (c101[c] - c001[c]) * fr;
+            const float c11 = c011[c] + (c111[c] - c011[c]) * fr;
+            const float c0 = c00 + (c10 - c00) * fg;
+            const float c1 = c01 + (c11 - c01) * fg;
+            result[c] = c0 + (c1 - c0) * fb;
+        }
+        outR[x] = result[0];
+        outG[x] = result[1];
+        outB[x] = result[2];
+    }
+}
+
+// 四面体插值：按小数部分从大到小选出穿过单元格的路径 c000 -> A -> B -> c111
+// 最大轴按 R > G > B、最小轴按 B > G > R 的优先级打破平局，保证两者不是同一个轴
+void InterpolateTetrahedralScalar(const LUTLayout& lut, const float* r, const float* g, const float* b,
+                                  float* outR, float* outG, float* outB, int32_t begin, int32_t count) {
+    const int32_t strideSum = lut.StrideR + lut.StrideG + lut.StrideB;
+    for (int32_t x = begin; x < count; ++x) {
+        int32_t ir, ig, ib;
+        float fr, fg, fb;
+        Locate(lut, r[x], ir, fr);
+        Locate(lut, g[x], ig, fg);
+        Locate(lut, b[x], ib, fb);
+
+        const bool rIsMax = (fr >= fg) && (fr >= fb);
+        const bool gIsMax = !rIsMax && (fg >= fb);
+        const bool bIsMin = (fb <= fg) && (fb <= fr);
+        const bool gIsMin = !bIsMin && (fg <= fr);
+        const int32_t offsetA = rIsMax ? lut.StrideR : (gIsMax ? lut.StrideG : lut.StrideB);
+        const int32_t offsetB = strideSum - (bIsMin ? lut.StrideB : (gIsMin ? lut.StrideG : lut.StrideR));
+
+        const float maxF = std::max(fr, std::max(fg, fb));
+        const float minF = std::min(fr, std::min(fg, fb));
+        const float midF = fr + fg + fb - maxF - minF;
+        const float w0 = 1.0f - maxF;
+        const float wA = maxF - midF;
+        const float wB = midF - minF;
+        const float w1 = minF;
+
+        const float* c0 = lut.Data + ir * lut.StrideR + ig * lut.StrideG + ib * lut.StrideB;
+        const float* cA = c0 + offsetA;
+        const float* cB = c0 + offsetB;
+        const float* c1 = c0 + strideSum;
+        outR[x] = w0 * c0[0] + wA * cA[0] + wB * cB[0] + w1 * c1[0];
+        outG[x] = w0 * c0[1] + wA * cA[1] + wB * cB[1] + w1 * c1[1];
+        outB[x] = w0 * c0[2] + wA * cA[2] + wB * cB[2] + w1 * c1[2];
+    }
+}
+
+// ============================================
+// AVX2 路径（每次 8 个像素，顶点通过 gather 读取）
+// ============================================
+
+struct LocateAVX2Result {
+    __m256i Index;      // 基准格点的 float 偏移
+    __m256 FractionR;
+    __m256 FractionG;
+    __m256 FractionB;
+};
+
+inline __m256 LocateAxisAVX2(__m256 value, __m256 maxCoord, __m256 maxBase, __m256i& outBase) {
+    const __m256 coord = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(value, maxCoord), _mm256_setzero_ps()), maxCoord);
+    const __m256 base = _mm256_min_ps(_mm256_floor_ps(coord), maxBase);
+    outBase = _mm256_cvttps_epi32(base);
+    return _mm256_sub_ps(coord, base);
+}
+
+inline LocateAVX2Result LocateAVX2(const LUTLayout& lut, const float* r, const float* g, const float* b) {
+    const __m256 maxCoord = _mm256_set1_ps(lut.MaxCoord);
+    const __m256 maxBase = _mm256_set1_ps(lut.MaxBase);
+    LocateAVX2Result result;
+    __m256i ir, ig, ib;
+    result.FractionR = LocateAxisAVX2(_mm256_loadu_ps(r), maxCoord, maxBase, ir);
+    result.FractionG = LocateAxisAVX2(_mm256_loadu_ps(g), maxCoord, maxBase, ig);
+    result.FractionB = LocateAxisAVX2(_mm256_loadu_ps(b), maxCoord, maxBase, ib);
+    result.Index = _mm256_add_epi32(_mm256_mullo_epi32(ir, _mm256_set1_epi32(lut.StrideR)),
+                   _mm256_add_epi32(_mm256_mullo_epi32(ig, _mm256_set1_epi32(lut.StrideG)),
+                                    _mm256_mullo_epi32(ib, _mm256_set1_epi32(lut.StrideB))));
+    return result;
+}
+
+inline __m256 Gather(const float* data, __m256i index) {
+    return _mm256_i32gather_ps(data, index, 4);
+}
+
+inline __m256 Lerp(__m256 a, __m256 b, __m256 t) {
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+int32_t InterpolateTrilinearAVX2(const LUTLayout& lut, const float* r, const float* g, const float* b,
+                                 float* outR, float* outG, float* outB, int32_t count) {
+    const __m256i strideR = _mm256_set1_epi32(lut.StrideR);
+    const __m256i strideG = _mm256_set1_epi32(lut.StrideG);
+    const __m256i strideB = _mm256_set1_epi32(lut.StrideB);
+    float* outputs[3] = { outR, outG, outB };
+
+    int32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        const LocateAVX2Result cell = LocateAVX2(lut, r + x, g + x, b + x);
+        const __m256i i000 = cell.Index;
+        const __m256i i100 = _mm256_add_epi32(i000, strideR);
+        const __m256i i010 = _mm256_add_epi32(i000, strideG);
+        const __m256i i110 = _mm256_add_epi32(i010, strideR);
+        const __m256i i001 = _mm256_add_epi32(i000, strideB);
+        const __m256i i101 = _mm256_add_epi32(i001, strideR);
+        const __m256i i011 = _mm256_add_epi32(i001, strideG);
+        const __m256i i111 = _mm256_add_epi32(i011, strideR);
+
+        for (int c = 0; c < 3; ++c) {
+            const float* channel = lut.Data + c;
+            const __m256 c00 = Lerp(Gather(channel, i000), Gather(channel, i100), cell.FractionR);
+            const __m256 c10 = Lerp(Gather(channel, i010), Gather(channel, i110), cell.FractionR);
+            const __m256 c01 = Lerp(Gather(channel, i001), Gather(channel, i101), cell.FractionR);
+            const __m256 c11 = Lerp(Gather(channel, i011), Gather(channel, i111), cell.FractionR);
+            const __m256 c0 = Lerp(c00, c10, cell.FractionG);
+            const __m256 c1 = Lerp(c01, c11, cell.FractionG);
+            _mm256_storeu_ps(outputs[c] + x, Lerp(c0, c1, cell.FractionB));
+        }
+    }
+    return x;
+}
+
+int32_t InterpolateTetrahedralAVX2(const LUTLayout& lut, const float* r, const float* g, const float* b,
+                                   float* outR, float* outG, float* outB, int32_t count) {
+    const __m256i strideR = _mm256_set1_epi32(lut.StrideR);
+    const __m256i strideG = _mm256_set1_epi32(lut.StrideG);
+    const __m256i strideB = _mm256_set1_epi32(lut.StrideB);
+    const __m256i strideSum = _mm256_set1_epi32(lut.StrideR + lut.StrideG + lut.StrideB);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    float* outputs[3] = { outR, outG, outB };
+
+    int32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        const LocateAVX2Result cell = LocateAVX2(lut, r + x, g + x, b + x);
+        const __m256 fr = cell.FractionR;
+        const __m256 fg = cell.FractionG;
+        const __m256 fb = cell.FractionB;
+
+        // 与标量路径相同的平局规则
+        const __m256 rIsMax = _mm256_and_ps(_mm256_cmp_ps(fr, fg, _CMP_GE_OQ), _mm256_cmp_ps(fr, fb, _CMP_GE_OQ));
+        const __m256 gIsMax = _mm256_andnot_ps(rIsMax, _mm256_cmp_ps(fg, fb, _CMP_GE_OQ));
+        const __m256 bIsMin = _mm256_and_ps(_mm256_cmp_ps(fb, fg, _CMP_LE_OQ), _mm256_cmp_ps(fb, fr, _CMP_LE_OQ));
+        const __m256 gIsMin = _mm256_andnot_ps(bIsMin, _mm256_cmp_ps(fg, fr, _CMP_LE_OQ));
+
+        const __m256i offsetA = _mm256_blendv_epi8(_mm256_blendv_epi8(strideB, strideG, _mm256_castps_si256(gIsMax)),
+                                                   strideR, _mm256_castps_si256(rIsMax));
+        const __m256i offsetMin = _mm256_blendv_epi8(_mm256_blendv_epi8(strideR, strideG, _mm256_castps_si256(gIsMin)),
+                                                     strideB, _mm256_castps_si256(bIsMin));
+        const __m256i i0 = cell.Index;
+        const __m256i iA = _mm256_add_epi32(i0, offsetA);
+        const __m256i iB = _mm256_add_epi32(i0, _mm256_sub_epi32(strideSum, offsetMin));
+        const __m256i i1 = _mm256_add_epi32(i0, strideSum);
+
+        const __m256 maxF = _mm256_max_ps(fr, _mm256_max_ps(fg, fb));
+        const __m256 minF = _mm256_min_ps(fr, _mm256_min_ps(fg, fb));
+        const __m256 midF = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(fr, fg), fb), maxF), minF);
+        const __m256 w0 = _mm256_sub_ps(one, maxF);
+        const __m256 wA = _mm256_sub_ps(maxF, midF);
+        const __m256 wB = _mm256_sub_ps(midF, minF);
+        const __m256 w1 = minF;
+
+        for (int c = 0; c < 3; ++c) {
+            const float* channel = lut.Data + c;
+            __m256 sum = _mm256_mul_ps(w0, Gather(channel, i0));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(wA, Gather(channel, iA)));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(wB, Gather(channel, iB)));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(w1, Gather(channel, i1)));
+            _mm256_storeu_ps(outputs[c] + x, sum);
+        }
+    }
+    return x;
+}
+
+inline uint8_t ToByte(float value) {
+    const float scaled = value * 255.0f + 0.5f;
+    return static_cast<uint8_t>(scaled <= 0.0f ? 0.0f : (scaled >= 255.0f ? 255.0f : scaled));
+}
+
+} // namespace
+
+LUTKernel::LUTKernel(const float* lutData, uint32_t lutSize, LUTInterpolation interpolation, float intensity)
+    : m_LUTData(lutData)
+    , m_LUTSize(lutSize)
+    , m_Interpolation(interpolation)
+    , m_Intensity(std::min(std::max(intensity, 0.0f), 1.0f))
+    , m_SimdLevel(ImageAdjustKernel::GetSupportedSimdLevel())
+{
+}
+
+void LUTKernel::SetSimdLevel(ImageAdjustSimdLevel level) {
+    m_SimdLevel = std::min(level, ImageAdjustKernel::GetSupportedSimdLevel());
+}
+
+bool LUTKernel::Process(const uint8_t* source, size_t sourceRowPitch, uint8_t* destination, size_t destinationRowPitch,
+                        uint32_t width, uint32_t height) const {
+    if (!m_LUTData || m_LUTSize < 2 || !source || !destination || width == 0 || height == 0) {
+        std::cerr << "[LUTKernel] Invalid LUT or image" << std::endl;
+        return false;
+    }
+
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(height), 16,
+        [&](int32_t beginRow, int32_t endRow) {
+            ProcessRows(source, sourceRowPitch, destination, destinationRowPitch, width, beginRow, endRow);
+        });
+    return true;
+}
+
+void LUTKernel::InterpolateRow(const float* r, const float* g, const float* b,
+                               float* outR, float* outG, float* outB, int32_t count) const {
+    LUTLayout lut;
+    lut.Data = m_LUTData;
+    lut.MaxCoord = static_cast<float>(m_LUTSize - 1);
+    lut.MaxBase = static_cast<float>(m_LUTSize - 2);
+    lut.StrideR = 3;
+    lut.StrideG = 3 * static_cast<int32_t>(m_LUTSize);
+    lut.StrideB = 3 * static_cast<int32_t>(m_LUTSize * m_LUTSize);
+
+    const bool useAVX2 = (m_SimdLevel == ImageAdjustSimdLevel::AVX2);
+    int32_t done = 0;
+    if (m_Interpolation == LUTInterpolation::Tetrahedral) {
+        if (useAVX2) {
+            done = InterpolateTetrahedralAVX2(lut, r, g, b, outR, outG, outB, count);
+        }
+        InterpolateTetrahedralScalar(lut, r, g, b, outR, outG, outB, done, count);
+    } else {
+        if (useAVX2) {
+            done = InterpolateTrilinearAVX2(lut, r, g, b, outR, outG, outB, count);
+        }
+        InterpolateTrilinearScalar(lut, r, g, b, outR, outG, outB, done, count);
+    }
+}
+
+void LUTKernel::ProcessRows(const uint8_t* source, size_t sourceRowPitch, uint8_t* destination, size_t destinationRowPitch,
+                            uint32_t width, int32_t beginRow, int32_t endRow) const {
+    // 每个行带一份 SoA 暂存行：输入 RGB 与插值结果
+    std::vector<float> scratch(static_cast<size_t>(width) * 6);
+    float* r = scratch.data();
+    float* g = r + width;
+    float* b = g + width;
+    float* outR = b + width;
+    float* outG = outR + width;
+    float* outB = outG + width;
+
+    const int32_t count = static_cast<int32_t>(width);
+    const float intensity = m_Intensity;
+
+    for (int32_t y = beginRow; y < endRow; ++y) {
+        const uint8_t* srcRow = source + static_cast<size_t>(y) * sourceRowPitch;
+        uint8_t* dstRow = destination + static_cast<size_t>(y) * destinationRowPitch;
+
+        for (uint32_t x = 0; x < width; ++x) {
+            b[x] = srcRow[x * 4 + 0] * (1.0f / 255.0f);
+            g[x] = srcRow[x * 4 + 1] * (1.0f / 255.0f);
+            r[x] = srcRow[x * 4 + 2] * (1.0f / 255.0f);
+        }
+
+        InterpolateRow(r, g, b, outR, outG, outB, count);
+
+        // 按强度与原色混合（alpha 保持不变）
+        for (uint32_t x = 0; x < width; ++x) {
+            const uint8_t alpha = srcRow[x * 4 + 3];
+            dstRow[x * 4 + 0] = ToByte(b[x] + (outB[x] - b[x]) * intensity);
+            dstRow[x * 4 + 1] = ToByte(g[x] + (outG[x] - g[x]) * intensity);
+            dstRow[x * 4 + 2] = ToByte(r[x] + (outR[x] - r[x]) * intensity);
+            dstRow[x * 4 + 3] = alpha;
+        }
+    }
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include "ImageAdjustKernel.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace LightroomCore {
+
+// 3D LUT 插值方式
+enum class LUTInterpolation : uint8_t {
+    Trilinear,      // 8 个顶点，与 GPU 路径（两次双线性采样 + 切片间插值）一致
+    Tetrahedral     // 4 个顶点，灰轴上没有三线性插值的偏色，导出时使用
+};
+
+// 3D LUT 的 CPU 实现（BGRA8 -> BGRA8）
+// 每行先展开为 SoA float，插值按运行时检测到的 AVX2（gather，每次 8 个像素）/ 标量路径执行，
+// 并按行带分发到 SoftwareTaskPool。
+class LUTKernel {
+public:
+    // lutData: RGB float，大小为 lutSize^3 * 3，Red 变化最快（与 CubeLUT::Data 一致）
+    // 内核不复制 LUT 数据，调用 Process 期间 lutData 必须有效
+    // intensity: 0.0 = 原图，1.0 = 完全应用
+    LUTKernel(const float* lutData, uint32_t lutSize, LUTInterpolation interpolation, float intensity);
+
+    // source 与 destination 可以是同一块内存（逐像素运算）
+    bool Process(const uint8_t* source, size_t sourceRowPitch, uint8_t* destination, size_t destinationRowPitch,
+                 uint32_t width, uint32_t height) const;
+
+    // 对 SoA 浮点颜色逐个插值（不按强度混合），输入超出 [0, 1] 时按边界取值
+    // 供其他内核组合 LUT 使用（例如 AdjustmentLUT 合并滤镜、ImageAdjustKernel 查表）
+    void InterpolateRow(const float* r, const float* g, const float* b,
+                        float* outR, float* outG, float* outB, int32_t count) const;
+
+    // 强制使用指定级别（不会超过 CPU 支持的级别），用于对比校验；没有 gather 的 SSE4.1 使用标量路径
+    void SetSimdLevel(ImageAdjustSimdLevel level);
+
+private:
+    void ProcessRows(const uint8_t* source, size_t sourceRowPitch, uint8_t* destination, size_t destinationRowPitch,
+                     uint32_t width, int32_t beginRow, int32_t endRow) const;
+
+    const float* m_LUTData;
+    uint32_t m_LUTSize;
+    LUTInterpolation m_Interpolation;
+    float m_Intensity;
+    ImageAdjustSimdLevel m_SimdLevel;
+};
+
+} // namespace LightroomCore
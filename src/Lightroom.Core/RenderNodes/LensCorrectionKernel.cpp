@@ -0,0 +1,272 @@
+﻿#include "LensCorrectionKernel.h"
+#include "ImageAdjustKernel.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+
+namespace LightroomCore {
+
+namespace {
+
+// 源纹素坐标限制在 [-1, size]：clamp 寻址下结果不变，且转换为整数不会溢出
+inline float ClampTexelCoord(float v, float size) {
+    v = (v > -1.0f) ? v : -1.0f;
+    return (v < size) ? v : size;
+}
+
+// 双线性采样 BGRA8 的全部四个通道（clamp 寻址，x、y 为纹素坐标且像素中心已减去 0.5）
+// 插值顺序与 SampleBilinearBGRA8 一致：先水平后垂直
+inline void SampleBilinear(const uint8_t* source, size_t rowPitch, int32_t width, int32_t height,
+                           float x, float y, float out[4]) {
+    const float fx0 = std::floor(x);
+    const float fy0 = std::floor(y);
+    const float fx = x - fx0;
+    const float fy = y - fy0;
+    const int32_t x0 = std::min(std::max(static_cast<int32_t>(fx0), 0), width - 1);
+    const int32_t x1 = std::min(std::max(static_cast<int32_t>(fx0) + 1, 0), width - 1);
+    const int32_t y0 = std::min(std::max(static_cast<int32_t>(fy0), 0), height - 1);
+    const int32_t y1 = std::min(std::max(static_cast<int32_t>(fy0) + 1, 0), height - 1);
+
+    const uint8_t* p00 = source + static_cast<size_t>(y0) * rowPitch + x0 * 4;
+    const uint8_t* p10 = source + static_cast<size_t>(y0) * rowPitch + x1 * 4;
+    const uint8_t* p01 = source + static_cast<size_t>(y1) * rowPitch + x0 * 4;
+    const uint8_t* p11 = source + static_cast<size_t>(y1) * rowPitch + x1 * 4;
+    for (int c = 0; c < 4; ++c) {
+        const float top = p00[c] + (static_cast<float>(p10[c]) - p00[c]) * fx;
+        const float bottom = p01[c] + (static_cast<float>(p11[c]) - p01[c]) * fx;
+        out[c] = top + (bottom - top) * fy;
+    }
+}
+
+// 8 个像素的双线性采样，out 为 B、G、R、A 四个通道（0 - 255）
+// BGRA8 纹素作为 32 位整数 gather，行字节数必须是 4 的倍数
+__forceinline void SampleBilinearAVX2(const int32_t* source, int32_t pitchTexels, __m256i maxX, __m256i maxY,
+                                      __m256 x, __m256 y, __m256 out[4]) {
+    const __m256 fx0 = _mm256_floor_ps(x);
+    const __m256 fy0 = _mm256_floor_ps(y);
+    const __m256 fx = _mm256_sub_ps(x, fx0);
+    const __m256 fy = _mm256_sub_ps(y, fy0);
+    const __m256i ix = _mm256_cvttps_epi32(fx0);
+    const __m256i iy = _mm256_cvttps_epi32(fy0);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i x0 = _mm256_min_epi32(_mm256_max_epi32(ix, zero), maxX);
+    const __m256i x1 = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(ix, one), zero), maxX);
+    const __m256i y0 = _mm256_mullo_epi32(_mm256_min_epi32(_mm256_max_epi32(iy, zero), maxY), _mm256_set1_epi32(pitchTexels));
+    const __m256i y1 = _mm256_mullo_epi32(_mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(iy, one), zero), maxY),
+                                          _mm256_set1_epi32(pitchTexels));
+
+    const __m256i p00 = _mm256_i32gather_epi32(source, _mm256_add_epi32(y0, x0), 4);
+    const __m256i p10 = _mm256_i32gather_epi32(source, _mm256_add_epi32(y0, x1), 4);
+    const __m256i p01 = _mm256_i32gather_epi32(source, _mm256_add_epi32(y1, x0), 4);
+    const __m256i p11 = _mm256_i32gather_epi32(source, _mm256_add_epi32(y1, x1), 4);
+
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    auto channel = [&](__m256i texel, int shift) {
+        return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texel, shift), mask));
+    };
+    for (int c = 0; c < 4; ++c) {
+        const int shift = c * 8;
+        const __m256 c00 = channel(p00, shift);
+        const __m256 c01 = channel(p01, shift);
+        const __m256 top = _mm256_add_ps(c00, _mm256_mul_ps(_mm256_sub_ps(channel(p10, shift), c00), fx));
+        const __m256 bottom = _mm256_add_ps(c01, _mm256_mul_ps(_mm256_sub_ps(channel(p11, shift), c01), fx));
+        out[c] = _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(bottom, top), fy));
+    }
+}
+
+// 一行像素的重采样：coords 为 6 个 SoA 坐标数组（红、绿、蓝的 x、y，纹素空间），返回已处理的像素数
+int32_t ResampleRowAVX2(const uint8_t* source, size_t sourceRowPitch, int32_t sourceWidth, int32_t sourceHeight,
+                        const float* const coords[6], bool chromatic, uint8_t* destination, int32_t count) {
+    const int32_t* texels = reinterpret_cast<const int32_t*>(source);
+    const int32_t pitchTexels = static_cast<int32_t>(sourceRowPitch / 4);
+    const __m256i maxX = _mm256_set1_epi32(sourceWidth - 1);
+    const __m256i maxY = _mm256_set1_epi32(sourceHeight - 1);
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    int32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        __m256 green[4];
+        SampleBilinearAVX2(texels, pitchTexels, maxX, maxY, _mm256_loadu_ps(coords[2] + x), _mm256_loadu_ps(coords[3] + x), green);
+        __m256 b = green[0];
+        __m256 r = green[2];
+        if (chromatic) {
+            __m256 red[4];
+            __m256 blue[4];
+            SampleBilinearAVX2(texels, pitchTexels, maxX, maxY, _mm256_loadu_ps(coords[0] + x), _mm256_loadu_ps(coords[1] + x), red);
+            SampleBilinearAVX2(texels, pitchTexels, maxX, maxY, _mm256_loadu_ps(coords[4] + x), _mm256_loadu_ps(coords[5] + x), blue);
+            r = red[2];
+            b = blue[0];
+        }
+
+        // 四舍五入后打包为 BGRA8
+        const __m256i ib = _mm256_cvttps_epi32(_mm256_add_ps(b, half));
+        const __m256i ig = _mm256_cvttps_epi32(_mm256_add_ps(green[1], half));
+        const __m256i ir = _mm256_cvttps_epi32(_mm256_add_ps(r, half));
+        const __m256i ia = _mm256_cvttps_epi32(_mm256_add_ps(green[3], half));
+        const __m256i packed = _mm256_or_si256(_mm256_or_si256(ib, _mm256_slli_epi32(ig, 8)),
+                                               _mm256_or_si256(_mm256_slli_epi32(ir, 16), _mm256_slli_epi32(ia, 24)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + static_cast<size_t>(x) * 4), packed);
+    }
+    return x;
+}
+
+} // namespace
+
+LensCorrectionKernel::LensCorrectionKernel(float distortion, float chromaticAberration) {
+    const float d = std::min(std::max(distortion, -100.0f), 100.0f) / 100.0f;
+    const float a = std::min(std::max(chromaticAberration, 0.0f), 100.0f) / 100.0f;
+    m_Distortion = d * kMaxDistortion;
+    m_DistortionNorm = (m_Distortion > 0.0f) ? 1.0f / (1.0f + m_Distortion) : 1.0f;
+    m_ChromaticScale = a * kMaxChromaticAberration;
+}
+
+float LensCorrectionKernel::RadialScale(float r2, int channel) const {
+    const float channelScale = 1.0f + static_cast<float>(channel - 1) * m_ChromaticScale;
+    return (1.0f + m_Distortion * r2) * m_DistortionNorm * channelScale;
+}
+
+int32_t LensCorrectionKernel::GetSupportRadius(float distortion, float chromaticAberration, uint32_t fullWidth, uint32_t fullHeight) {
+    if (IsIdentity(distortion, chromaticAberration)) {
+        return 0;
+    }
+
+    // 位移 |r * (s(r) - 1)| 只与半径有关，沿半径采样取最大值（位于四角以内的半径上限为 1）
+    const LensCorrectionKernel kernel(distortion, chromaticAberration);
+    const float halfDiagonal = 0.5f * std::sqrt(static_cast<float>(fullWidth) * fullWidth + static_cast<float>(fullHeight) * fullHeight);
+    float maxDisplacement = 0.0f;
+    for (int step = 0; step <= 64; ++step) {
+        const float r = step / 64.0f;
+        for (int c = 0; c < 3; ++c) {
+            maxDisplacement = std::max(maxDisplacement, std::abs(r * (kernel.RadialScale(r * r, c) - 1.0f)));
+        }
+    }
+    // 再加上双线性插值 1 像素与格点插值误差
+    return static_cast<int32_t>(std::ceil(maxDisplacement * halfDiagonal)) + 2;
+}
+
+void LensCorrectionKernel::BuildGrid(uint32_t width, uint32_t height, const Mapping& mapping) {
+    m_Width = width;
+    m_Height = height;
+    // 格点 i 位于输出像素 i * kGridSpacing，最后一列/行覆盖到最后一个像素之后
+    m_GridWidth = (width > 0) ? (width - 1) / kGridSpacing + 2 : 0;
+    m_GridHeight = (height > 0) ? (height - 1) / kGridSpacing + 2 : 0;
+    m_Grid.resize(static_cast<size_t>(m_GridWidth) * m_GridHeight * kGridChannels);
+
+    const float centerX = mapping.FullWidth * 0.5f;
+    const float centerY = mapping.FullHeight * 0.5f;
+    const float halfDiagonal = std::max(0.5f * std::sqrt(mapping.FullWidth * mapping.FullWidth + mapping.FullHeight * mapping.FullHeight), 1.0f);
+    // 输入纹理覆盖的完整图像范围（与输出相同）
+    const float extentX = static_cast<float>(width) * mapping.PixelScaleX;
+    const float extentY = static_cast<float>(height) * mapping.PixelScaleY;
+
+    for (uint32_t j = 0; j < m_GridHeight; ++j) {
+        const float py = mapping.OffsetY + (static_cast<float>(j * kGridSpacing) + 0.5f) * mapping.PixelScaleY;
+        const float dy = (py - centerY) / halfDiagonal;
+        float* node = m_Grid.data() + static_cast<size_t>(j) * m_GridWidth * kGridChannels;
+        for (uint32_t i = 0; i < m_GridWidth; ++i, node += kGridChannels) {
+            const float px = mapping.OffsetX + (static_cast<float>(i * kGridSpacing) + 0.5f) * mapping.PixelScaleX;
+            const float dx = (px - centerX) / halfDiagonal;
+            const float r2 = dx * dx + dy * dy;
+            for (int c = 0; c < 3; ++c) {
+                const float scale = RadialScale(r2, c);
+                const float sourceX = centerX + dx * scale * halfDiagonal;
+                const float sourceY = centerY + dy * scale * halfDiagonal;
+                node[c * 2 + 0] = (sourceX - mapping.OffsetX) / extentX;
+                node[c * 2 + 1] = (sourceY - mapping.OffsetY) / extentY;
+            }
+        }
+    }
+}
+
+bool LensCorrectionKernel::Process(const uint8_t* source, size_t sourceRowPitch, uint32_t sourceWidth, uint32_t sourceHeight,
+                                   uint8_t* destination, size_t destinationRowPitch) const {
+    if (!source || !destination || sourceWidth == 0 || sourceHeight == 0 || m_Grid.empty() || (sourceRowPitch % 4) != 0) {
+        return false;
+    }
+
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(m_Height), 16, [&](int32_t beginRow, int32_t endRow) {
+        ProcessRows(source, sourceRowPitch, sourceWidth, sourceHeight, destination, destinationRowPitch, beginRow, endRow);
+    });
+    return true;
+}
+
+void LensCorrectionKernel::ProcessRows(const uint8_t* source, size_t sourceRowPitch, uint32_t sourceWidth, uint32_t sourceHeight,
+                                       uint8_t* destination, size_t destinationRowPitch, int32_t beginRow, int32_t endRow) const {
+    const uint32_t width = m_Width;
+    const bool chromatic = HasChromaticAberration();
+    const bool useAVX2 = ImageAdjustKernel::GetSupportedSimdLevel() == ImageAdjustSimdLevel::AVX2;
+    const float invSpacing = 1.0f / static_cast<float>(kGridSpacing);
+    const float scaleX = static_cast<float>(sourceWidth);
+    const float scaleY = static_cast<float>(sourceHeight);
+
+    // 当前行在格点行之间插值后的一行格点，以及逐像素的 SoA 坐标（纹素空间）
+    float cellT[kGridSpacing];
+    for (uint32_t k = 0; k < kGridSpacing; ++k) {
+        cellT[k] = static_cast<float>(k) * invSpacing;
+    }
+    std::vector<float> rowNodes(static_cast<size_t>(m_GridWidth) * kGridChannels);
+    std::vector<float> coordData(static_cast<size_t>(width) * kGridChannels);
+    float* coords[kGridChannels];
+    for (uint32_t c = 0; c < kGridChannels; ++c) {
+        coords[c] = coordData.data() + static_cast<size_t>(c) * width;
+    }
+
+    for (int32_t y = beginRow; y < endRow; ++y) {
+        const uint32_t gridRow = static_cast<uint32_t>(y) / kGridSpacing;
+        const float ty = static_cast<float>(static_cast<uint32_t>(y) % kGridSpacing) * invSpacing;
+        const float* top = m_Grid.data() + static_cast<size_t>(gridRow) * m_GridWidth * kGridChannels;
+        const float* bottom = top + static_cast<size_t>(m_GridWidth) * kGridChannels;
+        for (size_t k = 0; k < rowNodes.size(); ++k) {
+            rowNodes[k] = top[k] + (bottom[k] - top[k]) * ty;
+        }
+
+        // 格点之间坐标是 x 的线性函数：每个像素一次乘加（纹理坐标 -> 纹素坐标，像素中心减 0.5）
+        const uint32_t channels = chromatic ? kGridChannels : 2;
+        const uint32_t firstChannel = chromatic ? 0 : 2;
+        for (uint32_t c = firstChannel; c < firstChannel + channels; ++c) {
+            const float scale = (c & 1) ? scaleY : scaleX;
+            float* out = coords[c];
+            for (uint32_t cell = 0, cellBegin = 0; cellBegin < width; ++cell, cellBegin += kGridSpacing) {
+                const float a = rowNodes[cell * kGridChannels + c];
+                const float delta = rowNodes[(cell + 1) * kGridChannels + c] - a;
+                const uint32_t cellEnd = std::min(cellBegin + kGridSpacing, width);
+                for (uint32_t x = cellBegin; x < cellEnd; ++x) {
+                    out[x] = ClampTexelCoord((a + delta * cellT[x - cellBegin]) * scale - 0.5f, scale);
+                }
+            }
+        }
+
+        uint8_t* dst = destination + static_cast<size_t>(y) * destinationRowPitch;
+        int32_t x = 0;
+        if (useAVX2) {
+            x = ResampleRowAVX2(source, sourceRowPitch, static_cast<int32_t>(sourceWidth), static_cast<int32_t>(sourceHeight),
+                                coords, chromatic, dst, static_cast<int32_t>(width));
+        }
+        for (; x < static_cast<int32_t>(width); ++x) {
+            float green[4];
+            SampleBilinear(source, sourceRowPitch, static_cast<int32_t>(sourceWidth), static_cast<int32_t>(sourceHeight),
+                           coords[2][x], coords[3][x], green);
+            float b = green[0];
+            float r = green[2];
+            if (chromatic) {
+                float red[4];
+                float blue[4];
+                SampleBilinear(source, sourceRowPitch, static_cast<int32_t>(sourceWidth), static_cast<int32_t>(sourceHeight),
+                               coords[0][x], coords[1][x], red);
+                SampleBilinear(source, sourceRowPitch, static_cast<int32_t>(sourceWidth), static_cast<int32_t>(sourceHeight),
+                               coords[4][x], coords[5][x], blue);
+                r = red[2];
+                b = blue[0];
+            }
+            uint8_t* p = dst + static_cast<size_t>(x) * 4;
+            p[0] = static_cast<uint8_t>(b + 0.5f);
+            p[1] = static_cast<uint8_t>(green[1] + 0.5f);
+            p[2] = static_cast<uint8_t>(r + 0.5f);
+            p[3] = static_cast<uint8_t>(green[3] + 0.5f);
+        }
+    }
+}
+
+} // namespace LightroomCore
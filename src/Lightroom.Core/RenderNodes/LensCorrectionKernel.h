@@ -0,0 +1,74 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace LightroomCore {
+
+// 镜头校正：径向畸变 + 横向色差（ImageAdjustParams::lensDistortion / chromaticAberration）
+// 畸变模型 r' = r * (1 + k * r^2)，r 以图像半对角线归一化；k > 0 时整体缩放使四角仍落在图像内。
+// 色差按通道缩放半径（红色向内、蓝色向外）。
+// 参数或尺寸变化时在稀疏格点（每 kGridSpacing 个输出像素）上预计算各通道的源纹理坐标，
+// 逐像素只需对格点做双线性插值再采样输入，不再逐像素逐通道求多项式。
+// GPU 路径（LensCorrectionNode）把同一份格点上传为纹理，插值方式与 CPU 相同。
+class LensCorrectionKernel {
+public:
+    // 输出像素到完整图像像素坐标的映射（分块执行时输出只是完整图像的一部分）
+    struct Mapping {
+        float FullWidth = 0.0f;     // 完整图像尺寸，决定畸变中心与归一化半径
+        float FullHeight = 0.0f;
+        float OffsetX = 0.0f;       // 输出 (0, 0) 像素左上角在完整图像中的位置
+        float OffsetY = 0.0f;
+        float PixelScaleX = 1.0f;   // 一个输出像素对应的完整图像像素数
+        float PixelScaleY = 1.0f;
+    };
+
+    // distortion: -100 - 100；chromaticAberration: 0 - 100
+    LensCorrectionKernel(float distortion, float chromaticAberration);
+
+    static bool IsIdentity(float distortion, float chromaticAberration) {
+        return distortion == 0.0f && chromaticAberration == 0.0f;
+    }
+
+    // 任意输出像素与其源像素之间的最大距离（完整图像像素，分块执行所需的邻域）
+    static int32_t GetSupportRadius(float distortion, float chromaticAberration, uint32_t fullWidth, uint32_t fullHeight);
+
+    // 为 width x height 的输出计算格点；输入纹理覆盖的完整图像范围与输出相同
+    void BuildGrid(uint32_t width, uint32_t height, const Mapping& mapping);
+
+    bool HasChromaticAberration() const { return m_ChromaticScale != 0.0f; }
+
+    // 格点数据：行优先，每个格点 kGridChannels 个 float，依次为红、绿、蓝通道的源纹理坐标 (u, v)
+    uint32_t GetGridWidth() const { return m_GridWidth; }
+    uint32_t GetGridHeight() const { return m_GridHeight; }
+    const float* GetGridData() const { return m_Grid.empty() ? nullptr : m_Grid.data(); }
+
+    // BGRA8 -> BGRA8（输出尺寸为 BuildGrid 的尺寸，输入可以是任意分辨率）；source 与 destination 不能重叠
+    bool Process(const uint8_t* source, size_t sourceRowPitch, uint32_t sourceWidth, uint32_t sourceHeight,
+                 uint8_t* destination, size_t destinationRowPitch) const;
+
+    static constexpr uint32_t kGridSpacing = 16;
+    static constexpr uint32_t kGridChannels = 6;
+    // 滑块为 ±100 时的畸变系数与色差半径缩放
+    static constexpr float kMaxDistortion = 0.2f;
+    static constexpr float kMaxChromaticAberration = 0.003f;
+
+private:
+    // 归一化半径平方 r2 处的径向缩放（通道 c：0 红、1 绿、2 蓝）
+    float RadialScale(float r2, int channel) const;
+    void ProcessRows(const uint8_t* source, size_t sourceRowPitch, uint32_t sourceWidth, uint32_t sourceHeight,
+                     uint8_t* destination, size_t destinationRowPitch, int32_t beginRow, int32_t endRow) const;
+
+    float m_Distortion;         // k
+    float m_DistortionNorm;     // k > 0 时使四角落在图像内的整体缩放
+    float m_ChromaticScale;     // 红色 1 - a，蓝色 1 + a
+
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    uint32_t m_GridWidth = 0;
+    uint32_t m_GridHeight = 0;
+    std::vector<float> m_Grid;
+};
+
+} // namespace LightroomCore
@@ -0,0 +1,283 @@
+﻿#include "LensCorrectionNode.h"
+#include "SoftwareNodeUtils.h"
+#include "../d3d11rhi/D3D11RHI.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace LightroomCore {
+
+// Constant buffer 结构体（必须 16 字节对齐）
+struct __declspec(align(16)) LensCorrectionConstantBuffer {
+    float GridSpacing;      // 相邻格点之间的输出像素数
+    float Padding[3];
+};
+
+LensCorrectionNode::LensCorrectionNode(std::shared_ptr<RenderCore::DynamicRHI> rhi)
+    : RenderNode(rhi)
+{
+    InitializeShaderResources();
+}
+
+LensCorrectionNode::~LensCorrectionNode() {
+    CleanupShaderResources();
+}
+
+bool LensCorrectionNode::InitializeShaderResources() {
+    if (m_ShaderResourcesInitialized || !m_RHI || IsSoftwareRHI()) {
+        return m_ShaderResourcesInitialized;
+    }
+
+    const char* vsCode = R"(
+        struct VSInput {
+            float2 Position : POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        struct VSOutput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        VSOutput main(VSInput input) {
+            VSOutput output;
+            output.Position = float4(input.Position, 0.0, 1.0);
+            output.TexCoord = input.TexCoord;
+            return output;
+        }
+    )";
+
+    // 格点插值顺序与 LensCorrectionKernel 一致：先在两行格点之间插值，再沿 x 插值
+    const char* psCode = R"(
+        cbuffer LensCorrectionParams : register(b0) {
+            float GridSpacing;
+            float3 Padding;
+        };
+        Texture2D InputTexture : register(t0);
+        Texture2D GridRG : register(t1);    // 每个格点：红、绿通道的源纹理坐标
+        Texture2D GridB : register(t2);     // 每个格点：蓝通道的源纹理坐标
+        SamplerState InputSampler : register(s0);
+        struct PSInput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+
+        float4 LoadGrid(Texture2D grid, float2 pixel) {
+            float2 g = (pixel - 0.5) / GridSpacing;
+            float2 cell = floor(g);
+            float2 t = g - cell;
+            int3 i = int3(cell, 0);
+            float4 left = lerp(grid.Load(i), grid.Load(i + int3(0, 1, 0)), t.y);
+            float4 right = lerp(grid.Load(i + int3(1, 0, 0)), grid.Load(i + int3(1, 1, 0)), t.y);
+            return lerp(left, right, t.x);
+        }
+
+        float4 main(PSInput input) : SV_TARGET {
+            float4 redGreen = LoadGrid(GridRG, input.Position.xy);
+            float4 color = InputTexture.Sample(InputSampler, redGreen.zw);
+        #if LENS_CHROMATIC_ABERRATION
+            color.r = InputTexture.Sample(InputSampler, redGreen.xy).r;
+            color.b = InputTexture.Sample(InputSampler, LoadGrid(GridB, input.Position.xy).xy).b;
+        #endif
+            return color;
+        }
+    )";
+
+    for (int i = 0; i < 2; ++i) {
+        const D3D_SHADER_MACRO defines[] = {
+            { "LENS_CHROMATIC_ABERRATION", i ? "1" : "0" },
+            { nullptr, nullptr }
+        };
+        if (!CompileShaders(vsCode, psCode, m_Shaders[i], defines)) {
+            std::cerr << "[LensCorrectionNode] Failed to compile shaders" << std::endl;
+            return false;
+        }
+    }
+
+    m_ParamsBuffer = m_RHI->RHICreateUniformBuffer(sizeof(LensCorrectionConstantBuffer));
+    if (!m_ParamsBuffer) {
+        std::cerr << "[LensCorrectionNode] Failed to create constant buffer" << std::endl;
+        return false;
+    }
+
+    m_ShaderResourcesInitialized = true;
+    return true;
+}
+
+void LensCorrectionNode::CleanupShaderResources() {
+    m_ParamsBuffer.reset();
+    for (auto& shader : m_Shaders) {
+        shader.VS.Reset();
+        shader.PS.Reset();
+        shader.InputLayout.Reset();
+        shader.Blob.Reset();
+    }
+    LensCorrectionNode::ReleaseResources();
+    m_ShaderResourcesInitialized = false;
+}
+
+void LensCorrectionNode::ReleaseResources() {
+    m_GridTextures[0].reset();
+    m_GridTextures[1].reset();
+    m_GridTextureKey = 0;
+}
+
+void LensCorrectionNode::SetParams(float distortion, float chromaticAberration) {
+    m_Distortion = distortion;
+    m_ChromaticAberration = chromaticAberration;
+}
+
+void LensCorrectionNode::SetInputImageSize(uint32_t width, uint32_t height) {
+    m_ImageWidth = width;
+    m_ImageHeight = height;
+}
+
+uint64_t LensCorrectionNode::GetParamsHash() const {
+    uint64_t hash = RenderNode::GetParamsHash();
+    hash = HashValue(m_Distortion, hash);
+    hash = HashValue(m_ChromaticAberration, hash);
+    hash = HashValue(m_ImageWidth, hash);
+    hash = HashValue(m_ImageHeight, hash);
+    return hash;
+}
+
+int32_t LensCorrectionNode::GetTileApron() const {
+    // 邻域为最大位移；位于渲染图最前端，分块导出时与之后的降噪、清晰度的邻域叠加（ImageExporter::ExportTiled）
+    // 分块执行时坐标以完整图像像素计算，需要知道原图尺寸
+    if (m_ImageWidth == 0 || m_ImageHeight == 0) {
+        return IsIdentity() ? 0 : -1;
+    }
+    return LensCorrectionKernel::GetSupportRadius(m_Distortion, m_ChromaticAberration, m_ImageWidth, m_ImageHeight);
+}
+
+LensCorrectionKernel::Mapping LensCorrectionNode::GetMapping(uint32_t width, uint32_t height) const {
+    LensCorrectionKernel::Mapping mapping;
+    if (m_TileFullWidth > 0 && m_TileFullHeight > 0) {
+        // 分块：输出像素与完整图像像素一一对应
+        mapping.FullWidth = static_cast<float>(m_TileFullWidth);
+        mapping.FullHeight = static_cast<float>(m_TileFullHeight);
+        mapping.OffsetX = static_cast<float>(m_TileOffsetX);
+        mapping.OffsetY = static_cast<float>(m_TileOffsetY);
+        return mapping;
+    }
+
+    // 整幅：输出是拉伸到 width x height 的整幅图像
+    mapping.FullWidth = static_cast<float>(m_ImageWidth > 0 ? m_ImageWidth : width);
+    mapping.FullHeight = static_cast<float>(m_ImageHeight > 0 ? m_ImageHeight : height);
+    mapping.PixelScaleX = mapping.FullWidth / static_cast<float>(width);
+    mapping.PixelScaleY = mapping.FullHeight / static_cast<float>(height);
+    return mapping;
+}
+
+bool LensCorrectionNode::UpdateGrid(uint32_t width, uint32_t height, bool uploadTexture) {
+    const LensCorrectionKernel::Mapping mapping = GetMapping(width, height);
+    uint64_t key = HashValue(m_Distortion, HashValue(m_ChromaticAberration, 0));
+    key = HashValue(width, key);
+    key = HashValue(height, key);
+    key = HashValue(mapping, key);
+
+    if (!m_Kernel || key != m_GridKey) {
+        m_Kernel = std::make_unique<LensCorrectionKernel>(m_Distortion, m_ChromaticAberration);
+        m_Kernel->BuildGrid(width, height, mapping);
+        m_GridKey = key;
+    }
+
+    if (uploadTexture && key != m_GridTextureKey) {
+        const uint32_t gridWidth = m_Kernel->GetGridWidth();
+        const uint32_t gridHeight = m_Kernel->GetGridHeight();
+        const size_t nodeCount = static_cast<size_t>(gridWidth) * gridHeight;
+        const float* grid = m_Kernel->GetGridData();
+        std::vector<float> redGreen(nodeCount * 4);
+        std::vector<float> blue(nodeCount * 2);
+        for (size_t i = 0; i < nodeCount; ++i) {
+            const float* node = grid + i * LensCorrectionKernel::kGridChannels;
+            std::copy(node, node + 4, redGreen.data() + i * 4);
+            std::copy(node + 4, node + 6, blue.data() + i * 2);
+        }
+
+        m_GridTextures[0] = m_RHI->RHICreateTexture2D(
+            RenderCore::EPixelFormat::PF_A32B32G32R32F,
+            RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+            gridWidth,
+            gridHeight,
+            1,
+            redGreen.data(),
+            gridWidth * 4 * sizeof(float)
+        );
+        m_GridTextures[1] = m_RHI->RHICreateTexture2D(
+            RenderCore::EPixelFormat::PF_G32R32F,
+            RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+            gridWidth,
+            gridHeight,
+            1,
+            blue.data(),
+            gridWidth * 2 * sizeof(float)
+        );
+        if (!m_GridTextures[0] || !m_GridTextures[1]) {
+            std::cerr << "[LensCorrectionNode] Failed to create remap grid textures" << std::endl;
+            ReleaseResources();
+            return false;
+        }
+        m_GridTextureKey = key;
+    }
+    return true;
+}
+
+void LensCorrectionNode::UpdateConstantBuffers(uint32_t width, uint32_t height) {
+    if (!m_ParamsBuffer || !m_CommandContext) {
+        return;
+    }
+
+    LensCorrectionConstantBuffer cbData = {};
+    cbData.GridSpacing = static_cast<float>(LensCorrectionKernel::kGridSpacing);
+    m_CommandContext->RHIUpdateUniformBuffer(m_ParamsBuffer, &cbData);
+}
+
+void LensCorrectionNode::SetConstantBuffers() {
+    if (m_ParamsBuffer) {
+        m_CommandContext->RHISetShaderUniformBuffer(RenderCore::EShaderFrequency::SF_Pixel, 0, m_ParamsBuffer);
+    }
+}
+
+void LensCorrectionNode::SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) {
+    m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, 0, inputTexture);
+    m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, 1, m_GridTextures[0]);
+    m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, 2, m_GridTextures[1]);
+    m_CommandContext->RHISetShaderSampler(RenderCore::EShaderFrequency::SF_Pixel, 0, m_CommonSamplerState);
+}
+
+bool LensCorrectionNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) {
+    if (IsSoftwareRHI()) {
+        return ExecuteSoftware(inputTexture, outputTarget, width, height);
+    }
+
+    if (!m_ShaderResourcesInitialized || width == 0 || height == 0) {
+        return false;
+    }
+
+    // 参数为 0 时格点就是恒等映射，作为最后一个节点或单独执行时同样适用
+    if (!UpdateGrid(width, height, true)) {
+        return false;
+    }
+
+    m_CurrentShader = &m_Shaders[m_Kernel->HasChromaticAberration() ? 1 : 0];
+    return RenderNode::Execute(inputTexture, outputTarget, width, height);
+}
+
+bool LensCorrectionNode::ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                         std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                         uint32_t width, uint32_t height) {
+    RenderCore::SoftwareTexture2D* input = GetSoftwareTexture(inputTexture);
+    RenderCore::SoftwareTexture2D* output = GetSoftwareTexture(outputTarget);
+    if (!IsSoftwareBGRA8Pair(input, output, width, height) || width == 0 || height == 0) {
+        return false;
+    }
+
+    // 输入可以是任意分辨率（代理图），格点中的坐标是归一化纹理坐标
+    UpdateGrid(width, height, false);
+    return m_Kernel->Process(input->GetRow(0), input->GetRowPitch(),
+                             static_cast<uint32_t>(input->GetSize().x), static_cast<uint32_t>(input->GetSize().y),
+                             output->GetRow(0), output->GetRowPitch());
+}
+
+} // namespace LightroomCore
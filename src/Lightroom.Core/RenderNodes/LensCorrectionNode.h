@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include "RenderNode.h"
+#include "LensCorrectionKernel.h"
+#include "../d3d11rhi/RHIUniformBuffer.h"
+#include <memory>
+
+namespace LightroomCore {
+
+// 镜头校正节点：径向畸变与横向色差（见 LensCorrectionKernel）
+// 参数、图像尺寸或分块位置变化时重建稀疏重映射格点；GPU 路径把格点上传为 t1/t2 两张 32 位浮点纹理，
+// 像素 shader 对格点做双线性插值后采样输入（没有色差时只采样一次）。两个参数都为 0 时渲染图跳过该节点。
+class LensCorrectionNode : public RenderNode {
+public:
+    LensCorrectionNode(std::shared_ptr<RenderCore::DynamicRHI> rhi);
+    virtual ~LensCorrectionNode();
+
+    virtual bool Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                        std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                        uint32_t width, uint32_t height) override;
+
+    virtual const char* GetName() const override { return "LensCorrection"; }
+    virtual uint64_t GetParamsHash() const override;
+    virtual int32_t GetTileApron() const override;
+    virtual bool IsIdentity() const override { return LensCorrectionKernel::IsIdentity(m_Distortion, m_ChromaticAberration); }
+    virtual void ReleaseResources() override;
+
+    // distortion: -100 - 100；chromaticAberration: 0 - 100
+    void SetParams(float distortion, float chromaticAberration);
+
+    // 原图尺寸：渲染图的中间纹理是拉伸到输出尺寸的整幅图像，畸变中心与半径需要原图的宽高比
+    void SetInputImageSize(uint32_t width, uint32_t height);
+
+protected:
+    virtual void UpdateConstantBuffers(uint32_t width, uint32_t height) override;
+    virtual void SetConstantBuffers() override;
+    virtual void SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) override;
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) override;
+
+private:
+    bool InitializeShaderResources();
+    void CleanupShaderResources();
+
+    // 输出尺寸为 width x height 时的坐标映射（考虑分块上下文）
+    LensCorrectionKernel::Mapping GetMapping(uint32_t width, uint32_t height) const;
+    // 参数、尺寸或映射变化时重建格点；uploadTexture 为 true 时同时更新 GPU 格点纹理
+    bool UpdateGrid(uint32_t width, uint32_t height, bool uploadTexture);
+
+    float m_Distortion = 0.0f;
+    float m_ChromaticAberration = 0.0f;
+    uint32_t m_ImageWidth = 0;
+    uint32_t m_ImageHeight = 0;
+
+    // 格点：m_GridKey 为构建时的参数、尺寸与映射的哈希
+    std::unique_ptr<LensCorrectionKernel> m_Kernel;
+    uint64_t m_GridKey = 0;
+    // GPU 格点纹理：t1 为红、绿通道坐标（RGBA32F），t2 为蓝通道坐标（RG32F）
+    std::shared_ptr<RenderCore::RHITexture2D> m_GridTextures[2];
+    uint64_t m_GridTextureKey = 0;
+
+    // [0] 无色差（只采样一次），[1] 按通道采样
+    CompiledShader m_Shaders[2];
+    std::shared_ptr<RenderCore::RHIUniformBuffer> m_ParamsBuffer;
+    bool m_ShaderResourcesInitialized = false;
+};
+
+} // namespace LightroomCore
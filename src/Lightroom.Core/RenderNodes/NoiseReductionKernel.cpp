@@ -0,0 +1,193 @@
+﻿#include "NoiseReductionKernel.h"
+#include "GaussianBlurKernel.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace LightroomCore {
+
+namespace {
+
+// 与 NoiseReductionNode shader 中的 ToYCbCr / FromYCbCr 一致（BT.601，色度不加偏移）
+inline void RgbToYCbCr(float r, float g, float b, float& y, float& cb, float& cr) {
+    y = 0.299f * r + 0.587f * g + 0.114f * b;
+    cb = (b - y) * 0.564f;
+    cr = (r - y) * 0.713f;
+}
+
+inline void YCbCrToRgb(float y, float cb, float cr, float& r, float& g, float& b) {
+    r = y + 1.403f * cr;
+    g = y - 0.344f * cb - 0.714f * cr;
+    b = y + 1.773f * cb;
+}
+
+inline uint8_t ToByte(float v) {
+    v = (v > 0.0f) ? v : 0.0f;
+    v = (v < 1.0f) ? v : 1.0f;
+    return static_cast<uint8_t>(v * 255.0f + 0.5f);
+}
+
+} // namespace
+
+NoiseReductionKernel::NoiseReductionKernel(float strength)
+    : m_Strength(strength)
+    , m_Settings(GetSettings(strength))
+{
+}
+
+NoiseReductionKernel::Settings NoiseReductionKernel::GetSettings(float strength) {
+    const float t = std::min(std::max(strength, 0.0f), 100.0f) / 100.0f;
+    Settings settings;
+    const float lumaSigma = 0.05f * t;
+    const float chromaSigma = 0.1f * t;
+    settings.Radius[0] = 1 + static_cast<int32_t>(std::lround(2.0f * t));
+    settings.Radius[1] = settings.Radius[2] = 2 + static_cast<int32_t>(std::lround(6.0f * t));
+    settings.Epsilon[0] = lumaSigma * lumaSigma;
+    settings.Epsilon[1] = settings.Epsilon[2] = chromaSigma * chromaSigma;
+    return settings;
+}
+
+int32_t NoiseReductionKernel::GetSupportRadius(float strength) {
+    if (IsIdentity(strength)) {
+        return 0;
+    }
+    // 两次盒式均值（均值/方差、系数平滑）+ 双线性放大
+    const Settings settings = GetSettings(strength);
+    const int32_t radius = std::max(settings.Radius[0], settings.Radius[1]);
+    return (2 * radius + 1) * kSubsample;
+}
+
+bool NoiseReductionKernel::Process(const uint8_t* source, size_t sourceRowPitch, uint8_t* destination, size_t destinationRowPitch,
+                                   uint32_t width, uint32_t height) const {
+    if (!source || !destination || width == 0 || height == 0) {
+        return false;
+    }
+
+    auto& pool = RenderCore::SoftwareTaskPool::Get();
+    if (IsIdentity(m_Strength)) {
+        if (source != destination) {
+            pool.ParallelForRows(static_cast<int32_t>(height), 64, [&](int32_t beginRow, int32_t endRow) {
+                for (int32_t y = beginRow; y < endRow; ++y) {
+                    std::memcpy(destination + y * destinationRowPitch, source + y * sourceRowPitch, width * 4);
+                }
+            });
+        }
+        return true;
+    }
+
+    // 1. 全分辨率 YCbCr 平面（引导图）
+    const size_t planeSize = static_cast<size_t>(width) * height;
+    std::vector<float> guide(planeSize * 3);
+    pool.ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t beginRow, int32_t endRow) {
+        for (int32_t y = beginRow; y < endRow; ++y) {
+            const uint8_t* p = source + y * sourceRowPitch;
+            const size_t rowOffset = static_cast<size_t>(y) * width;
+            for (uint32_t x = 0; x < width; ++x, p += 4) {
+                RgbToYCbCr(p[2] / 255.0f, p[1] / 255.0f, p[0] / 255.0f,
+                           guide[rowOffset + x], guide[planeSize + rowOffset + x], guide[planeSize * 2 + rowOffset + x]);
+            }
+        }
+    });
+
+    // 2. 低分辨率上逐通道计算引导滤波系数 a、b，并做盒式平滑
+    const uint32_t lowWidth = (width + kSubsample - 1) / kSubsample;
+    const uint32_t lowHeight = (height + kSubsample - 1) / kSubsample;
+    const size_t lowSize = static_cast<size_t>(lowWidth) * lowHeight;
+    const size_t lowPitch = static_cast<size_t>(lowWidth) * sizeof(float);
+    std::vector<float> coeffA(lowSize * 3);
+    std::vector<float> coeffB(lowSize * 3);
+    std::vector<float> mean(lowSize);
+    std::vector<float> corr(lowSize);
+
+    for (int c = 0; c < 3; ++c) {
+        const float* plane = guide.data() + planeSize * c;
+        float* a = coeffA.data() + lowSize * c;
+        float* b = coeffB.data() + lowSize * c;
+
+        // 2x2 均值缩小（与 GPU 在低分辨率像素中心做双线性采样一致），同时写出平方
+        pool.ParallelForRows(static_cast<int32_t>(lowHeight), 16, [&](int32_t beginRow, int32_t endRow) {
+            for (int32_t ly = beginRow; ly < endRow; ++ly) {
+                const uint32_t y0 = std::min(static_cast<uint32_t>(ly) * kSubsample, height - 1);
+                const uint32_t y1 = std::min(y0 + 1, height - 1);
+                const float* row0 = plane + static_cast<size_t>(y0) * width;
+                const float* row1 = plane + static_cast<size_t>(y1) * width;
+                for (uint32_t lx = 0; lx < lowWidth; ++lx) {
+                    const uint32_t x0 = std::min(lx * kSubsample, width - 1);
+                    const uint32_t x1 = std::min(x0 + 1, width - 1);
+                    const float value = 0.25f * (row0[x0] + row0[x1] + row1[x0] + row1[x1]);
+                    a[ly * lowWidth + lx] = value;
+                    b[ly * lowWidth + lx] = value * value;
+                }
+            }
+        });
+
+        const int32_t radius = m_Settings.Radius[c];
+        GaussianBlurKernel::BoxFilter(a, lowPitch, mean.data(), lowPitch, lowWidth, lowHeight, radius);
+        GaussianBlurKernel::BoxFilter(b, lowPitch, corr.data(), lowPitch, lowWidth, lowHeight, radius);
+
+        const float epsilon = m_Settings.Epsilon[c];
+        pool.ParallelForRows(static_cast<int32_t>(lowHeight), 16, [&](int32_t beginRow, int32_t endRow) {
+            const size_t begin = static_cast<size_t>(beginRow) * lowWidth;
+            const size_t end = static_cast<size_t>(endRow) * lowWidth;
+            for (size_t i = begin; i < end; ++i) {
+                const float variance = std::max(corr[i] - mean[i] * mean[i], 0.0f);
+                const float gain = variance / (variance + epsilon);
+                a[i] = gain;
+                b[i] = mean[i] - gain * mean[i];
+            }
+        });
+
+        GaussianBlurKernel::BoxFilter(a, lowPitch, a, lowPitch, lowWidth, lowHeight, radius);
+        GaussianBlurKernel::BoxFilter(b, lowPitch, b, lowPitch, lowWidth, lowHeight, radius);
+    }
+
+    // 3. 双线性放大系数，q = a * I + b，转换回 RGB
+    pool.ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t beginRow, int32_t endRow) {
+        for (int32_t y = beginRow; y < endRow; ++y) {
+            // 全分辨率像素中心在低分辨率纹素空间中的位置
+            const float ly = (static_cast<float>(y) + 0.5f) / kSubsample - 0.5f;
+            const int32_t ly0 = std::max(static_cast<int32_t>(std::floor(ly)), 0);
+            const int32_t ly1 = std::min(ly0 + 1, static_cast<int32_t>(lowHeight) - 1);
+            const float fy = std::min(std::max(ly - static_cast<float>(ly0), 0.0f), 1.0f);
+
+            const uint8_t* src = source + y * sourceRowPitch;
+            uint8_t* dst = destination + y * destinationRowPitch;
+            const size_t rowOffset = static_cast<size_t>(y) * width;
+            for (uint32_t x = 0; x < width; ++x) {
+                const float lx = (static_cast<float>(x) + 0.5f) / kSubsample - 0.5f;
+                const int32_t lx0 = std::max(static_cast<int32_t>(std::floor(lx)), 0);
+                const int32_t lx1 = std::min(lx0 + 1, static_cast<int32_t>(lowWidth) - 1);
+                const float fx = std::min(std::max(lx - static_cast<float>(lx0), 0.0f), 1.0f);
+
+                const size_t i00 = static_cast<size_t>(ly0) * lowWidth + lx0;
+                const size_t i01 = static_cast<size_t>(ly0) * lowWidth + lx1;
+                const size_t i10 = static_cast<size_t>(ly1) * lowWidth + lx0;
+                const size_t i11 = static_cast<size_t>(ly1) * lowWidth + lx1;
+                auto bilinear = [&](const float* plane) {
+                    const float top = plane[i00] + (plane[i01] - plane[i00]) * fx;
+                    const float bottom = plane[i10] + (plane[i11] - plane[i10]) * fx;
+                    return top + (bottom - top) * fy;
+                };
+
+                float filtered[3];
+                for (int c = 0; c < 3; ++c) {
+                    const float guideValue = guide[planeSize * c + rowOffset + x];
+                    filtered[c] = bilinear(coeffA.data() + lowSize * c) * guideValue + bilinear(coeffB.data() + lowSize * c);
+                }
+
+                float r, g, b;
+                YCbCrToRgb(filtered[0], filtered[1], filtered[2], r, g, b);
+                const uint8_t alpha = src[x * 4 + 3];
+                dst[x * 4 + 0] = ToByte(b);
+                dst[x * 4 + 1] = ToByte(g);
+                dst[x * 4 + 2] = ToByte(r);
+                dst[x * 4 + 3] = alpha;
+            }
+        }
+    });
+    return true;
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace LightroomCore {
+
+// 边缘保持降噪（快速引导滤波，自引导）
+// 在 YCbCr 空间对亮度与两个色度通道分别滤波：亮度半径小、阈值低，只去除颗粒；色度半径大、阈值高，去除彩色噪点。
+// 系数在 1/kSubsample 分辨率上计算（盒式均值为滑动窗口求和，耗时与半径无关），双线性放大后作用于全分辨率图像。
+// GPU 路径（NoiseReductionNode）使用相同的参数与步骤。
+class NoiseReductionKernel {
+public:
+    // 每个通道（Y、Cb、Cr）的滤波参数，半径以低分辨率像素为单位
+    struct Settings {
+        int32_t Radius[3];
+        float Epsilon[3];   // 引导滤波正则项：局部方差远大于 Epsilon 的区域（边缘）被保留
+    };
+
+    // strength: 0 - 100（ImageAdjustParams::noiseReduction）
+    explicit NoiseReductionKernel(float strength);
+
+    static Settings GetSettings(float strength);
+    static bool IsIdentity(float strength) { return strength <= 0.0f; }
+
+    // 每个方向上影响结果的全分辨率像素数（分块执行所需的邻域）
+    static int32_t GetSupportRadius(float strength);
+
+    // BGRA8 -> BGRA8，alpha 原样保留；source 与 destination 可以是同一块内存
+    bool Process(const uint8_t* source, size_t sourceRowPitch, uint8_t* destination, size_t destinationRowPitch,
+                 uint32_t width, uint32_t height) const;
+
+    static constexpr int32_t kSubsample = 2;
+
+private:
+    float m_Strength;
+    Settings m_Settings;
+};
+
+} // namespace LightroomCore
@@ -0,0 +1,332 @@
+﻿#include "NoiseReductionNode.h"
+#include "SoftwareNodeUtils.h"
+#include "../d3d11rhi/D3D11RHI.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace LightroomCore {
+
+// Constant buffer 结构体（必须 16 字节对齐）
+struct __declspec(align(16)) NoiseReductionConstantBuffer {
+    float TexelStep[2];     // 盒式均值 pass：一个纹素在当前方向上的纹理坐标步长
+    float Padding[2];
+    float Radius[4];        // Y、Cb、Cr 的盒式均值半径（低分辨率像素）
+    float Epsilon[4];       // Y、Cb、Cr 的引导滤波正则项
+};
+
+NoiseReductionNode::NoiseReductionNode(std::shared_ptr<RenderCore::DynamicRHI> rhi)
+    : RenderNode(rhi)
+{
+    InitializeShaderResources();
+}
+
+NoiseReductionNode::~NoiseReductionNode() {
+    CleanupShaderResources();
+}
+
+bool NoiseReductionNode::InitializeShaderResources() {
+    if (m_ShaderResourcesInitialized || !m_RHI || IsSoftwareRHI()) {
+        return m_ShaderResourcesInitialized;
+    }
+
+    const char* vsCode = R"(
+        struct VSInput {
+            float2 Position : POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        struct VSOutput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+        VSOutput main(VSInput input) {
+            VSOutput output;
+            output.Position = float4(input.Position, 0.0, 1.0);
+            output.TexCoord = input.TexCoord;
+            return output;
+        }
+    )";
+
+    // 所有 pass 共用一份源码，按 PASS_* 宏选择主函数
+    const char* psCode = R"(
+        cbuffer NoiseReductionParams : register(b0) {
+            float2 TexelStep;
+            float2 Padding;
+            float4 Radius;
+            float4 Epsilon;
+        };
+        Texture2D InputTexture : register(t0);
+        Texture2D ExtraTexture0 : register(t1);
+        Texture2D ExtraTexture1 : register(t2);
+        SamplerState InputSampler : register(s0);
+        struct PSInput {
+            float4 Position : SV_POSITION;
+            float2 TexCoord : TEXCOORD0;
+        };
+
+        // BT.601，色度不加偏移（与 NoiseReductionKernel 一致）
+        float3 ToYCbCr(float3 rgb) {
+            float y = dot(rgb, float3(0.299, 0.587, 0.114));
+            return float3(y, (rgb.b - y) * 0.564, (rgb.r - y) * 0.713);
+        }
+        float3 FromYCbCr(float3 ycc) {
+            return float3(ycc.x + 1.403 * ycc.z,
+                          ycc.x - 0.344 * ycc.y - 0.714 * ycc.z,
+                          ycc.x + 1.773 * ycc.y);
+        }
+        float3 GuidedGain(float3 mean, float3 corr) {
+            float3 variance = max(corr - mean * mean, 0.0);
+            return variance / (variance + Epsilon.xyz);
+        }
+
+        float4 main(PSInput input) : SV_TARGET {
+            float2 uv = input.TexCoord;
+        #if defined(PASS_MEAN)
+            return float4(ToYCbCr(InputTexture.Sample(InputSampler, uv).rgb), 1.0);
+        #elif defined(PASS_SQUARE)
+            float3 ycc = ToYCbCr(InputTexture.Sample(InputSampler, uv).rgb);
+            return float4(ycc * ycc, 1.0);
+        #elif defined(PASS_BOX)
+            // 每个通道使用自己的半径：窗口外的采样权重为 0
+            int maxRadius = (int)max(Radius.x, max(Radius.y, Radius.z));
+            float4 sum = 0.0;
+            float4 count = 0.0;
+            [loop]
+            for (int i = -maxRadius; i <= maxRadius; ++i) {
+                float4 inside = float4(step(abs((float)i), Radius.xyz), 1.0);
+                sum += InputTexture.Sample(InputSampler, uv + TexelStep * i) * inside;
+                count += inside;
+            }
+            return sum / count;
+        #elif defined(PASS_COEFF_A)
+            float3 mean = InputTexture.Sample(InputSampler, uv).rgb;
+            float3 corr = ExtraTexture0.Sample(InputSampler, uv).rgb;
+            return float4(GuidedGain(mean, corr), 1.0);
+        #elif defined(PASS_COEFF_B)
+            float3 mean = InputTexture.Sample(InputSampler, uv).rgb;
+            float3 corr = ExtraTexture0.Sample(InputSampler, uv).rgb;
+            return float4(mean - GuidedGain(mean, corr) * mean, 1.0);
+        #elif defined(PASS_COMBINE)
+            float4 color = InputTexture.Sample(InputSampler, uv);
+            float3 a = ExtraTexture0.Sample(InputSampler, uv).rgb;
+            float3 b = ExtraTexture1.Sample(InputSampler, uv).rgb;
+            return float4(saturate(FromYCbCr(a * ToYCbCr(color.rgb) + b)), color.a);
+        #else
+            return InputTexture.Sample(InputSampler, uv);
+        #endif
+        }
+    )";
+
+    const char* passDefines[] = {
+        "",                             // Copy
+        "#define PASS_MEAN\n",
+        "#define PASS_SQUARE\n",
+        "#define PASS_BOX\n",           // BoxHorizontal
+        "#define PASS_BOX\n",           // BoxVertical
+        "#define PASS_COEFF_A\n",
+        "#define PASS_COEFF_B\n",
+        "#define PASS_COMBINE\n"
+    };
+    for (size_t i = 0; i < static_cast<size_t>(Pass::Count); ++i) {
+        const std::string source = std::string(passDefines[i]) + psCode;
+        if (!CompileShaders(vsCode, source.c_str(), m_Shaders[i])) {
+            std::cerr << "[NoiseReductionNode] Failed to compile shaders" << std::endl;
+            return false;
+        }
+    }
+
+    m_ParamsBuffer = m_RHI->RHICreateUniformBuffer(sizeof(NoiseReductionConstantBuffer));
+    if (!m_ParamsBuffer) {
+        std::cerr << "[NoiseReductionNode] Failed to create constant buffer" << std::endl;
+        return false;
+    }
+
+    m_ShaderResourcesInitialized = true;
+    return true;
+}
+
+void NoiseReductionNode::CleanupShaderResources() {
+    m_ParamsBuffer.reset();
+    for (auto& shader : m_Shaders) {
+        shader.VS.Reset();
+        shader.PS.Reset();
+        shader.InputLayout.Reset();
+        shader.Blob.Reset();
+    }
+    NoiseReductionNode::ReleaseResources();
+    m_ShaderResourcesInitialized = false;
+}
+
+uint64_t NoiseReductionNode::GetParamsHash() const {
+    return HashValue(m_Strength, RenderNode::GetParamsHash());
+}
+
+void NoiseReductionNode::ReleaseResources() {
+    m_MeanTexture.reset();
+    m_CorrTexture.reset();
+    m_CoeffATexture.reset();
+    m_CoeffBTexture.reset();
+    m_ScratchTexture.reset();
+}
+
+bool NoiseReductionNode::EnsureTextures(uint32_t lowWidth, uint32_t lowHeight) {
+    if (m_ScratchTexture) {
+        const core::vec2i size = m_ScratchTexture->GetSize();
+        if (static_cast<uint32_t>(size.x) == lowWidth && static_cast<uint32_t>(size.y) == lowHeight) {
+            return true;
+        }
+    }
+
+    std::shared_ptr<RenderCore::RHITexture2D>* textures[] = {
+        &m_MeanTexture, &m_CorrTexture, &m_CoeffATexture, &m_CoeffBTexture, &m_ScratchTexture
+    };
+    for (auto* texture : textures) {
+        // 平方与方差需要 FP16 精度
+        *texture = m_RHI->RHICreateTexture2D(
+            RenderCore::EPixelFormat::PF_FloatRGBA,
+            RenderCore::ETextureCreateFlags::TexCreate_RenderTargetable | RenderCore::ETextureCreateFlags::TexCreate_ShaderResource,
+            lowWidth,
+            lowHeight,
+            1
+        );
+        if (!*texture) {
+            m_ScratchTexture.reset();
+            return false;
+        }
+    }
+    return true;
+}
+
+void NoiseReductionNode::UpdateConstantBuffers(uint32_t width, uint32_t height) {
+    if (!m_ParamsBuffer || !m_CommandContext) {
+        return;
+    }
+
+    const NoiseReductionKernel::Settings settings = NoiseReductionKernel::GetSettings(m_Strength);
+    NoiseReductionConstantBuffer cbData = {};
+    cbData.TexelStep[0] = (m_Pass == Pass::BoxHorizontal) ? 1.0f / static_cast<float>(width) : 0.0f;
+    cbData.TexelStep[1] = (m_Pass == Pass::BoxVertical) ? 1.0f / static_cast<float>(height) : 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        cbData.Radius[c] = static_cast<float>(settings.Radius[c]);
+        cbData.Epsilon[c] = settings.Epsilon[c];
+    }
+    m_CommandContext->RHIUpdateUniformBuffer(m_ParamsBuffer, &cbData);
+}
+
+void NoiseReductionNode::SetConstantBuffers() {
+    if (m_ParamsBuffer) {
+        m_CommandContext->RHISetShaderUniformBuffer(RenderCore::EShaderFrequency::SF_Pixel, 0, m_ParamsBuffer);
+    }
+}
+
+void NoiseReductionNode::SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) {
+    m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, 0, inputTexture);
+    for (uint32_t i = 0; i < 2; ++i) {
+        if (m_ExtraTextures[i]) {
+            m_CommandContext->RHISetShaderTexture(RenderCore::EShaderFrequency::SF_Pixel, i + 1, m_ExtraTextures[i]);
+        }
+    }
+    m_CommandContext->RHISetShaderSampler(RenderCore::EShaderFrequency::SF_Pixel, 0, m_CommonSamplerState);
+}
+
+bool NoiseReductionNode::RunPass(Pass pass, std::shared_ptr<RenderCore::RHITexture2D> input,
+                                 std::shared_ptr<RenderCore::RHITexture2D> output, uint32_t width, uint32_t height,
+                                 std::shared_ptr<RenderCore::RHITexture2D> extra0,
+                                 std::shared_ptr<RenderCore::RHITexture2D> extra1) {
+    m_Pass = pass;
+    m_ExtraTextures[0] = extra0;
+    m_ExtraTextures[1] = extra1;
+    m_CurrentShader = &m_Shaders[static_cast<size_t>(pass)];
+    const bool result = RenderNode::Execute(input, output, width, height);
+
+    // 解除 t1/t2 绑定，这些纹理在后续 pass 中会作为渲染目标
+    if (extra0 || extra1) {
+        RenderCore::D3D11DynamicRHI* d3d11RHI = dynamic_cast<RenderCore::D3D11DynamicRHI*>(m_RHI.get());
+        if (d3d11RHI && d3d11RHI->GetDeviceContext()) {
+            ID3D11ShaderResourceView* nullSRVs[2] = { nullptr, nullptr };
+            d3d11RHI->GetDeviceContext()->PSSetShaderResources(1, 2, nullSRVs);
+        }
+    }
+    m_ExtraTextures[0].reset();
+    m_ExtraTextures[1].reset();
+    return result;
+}
+
+bool NoiseReductionNode::BoxFilter(std::shared_ptr<RenderCore::RHITexture2D> texture, uint32_t width, uint32_t height) {
+    return RunPass(Pass::BoxHorizontal, texture, m_ScratchTexture, width, height) &&
+           RunPass(Pass::BoxVertical, m_ScratchTexture, texture, width, height);
+}
+
+bool NoiseReductionNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) {
+    if (IsSoftwareRHI()) {
+        return ExecuteSoftware(inputTexture, outputTarget, width, height);
+    }
+
+    if (!m_ShaderResourcesInitialized) {
+        return false;
+    }
+
+    // 强度为 0 时渲染图会跳过本节点；作为最后一个节点或单独执行时直接复制
+    if (IsIdentity()) {
+        return RunPass(Pass::Copy, inputTexture, outputTarget, width, height);
+    }
+
+    const uint32_t lowWidth = (width + NoiseReductionKernel::kSubsample - 1) / NoiseReductionKernel::kSubsample;
+    const uint32_t lowHeight = (height + NoiseReductionKernel::kSubsample - 1) / NoiseReductionKernel::kSubsample;
+    if (!EnsureTextures(lowWidth, lowHeight)) {
+        std::cerr << "[NoiseReductionNode] Failed to create intermediate textures" << std::endl;
+        return false;
+    }
+
+    // 1. 低分辨率的 E[I]、E[I^2]
+    if (!RunPass(Pass::Mean, inputTexture, m_MeanTexture, lowWidth, lowHeight) ||
+        !RunPass(Pass::Square, inputTexture, m_CorrTexture, lowWidth, lowHeight) ||
+        !BoxFilter(m_MeanTexture, lowWidth, lowHeight) ||
+        !BoxFilter(m_CorrTexture, lowWidth, lowHeight)) {
+        return false;
+    }
+
+    // 2. 系数 a = var / (var + eps)，b = mean - a * mean，再做一次盒式均值
+    if (!RunPass(Pass::CoeffA, m_MeanTexture, m_CoeffATexture, lowWidth, lowHeight, m_CorrTexture) ||
+        !RunPass(Pass::CoeffB, m_MeanTexture, m_CoeffBTexture, lowWidth, lowHeight, m_CorrTexture) ||
+        !BoxFilter(m_CoeffATexture, lowWidth, lowHeight) ||
+        !BoxFilter(m_CoeffBTexture, lowWidth, lowHeight)) {
+        return false;
+    }
+
+    // 3. 全分辨率合成（系数由采样器双线性放大）
+    return RunPass(Pass::Combine, inputTexture, outputTarget, width, height, m_CoeffATexture, m_CoeffBTexture);
+}
+
+bool NoiseReductionNode::ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                         std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                         uint32_t width, uint32_t height) {
+    RenderCore::SoftwareTexture2D* input = GetSoftwareTexture(inputTexture);
+    RenderCore::SoftwareTexture2D* output = GetSoftwareTexture(outputTarget);
+    if (!IsSoftwareBGRA8Pair(input, output, width, height) || width == 0 || height == 0) {
+        return false;
+    }
+
+    const NoiseReductionKernel kernel(m_Strength);
+    if (input->GetSize().x == static_cast<int32_t>(width) && input->GetSize().y == static_cast<int32_t>(height)) {
+        return kernel.Process(input->GetRow(0), input->GetRowPitch(), output->GetRow(0), output->GetRowPitch(), width, height);
+    }
+
+    // 输入与输出尺寸不同时与 GPU 一样先按纹理坐标重采样到输出尺寸
+    std::vector<uint8_t> resampled(static_cast<size_t>(width) * height * 4);
+    const float scaleX = static_cast<float>(input->GetSize().x) / static_cast<float>(width);
+    const float scaleY = static_cast<float>(input->GetSize().y) / static_cast<float>(height);
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t rowBegin, int32_t rowEnd) {
+        for (int32_t y = rowBegin; y < rowEnd; ++y) {
+            uint8_t* dst = resampled.data() + static_cast<size_t>(y) * width * 4;
+            for (uint32_t x = 0; x < width; ++x, dst += 4) {
+                SampleBilinearBGRA8(input, (x + 0.5f) * scaleX, (y + 0.5f) * scaleY, dst);
+            }
+        }
+    });
+    return kernel.Process(resampled.data(), static_cast<size_t>(width) * 4, output->GetRow(0), output->GetRowPitch(), width, height);
+}
+
+} // namespace LightroomCore
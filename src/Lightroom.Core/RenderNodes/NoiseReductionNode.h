@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include "RenderNode.h"
+#include "NoiseReductionKernel.h"
+#include "../d3d11rhi/RHIUniformBuffer.h"
+#include <memory>
+
+namespace LightroomCore {
+
+// 降噪节点：YCbCr 空间的快速引导滤波（见 NoiseReductionKernel）
+// GPU 路径在 1/2 分辨率的 FP16 纹理上依次执行：均值/平方 -> 盒式均值 -> 系数 a、b -> 盒式均值，
+// 最后在全分辨率上合成 q = a * I + b。强度为 0 时 IsIdentity() 返回 true，渲染图直接跳过该节点。
+class NoiseReductionNode : public RenderNode {
+public:
+    NoiseReductionNode(std::shared_ptr<RenderCore::DynamicRHI> rhi);
+    virtual ~NoiseReductionNode();
+
+    virtual bool Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                        std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                        uint32_t width, uint32_t height) override;
+
+    virtual const char* GetName() const override { return "NoiseReduction"; }
+    virtual uint64_t GetParamsHash() const override;
+    virtual int32_t GetTileApron() const override { return NoiseReductionKernel::GetSupportRadius(m_Strength); }
+    virtual bool IsIdentity() const override { return NoiseReductionKernel::IsIdentity(m_Strength); }
+    virtual void ReleaseResources() override;
+
+    // strength: 0 - 100
+    void SetStrength(float strength) { m_Strength = strength; }
+    float GetStrength() const { return m_Strength; }
+
+protected:
+    virtual void UpdateConstantBuffers(uint32_t width, uint32_t height) override;
+    virtual void SetConstantBuffers() override;
+    virtual void SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) override;
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) override;
+
+private:
+    enum class Pass : uint8_t {
+        Copy,
+        Mean,
+        Square,
+        BoxHorizontal,
+        BoxVertical,
+        CoeffA,
+        CoeffB,
+        Combine,
+        Count
+    };
+
+    bool InitializeShaderResources();
+    void CleanupShaderResources();
+    bool EnsureTextures(uint32_t lowWidth, uint32_t lowHeight);
+
+    // 以 pass 对应的 shader 绘制一次；extra0/extra1 绑定到 t1/t2
+    bool RunPass(Pass pass, std::shared_ptr<RenderCore::RHITexture2D> input,
+                 std::shared_ptr<RenderCore::RHITexture2D> output, uint32_t width, uint32_t height,
+                 std::shared_ptr<RenderCore::RHITexture2D> extra0 = nullptr,
+                 std::shared_ptr<RenderCore::RHITexture2D> extra1 = nullptr);
+    // 低分辨率纹理的原地盒式均值（经 m_ScratchTexture 水平 + 垂直两遍）
+    bool BoxFilter(std::shared_ptr<RenderCore::RHITexture2D> texture, uint32_t width, uint32_t height);
+
+    float m_Strength = 0.0f;
+
+    CompiledShader m_Shaders[static_cast<size_t>(Pass::Count)];
+    std::shared_ptr<RenderCore::RHIUniformBuffer> m_ParamsBuffer;
+    bool m_ShaderResourcesInitialized = false;
+
+    // 当前 pass 的状态（供钩子方法使用）
+    Pass m_Pass = Pass::Copy;
+    std::shared_ptr<RenderCore::RHITexture2D> m_ExtraTextures[2];
+
+    // 低分辨率中间纹理
+    std::shared_ptr<RenderCore::RHITexture2D> m_MeanTexture;    // 盒式均值 E[I]
+    std::shared_ptr<RenderCore::RHITexture2D> m_CorrTexture;    // 盒式均值 E[I^2]
+    std::shared_ptr<RenderCore::RHITexture2D> m_CoeffATexture;
+    std::shared_ptr<RenderCore::RHITexture2D> m_CoeffBTexture;
+    std::shared_ptr<RenderCore::RHITexture2D> m_ScratchTexture;
+};
+
+} // namespace LightroomCore
@@ -1,11 +1,13 @@
 ﻿#include "RenderNode.h"
 #include "../d3d11rhi/D3D11RHI.h"
 #include "../d3d11rhi/D3D11VertexBuffer.h"
+#include "../d3d11rhi/SoftwareRHI.h"
 #include "../d3d11rhi/RHI.h"
 #include "../d3d11rhi/Common.h"
 #include <d3dcompiler.h>
 #include <iostream>
 #include <cfloat>
+#include <cstring>
 
 #pragma comment(lib, "d3dcompiler.lib")
 
@@ -70,13 +72,37 @@ bool RenderNode::InitializeCommonResources() {
     return m_CommonResourcesInitialized;
 }
 
+bool RenderNode::IsSoftwareRHI() const {
+    return RenderCore::IsSoftwareRHI(m_RHI.get());
+}
+
+bool RenderNode::ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) {
+    std::cerr << "[RenderNode] " << GetName() << " has no CPU implementation" << std::endl;
+    return false;
+}
+
+void RenderNode::SetTileContext(uint32_t fullWidth, uint32_t fullHeight, int32_t offsetX, int32_t offsetY) {
+    m_TileFullWidth = fullWidth;
+    m_TileFullHeight = fullHeight;
+    m_TileOffsetX = offsetX;
+    m_TileOffsetY = offsetY;
+}
+
+uint64_t RenderNode::GetParamsHash() const {
+    const char* name = GetName();
+    return HashBytes(name, strlen(name));
+}
+
 void RenderNode::CleanupCommonResources() {
     m_CommonVertexBuffer.reset();
     m_CommonSamplerState.reset();
     m_CommonResourcesInitialized = false;
 }
 
-bool RenderNode::CompileShaders(const char* vsCode, const char* psCode, CompiledShader& outShader) {
+bool RenderNode::CompileShaders(const char* vsCode, const char* psCode, CompiledShader& outShader,
+                                const D3D_SHADER_MACRO* psDefines) {
     if (!m_RHI) {
         return false;
     }
@@ -113,7 +139,7 @@ bool RenderNode::CompileShaders(const char* vsCode, const char* psCode, Compiled
     // 编译 Pixel Shader
     Microsoft::WRL::ComPtr<ID3DBlob> psBlob;
     errorBlob.Reset();
-    hr = D3DCompile(psCode, strlen(psCode), nullptr, nullptr, nullptr, "main", "ps_5_0", 0, 0, 
+    hr = D3DCompile(psCode, strlen(psCode), nullptr, psDefines, nullptr, "main", "ps_5_0", 0, 0, 
                     &psBlob, &errorBlob);
     if (FAILED(hr)) {
         if (errorBlob) {
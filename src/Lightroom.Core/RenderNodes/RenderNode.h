@@ -7,11 +7,28 @@
 #include "../d3d11rhi/RHIState.h"
 #include "../d3d11rhi/RHIUniformBuffer.h"
 #include <memory>
+#include <cstdint>
 #include <wrl/client.h>
 #include <d3d11.h>
 
 namespace LightroomCore {
 
+// FNV-1a 64 位哈希，用于节点参数哈希与 RenderGraph 缓存键
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template <typename T>
+inline uint64_t HashValue(const T& value, uint64_t seed) {
+    return HashBytes(&value, sizeof(T), seed);
+}
+
 // 简单的顶点结构（全屏四边形）
 struct SimpleVertex {
     float Position[2];
@@ -35,7 +52,41 @@ public:
     // 获取节点名称（用于调试）
     virtual const char* GetName() const = 0;
 
+    // 参数哈希：参数不变时返回相同的值，RenderGraph 据此复用该节点的输出
+    // 默认只包含节点名称，有参数的子类需要把参数混入哈希
+    virtual uint64_t GetParamsHash() const;
+
+    // 分块执行所需的邻域像素数（每个方向）
+    // 返回 -1 表示节点依赖整幅图像（例如视图缩放/平移），不能分块执行
+    virtual int32_t GetTileApron() const { return -1; }
+
+    // 当前参数下输出与输入完全相同（例如强度为 0）时返回 true，RenderGraph 会跳过该节点
+    // 跳过的节点仍需能正确执行（作为最后一个节点时总是执行）
+    virtual bool IsIdentity() const { return false; }
+
+    // 释放节点内部可以重建的纹理（内存预算回收时调用），下次执行时按需重新创建
+    virtual void ReleaseResources() {}
+
+    // 把紧随其后的执行节点合并到本节点中（例如颜色调整与滤镜 LUT 编译为同一张 LUT）
+    // RenderGraph 每次执行前调用；返回 true 时 next 不再执行，本节点的输出等同于 next 的输出
+    // next 为 nullptr 或返回 false 时本节点按自身参数执行
+    virtual bool FoldNext(std::shared_ptr<RenderNode> next) { return false; }
+
+    // 分块执行上下文：完整图像尺寸与当前块（含邻域）左上角在完整图像中的位置
+    // fullWidth/fullHeight 为 0 表示非分块执行，节点使用 Execute 传入的尺寸
+    void SetTileContext(uint32_t fullWidth, uint32_t fullHeight, int32_t offsetX, int32_t offsetY);
+    void ClearTileContext() { SetTileContext(0, 0, 0, 0); }
+
 protected:
+    // 当前 RHI 是否为 CPU 软件后端（无 GPU 的机器上使用）
+    bool IsSoftwareRHI() const;
+
+    // 软件 RHI 下的 CPU 实现（输入/输出均为 SoftwareTexture2D）
+    // 子类在 Execute 中检测到软件 RHI 时调用；默认不支持，返回 false
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height);
+
     // 初始化公共资源（全屏四边形顶点缓冲区、采样器状态）
     bool InitializeCommonResources();
     void CleanupCommonResources();
@@ -47,7 +98,9 @@ protected:
         Microsoft::WRL::ComPtr<ID3D11PixelShader> PS;
         Microsoft::WRL::ComPtr<ID3D11InputLayout> InputLayout;
     };
-    bool CompileShaders(const char* vsCode, const char* psCode, CompiledShader& outShader);
+    // psDefines：pixel shader 的预处理宏（以 { nullptr, nullptr } 结尾），用于编译同一份代码的不同变体
+    bool CompileShaders(const char* vsCode, const char* psCode, CompiledShader& outShader,
+                        const D3D_SHADER_MACRO* psDefines = nullptr);
 
     // 通用的渲染设置
     virtual void SetupRenderState(ID3D11DeviceContext* d3d11Context,
@@ -69,6 +122,12 @@ protected:
     bool m_CommonResourcesInitialized = false;
 
     CompiledShader* m_CurrentShader = nullptr;
+
+    // 分块执行上下文（见 SetTileContext）
+    uint32_t m_TileFullWidth = 0;
+    uint32_t m_TileFullHeight = 0;
+    int32_t m_TileOffsetX = 0;
+    int32_t m_TileOffsetY = 0;
 };
 
 } // namespace LightroomCore
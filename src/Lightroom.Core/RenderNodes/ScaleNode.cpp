@@ -1,6 +1,7 @@
 ﻿#include "ScaleNode.h"
 #include "../d3d11rhi/D3D11RHI.h"
 #include "../d3d11rhi/D3D11VertexBuffer.h"
+#include "SoftwareNodeUtils.h"
 #include "../d3d11rhi/RHI.h"
 #include "../d3d11rhi/Common.h"
 #include <d3dcompiler.h>
@@ -41,7 +42,7 @@ ScaleNode::~ScaleNode() {
 }
 
 bool ScaleNode::InitializeShaderResources() {
-    if (m_ShaderResourcesInitialized || !m_RHI) {
+    if (m_ShaderResourcesInitialized || !m_RHI || IsSoftwareRHI()) {
         return m_ShaderResourcesInitialized;
     }
 
@@ -158,13 +159,16 @@ void ScaleNode::SetInputImageSize(uint32_t width, uint32_t height) {
     m_InputImageHeight = height;
 }
 
-void ScaleNode::UpdateConstantBuffers(uint32_t width, uint32_t height) {
-    uint32_t outputWidth = width;
-    uint32_t outputHeight = height;
-    if (!m_ConstantBuffer || !m_CommandContext) {
-        return;
-    }
+uint64_t ScaleNode::GetParamsHash() const {
+    uint64_t hash = RenderNode::GetParamsHash();
+    hash = HashValue(m_ZoomLevel, hash);
+    hash = HashValue(m_PanX, hash);
+    hash = HashValue(m_PanY, hash);
+    hash = HashValue(m_InputImageWidth, hash);
+    return HashValue(m_InputImageHeight, hash);
+}
 
+float ScaleNode::ComputeFitScale(uint32_t outputWidth, uint32_t outputHeight) const {
     // 计算保持宽高比的自适应缩放比例（以长边自适应）
     // FitScale = min(输出宽度/输入宽度, 输出高度/输入高度)
     // 这样确保图片完全显示在输出区域内，短边会有黑边
@@ -174,6 +178,17 @@ void ScaleNode::UpdateConstantBuffers(uint32_t width, uint32_t height) {
         float scaleY = static_cast<float>(outputHeight) / static_cast<float>(m_InputImageHeight);
         fitScale = (scaleX < scaleY) ? scaleX : scaleY;  // 取较小值，确保图片完全显示
     }
+    return fitScale;
+}
+
+void ScaleNode::UpdateConstantBuffers(uint32_t width, uint32_t height) {
+    uint32_t outputWidth = width;
+    uint32_t outputHeight = height;
+    if (!m_ConstantBuffer || !m_CommandContext) {
+        return;
+    }
+
+    float fitScale = ComputeFitScale(outputWidth, outputHeight);
 
     ScaleConstantBuffer cbData;
     cbData.ZoomLevel = static_cast<float>(m_ZoomLevel);
@@ -208,6 +223,10 @@ void ScaleNode::SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inp
 bool ScaleNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
                         std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
                         uint32_t width, uint32_t height) {
+    if (IsSoftwareRHI()) {
+        return ExecuteSoftware(inputTexture, outputTarget, width, height);
+    }
+
     if (!m_ShaderResourcesInitialized) {
         return false;
     }
@@ -220,5 +239,57 @@ bool ScaleNode::Execute(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
     return RenderNode::Execute(inputTexture, outputTarget, width, height);
 }
 
+bool ScaleNode::ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                uint32_t width, uint32_t height) {
+    RenderCore::SoftwareTexture2D* input = GetSoftwareTexture(inputTexture);
+    RenderCore::SoftwareTexture2D* output = GetSoftwareTexture(outputTarget);
+    if (!IsSoftwareBGRA8Pair(input, output, width, height) || width == 0 || height == 0) {
+        return false;
+    }
+
+    // 与 Vertex Shader 相同的映射：输出像素 -> 归一化屏幕坐标 -> 图片坐标 -> 纹理坐标
+    // 该映射在 x/y 上都是线性的，因此每列/每行的纹理坐标可以预先算好
+    const float fitScale = ComputeFitScale(width, height);
+    const float inputWidth = static_cast<float>(m_InputImageWidth > 0 ? m_InputImageWidth : input->GetSize().x);
+    const float inputHeight = static_cast<float>(m_InputImageHeight > 0 ? m_InputImageHeight : input->GetSize().y);
+    const float displayX = (inputWidth * fitScale) / static_cast<float>(width);
+    const float displayY = (inputHeight * fitScale) / static_cast<float>(height);
+    const float zoom = static_cast<float>(m_ZoomLevel);
+
+    auto toTexCoord = [zoom](float screen, float displaySize, float pan) {
+        return ((screen / displaySize) / zoom + pan) * 0.5f + 0.5f;
+    };
+
+    std::vector<float> texU(width);
+    for (uint32_t x = 0; x < width; ++x) {
+        const float screenX = ((x + 0.5f) / width - 0.5f) * 2.0f;
+        texU[x] = toTexCoord(screenX, displayX, static_cast<float>(m_PanX));
+    }
+
+    const float texelScaleX = static_cast<float>(input->GetSize().x);
+    const float texelScaleY = static_cast<float>(input->GetSize().y);
+
+    RenderCore::SoftwareTaskPool::Get().ParallelForRows(static_cast<int32_t>(height), 16, [&](int32_t rowBegin, int32_t rowEnd) {
+        for (int32_t y = rowBegin; y < rowEnd; ++y) {
+            const float screenY = ((y + 0.5f) / height - 0.5f) * 2.0f;
+            const float v = toTexCoord(screenY, displayY, static_cast<float>(m_PanY));
+            uint8_t* dst = output->GetRow(y);
+
+            for (uint32_t x = 0; x < width; ++x, dst += 4) {
+                const float u = texU[x];
+                // 超出图片范围：黑色
+                if (u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f) {
+                    dst[0] = 0; dst[1] = 0; dst[2] = 0; dst[3] = 255;
+                    continue;
+                }
+                SampleBilinearBGRA8(input, u * texelScaleX, v * texelScaleY, dst);
+            }
+        }
+    });
+
+    return true;
+}
+
 } // namespace LightroomCore
 
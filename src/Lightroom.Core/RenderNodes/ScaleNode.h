@@ -23,6 +23,7 @@ public:
                         uint32_t width, uint32_t height) override;
 
     virtual const char* GetName() const override { return "Scale"; }
+    virtual uint64_t GetParamsHash() const override;
 
     // 设置缩放参数
     // zoomLevel: 缩放级别（1.0 = 100%, 2.0 = 200%, 0.5 = 50%）
@@ -37,8 +38,14 @@ protected:
     virtual void UpdateConstantBuffers(uint32_t width, uint32_t height) override;
     virtual void SetConstantBuffers() override;
     virtual void SetShaderResources(std::shared_ptr<RenderCore::RHITexture2D> inputTexture) override;
+    virtual bool ExecuteSoftware(std::shared_ptr<RenderCore::RHITexture2D> inputTexture,
+                                 std::shared_ptr<RenderCore::RHITexture2D> outputTarget,
+                                 uint32_t width, uint32_t height) override;
 
 private:
+    // 自适应缩放比例（GPU/CPU 路径共用）
+    float ComputeFitScale(uint32_t outputWidth, uint32_t outputHeight) const;
+
     bool InitializeShaderResources();
     void CleanupShaderResources();
 
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include "../d3d11rhi/SoftwareRHI.h"
+#include "../d3d11rhi/SoftwareTexture2D.h"
+#include "../d3d11rhi/SoftwareTaskPool.h"
+#include <memory>
+#include <cstdint>
+
+namespace LightroomCore {
+
+// 软件 RHI 下节点 CPU 实现的公共辅助函数
+
+// 取出 CPU 纹理（非软件 RHI 纹理返回 nullptr）
+inline RenderCore::SoftwareTexture2D* GetSoftwareTexture(const std::shared_ptr<RenderCore::RHITexture2D>& texture) {
+    return dynamic_cast<RenderCore::SoftwareTexture2D*>(texture.get());
+}
+
+// 检查输入/输出是否为 BGRA8 CPU 纹理，且输出尺寸不小于 width x height
+inline bool IsSoftwareBGRA8Pair(RenderCore::SoftwareTexture2D* input, RenderCore::SoftwareTexture2D* output,
+                                uint32_t width, uint32_t height) {
+    if (!input || !output) {
+        return false;
+    }
+    if (input->GetPixelFormat() != RenderCore::PF_B8G8R8A8 || output->GetPixelFormat() != RenderCore::PF_B8G8R8A8) {
+        return false;
+    }
+    return output->GetSize().x >= static_cast<int32_t>(width) && output->GetSize().y >= static_cast<int32_t>(height);
+}
+
+// 双线性采样 BGRA8（clamp 寻址，坐标为纹素空间，像素中心在 +0.5）
+inline void SampleBilinearBGRA8(const RenderCore::SoftwareTexture2D* texture, float x, float y, uint8_t outPixel[4]) {
+    const int32_t w = texture->GetSize().x;
+    const int32_t h = texture->GetSize().y;
+    x -= 0.5f;
+    y -= 0.5f;
+    int32_t x0 = static_cast<int32_t>(x < 0.0f ? x - 1.0f : x);
+    int32_t y0 = static_cast<int32_t>(y < 0.0f ? y - 1.0f : y);
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+    const int32_t x1 = math::Clamp(x0 + 1, 0, w - 1);
+    const int32_t y1 = math::Clamp(y0 + 1, 0, h - 1);
+    x0 = math::Clamp(x0, 0, w - 1);
+    y0 = math::Clamp(y0, 0, h - 1);
+
+    const uint8_t* row0 = texture->GetRow(y0);
+    const uint8_t* row1 = texture->GetRow(y1);
+    const uint8_t* p00 = row0 + x0 * 4;
+    const uint8_t* p10 = row0 + x1 * 4;
+    const uint8_t* p01 = row1 + x0 * 4;
+    const uint8_t* p11 = row1 + x1 * 4;
+    for (int c = 0; c < 4; ++c) {
+        const float top = p00[c] + (p10[c] - p00[c]) * fx;
+        const float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+        outPixel[c] = static_cast<uint8_t>(top + (bottom - top) * fy + 0.5f);
+    }
+}
+
+} // namespace LightroomCore
@@ -3,6 +3,8 @@
 #include "d3d11rhi/D3D11Texture2D.h"
 #include "d3d11rhi/D3D11RenderTarget.h"
 #include "d3d11rhi/RHIRenderTarget.h"
+#include "d3d11rhi/RHICommandContext.h"
+#include "d3d11rhi/SoftwareRHI.h"
 #include "d3d11rhi/Common.h"
 #include <dxgi.h>
 #include <wrl/client.h>
@@ -32,6 +34,22 @@ namespace LightroomCore {
 			return false;
 		}
 
+		// 软件 RHI：缓冲区位于系统内存，没有共享句柄/D3D9 Surface（无界面的批处理场景）
+		if (IsSoftwareRHI(m_RHI.get())) {
+			buffer->RHIRenderTarget = m_RHI->RHICreateRenderTarget(EPixelFormat::PF_B8G8R8A8, width, height, 1, false, false);
+			if (!buffer->RHIRenderTarget) {
+				return false;
+			}
+			buffer->RHITexture = buffer->RHIRenderTarget->GetTex();
+			buffer->D3D11SharedTexture.Reset();
+			buffer->D3D11SharedRTV.Reset();
+			buffer->D3D11SharedHandle = nullptr;
+			buffer->D3D9SharedSurface.Reset();
+			buffer->Width = width;
+			buffer->Height = height;
+			return true;
+		}
+
 		// Front Buffer需要D3D9 Surface，需要检查D3D9Interop
 		if (createD3D9Surface) {
 			if (!m_D3D9Interop || !m_D3D9Interop->IsInitialized()) {
@@ -107,6 +125,10 @@ namespace LightroomCore {
 
 		buffer->RHIRenderTarget = d3d11RenderTarget;
 		buffer->RHITexture = buffer->RHIRenderTarget->GetTex();
+		// 原生创建的纹理不经过 RHICreateTexture2D，在这里计入纹理内存统计
+		if (buffer->RHITexture) {
+			buffer->RHITexture->TrackMemory(RHITexture2D::ComputeTextureBytes(EPixelFormat::PF_B8G8R8A8, width, height), false);
+		}
 
 		buffer->Width = width;
 		buffer->Height = height;
@@ -120,7 +142,19 @@ namespace LightroomCore {
 	// 如果尺寸不同，只复制重叠区域；实际渲染会在resize后立即进行
 	// -----------------------------------------------------------------------------
 	bool RenderTargetManager::CopyBufferContent(BufferResources* srcBuffer, BufferResources* dstBuffer) {
-		if (!srcBuffer || !dstBuffer || !srcBuffer->D3D11SharedTexture || !dstBuffer->D3D11SharedTexture) {
+		if (!srcBuffer || !dstBuffer || !srcBuffer->RHITexture || !dstBuffer->RHITexture) {
+			return false;
+		}
+
+		if (IsSoftwareRHI(m_RHI.get())) {
+			uint32_t copyWidth = std::min(srcBuffer->Width, dstBuffer->Width);
+			uint32_t copyHeight = std::min(srcBuffer->Height, dstBuffer->Height);
+			m_RHI->GetDefaultCommandContext()->RHICopyResource2D(
+				dstBuffer->RHITexture, srcBuffer->RHITexture, core::vec4u(0, 0, copyWidth, copyHeight));
+			return true;
+		}
+
+		if (!srcBuffer->D3D11SharedTexture || !dstBuffer->D3D11SharedTexture) {
 			return false;
 		}
 
@@ -232,7 +266,7 @@ namespace LightroomCore {
 		// 保存旧Front Buffer的内容（用于复制）
 		// 重要：必须先移动到临时变量，因为InitBufferResources会覆盖原内容
 		BufferResources oldFront = std::move(info->FrontBuffer);
-		bool hasContent = oldFront.D3D11SharedTexture != nullptr && 
+		bool hasContent = oldFront.RHITexture != nullptr && 
 		                  oldFront.Width > 0 && oldFront.Height > 0;
 
 		// 重新初始化Front Buffer（WPF使用的固定缓冲区）
@@ -296,7 +330,7 @@ namespace LightroomCore {
 		
 		// 返回当前Back Buffer的纹理
 		BufferResources* backBuffer = &info->BackBuffers[info->CurrentBackBuffer];
-		if (!backBuffer->D3D11SharedTexture) {
+		if (!backBuffer->RHITexture) {
 			return nullptr;
 		}
 		
@@ -319,7 +353,7 @@ namespace LightroomCore {
 		
 		// 确保Back Buffer已初始化（Back Buffer不需要D3D9 Surface）
 		BufferResources* backBuffer = &info->BackBuffers[info->CurrentBackBuffer];
-		if (!backBuffer->D3D11SharedTexture || 
+		if (!backBuffer->RHITexture || 
 		    backBuffer->Width != info->Width ||
 		    backBuffer->Height != info->Height) {
 			// 需要初始化Back Buffer（不需要D3D9 Surface）
@@ -338,6 +372,15 @@ namespace LightroomCore {
 		}
 
 		BufferResources* backBuffer = &info->BackBuffers[info->CurrentBackBuffer];
+		if (!backBuffer->RHITexture || !info->FrontBuffer.RHITexture) {
+			return false;
+		}
+
+		if (IsSoftwareRHI(m_RHI.get())) {
+			m_RHI->GetDefaultCommandContext()->RHICopyResource(info->FrontBuffer.RHITexture, backBuffer->RHITexture);
+			return true;
+		}
+
 		if (!backBuffer->D3D11SharedTexture || !info->FrontBuffer.D3D11SharedTexture) {
 			return false;
 		}
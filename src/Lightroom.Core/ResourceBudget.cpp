@@ -0,0 +1,125 @@
+﻿#include "ResourceBudget.h"
+#include <iostream>
+#include <vector>
+
+namespace LightroomCore {
+
+ResourceBudget& ResourceBudget::Get() {
+    static ResourceBudget budget;
+    return budget;
+}
+
+ResourceBudget::ResourceBudget()
+    : m_Budget(kDefaultBudget)
+    , m_EvictionCount(0)
+{
+}
+
+uint64_t ResourceBudget::GetTrackedBytes() {
+    const RenderCore::RHITextureMemoryStats stats = RenderCore::RHITexture2D::GetMemoryStats();
+    return stats.GPUBytes + stats.SystemBytes;
+}
+
+void ResourceBudget::SetBudget(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Budget = bytes;
+}
+
+uint64_t ResourceBudget::GetBudget() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Budget;
+}
+
+void ResourceBudget::Register(const void* owner, EvictCallback evict) {
+    if (!owner || !evict) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(owner);
+    if (it != m_Entries.end()) {
+        m_LRU.erase(it->second);
+    }
+    m_LRU.push_front(Entry{ owner, std::move(evict), false });
+    m_Entries[owner] = m_LRU.begin();
+}
+
+void ResourceBudget::Unregister(const void* owner) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(owner);
+    if (it != m_Entries.end()) {
+        m_LRU.erase(it->second);
+        m_Entries.erase(it);
+    }
+}
+
+void ResourceBudget::Touch(const void* owner) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(owner);
+    if (it != m_Entries.end()) {
+        it->second->bEvicted = false;
+        m_LRU.splice(m_LRU.begin(), m_LRU, it->second);
+    }
+}
+
+uint32_t ResourceBudget::Enforce(const void* keep) {
+    // 回调在锁外执行：释放纹理不需要持有锁，回调中也可能登记/注销其他缓存
+    std::vector<std::pair<const void*, EvictCallback>> candidates;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Budget == 0 || GetTrackedBytes() <= m_Budget) {
+            return 0;
+        }
+
+        // 从最久未使用的开始
+        for (auto it = m_LRU.rbegin(); it != m_LRU.rend(); ++it) {
+            if (it->Owner != keep && !it->bEvicted) {
+                candidates.emplace_back(it->Owner, it->Evict);
+            }
+        }
+    }
+
+    const uint64_t budget = GetBudget();
+    std::vector<const void*> evictedOwners;
+    for (const auto& candidate : candidates) {
+        if (GetTrackedBytes() <= budget) {
+            break;
+        }
+        candidate.second();
+        evictedOwners.push_back(candidate.first);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const void* owner : evictedOwners) {
+            auto it = m_Entries.find(owner);
+            if (it != m_Entries.end()) {
+                it->second->bEvicted = true;
+            }
+        }
+        m_EvictionCount += evictedOwners.size();
+    }
+
+    const uint32_t evicted = static_cast<uint32_t>(evictedOwners.size());
+    if (evicted > 0) {
+        std::cerr << "[ResourceBudget] Evicted " << evicted << " cache(s), "
+                  << (GetTrackedBytes() >> 20) << " MB in use" << std::endl;
+    }
+    return evicted;
+}
+
+ResourceMemoryStats ResourceBudget::GetStats() const {
+    const RenderCore::RHITextureMemoryStats textureStats = RenderCore::RHITexture2D::GetMemoryStats();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ResourceMemoryStats stats;
+    stats.GPUBytes = textureStats.GPUBytes;
+    stats.SystemBytes = textureStats.SystemBytes;
+    stats.TextureCount = textureStats.TextureCount;
+    stats.BudgetBytes = m_Budget;
+    stats.EvictableCount = static_cast<uint32_t>(m_Entries.size());
+    stats.EvictionCount = m_EvictionCount;
+    return stats;
+}
+
+} // namespace LightroomCore
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "d3d11rhi/RHITexture2D.h"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace LightroomCore {
+
+// 纹理内存统计（字节）
+struct ResourceMemoryStats {
+    uint64_t GPUBytes = 0;          // D3D11 纹理与渲染目标
+    uint64_t SystemBytes = 0;       // 软件 RHI 纹理
+    uint32_t TextureCount = 0;
+    uint64_t BudgetBytes = 0;       // 0 表示不限制
+    uint32_t EvictableCount = 0;    // 已登记的可回收缓存数量
+    uint64_t EvictionCount = 0;     // 累计回收次数
+};
+
+// 进程级纹理内存预算
+// 纹理字节数由 RHI 在创建纹理时记录（RHITexture2D::TrackMemory），这里只负责按最近使用顺序回收：
+// 每个渲染目标把可以重建的资源（渲染图中间结果、节点内部纹理、代理金字塔）登记为一个可回收缓存，
+// 总量超过预算时从最久未使用的缓存开始回收，回收后的资源在该渲染目标下次渲染时按需重新创建。
+// 多窗格对比和长时间使用时，不可见窗格的缓存会让位给当前窗格，内存不再无限增长。
+// 预算只覆盖这些可重建的缓存：源纹理（解码后的图片、当前视频帧）需要重新解码才能恢复，不登记也不回收，
+// 但计入统计的总量，因此源纹理本身较大时总量仍可能高于预算。
+class ResourceBudget {
+public:
+    using EvictCallback = std::function<void()>;
+
+    static ResourceBudget& Get();
+
+    // 预算（字节，GPU 与系统内存纹理合计），0 表示不限制
+    void SetBudget(uint64_t bytes);
+    uint64_t GetBudget() const;
+
+    // 登记 / 注销可回收缓存；evict 释放 owner 持有的可重建纹理
+    void Register(const void* owner, EvictCallback evict);
+    void Unregister(const void* owner);
+
+    // 标记 owner 为最近使用
+    void Touch(const void* owner);
+
+    // 超出预算时按最近最少使用的顺序回收，keep（正在使用的缓存）不回收
+    // 只在渲染线程的安全点调用（渲染图执行之前），回收回调不会与渲染交错
+    // 返回回收的缓存数量
+    uint32_t Enforce(const void* keep);
+
+    ResourceMemoryStats GetStats() const;
+
+    static constexpr uint64_t kDefaultBudget = 2ull * 1024 * 1024 * 1024;
+
+private:
+    ResourceBudget();
+
+    static uint64_t GetTrackedBytes();
+
+    struct Entry {
+        const void* Owner;
+        EvictCallback Evict;
+        bool bEvicted;  // 回收后未再使用，不需要再次回收
+    };
+
+    mutable std::mutex m_Mutex;
+    uint64_t m_Budget;
+    uint64_t m_EvictionCount;
+    std::list<Entry> m_LRU;  // 头部为最近使用
+    std::unordered_map<const void*, std::list<Entry>::iterator> m_Entries;
+};
+
+} // namespace LightroomCore
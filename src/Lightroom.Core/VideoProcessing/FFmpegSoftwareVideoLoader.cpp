@@ -5,6 +5,7 @@
 #include "../d3d11rhi/D3D11Texture2D.h"
 #include "../d3d11rhi/Common.h"
 #include "../RenderNodes/YUVToRGBNode.h"
+#include "../ImageProcessing/TiledImage.h"
 #include <iostream>
 #include <algorithm>
 #include <cstring>
@@ -32,11 +33,17 @@ namespace LightroomCore {
         : m_FormatContext(nullptr)
         , m_CodecContext(nullptr)
         , m_Frame(nullptr)
-        , m_ConvertedFrame(nullptr)
         , m_SwsContext(nullptr)
         , m_VideoStreamIndex(-1)
         , m_CurrentFrameIndex(0)
+        , m_DecodeFrameIndex(0)
         , m_IsOpen(false)
+        , m_QueueCapacity(kDefaultVideoDecodeQueueCapacity)
+        , m_StopDecoding(false)
+        , m_DecodeFinished(false)
+        , m_QueuePrimed(false)
+        , m_FramesDecoded(0)
+        , m_Underruns(0)
         , m_CachedYUVToRGBNode(nullptr)
         , m_CachedRHI(nullptr)
         , m_CachedRGBTexture(nullptr)
@@ -135,6 +142,9 @@ namespace LightroomCore {
             return false;
         }
 
+        // 多线程解码（线程数由 FFmpeg 按 CPU 自动选择），帧级多线程增加的延迟由解码队列吸收
+        m_CodecContext->thread_count = 0;
+
         // Open codec
         if (avcodec_open2(m_CodecContext, codec, nullptr) < 0) {
             Close();
@@ -143,8 +153,7 @@ namespace LightroomCore {
 
         // Allocate frames
         m_Frame = av_frame_alloc();
-        m_ConvertedFrame = av_frame_alloc();
-        if (!m_Frame || !m_ConvertedFrame) {
+        if (!m_Frame) {
             Close();
             return false;
         }
@@ -163,9 +172,12 @@ namespace LightroomCore {
         m_FrameDuration = av_q2d(av_inv_q(videoStream->r_frame_rate)) * 1000000.0;  // microseconds
 
         m_CurrentFrameIndex = 0;
+        m_DecodeFrameIndex = 0;
+        m_FramesDecoded = 0;
+        m_Underruns = 0;
         m_IsOpen = true;
 
-
+        StartDecodeThread();
         return true;
     }
 
@@ -182,14 +194,21 @@ namespace LightroomCore {
             return false;
         }
 
+        // 停止解码线程并丢弃队列中按旧位置解码的帧
+        StopDecodeThread();
+
         int64_t seekTarget = av_rescale_q(timestamp, { 1, 1000000 }, m_TimeBase);
         if (av_seek_frame(m_FormatContext, m_VideoStreamIndex, seekTarget, AVSEEK_FLAG_BACKWARD) < 0) {
+            // 定位失败：从解码器当前位置继续
+            StartDecodeThread();
             return false;
         }
 
-                avcodec_flush_buffers(m_CodecContext);
+        avcodec_flush_buffers(m_CodecContext);
         m_CurrentFrameIndex = (int64_t)((double)timestamp / m_FrameDuration);
+        m_DecodeFrameIndex = m_CurrentFrameIndex;
 
+        StartDecodeThread();
         return true;
     }
 
@@ -208,6 +227,16 @@ namespace LightroomCore {
             return false;
         }
 
+        // 先取出解码器中已缓存的帧（一个包可能产生多帧，多线程解码也会延迟输出）
+        int ret = avcodec_receive_frame(m_CodecContext, m_Frame);
+        if (ret == 0) {
+            return true;
+        }
+        if (ret != AVERROR(EAGAIN)) {
+            // AVERROR_EOF：已冲刷完毕，没有更多帧
+            return false;
+        }
+
         AVPacket* packet = av_packet_alloc();
         if (!packet) {
             return false;
@@ -216,25 +245,15 @@ namespace LightroomCore {
         int readRet = 0;
         while ((readRet = av_read_frame(m_FormatContext, packet)) >= 0) {
             if (packet->stream_index == m_VideoStreamIndex) {
-                // 检查 codec context 是否有效
-                if (!m_CodecContext || m_CodecContext->codec_id == AV_CODEC_ID_NONE) {
-                    av_packet_unref(packet);
-                    break;
-                }
-
+                // 解码器的输出已取空，这里不会返回 EAGAIN
                 int sendRet = avcodec_send_packet(m_CodecContext, packet);
                 av_packet_unref(packet);
-
                 if (sendRet < 0) {
-                    // 如果是 EAGAIN，需要继续读取更多数据
-                    if (sendRet == AVERROR(EAGAIN)) {
-                        continue;
-                    }
-                    // 其他错误，停止解码
+                    // 解码错误，停止解码
                     break;
                 }
 
-                int ret = avcodec_receive_frame(m_CodecContext, m_Frame);
+                ret = avcodec_receive_frame(m_CodecContext, m_Frame);
                 if (ret == 0) {
                     av_packet_free(&packet);
                     return true;
@@ -243,10 +262,6 @@ namespace LightroomCore {
                     // 需要更多输入数据，继续读取
                     continue;
                 }
-                else if (ret == AVERROR_EOF) {
-                    // 解码器已刷新，没有更多帧
-                    break;
-                }
                 else {
                     // 其他错误，停止解码
                     break;
@@ -256,11 +271,156 @@ namespace LightroomCore {
                 av_packet_unref(packet);
             }
         }
-
         av_packet_free(&packet);
+
+        // 文件读完：冲刷解码器，取出其中剩余的帧（后续调用由开头的 receive 继续取）
+        if (readRet == AVERROR_EOF) {
+            avcodec_send_packet(m_CodecContext, nullptr);
+            return avcodec_receive_frame(m_CodecContext, m_Frame) == 0;
+        }
         return false;
     }
 
+    AVFrame* FFmpegSoftwareVideoLoader::CreateQueuedFrame() {
+        if (m_Frame->width <= 0 || m_Frame->height <= 0) {
+            return nullptr;
+        }
+
+        // YUV420P：只增加引用计数，不复制像素
+        if (m_Frame->format == AV_PIX_FMT_YUV420P) {
+            return av_frame_clone(m_Frame);
+        }
+
+        // 其他格式转换为 YUV420P（只做格式转换，颜色转换在 GPU 上）
+        ScopedTimer timer("FormatConversion", m_DecodeFrameIndex);
+        m_SwsContext = sws_getCachedContext(m_SwsContext,
+            m_Frame->width, m_Frame->height, static_cast<AVPixelFormat>(m_Frame->format),
+            m_Frame->width, m_Frame->height, AV_PIX_FMT_YUV420P,
+            SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!m_SwsContext) {
+            return nullptr;
+        }
+
+        AVFrame* converted = av_frame_alloc();
+        if (!converted) {
+            return nullptr;
+        }
+        converted->format = AV_PIX_FMT_YUV420P;
+        converted->width = m_Frame->width;
+        converted->height = m_Frame->height;
+        if (av_frame_get_buffer(converted, 32) < 0) {
+            av_frame_free(&converted);
+            return nullptr;
+        }
+
+        // Convert format (e.g., YUVA444P12LE -> YUV420P)
+        sws_scale(m_SwsContext,
+            m_Frame->data, m_Frame->linesize, 0, m_Frame->height,
+            converted->data, converted->linesize);
+        return converted;
+    }
+
+    void FFmpegSoftwareVideoLoader::StartDecodeThread() {
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_StopDecoding = false;
+            m_DecodeFinished = false;
+            m_QueuePrimed = false;
+        }
+        m_DecodeThread = std::thread(&FFmpegSoftwareVideoLoader::DecodeThreadLoop, this);
+    }
+
+    void FFmpegSoftwareVideoLoader::StopDecodeThread() {
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_StopDecoding = true;
+        }
+        m_QueueNotFull.notify_all();
+        if (m_DecodeThread.joinable()) {
+            m_DecodeThread.join();
+        }
+
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        for (auto& queued : m_FrameQueue) {
+            av_frame_free(&queued.Frame);
+        }
+        m_FrameQueue.clear();
+        m_DecodeFinished = true;
+        m_QueueNotEmpty.notify_all();
+    }
+
+    void FFmpegSoftwareVideoLoader::DecodeThreadLoop() {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_QueueMutex);
+                m_QueueNotFull.wait(lock, [this]() {
+                    return m_StopDecoding || m_FrameQueue.size() < m_QueueCapacity;
+                });
+                if (m_StopDecoding) {
+                    break;
+                }
+            }
+
+            // 解码不持有队列锁，渲染线程可以同时取帧
+            AVFrame* queuedFrame = nullptr;
+            {
+                ScopedTimer timer("DecodeFrame", m_DecodeFrameIndex);
+                if (DecodeFrame()) {
+                    queuedFrame = CreateQueuedFrame();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            if (!queuedFrame) {
+                m_DecodeFinished = true;
+                m_QueueNotEmpty.notify_all();
+                break;
+            }
+            m_FrameQueue.push_back({ queuedFrame, m_DecodeFrameIndex++ });
+            ++m_FramesDecoded;
+            m_QueueNotEmpty.notify_one();
+        }
+    }
+
+    bool FFmpegSoftwareVideoLoader::PopQueuedFrame(QueuedFrame& outFrame) {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        if (m_FrameQueue.empty() && !m_DecodeFinished) {
+            // 打开/定位后的第一帧本来就需要等待，不计入
+            if (m_QueuePrimed) {
+                ++m_Underruns;
+            }
+            m_QueueNotEmpty.wait(lock, [this]() { return !m_FrameQueue.empty() || m_DecodeFinished; });
+        }
+        if (m_FrameQueue.empty()) {
+            return false;
+        }
+
+        outFrame = m_FrameQueue.front();
+        m_FrameQueue.pop_front();
+        m_QueuePrimed = true;
+        lock.unlock();
+        m_QueueNotFull.notify_one();
+        return true;
+    }
+
+    void FFmpegSoftwareVideoLoader::SetDecodeQueueCapacity(uint32_t capacity) {
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_QueueCapacity = std::max(1u, capacity);
+        }
+        // 容量变小时队列自然消耗到新容量以下，不丢弃已解码的帧
+        m_QueueNotFull.notify_all();
+    }
+
+    bool FFmpegSoftwareVideoLoader::GetDecodeQueueStats(VideoDecodeQueueStats& stats) const {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        stats.queueDepth = static_cast<uint32_t>(m_FrameQueue.size());
+        stats.queueCapacity = m_QueueCapacity;
+        stats.framesDecoded = m_FramesDecoded;
+        stats.underruns = m_Underruns;
+        return true;
+    }
+
     bool FFmpegSoftwareVideoLoader::EnsureYUVTextures(std::shared_ptr<RenderCore::DynamicRHI> rhi, 
                                                        uint32_t width, uint32_t height,
                                                        uint32_t yWidth, uint32_t yHeight,
@@ -338,74 +498,36 @@ namespace LightroomCore {
             return nullptr;
         }
 
+        // 从解码队列取帧；队列为空时等待解码线程
+        QueuedFrame queued;
         {
-            ScopedTimer timer("DecodeFrame", m_CurrentFrameIndex);
-            if (!DecodeFrame()) {
+            ScopedTimer timer("WaitDecodedFrame", m_CurrentFrameIndex);
+            if (!PopQueuedFrame(queued)) {
                 return nullptr;
             }
         }
 
-        if (!m_Frame || m_Frame->width <= 0 || m_Frame->height <= 0) {
+        auto texture = UploadAndConvertFrame(queued.Frame, rhi);
+        av_frame_free(&queued.Frame);
+        if (!texture) {
             return nullptr;
         }
 
+        m_CurrentFrameIndex = queued.FrameIndex + 1;
+        return texture;
+    }
+
+    std::shared_ptr<RenderCore::RHITexture2D> FFmpegSoftwareVideoLoader::UploadAndConvertFrame(
+        const AVFrame* frameToUse, std::shared_ptr<RenderCore::DynamicRHI> rhi) {
         RenderCore::D3D11DynamicRHI* d3d11RHI = dynamic_cast<RenderCore::D3D11DynamicRHI*>(rhi.get());
         if (!d3d11RHI) {
             return nullptr;
         }
 
-        ID3D11Device* device = d3d11RHI->GetDevice();
         ID3D11DeviceContext* context = d3d11RHI->GetDeviceContext();
 
-        uint32_t width = m_Frame->width;
-        uint32_t height = m_Frame->height;
-        
-        // Determine pixel format and handle format conversion if needed
-        AVPixelFormat pixFmt = (AVPixelFormat)m_Frame->format;
-        AVFrame* frameToUse = m_Frame;  // Default to original frame
-        
-        // Check if format conversion is needed
-        bool needsConversion = (pixFmt != AV_PIX_FMT_YUV420P);
-        
-        if (needsConversion) {
-            // Convert to YUV420P using sws_scale (only for format conversion, not color conversion)
-            {
-                ScopedTimer timer("FormatConversion", m_CurrentFrameIndex);
-                
-                // Initialize or update SWS context if format changed
-                if (!m_SwsContext || m_CodecContext->width != width || m_CodecContext->height != height) {
-                    if (m_SwsContext) {
-                        sws_freeContext(m_SwsContext);
-                        m_SwsContext = nullptr;
-                    }
-                    
-                    m_SwsContext = sws_getContext(
-                        width, height, pixFmt,
-                        width, height, AV_PIX_FMT_YUV420P,
-                        SWS_BILINEAR, nullptr, nullptr, nullptr);
-                    
-                    if (!m_SwsContext) {
-                        return nullptr;
-                    }
-                    
-                    // Setup converted frame
-                    m_ConvertedFrame->format = AV_PIX_FMT_YUV420P;
-                    m_ConvertedFrame->width = width;
-                    m_ConvertedFrame->height = height;
-                    int ret = av_frame_get_buffer(m_ConvertedFrame, 32);
-                    if (ret < 0) {
-                        return nullptr;
-                    }
-                }
-                
-                // Convert format (e.g., YUVA444P12LE -> YUV420P)
-                sws_scale(m_SwsContext,
-                    m_Frame->data, m_Frame->linesize, 0, height,
-                    m_ConvertedFrame->data, m_ConvertedFrame->linesize);
-                
-                frameToUse = m_ConvertedFrame;
-            }
-        }
+        uint32_t width = frameToUse->width;
+        uint32_t height = frameToUse->height;
         
         // YUV420P: Y plane is full resolution, U and V planes are quarter resolution
         uint32_t yWidth = width;
@@ -518,7 +640,6 @@ namespace LightroomCore {
             return nullptr;
         }
         
-        m_CurrentFrameIndex++;
         return m_CachedRGBTexture;
     }
 
@@ -533,6 +654,9 @@ namespace LightroomCore {
     }
 
     void FFmpegSoftwareVideoLoader::Close() {
+        // 先停止解码线程，之后才能释放它使用的 FFmpeg 资源
+        StopDecodeThread();
+
         // Clear SWS context
         if (m_SwsContext) {
             sws_freeContext(m_SwsContext);
@@ -553,10 +677,6 @@ namespace LightroomCore {
         m_CachedYUVWidth = 0;
         m_CachedYUVHeight = 0;
 
-        if (m_ConvertedFrame) {
-            av_frame_free(&m_ConvertedFrame);
-        }
-
         if (m_Frame) {
             av_frame_free(&m_Frame);
         }
@@ -571,9 +691,105 @@ namespace LightroomCore {
 
         m_VideoStreamIndex = -1;
         m_CurrentFrameIndex = 0;
+        m_DecodeFrameIndex = 0;
         m_IsOpen = false;
     }
 
+    bool FFmpegSoftwareVideoLoader::DecodeKeyframeThumbnail(const std::wstring& filePath, uint32_t maxWidth, uint32_t maxHeight,
+                                                            std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight) {
+        InitializeFFmpeg();
+
+        int pathLen = WideCharToMultiByte(CP_UTF8, 0, filePath.c_str(), -1, nullptr, 0, nullptr, nullptr);
+        if (pathLen <= 0) {
+            return false;
+        }
+        std::vector<char> utf8Path(pathLen);
+        WideCharToMultiByte(CP_UTF8, 0, filePath.c_str(), -1, utf8Path.data(), pathLen, nullptr, nullptr);
+
+        // 所有 FFmpeg 资源在任何返回路径上都会释放
+        struct DecodeResources {
+            AVFormatContext* FormatContext = nullptr;
+            AVCodecContext* CodecContext = nullptr;
+            AVPacket* Packet = nullptr;
+            AVFrame* Frame = nullptr;
+            SwsContext* Sws = nullptr;
+            ~DecodeResources() {
+                if (Sws) sws_freeContext(Sws);
+                if (Frame) av_frame_free(&Frame);
+                if (Packet) av_packet_free(&Packet);
+                if (CodecContext) avcodec_free_context(&CodecContext);
+                if (FormatContext) avformat_close_input(&FormatContext);
+            }
+        } res;
+
+        if (avformat_open_input(&res.FormatContext, utf8Path.data(), nullptr, nullptr) < 0) {
+            return false;
+        }
+        if (avformat_find_stream_info(res.FormatContext, nullptr) < 0) {
+            return false;
+        }
+
+        const AVCodec* codec = nullptr;
+        int streamIndex = av_find_best_stream(res.FormatContext, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+        if (streamIndex < 0 || !codec) {
+            return false;
+        }
+
+        res.CodecContext = avcodec_alloc_context3(codec);
+        if (!res.CodecContext ||
+            avcodec_parameters_to_context(res.CodecContext, res.FormatContext->streams[streamIndex]->codecpar) < 0) {
+            return false;
+        }
+
+        // 只解码关键帧；批量生成时已经按文件并行，解码器本身使用单线程
+        res.CodecContext->skip_frame = AVDISCARD_NONKEY;
+        res.CodecContext->thread_count = 1;
+        if (avcodec_open2(res.CodecContext, codec, nullptr) < 0) {
+            return false;
+        }
+
+        res.Packet = av_packet_alloc();
+        res.Frame = av_frame_alloc();
+        if (!res.Packet || !res.Frame) {
+            return false;
+        }
+
+        // 读取到第一个可解码的关键帧为止（限制读取的包数，避免损坏文件扫描整个文件）
+        bool gotFrame = false;
+        int videoPackets = 0;
+        while (!gotFrame && videoPackets < 1000 && av_read_frame(res.FormatContext, res.Packet) >= 0) {
+            if (res.Packet->stream_index == streamIndex) {
+                ++videoPackets;
+                // 非关键帧包由 skip_frame 直接丢弃，只经过解析
+                if (avcodec_send_packet(res.CodecContext, res.Packet) >= 0) {
+                    gotFrame = avcodec_receive_frame(res.CodecContext, res.Frame) >= 0;
+                }
+            }
+            av_packet_unref(res.Packet);
+        }
+        if (!gotFrame) {
+            // 解码器可能还缓存着帧
+            avcodec_send_packet(res.CodecContext, nullptr);
+            gotFrame = avcodec_receive_frame(res.CodecContext, res.Frame) >= 0;
+        }
+        if (!gotFrame || res.Frame->width <= 0 || res.Frame->height <= 0) {
+            return false;
+        }
+
+        // 直接从 YUV 缩放并转换为 BGRA
+        ComputeFitSize(res.Frame->width, res.Frame->height, maxWidth, maxHeight, outWidth, outHeight);
+        res.Sws = sws_getContext(res.Frame->width, res.Frame->height, static_cast<AVPixelFormat>(res.Frame->format),
+                                 outWidth, outHeight, AV_PIX_FMT_BGRA, SWS_AREA, nullptr, nullptr, nullptr);
+        if (!res.Sws) {
+            return false;
+        }
+
+        outData.resize(static_cast<size_t>(outWidth) * outHeight * 4);
+        uint8_t* dstData[4] = { outData.data(), nullptr, nullptr, nullptr };
+        int dstLinesize[4] = { static_cast<int>(outWidth * 4), 0, 0, 0 };
+        return sws_scale(res.Sws, res.Frame->data, res.Frame->linesize, 0, res.Frame->height, dstData, dstLinesize) > 0;
+    }
+
     int64_t FFmpegSoftwareVideoLoader::GetCurrentFrameIndex() const {
         return m_IsOpen ? m_CurrentFrameIndex : -1;
     }
@@ -4,6 +4,10 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <wrl/client.h>
 #include <d3d11.h>
 
@@ -21,6 +25,9 @@ extern "C" {
 namespace LightroomCore {
 
 // FFmpeg software video loader
+// A decoder thread keeps a bounded queue of YUV420P frames ahead of ReadNextFrame, so a slow
+// frame (e.g. a long GOP reference) is absorbed by the queue instead of stalling presentation.
+// ReadNextFrame only uploads the queued planes and runs the GPU color conversion.
 class FFmpegSoftwareVideoLoader : public IVideoLoader {
 public:
     FFmpegSoftwareVideoLoader();
@@ -43,9 +50,32 @@ public:
     int64_t GetCurrentFrameIndex() const override;
     int64_t GetCurrentTimestamp() const override;
     bool IsOpen() const override;
+    void SetDecodeQueueCapacity(uint32_t capacity) override;
+    bool GetDecodeQueueStats(VideoDecodeQueueStats& stats) const override;
+
+    // Decodes only the first keyframe and scales it to a BGRA thumbnail on the CPU.
+    // Needs no RHI and keeps no state, so it can run concurrently on worker threads.
+    static bool DecodeKeyframeThumbnail(const std::wstring& filePath, uint32_t maxWidth, uint32_t maxHeight,
+                                        std::vector<uint8_t>& outData, uint32_t& outWidth, uint32_t& outHeight);
 
 private:
+    struct QueuedFrame {
+        AVFrame* Frame = nullptr;   // YUV420P, owned by the queue
+        int64_t FrameIndex = 0;
+    };
+
     bool DecodeFrame();
+    AVFrame* CreateQueuedFrame();
+    std::shared_ptr<RenderCore::RHITexture2D> UploadAndConvertFrame(
+        const AVFrame* frame, std::shared_ptr<RenderCore::DynamicRHI> rhi);
+
+    // Decoder thread: the thread owns the format/codec contexts while it runs,
+    // Seek and Close stop it before touching them
+    void StartDecodeThread();
+    void StopDecodeThread();
+    void DecodeThreadLoop();
+    bool PopQueuedFrame(QueuedFrame& outFrame);
+
     bool EnsureYUVTextures(std::shared_ptr<RenderCore::DynamicRHI> rhi, uint32_t width, uint32_t height, 
                            uint32_t yWidth, uint32_t yHeight, uint32_t uvWidth, uint32_t uvHeight);
     static void InitializeFFmpeg();
@@ -54,13 +84,26 @@ private:
     AVFormatContext* m_FormatContext;
     AVCodecContext* m_CodecContext;
     AVFrame* m_Frame;
-    AVFrame* m_ConvertedFrame;  // For format conversion (YUVA444P12LE -> YUV420P)
-    SwsContext* m_SwsContext;   // For format conversion only
+    SwsContext* m_SwsContext;   // For format conversion only (e.g. YUVA444P12LE -> YUV420P)
     
     int m_VideoStreamIndex;
     VideoMetadata m_Metadata;
-    int64_t m_CurrentFrameIndex;
+    int64_t m_CurrentFrameIndex;    // Next frame to present (render thread)
+    int64_t m_DecodeFrameIndex;     // Next frame to decode (decoder thread)
     bool m_IsOpen;
+
+    // Decoded frame queue
+    std::deque<QueuedFrame> m_FrameQueue;
+    mutable std::mutex m_QueueMutex;
+    std::condition_variable m_QueueNotFull;
+    std::condition_variable m_QueueNotEmpty;
+    std::thread m_DecodeThread;
+    uint32_t m_QueueCapacity;
+    bool m_StopDecoding;
+    bool m_DecodeFinished;          // End of stream or decode error
+    bool m_QueuePrimed;             // A frame was presented since the last open/seek
+    uint64_t m_FramesDecoded;
+    uint64_t m_Underruns;
     
     // Cached resources for GPU-based YUV to RGB conversion
     std::unique_ptr<class YUVToRGBNode> m_CachedYUVToRGBNode;
@@ -10,6 +10,7 @@ FFmpegVideoLoader::FFmpegVideoLoader()
     , m_SoftwareLoader(nullptr)
     , m_ActiveLoader(nullptr)
     , m_IsOpen(false)
+    , m_DecodeQueueCapacity(kDefaultVideoDecodeQueueCapacity)
 {
 }
 
@@ -41,6 +42,7 @@ bool FFmpegVideoLoader::Open(const std::wstring& filePath) {
     m_HardwareLoader.reset();
     
     m_SoftwareLoader = std::make_unique<FFmpegSoftwareVideoLoader>();
+    m_SoftwareLoader->SetDecodeQueueCapacity(m_DecodeQueueCapacity);
     if (!m_SoftwareLoader->Open(filePath)) {
         m_SoftwareLoader.reset();
         return false;
@@ -125,4 +127,18 @@ bool FFmpegVideoLoader::IsOpen() const {
     return m_IsOpen;
 }
 
+void FFmpegVideoLoader::SetDecodeQueueCapacity(uint32_t capacity) {
+    m_DecodeQueueCapacity = capacity;
+    if (m_ActiveLoader) {
+        m_ActiveLoader->SetDecodeQueueCapacity(capacity);
+    }
+}
+
+bool FFmpegVideoLoader::GetDecodeQueueStats(VideoDecodeQueueStats& stats) const {
+    if (!m_ActiveLoader) {
+        return false;
+    }
+    return m_ActiveLoader->GetDecodeQueueStats(stats);
+}
+
 } // namespace LightroomCore
@@ -33,12 +33,15 @@ public:
     int64_t GetCurrentFrameIndex() const override;
     int64_t GetCurrentTimestamp() const override;
     bool IsOpen() const override;
+    void SetDecodeQueueCapacity(uint32_t capacity) override;
+    bool GetDecodeQueueStats(VideoDecodeQueueStats& stats) const override;
 
 private:
     std::unique_ptr<FFmpegHardwareVideoLoader> m_HardwareLoader;
     std::unique_ptr<FFmpegSoftwareVideoLoader> m_SoftwareLoader;
     IVideoLoader* m_ActiveLoader;  // 当前活动的加载器（硬件或软件）
     bool m_IsOpen;
+    uint32_t m_DecodeQueueCapacity;  // 打开新文件时应用到软件解码器
 };
 
 } // namespace LightroomCore
@@ -10,9 +10,12 @@
 #include "VideoPerformanceProfiler.h"
 #include "../RenderTargetManager.h"
 #include "../RenderGraph.h"
+#include "../ResourceBudget.h"
 #include "../RenderNodes/ImageAdjustNode.h"
+#include "../RenderNodes/GrainNode.h"
 #include "../RenderNodes/ScaleNode.h"
 #include "../ImageProcessing/ImageExporter.h"
+#include "../ImageProcessing/ThumbnailCache.h"
 #include "../d3d11rhi/D3D11Texture2D.h"
 #include <iostream>
 #include <string>
@@ -51,6 +54,9 @@ bool OpenVideo(void* renderTargetHandle, const char* videoPath) {
         
         // 创建新的视频处理器
         data->VideoProcessor = std::make_unique<LightroomCore::VideoProcessor>(g_DynamicRHI);
+        if (data->VideoDecodeQueueCapacity > 0) {
+            data->VideoProcessor->SetDecodeQueueCapacity(data->VideoDecodeQueueCapacity);
+        }
         
         // 转换路径
         int pathLen = MultiByteToWideChar(CP_UTF8, 0, videoPath, -1, nullptr, 0);
@@ -77,6 +83,8 @@ bool OpenVideo(void* renderTargetHandle, const char* videoPath) {
         
         // 清除旧的渲染图
         data->RenderGraph->Clear();
+        // 视频帧为 8-bit，高精度模式的 FP16 中间结果只会增加带宽
+        data->RenderGraph->SetIntermediateFormat(RenderCore::EPixelFormat::PF_B8G8R8A8);
         
         // 添加图像调整节点
         auto adjustNode = std::make_shared<LightroomCore::ImageAdjustNode>(g_DynamicRHI);
@@ -86,6 +94,11 @@ bool OpenVideo(void* renderTargetHandle, const char* videoPath) {
         adjustNode->SetAdjustParams(defaultParams);
         data->RenderGraph->AddNode(adjustNode);
         
+        // 颗粒（强度为 0 时渲染图跳过；每帧按帧号平移噪声）
+        auto grainNode = std::make_shared<LightroomCore::GrainNode>(g_DynamicRHI);
+        grainNode->SetInputImageSize(metadata->width, metadata->height);
+        data->RenderGraph->AddNode(grainNode);
+        
         // 添加缩放节点
         auto scaleNode = std::make_shared<LightroomCore::ScaleNode>(g_DynamicRHI);
         scaleNode->SetInputImageSize(metadata->width, metadata->height);
@@ -94,6 +107,8 @@ bool OpenVideo(void* renderTargetHandle, const char* videoPath) {
         data->bIsVideo = true;
         data->bHasImage = true;
         data->ImageFormat = LightroomCore::ImageFormat::Unknown; // 视频不使用 ImageFormat
+        data->TileSource.reset();
+        data->CancelProgressiveLoad();
         data->VideoFilePath = std::string(videoPath);  // 保存视频文件路径，用于导出
         
         return true;
@@ -222,6 +237,10 @@ bool RenderVideoFrame(void* renderTargetHandle) {
         return false;
     }
     
+    // 与图片渲染相同：渲染之前标记最近使用并检查内存预算，回收其他渲染目标的缓存
+    LightroomCore::ResourceBudget::Get().Touch(renderTargetHandle);
+    LightroomCore::ResourceBudget::Get().Enforce(renderTargetHandle);
+    
     try {
         using namespace LightroomCore;
         ScopedTimer totalTimer("RenderVideoFrame_Total");
@@ -244,6 +263,17 @@ bool RenderVideoFrame(void* renderTargetHandle) {
         
         // 更新 ImageTexture（用于渲染图）
         data->ImageTexture = frameTexture;
+        // 解码器可能复用同一纹理承载新帧，中间结果不能沿用
+        data->RenderGraph->InvalidateCache();
+        
+        // 颗粒随帧变化
+        const int64_t frameIndex = std::max<int64_t>(data->VideoProcessor->GetCurrentFrameIndex(), 0);
+        for (size_t i = 0; i < data->RenderGraph->GetNodeCount(); ++i) {
+            auto grainNode = std::dynamic_pointer_cast<GrainNode>(data->RenderGraph->GetNode(i));
+            if (grainNode) {
+                grainNode->SetFrameIndex(static_cast<uint64_t>(frameIndex));
+            }
+        }
         
         // 获取渲染目标信息
         using RenderTargetInfo = LightroomCore::RenderTargetManager::RenderTargetInfo;
@@ -291,6 +321,7 @@ bool RenderVideoFrame(void* renderTargetHandle) {
         }
         
         // 【双缓冲+拷贝策略】将Back Buffer的内容复制到Front Buffer
+        data->PresentedContentKey = data->RenderGraph->GetOutputKey();
         return g_RenderTargetManager->PresentBackBuffer(renderTargetHandle);
     }
     catch (const std::exception& e) {
@@ -334,6 +365,54 @@ int64_t GetCurrentVideoTimestamp(void* renderTargetHandle) {
     return data->VideoProcessor->GetCurrentTimestamp();
 }
 
+void SetVideoDecodeQueueCapacity(void* renderTargetHandle, uint32_t capacity) {
+    if (!renderTargetHandle) {
+        return;
+    }
+    
+    auto it = g_RenderTargetData.find(renderTargetHandle);
+    if (it == g_RenderTargetData.end()) {
+        return;
+    }
+    
+    auto& data = it->second;
+    if (!data) {
+        return;
+    }
+    
+    data->VideoDecodeQueueCapacity = capacity;
+    if (data->VideoProcessor) {
+        data->VideoProcessor->SetDecodeQueueCapacity(
+            capacity > 0 ? capacity : LightroomCore::kDefaultVideoDecodeQueueCapacity);
+    }
+}
+
+bool GetVideoDecodeQueueStats(void* renderTargetHandle, VideoDecodeQueueStats* outStats) {
+    if (!renderTargetHandle || !outStats) {
+        return false;
+    }
+    
+    auto it = g_RenderTargetData.find(renderTargetHandle);
+    if (it == g_RenderTargetData.end()) {
+        return false;
+    }
+    
+    auto& data = it->second;
+    if (!data || !data->VideoProcessor || !data->bIsVideo) {
+        return false;
+    }
+    
+    LightroomCore::VideoDecodeQueueStats stats;
+    if (!data->VideoProcessor->GetDecodeQueueStats(stats)) {
+        return false;
+    }
+    outStats->queueDepth = stats.queueDepth;
+    outStats->queueCapacity = stats.queueCapacity;
+    outStats->framesDecoded = stats.framesDecoded;
+    outStats->underruns = stats.underruns;
+    return true;
+}
+
 bool IsVideoFormat(const char* filePath) {
     if (!filePath) {
         return false;
@@ -376,6 +455,20 @@ bool ExtractVideoThumbnail(const char* videoPath, uint32_t* outWidth, uint32_t*
         std::wstring wVideoPath(pathLen - 1, L'\0');
         MultiByteToWideChar(CP_UTF8, 0, videoPath, -1, &wVideoPath[0], pathLen);
         
+        // 先查询缩略图缓存，命中时不需要打开解码器
+        auto thumbnailCache = GetThumbnailCache();
+        LightroomCore::ThumbnailCacheKey cacheKey;
+        const bool hasCacheKey = thumbnailCache &&
+            LightroomCore::ThumbnailCache::MakeKey(wVideoPath, videoPath, maxWidth, maxHeight, cacheKey);
+        if (hasCacheKey) {
+            // 调用者按 maxWidth*maxHeight*4 分配缓冲区（0 表示原始尺寸，大小未知）
+            const size_t bufferSize = (maxWidth > 0 && maxHeight > 0) ?
+                static_cast<size_t>(maxWidth) * maxHeight * 4 : SIZE_MAX;
+            if (thumbnailCache->Lookup(cacheKey, *outWidth, *outHeight, outData, bufferSize)) {
+                return true;
+            }
+        }
+        
         // 创建临时的VideoProcessor
         auto videoProcessor = std::make_unique<LightroomCore::VideoProcessor>(g_DynamicRHI);
         if (!videoProcessor->OpenVideo(wVideoPath)) {
@@ -504,6 +597,10 @@ bool ExtractVideoThumbnail(const char* videoPath, uint32_t* outWidth, uint32_t*
         memcpy(outData, imageData.data(), requiredSize);
         
         videoProcessor->CloseVideo();
+        
+        if (hasCacheKey) {
+            thumbnailCache->Store(cacheKey, outData, outputWidth, outputHeight);
+        }
         return true;
     }
     catch (const std::exception& e) {
@@ -3,6 +3,7 @@
 #include "../RenderGraph.h"
 #include "../RenderNodes/ImageAdjustNode.h"
 #include "../RenderNodes/FilterNode.h"
+#include "../RenderNodes/GrainNode.h"
 #include "../RenderNodes/RGBToYUVNode.h"
 #include "../d3d11rhi/D3D11RHI.h"
 #include "../d3d11rhi/D3D11Texture2D.h"
@@ -13,6 +14,10 @@
 #include <d3d10_1.h> // ID3D10Multithread
 #include <iostream>
 #include <algorithm>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 
 // FFmpeg headers
 extern "C" {
@@ -27,6 +32,52 @@ using Microsoft::WRL::ComPtr;
 
 namespace LightroomCore {
 
+	namespace {
+
+		// 导出流水线阶段之间的有界队列
+		// Close 之后 Push 失败，Pop 取完剩余元素后失败
+		template <typename T>
+		class BoundedQueue {
+		public:
+			explicit BoundedQueue(size_t capacity) : m_Capacity(capacity), m_Closed(false) {}
+
+			bool Push(T value) {
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_NotFull.wait(lock, [this]() { return m_Closed || m_Items.size() < m_Capacity; });
+				if (m_Closed) return false;
+				m_Items.push_back(std::move(value));
+				m_NotEmpty.notify_one();
+				return true;
+			}
+
+			bool Pop(T& outValue) {
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_NotEmpty.wait(lock, [this]() { return m_Closed || !m_Items.empty(); });
+				if (m_Items.empty()) return false;
+				outValue = std::move(m_Items.front());
+				m_Items.pop_front();
+				m_NotFull.notify_one();
+				return true;
+			}
+
+			void Close() {
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Closed = true;
+				m_NotFull.notify_all();
+				m_NotEmpty.notify_all();
+			}
+
+		private:
+			std::mutex m_Mutex;
+			std::condition_variable m_NotFull;
+			std::condition_variable m_NotEmpty;
+			std::deque<T> m_Items;
+			size_t m_Capacity;
+			bool m_Closed;
+		};
+
+	} // namespace
+
 	VideoExporter::VideoExporter()
 		: m_IsExporting(false), m_ShouldCancel(false) {}
 
@@ -100,6 +151,12 @@ void VideoExporter::CancelExport() {
 				node->SetAdjustParams(adj->GetAdjustParams());
 				clonedNode = node;
 			}
+			else if (auto grain = std::dynamic_pointer_cast<GrainNode>(originalNode)) {
+				auto node = std::make_shared<GrainNode>(targetRHI);
+				node->SetAmount(grain->GetAmount());
+				node->SetInputImageSize(grain->GetInputImageWidth(), grain->GetInputImageHeight());
+				clonedNode = node;
+			}
 			// Add other node types here...
 
 			if (clonedNode) newGraph->AddNode(clonedNode);
@@ -126,6 +183,7 @@ void VideoExporter::CancelExport() {
 		ID3D11DeviceContext* context = d3dRHI->GetDeviceContext();
 
 		// 2. Setup Processor & Graph
+		// 软件解码时 VideoProcessor 自带解码线程和帧队列（解码阶段），这里的循环只负责渲染和回读
 		auto processor = std::make_unique<VideoProcessor>(m_ExportRHI);
 		if (!processor->OpenVideo(videoPath)) {
 			m_LastError = "Failed to open video";
@@ -142,6 +200,13 @@ void VideoExporter::CancelExport() {
         }
         
 		auto exportGraph = CloneRenderGraph(sourceGraph, m_ExportRHI);
+		// Grain noise is offset per frame so it animates like the preview
+		std::shared_ptr<GrainNode> exportGrain;
+		for (size_t i = 0; exportGraph && i < exportGraph->GetNodeCount(); ++i) {
+			if (auto grain = std::dynamic_pointer_cast<GrainNode>(exportGraph->GetNode(i))) {
+				exportGrain = grain;
+			}
+		}
 
 		// 3. Setup Encoder & Resources
 		FFmpegContext ctx;
@@ -152,19 +217,23 @@ void VideoExporter::CancelExport() {
         }
         
 		// Pre-allocate resources to prevent loop allocation overhead
-		ComPtr<ID3D11Query> syncQuery;
 		std::shared_ptr<RenderCore::RHITexture2D> processedTexture;
 		
 		// RGB to YUV conversion node (GPU-accelerated)
 		std::unique_ptr<RGBToYUVNode> rgbToYuvNode = std::make_unique<RGBToYUVNode>(m_ExportRHI);
 		
-		// Staging textures for YUV readback (created once, reused for all frames)
-		YUVStagingTextures stagingTextures;
-		if (!stagingTextures.Init(device, meta->width, meta->height)) {
-			m_LastError = "Failed to create staging textures";
-            m_IsExporting = false;
-            return;
-        }
+		// Readback slots: staging textures + completion query, reused round-robin
+		std::vector<ReadbackSlot> slots(kPipelineDepth);
+		D3D11_QUERY_DESC qDesc = { D3D11_QUERY_EVENT, 0 };
+		for (auto& slot : slots) {
+			if (!slot.Staging.Init(device, meta->width, meta->height) ||
+				FAILED(device->CreateQuery(&qDesc, slot.Query.GetAddressOf()))) {
+				m_LastError = "Failed to create staging textures";
+				CleanupContext(ctx);
+				m_IsExporting = false;
+				return;
+			}
+		}
         
 		// YUV textures for GPU conversion
 		std::shared_ptr<RenderCore::RHITexture2D> yTexture = m_ExportRHI->RHICreateTexture2D(
@@ -186,10 +255,6 @@ void VideoExporter::CancelExport() {
 			uvWidth, uvHeight, 1
 		);
 
-		// Sync query for Intel stability
-		D3D11_QUERY_DESC qDesc = { D3D11_QUERY_EVENT, 0 };
-		device->CreateQuery(&qDesc, syncQuery.GetAddressOf());
-
 		// Output texture for RenderGraph
 		if (exportGraph) {
 			processedTexture = m_ExportRHI->RHICreateTexture2D(
@@ -199,11 +264,79 @@ void VideoExporter::CancelExport() {
 			);
 		}
 
-		// 4. Export Loop
+		// AVFrame pool shared by the readback and encode stages
+		std::vector<AVFrame*> framePool;
+		BoundedQueue<AVFrame*> freeFrames(kPipelineDepth);
+		BoundedQueue<AVFrame*> encodeQueue(kPipelineDepth);
+		for (uint32_t i = 0; i < kPipelineDepth; ++i) {
+			AVFrame* frame = av_frame_alloc();
+			if (!frame) break;
+			frame->format = AV_PIX_FMT_YUV420P;
+			frame->width = meta->width;
+			frame->height = meta->height;
+			framePool.push_back(frame);
+			if (av_frame_get_buffer(frame, 0) < 0) break;
+			freeFrames.Push(frame);
+		}
+		auto freeFramePool = [&framePool]() {
+			for (AVFrame*& frame : framePool) {
+				av_frame_free(&frame);
+			}
+		};
+		if (framePool.size() != kPipelineDepth || !framePool.back()->data[0]) {
+			m_LastError = "Failed to allocate frames";
+			freeFramePool();
+			CleanupContext(ctx);
+			m_IsExporting = false;
+			return;
+		}
+
+		// 4. Encode stage: runs on its own thread so it never waits on GPU readback
+		std::atomic<bool> encodeFailed(false);
+		const int64_t totalFrames = meta->totalFrames;
+		const uint32_t width = meta->width;
+		const uint32_t height = meta->height;
+		std::thread encodeThread([&]() {
+			AVFrame* frame = nullptr;
+			while (encodeQueue.Pop(frame)) {
+				if (!m_ShouldCancel.load() && !encodeFailed.load()) {
+					if (EncodeFrame(ctx, frame, width, height)) {
+						if (callback) callback((double)frame->pts / totalFrames, frame->pts, totalFrames);
+					} else {
+						encodeFailed = true;
+					}
+				}
+				freeFrames.Push(frame);
+			}
+		});
+
+		// 5. Render + readback stage
+		// 最多 kPipelineDepth 帧在 GPU 上排队：最老的一帧回读时复制早已完成，Map 不会让 CPU 等 GPU
+		std::deque<ReadbackSlot*> inFlight;
+		auto readbackOldest = [&]() -> bool {
+			ReadbackSlot* slot = inFlight.front();
+			inFlight.pop_front();
+
+			AVFrame* frame = nullptr;
+			if (!freeFrames.Pop(frame)) {
+				return false;
+			}
+			// 编码器可能仍引用上一次送入的缓冲区，写入前确保可写
+			if (av_frame_make_writable(frame) < 0 || !ReadStagingToFrame(*slot, width, height, frame)) {
+				freeFrames.Push(frame);
+				return false;
+			}
+			frame->pts = slot->FrameIndex;
+			return encodeQueue.Push(frame);
+		};
+
+		bool bFailed = false;
 		try {
 			int64_t currentFrame = 0;
-			while (currentFrame < meta->totalFrames && !m_ShouldCancel.load())
+			while (currentFrame < totalFrames && !m_ShouldCancel.load() && !encodeFailed.load())
 			{
+				ReadbackSlot& slot = slots[currentFrame % kPipelineDepth];
+
 				// Scope to force hardware texture release
 				{
 					auto frameTex = processor->GetNextFrame();
@@ -213,31 +346,31 @@ void VideoExporter::CancelExport() {
 
 					// Execute RenderGraph if present
 					if (exportGraph && processedTexture) {
-						if (exportGraph->Execute(frameTex, processedTexture, meta->width, meta->height)) {
+						exportGraph->InvalidateCache();
+						if (exportGrain) exportGrain->SetFrameIndex(static_cast<uint64_t>(currentFrame));
+						if (exportGraph->Execute(frameTex, processedTexture, width, height)) {
 							targetTex = processedTexture;
 							context->Flush(); // Ensure draw calls are submitted
 						}
 					}
 
 					// Convert RGB to YUV on GPU
-					if (!rgbToYuvNode->Execute(targetTex, yTexture, uTexture, vTexture, meta->width, meta->height)) {
+					if (!rgbToYuvNode->Execute(targetTex, yTexture, uTexture, vTexture, width, height)) {
 						throw std::runtime_error("Failed to convert RGB to YUV");
 					}
 
-					// 确保所有渲染完成
-					context->End(syncQuery.Get());
-					context->Flush();
-
-					// Wait for GPU (Prevents 'msg_end' crash on Intel)
-					while (context->GetData(syncQuery.Get(), nullptr, 0, 0) == S_FALSE) {
-						if (m_ShouldCancel.load()) break;
-						std::this_thread::yield();
-					}					
+					// 提交到暂存纹理的复制，不等待完成
+					slot.FrameIndex = currentFrame;
+					if (!CopyYUVToStaging(yTexture, uTexture, vTexture, slot)) {
+						throw std::runtime_error("Failed to copy YUV to staging");
+					}
 				}
 				// frameTex destructor runs here -> FFmpeg ref count -1
 
-				// Encode YUV textures directly (GPU data)
-				EncodeFrame(ctx, yTexture, uTexture, vTexture, meta->width, meta->height, currentFrame, stagingTextures);
+				inFlight.push_back(&slot);
+				if (inFlight.size() >= kPipelineDepth && !readbackOldest()) {
+					throw std::runtime_error("Failed to read back frame");
+				}
 
 				// Memory Trim (Prevents OutOfMemory on long exports)
 				if (currentFrame % 50 == 0) {
@@ -249,20 +382,38 @@ void VideoExporter::CancelExport() {
 					}
 				}
 
-				if (callback) callback((double)currentFrame / meta->totalFrames, currentFrame, meta->totalFrames);
-            currentFrame++;
-        }
-        
-			FlushEncoder(ctx);
-			if (callback) callback(1.0, meta->totalFrames, meta->totalFrames);
+				currentFrame++;
+			}
 
+			// 回读剩余在途的帧
+			while (!inFlight.empty() && !m_ShouldCancel.load()) {
+				if (!readbackOldest()) {
+					throw std::runtime_error("Failed to read back frame");
+				}
+			}
 		}
 		catch (const std::exception& e) {
 			m_LastError = e.what();
+			bFailed = true;
+		}
+
+		// 编码线程处理完队列中剩余的帧后退出
+		encodeQueue.Close();
+		encodeThread.join();
+
+		if (encodeFailed.load()) {
+			m_LastError = "Failed to encode frame";
+			bFailed = true;
+		}
+		if (bFailed) {
 			if (callback) callback(0.0, 0, 0);
+		} else if (!m_ShouldCancel.load()) {
+			FlushEncoder(ctx);
+			if (callback) callback(1.0, totalFrames, totalFrames);
 		}
 
 		// Cleanup
+		freeFramePool();
 		CleanupContext(ctx);
 		processor->CloseVideo();
 		if (m_ExportRHI) {
@@ -330,58 +481,33 @@ bool VideoExporter::InitEncoder(FFmpegContext& ctx, uint32_t w, uint32_t h, doub
 	return avformat_write_header(ctx.formatCtx, nullptr) >= 0;
 }
 
-	void VideoExporter::EncodeFrame(FFmpegContext& ctx, 
-	                                 std::shared_ptr<RenderCore::RHITexture2D> yTexture,
-	                                 std::shared_ptr<RenderCore::RHITexture2D> uTexture,
-	                                 std::shared_ptr<RenderCore::RHITexture2D> vTexture,
-	                                 uint32_t w, uint32_t h, int64_t pts,
-	                                 YUVStagingTextures& staging) {
-		// Initialize frame if needed
-		if (!ctx.frame) {
-			ctx.frame = av_frame_alloc();
-			ctx.frame->format = AV_PIX_FMT_YUV420P;
-			ctx.frame->width = w; ctx.frame->height = h;
-			av_frame_get_buffer(ctx.frame, 0);
-		}
-		// Get native D3D11 textures
-		auto yD3D = std::dynamic_pointer_cast<RenderCore::D3D11Texture2D>(yTexture);
-		auto uD3D = std::dynamic_pointer_cast<RenderCore::D3D11Texture2D>(uTexture);
-		auto vD3D = std::dynamic_pointer_cast<RenderCore::D3D11Texture2D>(vTexture);
-		
-		if (!yD3D || !uD3D || !vD3D) {
-			return;
-		}
-
-		ID3D11Texture2D* yTex = yD3D->GetNativeTex();
-		ID3D11Texture2D* uTex = uD3D->GetNativeTex();
-		ID3D11Texture2D* vTex = vD3D->GetNativeTex();
-
-		// Read YUV data from GPU textures using pre-allocated staging textures
-		if (!ReadYUVTextureData(yTex, uTex, vTex, w, h,
-		                        ctx.frame->data[0], ctx.frame->data[1], ctx.frame->data[2],
-		                        ctx.frame->linesize[0], ctx.frame->linesize[1], ctx.frame->linesize[2],
-		                        staging)) {
-			return;
-		}
-		
+	bool VideoExporter::EncodeFrame(FFmpegContext& ctx, AVFrame* frame, uint32_t w, uint32_t h) {
 		// Convert U/V from Full Range [0, 255] to Limited Range [16, 240]
 		// RGBToYUV outputs U/V in [0, 1] (Full Range), but encoder expects [16, 240] (Limited Range)
+		static const std::array<uint8_t, 256> kLimitedRangeUV = []() {
+			std::array<uint8_t, 256> table = {};
+			for (int i = 0; i < 256; ++i) {
+				table[i] = (uint8_t)std::clamp((int)(i * 224.0f / 255.0f + 16.0f), 16, 240);
+			}
+			return table;
+		}();
+
 		uint32_t uvWidth = w / 2;
 		uint32_t uvHeight = h / 2;
 		for (uint32_t y = 0; y < uvHeight; ++y) {
-			uint8_t* uLine = ctx.frame->data[1] + y * ctx.frame->linesize[1];
-			uint8_t* vLine = ctx.frame->data[2] + y * ctx.frame->linesize[2];
+			uint8_t* uLine = frame->data[1] + y * frame->linesize[1];
+			uint8_t* vLine = frame->data[2] + y * frame->linesize[2];
 			for (uint32_t x = 0; x < uvWidth; ++x) {
-				// Map [0, 255] -> [16, 240]
-				uLine[x] = (uint8_t)std::clamp((int)(uLine[x] * 224.0f / 255.0f + 16.0f), 16, 240);
-				vLine[x] = (uint8_t)std::clamp((int)(vLine[x] * 224.0f / 255.0f + 16.0f), 16, 240);
+				uLine[x] = kLimitedRangeUV[uLine[x]];
+				vLine[x] = kLimitedRangeUV[vLine[x]];
 			}
 		}
 
-		ctx.frame->pts = pts;
-		if (avcodec_send_frame(ctx.codecCtx, ctx.frame) >= 0) {
-			WritePackets(ctx);
+		if (avcodec_send_frame(ctx.codecCtx, frame) < 0) {
+			return false;
 		}
+		WritePackets(ctx);
+		return true;
 	}
 
 	void VideoExporter::FlushEncoder(FFmpegContext& ctx) {
@@ -404,7 +530,6 @@ bool VideoExporter::InitEncoder(FFmpegContext& ctx, uint32_t w, uint32_t h, doub
 	void VideoExporter::CleanupContext(FFmpegContext& ctx) {
 		if (ctx.swsCtx) { sws_freeContext(ctx.swsCtx); ctx.swsCtx = nullptr; }
 		if (ctx.rgbFrame) { av_frame_free(&ctx.rgbFrame); ctx.rgbFrame = nullptr; }
-		if (ctx.frame) { av_frame_free(&ctx.frame); ctx.frame = nullptr; }
 		if (ctx.codecCtx) { avcodec_free_context(&ctx.codecCtx); ctx.codecCtx = nullptr; }
 		if (ctx.formatCtx) {
 			if (ctx.formatCtx->pb) avio_closep(&ctx.formatCtx->pb);
@@ -444,17 +569,30 @@ bool VideoExporter::InitEncoder(FFmpegContext& ctx, uint32_t w, uint32_t h, doub
     return true;
 }
 
-	bool VideoExporter::ReadYUVTextureData(ID3D11Texture2D* yTex, ID3D11Texture2D* uTex, ID3D11Texture2D* vTex,
-	                                        uint32_t width, uint32_t height,
-	                                        uint8_t* yData, uint8_t* uData, uint8_t* vData,
-	                                        uint32_t yStride, uint32_t uStride, uint32_t vStride,
-	                                        YUVStagingTextures& staging) {
-		if (!yTex || !uTex || !vTex || !yData || !uData || !vData) {
+	bool VideoExporter::CopyYUVToStaging(std::shared_ptr<RenderCore::RHITexture2D> yTexture,
+	                                      std::shared_ptr<RenderCore::RHITexture2D> uTexture,
+	                                      std::shared_ptr<RenderCore::RHITexture2D> vTexture,
+	                                      ReadbackSlot& slot) {
+		auto yD3D = std::dynamic_pointer_cast<RenderCore::D3D11Texture2D>(yTexture);
+		auto uD3D = std::dynamic_pointer_cast<RenderCore::D3D11Texture2D>(uTexture);
+		auto vD3D = std::dynamic_pointer_cast<RenderCore::D3D11Texture2D>(vTexture);
+		RenderCore::D3D11DynamicRHI* d3d11RHI = dynamic_cast<RenderCore::D3D11DynamicRHI*>(m_ExportRHI.get());
+		if (!yD3D || !uD3D || !vD3D || !d3d11RHI || !d3d11RHI->GetDeviceContext()) {
 			return false;
 		}
 
+		ID3D11DeviceContext* context = d3d11RHI->GetDeviceContext();
+		context->CopyResource(slot.Staging.Y.Get(), yD3D->GetNativeTex());
+		context->CopyResource(slot.Staging.U.Get(), uD3D->GetNativeTex());
+		context->CopyResource(slot.Staging.V.Get(), vD3D->GetNativeTex());
+		context->End(slot.Query.Get());
+		context->Flush();
+		return true;
+	}
+
+	bool VideoExporter::ReadStagingToFrame(ReadbackSlot& slot, uint32_t width, uint32_t height, AVFrame* frame) {
 		RenderCore::D3D11DynamicRHI* d3d11RHI = dynamic_cast<RenderCore::D3D11DynamicRHI*>(m_ExportRHI.get());
-		if (!d3d11RHI) {
+		if (!d3d11RHI || !frame) {
 			return false;
 		}
 
@@ -463,14 +601,14 @@ bool VideoExporter::InitEncoder(FFmpegContext& ctx, uint32_t w, uint32_t h, doub
 			return false;
 		}
 
-		// Helper lambda to read a texture plane using pre-allocated staging texture
-		auto ReadPlane = [&](ID3D11Texture2D* texture, ID3D11Texture2D* stagingTex,
-		                     uint32_t texWidth, uint32_t texHeight, 
-		                     uint8_t* dstData, uint32_t dstStride) -> bool {
-			// Copy to staging
-			context->CopyResource(stagingTex, texture);
+		// Wait for the copy (Prevents 'msg_end' crash on Intel); normally already signaled
+		while (context->GetData(slot.Query.Get(), nullptr, 0, 0) == S_FALSE) {
+			if (m_ShouldCancel.load()) return false;
+			std::this_thread::yield();
+		}
 
-			// Map and read
+		auto ReadPlane = [&](ID3D11Texture2D* stagingTex, uint32_t texWidth, uint32_t texHeight,
+		                     uint8_t* dstData, uint32_t dstStride) -> bool {
 			D3D11_MAPPED_SUBRESOURCE mapped;
 			if (FAILED(context->Map(stagingTex, 0, D3D11_MAP_READ, 0, &mapped))) {
 				return false;
@@ -479,8 +617,8 @@ bool VideoExporter::InitEncoder(FFmpegContext& ctx, uint32_t w, uint32_t h, doub
 			// Copy data with stride handling
 			uint32_t copyWidth = std::min(texWidth, dstStride);
 			for (uint32_t y = 0; y < texHeight; ++y) {
-				memcpy(dstData + (y * dstStride), 
-				       (uint8_t*)mapped.pData + (y * mapped.RowPitch), 
+				memcpy(dstData + (y * dstStride),
+				       (uint8_t*)mapped.pData + (y * mapped.RowPitch),
 				       copyWidth);
 			}
 
@@ -488,24 +626,11 @@ bool VideoExporter::InitEncoder(FFmpegContext& ctx, uint32_t w, uint32_t h, doub
 			return true;
 		};
 
-		// Read Y plane (full resolution)
-		if (!ReadPlane(yTex, staging.Y.Get(), width, height, yData, yStride)) {
-        return false;
-    }
-    
-		// Read U plane (half resolution)
 		uint32_t uvWidth = width / 2;
 		uint32_t uvHeight = height / 2;
-		if (!ReadPlane(uTex, staging.U.Get(), uvWidth, uvHeight, uData, uStride)) {
-            return false;
-        }
-        
-		// Read V plane (half resolution)
-		if (!ReadPlane(vTex, staging.V.Get(), uvWidth, uvHeight, vData, vStride)) {
-            return false;
-    }
-    
-    return true;
-}
+		return ReadPlane(slot.Staging.Y.Get(), width, height, frame->data[0], frame->linesize[0]) &&
+		       ReadPlane(slot.Staging.U.Get(), uvWidth, uvHeight, frame->data[1], frame->linesize[1]) &&
+		       ReadPlane(slot.Staging.V.Get(), uvWidth, uvHeight, frame->data[2], frame->linesize[2]);
+	}
 
 } // namespace LightroomCore
\ No newline at end of file
@@ -58,12 +58,11 @@ namespace LightroomCore {
             AVFormatContext* formatCtx = nullptr;
             AVCodecContext* codecCtx = nullptr;
             AVStream* stream = nullptr;
-            AVFrame* frame = nullptr;      // YUV420P
             AVFrame* rgbFrame = nullptr;   // RGB24
             SwsContext* swsCtx = nullptr;
             AVPacket* packet = nullptr;
         };
-		// Staging textures for YUV readback (reused across frames)
+		// Staging textures for YUV readback (one set per pipeline slot)
 		struct YUVStagingTextures {
 			ComPtr<ID3D11Texture2D> Y;
 			ComPtr<ID3D11Texture2D> U;
@@ -71,6 +70,17 @@ namespace LightroomCore {
 
 			bool Init(ID3D11Device* device, uint32_t width, uint32_t height);
 		};
+
+		// 回读槽：GPU 把一帧 YUV 复制到暂存纹理后，等若干帧再 Map，此时复制早已完成，Map 不会阻塞
+		struct ReadbackSlot {
+			YUVStagingTextures Staging;
+			ComPtr<ID3D11Query> Query;     // 复制完成的事件查询
+			int64_t FrameIndex = 0;
+		};
+
+		// 流水线深度：同时在途的回读槽数，也是等待编码的 AVFrame 数
+		static constexpr uint32_t kPipelineDepth = 3;
+
         void ExportThreadFunc(
             const std::wstring& videoPath,
             RenderGraph* sourceGraph,
@@ -83,22 +93,20 @@ namespace LightroomCore {
 
         // 编码管线
         bool InitEncoder(FFmpegContext& ctx, uint32_t w, uint32_t h, double fps, const std::string& path);
-        void EncodeFrame(FFmpegContext& ctx, 
-                         std::shared_ptr<RenderCore::RHITexture2D> yTexture,
-                         std::shared_ptr<RenderCore::RHITexture2D> uTexture,
-                         std::shared_ptr<RenderCore::RHITexture2D> vTexture,
-                         uint32_t w, uint32_t h, int64_t pts,
-                         YUVStagingTextures& staging);
+        // 编码线程：UV 范围转换 + avcodec_send_frame + 写包
+        bool EncodeFrame(FFmpegContext& ctx, AVFrame* frame, uint32_t w, uint32_t h);
         void FlushEncoder(FFmpegContext& ctx);
         void WritePackets(FFmpegContext& ctx);
         void CleanupContext(FFmpegContext& ctx);
         
-        // Helper: Read YUV texture data to CPU (using pre-allocated staging textures)
-        bool ReadYUVTextureData(ID3D11Texture2D* yTex, ID3D11Texture2D* uTex, ID3D11Texture2D* vTex,
-                                uint32_t width, uint32_t height,
-                                uint8_t* yData, uint8_t* uData, uint8_t* vData,
-                                uint32_t yStride, uint32_t uStride, uint32_t vStride,
-                                YUVStagingTextures& staging);
+        // GPU 线程：YUV 纹理 -> 回读槽的暂存纹理（只提交复制命令，不等待）
+        bool CopyYUVToStaging(std::shared_ptr<RenderCore::RHITexture2D> yTexture,
+                              std::shared_ptr<RenderCore::RHITexture2D> uTexture,
+                              std::shared_ptr<RenderCore::RHITexture2D> vTexture,
+                              ReadbackSlot& slot);
+
+        // GPU 线程：等待回读槽的复制完成，Map 暂存纹理并复制到 AVFrame
+        bool ReadStagingToFrame(ReadbackSlot& slot, uint32_t width, uint32_t height, AVFrame* frame);
 
         // 成员变量
         std::shared_ptr<RenderCore::DynamicRHI> m_ExportRHI; // 导出独占 RHI
@@ -31,6 +31,17 @@ struct VideoMetadata {
     bool hasAudio = false;
 };
 
+// 预解码队列的默认容量（帧数）
+constexpr uint32_t kDefaultVideoDecodeQueueCapacity = 6;
+
+// 异步解码队列统计（只有带解码线程的加载器提供）
+struct VideoDecodeQueueStats {
+    uint32_t queueDepth = 0;        // 已解码、等待显示的帧数
+    uint32_t queueCapacity = 0;     // 队列容量
+    uint64_t framesDecoded = 0;     // 解码线程累计输出的帧数
+    uint64_t underruns = 0;         // 取帧时队列为空、渲染线程需要等待解码的次数
+};
+
 // 视频加载器接口（类似于 IImageLoader）
 class IVideoLoader {
 public:
@@ -71,6 +82,12 @@ public:
     
     // 检查是否已打开
     virtual bool IsOpen() const = 0;
+    
+    // 设置预解码队列容量（帧数），不支持异步解码的加载器忽略
+    virtual void SetDecodeQueueCapacity(uint32_t capacity) { (void)capacity; }
+    
+    // 获取预解码队列统计，不支持异步解码的加载器返回 false
+    virtual bool GetDecodeQueueStats(VideoDecodeQueueStats& stats) const { (void)stats; return false; }
 };
 
 } // namespace LightroomCore
@@ -102,5 +102,16 @@ bool VideoProcessor::IsOpen() const {
     return m_IsOpen;
 }
 
+void VideoProcessor::SetDecodeQueueCapacity(uint32_t capacity) {
+    m_VideoLoader->SetDecodeQueueCapacity(capacity);
+}
+
+bool VideoProcessor::GetDecodeQueueStats(VideoDecodeQueueStats& stats) const {
+    if (!m_IsOpen) {
+        return false;
+    }
+    return m_VideoLoader->GetDecodeQueueStats(stats);
+}
+
 } // namespace LightroomCore
 
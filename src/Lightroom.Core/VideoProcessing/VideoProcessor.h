@@ -46,6 +46,12 @@ public:
     
     // 检查是否已打开视频
     bool IsOpen() const;
+    
+    // 预解码队列容量（帧数），对之后打开的视频同样有效
+    void SetDecodeQueueCapacity(uint32_t capacity);
+    
+    // 预解码队列统计（硬件解码路径没有解码队列，返回 false）
+    bool GetDecodeQueueStats(VideoDecodeQueueStats& stats) const;
 
 private:
     std::shared_ptr<RenderCore::DynamicRHI> m_RHI;
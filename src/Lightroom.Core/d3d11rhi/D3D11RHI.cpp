@@ -212,6 +212,7 @@ namespace RenderCore
 		std::shared_ptr<D3D11Texture2D> Tex2DRHI = std::make_shared<D3D11Texture2D>(this);
 		if (Tex2DRHI->CreateTexture2D(Format, Flags, SizeX, SizeY,1, NumMips, InBuffer, RowBytes))
 		{
+			Tex2DRHI->TrackMemory(RHITexture2D::ComputeTextureBytes(Format, SizeX, SizeY, NumMips), false);
 			return Tex2DRHI;
 		}
 		else
@@ -318,6 +319,8 @@ namespace RenderCore
 		std::shared_ptr<D3D11RenderTarget> RenderTargetRHI = std::make_shared<D3D11RenderTarget>(this);
 		if (RenderTargetRHI->Create(Format, SizeX,SizeY, NumMips,IsMultiSampled, CreateDepth))
 		{
+			if (auto Tex = RenderTargetRHI->GetTex())
+				Tex->TrackMemory(RHITexture2D::ComputeTextureBytes(Format, SizeX, SizeY, NumMips), false);
 			return RenderTargetRHI;
 		}
 		else
@@ -1,5 +1,6 @@
 ﻿#include "DynamicRHI.h"
 #include "D3D11RHI.h"
+#include "SoftwareRHI.h"
 
 namespace RenderCore
 {
@@ -13,6 +14,11 @@ namespace RenderCore
 				return GRHIModule->CreateRHI();
 			return {};
 		}
+		else if (apiType == RHIAPIType::E_Software)
+		{
+			GRHIModule = std::make_shared<SoftwareDynamicRHIModule>();
+			return GRHIModule->CreateRHI();
+		}
 		else
 		{
 			return {};
@@ -65,4 +71,4 @@ namespace RenderCore
 		return GRHIVendorId == 0x10DE;
 	}
 
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -9,6 +9,7 @@ namespace RenderCore
 	{
 		E_D3D11,
 		E_D3D12,
+		E_Software,		// CPU-only backend for machines without a usable GPU
 	};
 
 	class RHICommandContext;
@@ -1,5 +1,7 @@
 ﻿#include "RHI.h"
 #include "Common.h"
+#include "RHITexture2D.h"
+#include <atomic>
 
 
 namespace RenderCore
@@ -111,6 +113,54 @@ namespace RenderCore
 		}
 	} ValidatePixelFormats;
 
+	static std::atomic<uint64_t> GTrackedGPUTextureBytes{ 0 };
+	static std::atomic<uint64_t> GTrackedSystemTextureBytes{ 0 };
+	static std::atomic<uint32_t> GTrackedTextureCount{ 0 };
+
+	void RHITexture2D::TrackMemory(uint64_t Bytes, bool bSystemMemory)
+	{
+		UntrackMemory();
+		TrackedBytes = Bytes;
+		bTrackedInSystemMemory = bSystemMemory;
+		(bSystemMemory ? GTrackedSystemTextureBytes : GTrackedGPUTextureBytes).fetch_add(Bytes);
+		GTrackedTextureCount.fetch_add(1);
+	}
+
+	void RHITexture2D::UntrackMemory()
+	{
+		if (TrackedBytes == 0)
+			return;
+
+		(bTrackedInSystemMemory ? GTrackedSystemTextureBytes : GTrackedGPUTextureBytes).fetch_sub(TrackedBytes);
+		GTrackedTextureCount.fetch_sub(1);
+		TrackedBytes = 0;
+	}
+
+	uint64_t RHITexture2D::ComputeTextureBytes(EPixelFormat Format, int32_t SizeX, int32_t SizeY, uint32_t NumMips)
+	{
+		const FPixelFormatInfo& Info = GPixelFormats[Format];
+		if (Info.BlockSizeX <= 0 || Info.BlockSizeY <= 0 || SizeX <= 0 || SizeY <= 0)
+			return 0;
+
+		uint64_t Bytes = 0;
+		for (uint32_t Mip = 0; Mip < std::max(NumMips, 1u); ++Mip)
+		{
+			const uint64_t BlocksX = (uint64_t)(std::max(SizeX >> Mip, 1) + Info.BlockSizeX - 1) / Info.BlockSizeX;
+			const uint64_t BlocksY = (uint64_t)(std::max(SizeY >> Mip, 1) + Info.BlockSizeY - 1) / Info.BlockSizeY;
+			Bytes += BlocksX * BlocksY * Info.BlockBytes;
+		}
+		return Bytes;
+	}
+
+	RHITextureMemoryStats RHITexture2D::GetMemoryStats()
+	{
+		RHITextureMemoryStats Stats;
+		Stats.GPUBytes = GTrackedGPUTextureBytes.load();
+		Stats.SystemBytes = GTrackedSystemTextureBytes.load();
+		Stats.TextureCount = GTrackedTextureCount.load();
+		return Stats;
+	}
+
 
 	uint32_t GetTypeHash(const SamplerStateInitializerRHI& Initializer)
 	{
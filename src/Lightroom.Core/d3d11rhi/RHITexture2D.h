@@ -3,11 +3,19 @@
 
 namespace RenderCore
 {
+	/** Process-wide totals of the texture memory tracked by RHITexture2D::TrackMemory. */
+	struct RHITextureMemoryStats
+	{
+		uint64_t GPUBytes = 0;		// D3D11 textures and render targets
+		uint64_t SystemBytes = 0;	// software RHI textures
+		uint32_t TextureCount = 0;
+	};
+
 	class RHITexture2D
 	{
 	public:
 		RHITexture2D() = default;
-		virtual ~RHITexture2D() {}
+		virtual ~RHITexture2D() { UntrackMemory(); }
 
 		virtual bool CreateTexture2D(EPixelFormat Format, int32_t Flags, int32_t SizeX, int32_t SizeY,int32_t SizeZ=1, 
 			uint32_t NumMips = 1, void* InBuffer = nullptr, int RowBytes = 0) = 0;
@@ -17,5 +25,19 @@ namespace RenderCore
 		virtual core::vec2i GetSize() const = 0;
 		virtual uint32_t GetNumMips() const = 0;
 		virtual EPixelFormat GetPixelFormat() const = 0;
+
+		/** Adds the texture's size to the process-wide totals until it is destroyed. Called by the RHI after creation. */
+		void TrackMemory(uint64_t Bytes, bool bSystemMemory);
+		uint64_t GetTrackedBytes() const { return TrackedBytes; }
+
+		/** Size of a SizeX x SizeY texture with NumMips levels. */
+		static uint64_t ComputeTextureBytes(EPixelFormat Format, int32_t SizeX, int32_t SizeY, uint32_t NumMips = 1);
+		static RHITextureMemoryStats GetMemoryStats();
+
+	private:
+		void UntrackMemory();
+
+		uint64_t TrackedBytes = 0;
+		bool bTrackedInSystemMemory = false;
 	};
 }
\ No newline at end of file
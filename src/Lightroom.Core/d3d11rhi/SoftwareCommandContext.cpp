@@ -0,0 +1,116 @@
+﻿#include "SoftwareCommandContext.h"
+#include "SoftwareRHI.h"
+#include "SoftwareTexture2D.h"
+#include "SoftwareUniformBuffer.h"
+#include "SoftwareTaskPool.h"
+#include "RHIRenderTarget.h"
+#include <cstring>
+
+namespace RenderCore
+{
+	SoftwareCommandContext::SoftwareCommandContext(SoftwareDynamicRHI* InSoftwareRHI)
+		: SoftwareRHI(InSoftwareRHI)
+	{
+	}
+
+	SoftwareCommandContext::~SoftwareCommandContext()
+	{
+	}
+
+	void SoftwareCommandContext::SetViewPort(int32_t TopLeftX, int32_t TopLeftY, int32_t SizeX, int32_t SizeY)
+	{
+		// CPU kernels always cover the full output texture.
+	}
+
+	void SoftwareCommandContext::SetRenderTarget(std::shared_ptr<RHITexture2D> Tex, std::shared_ptr<RHITexture2D> Depth)
+	{
+		RenderTargets.clear();
+		if (Tex)
+			RenderTargets.push_back(Tex);
+	}
+
+	void SoftwareCommandContext::SetRenderTarget(const std::vector<std::shared_ptr<RHITexture2D>>& Targets, std::shared_ptr<RHITexture2D> Depth)
+	{
+		RenderTargets = Targets;
+	}
+
+	void SoftwareCommandContext::SetRenderTarget(std::shared_ptr<RHIRenderTarget> RenderTarget, int32_t IndexMip)
+	{
+		RenderTargets.clear();
+		if (RenderTarget && RenderTarget->GetTex())
+			RenderTargets.push_back(RenderTarget->GetTex());
+	}
+
+	void SoftwareCommandContext::SetRenderTarget(std::shared_ptr<RHITextureCube> TextureCube, int32_t IndexView, int32_t IndexMip)
+	{
+		RenderTargets.clear();
+	}
+
+	void SoftwareCommandContext::Clear(std::shared_ptr<RHIRenderTarget> RenderTarget, const core::FLinearColor& Color, float Depth, uint8_t Stencil)
+	{
+		if (RenderTarget)
+			Clear(RenderTarget->GetTex(), nullptr, Color, Depth, Stencil);
+	}
+
+	void SoftwareCommandContext::Clear(std::shared_ptr<RHITexture2D> RenderTarget, std::shared_ptr<RHITexture2D> DepthTarget, const core::FLinearColor& Color, float Depth, uint8_t Stencil)
+	{
+		SoftwareTexture2D* Tex = dynamic_cast<SoftwareTexture2D*>(RenderTarget.get());
+		if (Tex)
+			Tex->Fill(Color);
+	}
+
+	void SoftwareCommandContext::Clear(std::vector<std::shared_ptr<RHITexture2D>> Targets, std::shared_ptr<RHITexture2D> DepthTarget, const core::FLinearColor& Color, float Depth, uint8_t Stencil)
+	{
+		for (auto& Target : Targets)
+			Clear(Target, DepthTarget, Color, Depth, Stencil);
+	}
+
+	void SoftwareCommandContext::Clear(std::shared_ptr<RHITextureCube> TextureCube, int32_t Face, int32_t Mip, const core::FLinearColor& Color, float Depth, uint8_t Stencil)
+	{
+	}
+
+	void SoftwareCommandContext::RHIUpdateUniformBuffer(std::shared_ptr<RHIUniformBuffer> UniformBufferRHI, const void* Contents)
+	{
+		SoftwareUniformBuffer* Buffer = dynamic_cast<SoftwareUniformBuffer*>(UniformBufferRHI.get());
+		if (Buffer)
+			Buffer->UpdateContents(Contents);
+	}
+
+	void SoftwareCommandContext::RHICopyResource(std::shared_ptr<RHITexture2D> DstTex, std::shared_ptr<RHITexture2D> SrcTex)
+	{
+		SoftwareTexture2D* Dst = dynamic_cast<SoftwareTexture2D*>(DstTex.get());
+		SoftwareTexture2D* Src = dynamic_cast<SoftwareTexture2D*>(SrcTex.get());
+		if (!Dst || !Src || Dst->GetPixelFormat() != Src->GetPixelFormat())
+			return;
+
+		const core::vec2i SrcSize = Src->GetSize();
+		RHICopyResource2D(DstTex, SrcTex, core::vec4u(0, 0, (uint32_t)SrcSize.x, (uint32_t)SrcSize.y));
+	}
+
+	void SoftwareCommandContext::RHICopyResource2D(std::shared_ptr<RHITexture2D> DstTex, std::shared_ptr<RHITexture2D> SrcTex, core::vec4u rect)
+	{
+		SoftwareTexture2D* Dst = dynamic_cast<SoftwareTexture2D*>(DstTex.get());
+		SoftwareTexture2D* Src = dynamic_cast<SoftwareTexture2D*>(SrcTex.get());
+		if (!Dst || !Src || Dst->GetPixelFormat() != Src->GetPixelFormat())
+			return;
+
+		// Same semantics as CopySubresourceRegion to (0, 0): the source box lands at the destination origin.
+		const core::vec2i SrcSize = Src->GetSize();
+		const core::vec2i DstSize = Dst->GetSize();
+		const int32_t Left = (int32_t)(std::min)(rect.left(), (uint32_t)SrcSize.x);
+		const int32_t Top = (int32_t)(std::min)(rect.top(), (uint32_t)SrcSize.y);
+		const int32_t Width = (std::min)((int32_t)(std::min)(rect.right(), (uint32_t)SrcSize.x) - Left, DstSize.x);
+		const int32_t Height = (std::min)((int32_t)(std::min)(rect.bottom(), (uint32_t)SrcSize.y) - Top, DstSize.y);
+		if (Width <= 0 || Height <= 0)
+			return;
+
+		const uint32_t BytesPerPixel = Src->GetBytesPerPixel();
+		SoftwareTaskPool::Get().ParallelForRows(Height, 64, [&](int32_t Begin, int32_t End)
+		{
+			for (int32_t y = Begin; y < End; ++y)
+			{
+				std::memcpy(Dst->GetRow(y), Src->GetRow(Top + y) + (size_t)Left * BytesPerPixel, (size_t)Width * BytesPerPixel);
+			}
+		});
+	}
+}
@@ -0,0 +1,110 @@
+﻿#include "SoftwareRHI.h"
+#include "SoftwareCommandContext.h"
+#include "SoftwareTexture2D.h"
+#include "SoftwareUniformBuffer.h"
+#include "SoftwareRenderTarget.h"
+#include "SoftwareTaskPool.h"
+
+namespace RenderCore
+{
+	SoftwareDynamicRHI::SoftwareDynamicRHI()
+	{
+		CommandContext = std::make_shared<SoftwareCommandContext>(this);
+	}
+
+	SoftwareDynamicRHI::~SoftwareDynamicRHI()
+	{
+	}
+
+	void SoftwareDynamicRHI::Init()
+	{
+		GRHIAdapterName = L"Software";
+		GRHIVendorId = 0;
+
+		// Spin up the worker threads now rather than on the first frame.
+		SoftwareTaskPool::Get();
+	}
+
+	void SoftwareDynamicRHI::Shutdown()
+	{
+	}
+
+	std::shared_ptr<RHICommandContext> SoftwareDynamicRHI::GetDefaultCommandContext()
+	{
+		return CommandContext;
+	}
+
+	std::shared_ptr<RHICommandContext> SoftwareDynamicRHI::GetDefaultAsyncComputeContext()
+	{
+		return CommandContext;
+	}
+
+	std::shared_ptr< RHIUniformBuffer> SoftwareDynamicRHI::RHICreateUniformBuffer(uint32_t ConstantBufferSize)
+	{
+		return RHICreateUniformBuffer(nullptr, ConstantBufferSize);
+	}
+
+	std::shared_ptr< RHIUniformBuffer> SoftwareDynamicRHI::RHICreateUniformBuffer(const void* Contents, uint32_t ConstantBufferSize)
+	{
+		std::shared_ptr<SoftwareUniformBuffer> UniformBufferRHI = std::make_shared<SoftwareUniformBuffer>(this);
+		if (UniformBufferRHI->CreateUniformBuffer(Contents, ConstantBufferSize))
+		{
+			return UniformBufferRHI;
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	std::shared_ptr< RHITexture2D> SoftwareDynamicRHI::RHICreateTexture2D(EPixelFormat Format, int32_t Flags, int32_t SizeX, int32_t SizeY, uint32_t NumMips, void* InBuffer /*= nullptr*/, int RowBytes /*= 0*/)
+	{
+		std::shared_ptr<SoftwareTexture2D> Tex2DRHI = std::make_shared<SoftwareTexture2D>(this);
+		if (Tex2DRHI->CreateTexture2D(Format, Flags, SizeX, SizeY, 1, NumMips, InBuffer, RowBytes))
+		{
+			Tex2DRHI->TrackMemory(RHITexture2D::ComputeTextureBytes(Format, SizeX, SizeY), true);
+			return Tex2DRHI;
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	std::shared_ptr< RHITexture2D> SoftwareDynamicRHI::RHICreateTexture2D(const core::FLinearColor& Color)
+	{
+		std::shared_ptr<SoftwareTexture2D> Tex2DRHI = std::make_shared<SoftwareTexture2D>(this);
+		if (Tex2DRHI->CreateTexture2D(EPixelFormat::PF_B8G8R8A8, ETextureCreateFlags::TexCreate_ShaderResource, 1, 1, 1, 1))
+		{
+			Tex2DRHI->Fill(Color);
+			return Tex2DRHI;
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	std::shared_ptr< RHIRenderTarget> SoftwareDynamicRHI::RHICreateRenderTarget(EPixelFormat Format, int32_t SizeX, int32_t SizeY, uint32_t NumMips, bool IsMultiSampled, bool CreateDepth)
+	{
+		std::shared_ptr<SoftwareRenderTarget> RenderTargetRHI = std::make_shared<SoftwareRenderTarget>(this);
+		if (RenderTargetRHI->Create(Format, SizeX, SizeY, NumMips, IsMultiSampled, CreateDepth))
+		{
+			if (auto Tex = RenderTargetRHI->GetTex())
+				Tex->TrackMemory(RHITexture2D::ComputeTextureBytes(Format, SizeX, SizeY), true);
+			return RenderTargetRHI;
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	std::shared_ptr<DynamicRHI> SoftwareDynamicRHIModule::CreateRHI()
+	{
+		if (_dynamicRHI)
+			return _dynamicRHI;
+		_dynamicRHI = std::make_shared<SoftwareDynamicRHI>();
+		return _dynamicRHI;
+	}
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+#include "DynamicRHI.h"
+
+namespace RenderCore
+{
+	class SoftwareDynamicRHI;
+	class SoftwareCommandContext;
+
+	class SoftwareDynamicRHIModule : public IDynamicRHIModule
+	{
+	public:
+		SoftwareDynamicRHIModule() = default;
+		~SoftwareDynamicRHIModule() = default;
+		bool IsSupported() override { return true; }
+		std::shared_ptr<DynamicRHI> CreateRHI() override;
+	private:
+		std::shared_ptr< SoftwareDynamicRHI> _dynamicRHI;
+	};
+
+	/**
+	 * RHI backed by system memory. Textures, render targets and uniform buffers live in plain
+	 * CPU allocations; shaders, vertex/index buffers and pipeline state objects are not
+	 * available, so render nodes detect this RHI and run their CPU kernels on SoftwareTaskPool.
+	 */
+	class SoftwareDynamicRHI : public DynamicRHI
+	{
+	public:
+		SoftwareDynamicRHI();
+		virtual ~SoftwareDynamicRHI();
+
+		virtual void Init() override;
+		virtual void Shutdown() override;
+
+		virtual const TCHAR* GetName() override { return TEXT("Software"); }
+
+		virtual std::shared_ptr< RHICommandContext> GetDefaultCommandContext() override;
+		virtual std::shared_ptr< RHICommandContext> GetDefaultAsyncComputeContext() override;
+		virtual std::shared_ptr< RHIVertexBuffer> RHICreateVertexBuffer(const void* Data, EBufferUsageFlags InUsage, int32_t StrideByteWidth, int32_t Count) override { return nullptr; }
+		virtual void RHIUpdateVertexBuffer(std::shared_ptr< RHIVertexBuffer> VertexBuffer, const void* InData, int32_t nVertex, int32_t sizePerVertex) override {}
+		virtual std::shared_ptr< RHIIndexBuffer> RHICreateIndexBuffer(const uint16_t* InData, EBufferUsageFlags InUsage, int32_t IndexCount) override { return nullptr; }
+		virtual std::shared_ptr< RHIIndexBuffer> RHICreateIndexBuffer(const uint32_t* InData, EBufferUsageFlags InUsage, int32_t IndexCount) override { return nullptr; }
+
+		virtual std::shared_ptr< RHIUniformBuffer> RHICreateUniformBuffer(uint32_t ConstantBufferSize) override;
+		virtual std::shared_ptr< RHIUniformBuffer> RHICreateUniformBuffer(const void* Contents, uint32_t ConstantBufferSize) override;
+
+		virtual std::shared_ptr< RHITexture2D> RHICreateTexture2D(EPixelFormat Format, int32_t Flags, int32_t SizeX, int32_t SizeY, uint32_t NumMips, void* InBuffer = nullptr, int RowBytes = 0) override;
+		virtual std::shared_ptr< RHITexture2D> RHICreateTexture2D(const std::wstring& FileName) override { return nullptr; }
+		virtual std::shared_ptr< RHITexture2D> RHICreateTexture2D(const core::FLinearColor& Color) override;
+		virtual std::shared_ptr< RHITexture2D> RHICreateHDRTexture2D(const std::wstring& FileName) override { return nullptr; }
+		virtual std::shared_ptr< RHITexture1D> RHICreateTexture1D(EPixelFormat Format, int32_t Flags, int32_t SizeX, void* InBuffer, int RowBytes) override { return nullptr; }
+		virtual std::shared_ptr< RHITextureCube> RHICreateTextureCube(EPixelFormat Format, int32_t SizeX, int32_t SizeY, uint32_t NumMips, bool CreateDepth) override { return nullptr; }
+		virtual std::shared_ptr< RHIUnorderedAccessView> RHICreateUnorderedAccessView(EPixelFormat Format, int32_t SizeX, int32_t SizeY) override { return nullptr; }
+		virtual std::shared_ptr< RHIUnorderedAccessView> RHICreateUnorderedAccessView(std::shared_ptr< RHITexture2D> Tex2D) override { return nullptr; }
+
+		virtual std::shared_ptr< RHIRenderTarget> RHICreateRenderTarget(EPixelFormat Format, int32_t SizeX, int32_t SizeY, uint32_t NumMips, bool IsMultiSampled, bool CreateDepth) override;
+
+		virtual std::shared_ptr< RHIVertexShader> RHICreateVertexShader(const std::wstring& FileName, const std::string& VSMain, const RHIVertexDeclare& VertexDeclare, const std::vector<RHIShaderMacro>& MacroDefines) override { return nullptr; }
+		virtual std::shared_ptr< RHIPixelShader> RHICreatePixelShader(const std::wstring& FileName, const std::string& PSMain, const std::vector<RHIShaderMacro>& MacroDefines) override { return nullptr; }
+		virtual std::shared_ptr< RHIComputeShader> RHICreateComputeShader(const std::wstring& FileName, const std::string& CSMain, const std::vector<RHIShaderMacro>& MacroDefines) override { return nullptr; }
+
+		virtual std::shared_ptr< RHISamplerState> RHICreateSamplerState(const SamplerStateInitializerRHI& Initializer) override { return nullptr; }
+		virtual std::shared_ptr< RHIRasterizerState> RHICreateRasterizerState(const RasterizerStateInitializerRHI& Initializer) override { return nullptr; }
+		virtual std::shared_ptr< RHIBlendState> RHICreateBlendState(const BlendStateInitializerRHI& Initializer) override { return nullptr; }
+		virtual std::shared_ptr< RHIDepthStencilState> RHICreateDepthStencilState(const DepthStencilStateInitializerRHI& Initializer) override { return nullptr; }
+		virtual std::shared_ptr< RHITilePool> RHICreateTilePool(std::shared_ptr< RHITexture2D> Tex2D) override { return nullptr; }
+
+	private:
+		std::shared_ptr< SoftwareCommandContext> CommandContext;
+	};
+
+	/** True when Rhi is the CPU backend (render nodes use this to pick their CPU kernels). */
+	inline bool IsSoftwareRHI(const DynamicRHI* Rhi)
+	{
+		return dynamic_cast<const SoftwareDynamicRHI*>(Rhi) != nullptr;
+	}
+}
@@ -0,0 +1,37 @@
+﻿#include "SoftwareRenderTarget.h"
+#include "SoftwareTexture2D.h"
+#include "SoftwareRHI.h"
+
+namespace RenderCore
+{
+	SoftwareRenderTarget::SoftwareRenderTarget(SoftwareDynamicRHI* InSoftwareRHI)
+		: SoftwareRHI(InSoftwareRHI)
+	{
+	}
+
+	SoftwareRenderTarget::~SoftwareRenderTarget()
+	{
+	}
+
+	bool SoftwareRenderTarget::Create(EPixelFormat Format, int32_t SizeX, int32_t SizeY, uint32_t NumMips, bool IsMultiSampled, bool CreateDepth)
+	{
+		// MSAA and depth have no meaning for the CPU pixel pipeline; only the color surface is allocated.
+		Tex2D = std::make_shared<SoftwareTexture2D>(SoftwareRHI);
+		if (!Tex2D->CreateTexture2D(Format, TexCreate_RenderTargetable | TexCreate_ShaderResource, SizeX, SizeY, 1, 1))
+		{
+			Tex2D.reset();
+			return false;
+		}
+		return true;
+	}
+
+	core::vec2i SoftwareRenderTarget::GetSize() const
+	{
+		return Tex2D ? Tex2D->GetSize() : core::vec2i();
+	}
+
+	std::shared_ptr<RHITexture2D> SoftwareRenderTarget::GetTex() const
+	{
+		return Tex2D;
+	}
+}
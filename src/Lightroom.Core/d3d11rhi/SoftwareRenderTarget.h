@@ -0,0 +1,28 @@
+﻿#pragma once
+#include "RHIRenderTarget.h"
+#include "Common.h"
+#include <memory>
+
+namespace RenderCore
+{
+	class SoftwareDynamicRHI;
+	class SoftwareTexture2D;
+
+	class SoftwareRenderTarget : public RHIRenderTarget
+	{
+	public:
+		SoftwareRenderTarget(SoftwareDynamicRHI* SoftwareRHI);
+		virtual ~SoftwareRenderTarget();
+
+		virtual bool Create(EPixelFormat Format, int32_t SizeX, int32_t SizeY, uint32_t NumMips, bool IsMultiSampled, bool CreateDepth) override;
+		virtual core::vec2i GetSize() const override;
+		virtual void Bind() override {}
+		virtual void UnBind() override {}
+
+		virtual std::shared_ptr< RHITexture2D> GetTex() const override;
+
+	private:
+		SoftwareDynamicRHI* SoftwareRHI = nullptr;
+		std::shared_ptr< SoftwareTexture2D> Tex2D;
+	};
+}
@@ -0,0 +1,140 @@
+﻿#include "SoftwareTaskPool.h"
+#include <algorithm>
+
+namespace RenderCore
+{
+	SoftwareTaskPool& SoftwareTaskPool::Get()
+	{
+		static SoftwareTaskPool Pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+		return Pool;
+	}
+
+	SoftwareTaskPool::SoftwareTaskPool(uint32_t NumWorkers)
+	{
+		Workers.reserve(NumWorkers);
+		for (uint32_t i = 0; i < NumWorkers; ++i)
+		{
+			Workers.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+
+	SoftwareTaskPool::~SoftwareTaskPool()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			bStop = true;
+		}
+		WorkCondition.notify_all();
+		for (auto& Worker : Workers)
+		{
+			if (Worker.joinable())
+				Worker.join();
+		}
+	}
+
+	void SoftwareTaskPool::ParallelFor(uint32_t Count, const std::function<void(uint32_t)>& Func)
+	{
+		if (Count == 0)
+			return;
+
+		if (Count == 1 || Workers.empty())
+		{
+			for (uint32_t i = 0; i < Count; ++i)
+				Func(i);
+			return;
+		}
+
+		auto Job = std::make_shared<ParallelJob>();
+		Job->Func = &Func;
+		Job->Count = Count;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Jobs.push_back(Job);
+		}
+		WorkCondition.notify_all();
+
+		RunJob(*Job);
+
+		std::unique_lock<std::mutex> Lock(Mutex);
+		DoneCondition.wait(Lock, [&]() { return Job->Done.load() == Count; });
+		auto It = std::find(Jobs.begin(), Jobs.end(), Job);
+		if (It != Jobs.end())
+			Jobs.erase(It);
+	}
+
+	void SoftwareTaskPool::ParallelForRows(int32_t Height, int32_t MinRows, const std::function<void(int32_t, int32_t)>& Func)
+	{
+		if (Height <= 0)
+			return;
+
+		// A few bands per thread keeps the load balanced when rows differ in cost.
+		const int32_t TargetBands = (int32_t)GetConcurrency() * 4;
+		const int32_t RowsPerBand = std::max(std::max(MinRows, 1), (Height + TargetBands - 1) / TargetBands);
+		const uint32_t NumBands = (uint32_t)((Height + RowsPerBand - 1) / RowsPerBand);
+
+		ParallelFor(NumBands, [&](uint32_t Band)
+		{
+			const int32_t Begin = (int32_t)Band * RowsPerBand;
+			const int32_t End = std::min(Height, Begin + RowsPerBand);
+			Func(Begin, End);
+		});
+	}
+
+	void SoftwareTaskPool::ParallelForTiles(int32_t Width, int32_t Height, int32_t TileSize, const std::function<void(int32_t, int32_t, int32_t, int32_t)>& Func)
+	{
+		if (Width <= 0 || Height <= 0)
+			return;
+
+		TileSize = std::max(TileSize, 1);
+		const int32_t TilesX = (Width + TileSize - 1) / TileSize;
+		const int32_t TilesY = (Height + TileSize - 1) / TileSize;
+
+		ParallelFor((uint32_t)(TilesX * TilesY), [&](uint32_t Tile)
+		{
+			const int32_t X0 = ((int32_t)Tile % TilesX) * TileSize;
+			const int32_t Y0 = ((int32_t)Tile / TilesX) * TileSize;
+			Func(X0, Y0, std::min(Width, X0 + TileSize), std::min(Height, Y0 + TileSize));
+		});
+	}
+
+	void SoftwareTaskPool::WorkerLoop()
+	{
+		for (;;)
+		{
+			std::shared_ptr<ParallelJob> Job;
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				WorkCondition.wait(Lock, [this]() { return bStop || !Jobs.empty(); });
+				if (bStop)
+					return;
+
+				Job = Jobs.front();
+				if (Job->Next.load() >= Job->Count)
+				{
+					// Every index has been claimed; the owner waits for the stragglers.
+					Jobs.pop_front();
+					continue;
+				}
+			}
+			RunJob(*Job);
+		}
+	}
+
+	void SoftwareTaskPool::RunJob(ParallelJob& Job)
+	{
+		for (;;)
+		{
+			const uint32_t Index = Job.Next.fetch_add(1);
+			if (Index >= Job.Count)
+				break;
+
+			(*Job.Func)(Index);
+
+			if (Job.Done.fetch_add(1) + 1 == Job.Count)
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				DoneCondition.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,61 @@
+﻿#pragma once
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace RenderCore
+{
+	/** Persistent worker pool used by the software RHI and CPU pixel kernels. */
+	class SoftwareTaskPool
+	{
+	public:
+		/** Process-wide pool sized to the number of hardware threads. */
+		static SoftwareTaskPool& Get();
+
+		explicit SoftwareTaskPool(uint32_t NumWorkers);
+		~SoftwareTaskPool();
+
+		SoftwareTaskPool(const SoftwareTaskPool&) = delete;
+		SoftwareTaskPool& operator=(const SoftwareTaskPool&) = delete;
+
+		/** Number of threads that execute work, including the calling thread. */
+		uint32_t GetConcurrency() const { return (uint32_t)Workers.size() + 1; }
+
+		/**
+		 * Runs Func(Index) for every Index in [0, Count) and blocks until all of them finished.
+		 * The calling thread takes part in the work, so nested calls from inside a task are safe.
+		 */
+		void ParallelFor(uint32_t Count, const std::function<void(uint32_t)>& Func);
+
+		/** Splits [0, Height) into row bands (at least MinRows each) and runs Func(BeginRow, EndRow) per band. */
+		void ParallelForRows(int32_t Height, int32_t MinRows, const std::function<void(int32_t, int32_t)>& Func);
+
+		/** Splits the image into TileSize x TileSize tiles and runs Func(X0, Y0, X1, Y1) per tile. */
+		void ParallelForTiles(int32_t Width, int32_t Height, int32_t TileSize, const std::function<void(int32_t, int32_t, int32_t, int32_t)>& Func);
+
+	private:
+		struct ParallelJob
+		{
+			const std::function<void(uint32_t)>* Func = nullptr;
+			uint32_t Count = 0;
+			std::atomic<uint32_t> Next{ 0 };
+			std::atomic<uint32_t> Done{ 0 };
+		};
+
+		void WorkerLoop();
+		void RunJob(ParallelJob& Job);
+
+		std::vector<std::thread> Workers;
+		std::deque<std::shared_ptr<ParallelJob>> Jobs;
+		std::mutex Mutex;
+		std::condition_variable WorkCondition;
+		std::condition_variable DoneCondition;
+		bool bStop = false;
+	};
+}
@@ -0,0 +1,189 @@
+﻿#include "SoftwareTexture2D.h"
+#include "SoftwareRHI.h"
+#include "SoftwareTaskPool.h"
+#include <cstring>
+
+namespace RenderCore
+{
+	namespace
+	{
+		uint16_t FloatToHalf(float Value)
+		{
+			uint32_t Bits;
+			std::memcpy(&Bits, &Value, sizeof(Bits));
+			const uint32_t Sign = (Bits >> 16) & 0x8000u;
+			int32_t Exponent = (int32_t)((Bits >> 23) & 0xFF) - 127 + 15;
+			uint32_t Mantissa = Bits & 0x007FFFFFu;
+			if (Exponent <= 0)
+				return (uint16_t)Sign;
+			if (Exponent >= 31)
+				return (uint16_t)(Sign | 0x7C00u);
+			return (uint16_t)(Sign | ((uint32_t)Exponent << 10) | (Mantissa >> 13));
+		}
+
+		uint8_t ToUNorm8(float Value)
+		{
+			return (uint8_t)(math::Clamp(Value, 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+
+		uint16_t ToUNorm16(float Value)
+		{
+			return (uint16_t)(math::Clamp(Value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+		}
+
+		bool IsSoftwareSupportedFormat(EPixelFormat Format)
+		{
+			switch (Format)
+			{
+			case PF_B8G8R8A8:
+			case PF_R8G8B8A8:
+			case PF_G8:
+			case PF_R8:
+			case PF_A8:
+			case PF_G16:
+			case PF_R8G8:
+			case PF_R32_FLOAT:
+			case PF_R16F:
+			case PF_A16B16G16R16:
+			case PF_FloatRGBA:
+			case PF_A32B32G32R32F:
+				return true;
+			default:
+				return false;
+			}
+		}
+	}
+
+	SoftwareTexture2D::SoftwareTexture2D(SoftwareDynamicRHI* InSoftwareRHI)
+		: SoftwareRHI(InSoftwareRHI)
+	{
+	}
+
+	SoftwareTexture2D::~SoftwareTexture2D()
+	{
+	}
+
+	bool SoftwareTexture2D::CreateTexture2D(EPixelFormat InFormat, int32_t InFlags, int32_t SizeX, int32_t SizeY, int32_t SizeZ,
+		uint32_t NumMips, void* InBuffer, int RowBytes)
+	{
+		if (SizeX <= 0 || SizeY <= 0 || !IsSoftwareSupportedFormat(InFormat))
+		{
+			return false;
+		}
+
+		Size = core::vec2i(SizeX, SizeY);
+		Format = InFormat;
+		Flags = InFlags;
+		BytesPerPixel = (uint32_t)GPixelFormats[InFormat].BlockBytes;
+		RowPitch = (uint32_t)SizeX * BytesPerPixel;
+
+		try
+		{
+			Data.assign((size_t)RowPitch * (size_t)SizeY, 0);
+		}
+		catch (const std::bad_alloc&)
+		{
+			Data.clear();
+			return false;
+		}
+
+		if (InBuffer)
+		{
+			const uint8_t* Src = static_cast<const uint8_t*>(InBuffer);
+			const size_t SrcPitch = RowBytes > 0 ? (size_t)RowBytes : (size_t)RowPitch;
+			SoftwareTaskPool::Get().ParallelForRows(SizeY, 64, [&](int32_t Begin, int32_t End)
+			{
+				for (int32_t y = Begin; y < End; ++y)
+				{
+					std::memcpy(GetRow(y), Src + SrcPitch * (size_t)y, RowPitch);
+				}
+			});
+		}
+		return true;
+	}
+
+	bool SoftwareTexture2D::CreateFromFile(const std::wstring& FileName)
+	{
+		// Image decoding is handled by LightroomCore's image loaders, which upload through CreateTexture2D.
+		return false;
+	}
+
+	bool SoftwareTexture2D::CreateHDRFromFile(const std::wstring& FileName)
+	{
+		return false;
+	}
+
+	void SoftwareTexture2D::Fill(const core::FLinearColor& Color)
+	{
+		if (Data.empty())
+			return;
+
+		uint8_t Pixel[16] = {};
+		switch (Format)
+		{
+		case PF_B8G8R8A8:
+			Pixel[0] = ToUNorm8(Color.B); Pixel[1] = ToUNorm8(Color.G); Pixel[2] = ToUNorm8(Color.R); Pixel[3] = ToUNorm8(Color.A);
+			break;
+		case PF_R8G8B8A8:
+			Pixel[0] = ToUNorm8(Color.R); Pixel[1] = ToUNorm8(Color.G); Pixel[2] = ToUNorm8(Color.B); Pixel[3] = ToUNorm8(Color.A);
+			break;
+		case PF_G8:
+		case PF_R8:
+			Pixel[0] = ToUNorm8(Color.R);
+			break;
+		case PF_A8:
+			Pixel[0] = ToUNorm8(Color.A);
+			break;
+		case PF_R8G8:
+			Pixel[0] = ToUNorm8(Color.R); Pixel[1] = ToUNorm8(Color.G);
+			break;
+		case PF_G16:
+		{
+			const uint16_t Value = ToUNorm16(Color.R);
+			std::memcpy(Pixel, &Value, sizeof(Value));
+			break;
+		}
+		case PF_R16F:
+		{
+			const uint16_t Value = FloatToHalf(Color.R);
+			std::memcpy(Pixel, &Value, sizeof(Value));
+			break;
+		}
+		case PF_R32_FLOAT:
+			std::memcpy(Pixel, &Color.R, sizeof(float));
+			break;
+		case PF_A16B16G16R16:
+		{
+			const uint16_t Values[4] = { ToUNorm16(Color.R), ToUNorm16(Color.G), ToUNorm16(Color.B), ToUNorm16(Color.A) };
+			std::memcpy(Pixel, Values, sizeof(Values));
+			break;
+		}
+		case PF_FloatRGBA:
+		{
+			const uint16_t Values[4] = { FloatToHalf(Color.R), FloatToHalf(Color.G), FloatToHalf(Color.B), FloatToHalf(Color.A) };
+			std::memcpy(Pixel, Values, sizeof(Values));
+			break;
+		}
+		case PF_A32B32G32R32F:
+		{
+			const float Values[4] = { Color.R, Color.G, Color.B, Color.A };
+			std::memcpy(Pixel, Values, sizeof(Values));
+			break;
+		}
+		default:
+			break;
+		}
+
+		SoftwareTaskPool::Get().ParallelForRows(Size.y, 64, [&](int32_t Begin, int32_t End)
+		{
+			for (int32_t y = Begin; y < End; ++y)
+			{
+				uint8_t* Row = GetRow(y);
+				for (int32_t x = 0; x < Size.x; ++x)
+				{
+					std::memcpy(Row + (size_t)x * BytesPerPixel, Pixel, BytesPerPixel);
+				}
+			}
+		});
+	}
+}
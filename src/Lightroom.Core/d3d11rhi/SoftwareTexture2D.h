@@ -0,0 +1,47 @@
+﻿#pragma once
+#include "RHITexture2D.h"
+#include "Common.h"
+#include <vector>
+#include <memory>
+
+namespace RenderCore
+{
+	class SoftwareDynamicRHI;
+
+	/** 2D texture stored in system memory, tightly packed (RowPitch = SizeX * BlockBytes). */
+	class SoftwareTexture2D : public RHITexture2D
+	{
+	public:
+		SoftwareTexture2D(SoftwareDynamicRHI* SoftwareRHI);
+		virtual ~SoftwareTexture2D();
+
+		virtual bool CreateTexture2D(EPixelFormat Format, int32_t Flags, int32_t SizeX, int32_t SizeY, int32_t SizeZ = 1,
+			uint32_t NumMips = 1, void* InBuffer = nullptr, int RowBytes = 0) override;
+		virtual bool CreateFromFile(const std::wstring& FileName) override;
+		virtual bool CreateHDRFromFile(const std::wstring& FileName) override;
+		virtual bool IsMultisampled() const override { return false; }
+		virtual core::vec2i GetSize() const override { return Size; }
+		virtual uint32_t GetNumMips() const override { return 1; }
+		virtual EPixelFormat GetPixelFormat() const override { return Format; }
+
+		uint8_t* GetData() { return Data.data(); }
+		const uint8_t* GetData() const { return Data.data(); }
+		uint8_t* GetRow(int32_t Y) { return Data.data() + (size_t)Y * RowPitch; }
+		const uint8_t* GetRow(int32_t Y) const { return Data.data() + (size_t)Y * RowPitch; }
+		uint32_t GetRowPitch() const { return RowPitch; }
+		uint32_t GetBytesPerPixel() const { return BytesPerPixel; }
+		int32_t GetFlags() const { return Flags; }
+
+		/** Fills the whole texture with Color converted to the texture's pixel format. */
+		void Fill(const core::FLinearColor& Color);
+
+	private:
+		SoftwareDynamicRHI* SoftwareRHI = nullptr;
+		std::vector<uint8_t> Data;
+		core::vec2i Size;
+		uint32_t RowPitch = 0;
+		uint32_t BytesPerPixel = 0;
+		int32_t Flags = 0;
+		EPixelFormat Format = PF_Unknown;
+	};
+}
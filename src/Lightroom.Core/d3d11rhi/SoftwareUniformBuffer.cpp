@@ -0,0 +1,40 @@
+﻿#include "SoftwareUniformBuffer.h"
+#include "SoftwareRHI.h"
+#include <cstring>
+
+namespace RenderCore
+{
+	SoftwareUniformBuffer::SoftwareUniformBuffer(SoftwareDynamicRHI* InSoftwareRHI)
+		: SoftwareRHI(InSoftwareRHI)
+	{
+	}
+
+	SoftwareUniformBuffer::~SoftwareUniformBuffer()
+	{
+	}
+
+	bool SoftwareUniformBuffer::CreateUniformBuffer(const void* InContents, uint32_t ConstantBufferSize)
+	{
+		Assert(core::Align(ConstantBufferSize, 16u) == ConstantBufferSize);
+
+		Contents.assign(ConstantBufferSize, 0);
+		if (InContents)
+		{
+			std::memcpy(Contents.data(), InContents, ConstantBufferSize);
+		}
+		return ConstantBufferSize > 0;
+	}
+
+	uint32_t SoftwareUniformBuffer::GetConstantBufferSize() const
+	{
+		return (uint32_t)Contents.size();
+	}
+
+	void SoftwareUniformBuffer::UpdateContents(const void* InContents)
+	{
+		if (InContents && !Contents.empty())
+		{
+			std::memcpy(Contents.data(), InContents, Contents.size());
+		}
+	}
+}
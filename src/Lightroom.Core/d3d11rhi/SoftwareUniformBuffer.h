@@ -0,0 +1,27 @@
+﻿#pragma once
+#include "RHIUniformBuffer.h"
+#include "Common.h"
+#include <vector>
+
+namespace RenderCore
+{
+	class SoftwareDynamicRHI;
+
+	/** Constant buffer kept in system memory; CPU kernels read it back through GetContents. */
+	class SoftwareUniformBuffer : public RHIUniformBuffer
+	{
+	public:
+		SoftwareUniformBuffer(SoftwareDynamicRHI* SoftwareRHI);
+		virtual ~SoftwareUniformBuffer();
+
+		virtual bool CreateUniformBuffer(const void* Contents, uint32_t ConstantBufferSize) override;
+		virtual uint32_t GetConstantBufferSize() const override;
+
+		void UpdateContents(const void* Contents);
+		const void* GetContents() const { return Contents.data(); }
+
+	private:
+		SoftwareDynamicRHI* SoftwareRHI{ nullptr };
+		std::vector<uint8_t> Contents;
+	};
+}